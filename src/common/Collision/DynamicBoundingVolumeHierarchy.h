@@ -0,0 +1,446 @@
+/*
+ * This file is part of the TrinityCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _DYNAMIC_BVH_H
+#define _DYNAMIC_BVH_H
+
+#include "Define.h"
+#include "Errors.h"
+#include <G3D/AABox.h>
+#include <G3D/BoundsTrait.h>
+#include <G3D/Ray.h>
+#include <algorithm>
+#include <unordered_map>
+#include <vector>
+
+/*
+ * Bounding volume hierarchy for objects that move or appear and disappear at runtime.
+ *
+ * Unlike BIH, which has to be rebuilt from scratch after any change, this tree is updated in place:
+ * - leaves store their object's bounds enlarged by a margin, so small movements need no change at all
+ * - insertion descends to the sibling with the lowest surface area cost
+ * - every node touched on the way back up is refit and rebalanced with AVL style rotations
+ * Insert, remove and update therefore cost O(log n) and the tree is always ready to be queried.
+ */
+template<class T, class BoundsFunc = BoundsTrait<T> >
+class DynamicBVH
+{
+    static int32 const NullNode = -1;
+    static uint32 const MaxStackSize = 64;
+
+    struct Node
+    {
+        G3D::AABox bounds;
+        T const* object;
+        int32 parent;                                       // next free node while on the free list
+        int32 child1;
+        int32 child2;
+        int32 height;                                       // 0 for leaves, -1 for free nodes
+
+        bool isLeaf() const { return child1 == NullNode; }
+    };
+
+public:
+    // bounds of stored leaves are enlarged by this much on every side
+    static constexpr float Margin = 0.5f;
+
+    DynamicBVH() : m_root(NullNode), m_freeList(NullNode) { }
+
+    void insert(T const& obj)
+    {
+        ASSERT(m_objectToLeaf.find(&obj) == m_objectToLeaf.end());
+
+        int32 leaf = allocateNode();
+        m_nodes[leaf].object = &obj;
+        m_nodes[leaf].bounds = getFatBounds(obj);
+        m_nodes[leaf].height = 0;
+        insertLeaf(leaf);
+        m_objectToLeaf[&obj] = leaf;
+    }
+
+    void remove(T const& obj)
+    {
+        auto itr = m_objectToLeaf.find(&obj);
+        if (itr == m_objectToLeaf.end())
+            return;
+
+        removeLeaf(itr->second);
+        freeNode(itr->second);
+        m_objectToLeaf.erase(itr);
+    }
+
+    // must be called after bounds of an inserted object changed, returns true if the tree had to be restructured
+    bool update(T const& obj)
+    {
+        auto itr = m_objectToLeaf.find(&obj);
+        if (itr == m_objectToLeaf.end())
+            return false;
+
+        int32 leaf = itr->second;
+        G3D::AABox bounds;
+        BoundsFunc::getBounds(obj, bounds);
+        if (m_nodes[leaf].bounds.contains(bounds))
+            return false;
+
+        removeLeaf(leaf);
+        m_nodes[leaf].bounds = getFatBounds(obj);
+        insertLeaf(leaf);
+        return true;
+    }
+
+    bool contains(T const& obj) const { return m_objectToLeaf.find(&obj) != m_objectToLeaf.end(); }
+    bool empty() const { return m_root == NullNode; }
+    uint32 size() const { return uint32(m_objectToLeaf.size()); }
+    int32 height() const { return m_root != NullNode ? m_nodes[m_root].height : 0; }
+
+    // calls intersectCallback(ray, object, maxDist) for objects whose bounds the ray passes within maxDist, nearest bounds first.
+    // The callback shortens maxDist to its hits and returns true to stop the traversal (same as BIHWrap)
+    template<typename RayCallback>
+    void intersectRay(G3D::Ray const& ray, RayCallback& intersectCallback, float& maxDist) const
+    {
+        if (m_root == NullNode)
+            return;
+
+        G3D::Vector3 const& origin = ray.origin();
+        G3D::Vector3 const& invDir = ray.invDirection();
+
+        struct StackEntry
+        {
+            int32 Node;
+            float Entry;                                    // distance the ray enters the node's bounds at
+        };
+
+        StackEntry stack[MaxStackSize];
+        uint32 stackSize = 0;
+        float rootEntry;
+        if (!intersectsRay(m_nodes[m_root].bounds, origin, invDir, maxDist, rootEntry))
+            return;
+
+        stack[stackSize++] = { m_root, rootEntry };
+        while (stackSize)
+        {
+            StackEntry const entry = stack[--stackSize];
+            // behind a hit reported since the node was pushed
+            if (entry.Entry > maxDist)
+                continue;
+
+            Node const& node = m_nodes[entry.Node];
+            if (node.isLeaf())
+            {
+                if (intersectCallback(ray, *node.object, maxDist))
+                    return;
+                continue;
+            }
+
+            float entry1, entry2;
+            bool const hit1 = intersectsRay(m_nodes[node.child1].bounds, origin, invDir, maxDist, entry1);
+            bool const hit2 = intersectsRay(m_nodes[node.child2].bounds, origin, invDir, maxDist, entry2);
+
+            // the nearer child ends up on top of the stack
+            ASSERT(stackSize + 2 <= MaxStackSize);
+            if (hit1 && hit2 && entry1 < entry2)
+            {
+                stack[stackSize++] = { node.child2, entry2 };
+                stack[stackSize++] = { node.child1, entry1 };
+            }
+            else
+            {
+                if (hit1)
+                    stack[stackSize++] = { node.child1, entry1 };
+                if (hit2)
+                    stack[stackSize++] = { node.child2, entry2 };
+            }
+        }
+    }
+
+    // calls intersectCallback(point, object) for objects whose bounds contain the point
+    template<typename IsectCallback>
+    void intersectPoint(G3D::Vector3 const& point, IsectCallback& intersectCallback) const
+    {
+        if (m_root == NullNode)
+            return;
+
+        int32 stack[MaxStackSize];
+        uint32 stackSize = 0;
+        stack[stackSize++] = m_root;
+        while (stackSize)
+        {
+            Node const& node = m_nodes[stack[--stackSize]];
+            if (!node.bounds.contains(point))
+                continue;
+
+            if (node.isLeaf())
+            {
+                intersectCallback(point, *node.object);
+                continue;
+            }
+
+            ASSERT(stackSize + 2 <= MaxStackSize);
+            stack[stackSize++] = node.child2;
+            stack[stackSize++] = node.child1;
+        }
+    }
+
+private:
+    static G3D::AABox getFatBounds(T const& obj)
+    {
+        G3D::AABox bounds;
+        BoundsFunc::getBounds(obj, bounds);
+        G3D::Vector3 const margin(Margin, Margin, Margin);
+        return G3D::AABox(bounds.low() - margin, bounds.high() + margin);
+    }
+
+    static G3D::AABox merge(G3D::AABox const& a, G3D::AABox const& b)
+    {
+        return G3D::AABox(a.low().min(b.low()), a.high().max(b.high()));
+    }
+
+    // half of the surface area, only used for comparisons
+    static float area(G3D::AABox const& box)
+    {
+        G3D::Vector3 const extent = box.high() - box.low();
+        return extent.x * extent.y + extent.y * extent.z + extent.z * extent.x;
+    }
+
+    // slab test, NaNs produced by axis parallel rays fail every comparison and leave the interval untouched
+    static bool intersectsRay(G3D::AABox const& box, G3D::Vector3 const& origin, G3D::Vector3 const& invDir, float maxDist, float& entry)
+    {
+        float tMin = 0.0f;
+        float tMax = maxDist;
+        for (int axis = 0; axis < 3; ++axis)
+        {
+            float t1 = (box.low()[axis] - origin[axis]) * invDir[axis];
+            float t2 = (box.high()[axis] - origin[axis]) * invDir[axis];
+            if (t1 > t2)
+                std::swap(t1, t2);
+            if (t1 > tMin)
+                tMin = t1;
+            if (t2 < tMax)
+                tMax = t2;
+            if (tMin > tMax)
+                return false;
+        }
+        entry = tMin;
+        return true;
+    }
+
+    int32 allocateNode()
+    {
+        int32 index;
+        if (m_freeList != NullNode)
+        {
+            index = m_freeList;
+            m_freeList = m_nodes[index].parent;
+        }
+        else
+        {
+            index = int32(m_nodes.size());
+            m_nodes.emplace_back();
+        }
+
+        Node& node = m_nodes[index];
+        node.object = nullptr;
+        node.parent = NullNode;
+        node.child1 = NullNode;
+        node.child2 = NullNode;
+        node.height = 0;
+        return index;
+    }
+
+    void freeNode(int32 index)
+    {
+        m_nodes[index].parent = m_freeList;
+        m_nodes[index].height = -1;
+        m_freeList = index;
+    }
+
+    void insertLeaf(int32 leaf)
+    {
+        if (m_root == NullNode)
+        {
+            m_root = leaf;
+            m_nodes[leaf].parent = NullNode;
+            return;
+        }
+
+        // find the best sibling
+        G3D::AABox const leafBounds = m_nodes[leaf].bounds;
+        int32 index = m_root;
+        while (!m_nodes[index].isLeaf())
+        {
+            Node const& node = m_nodes[index];
+            float const nodeArea = area(node.bounds);
+            float const combinedArea = area(merge(node.bounds, leafBounds));
+
+            // cost of creating a new parent for this node and the new leaf
+            float const cost = 2.0f * combinedArea;
+            // minimum cost of pushing the leaf further down the tree
+            float const inheritanceCost = 2.0f * (combinedArea - nodeArea);
+
+            float const cost1 = descendCost(node.child1, leafBounds) + inheritanceCost;
+            float const cost2 = descendCost(node.child2, leafBounds) + inheritanceCost;
+            if (cost < cost1 && cost < cost2)
+                break;
+
+            index = cost1 < cost2 ? node.child1 : node.child2;
+        }
+
+        int32 const sibling = index;
+        int32 const oldParent = m_nodes[sibling].parent;
+        int32 const newParent = allocateNode();
+        m_nodes[newParent].parent = oldParent;
+        m_nodes[newParent].bounds = merge(leafBounds, m_nodes[sibling].bounds);
+        m_nodes[newParent].height = m_nodes[sibling].height + 1;
+        m_nodes[newParent].child1 = sibling;
+        m_nodes[newParent].child2 = leaf;
+        m_nodes[sibling].parent = newParent;
+        m_nodes[leaf].parent = newParent;
+
+        if (oldParent != NullNode)
+            replaceChild(oldParent, sibling, newParent);
+        else
+            m_root = newParent;
+
+        refitUpwards(m_nodes[leaf].parent);
+    }
+
+    void removeLeaf(int32 leaf)
+    {
+        if (leaf == m_root)
+        {
+            m_root = NullNode;
+            return;
+        }
+
+        int32 const parent = m_nodes[leaf].parent;
+        int32 const grandParent = m_nodes[parent].parent;
+        int32 const sibling = m_nodes[parent].child1 == leaf ? m_nodes[parent].child2 : m_nodes[parent].child1;
+
+        freeNode(parent);
+        if (grandParent != NullNode)
+        {
+            replaceChild(grandParent, parent, sibling);
+            m_nodes[sibling].parent = grandParent;
+            refitUpwards(grandParent);
+        }
+        else
+        {
+            m_root = sibling;
+            m_nodes[sibling].parent = NullNode;
+        }
+    }
+
+    float descendCost(int32 child, G3D::AABox const& leafBounds) const
+    {
+        Node const& node = m_nodes[child];
+        float const combinedArea = area(merge(node.bounds, leafBounds));
+        if (node.isLeaf())
+            return combinedArea;
+        return combinedArea - area(node.bounds);
+    }
+
+    void replaceChild(int32 parent, int32 oldChild, int32 newChild)
+    {
+        if (m_nodes[parent].child1 == oldChild)
+            m_nodes[parent].child1 = newChild;
+        else
+            m_nodes[parent].child2 = newChild;
+    }
+
+    void refitUpwards(int32 index)
+    {
+        while (index != NullNode)
+        {
+            index = rotate(index);
+
+            Node& node = m_nodes[index];
+            Node const& child1 = m_nodes[node.child1];
+            Node const& child2 = m_nodes[node.child2];
+            node.height = 1 + std::max(child1.height, child2.height);
+            node.bounds = merge(child1.bounds, child2.bounds);
+
+            index = node.parent;
+        }
+    }
+
+    // rotates the taller child of an unbalanced node up, returns the node now standing in its place
+    int32 rotate(int32 iA)
+    {
+        Node& A = m_nodes[iA];
+        if (A.isLeaf() || A.height < 2)
+            return iA;
+
+        int32 const iB = A.child1;
+        int32 const iC = A.child2;
+        Node& B = m_nodes[iB];
+        Node& C = m_nodes[iC];
+
+        int32 const balance = C.height - B.height;
+        if (balance > 1)
+            return rotateUp(iA, iC, iB, false);
+        if (balance < -1)
+            return rotateUp(iA, iB, iC, true);
+        return iA;
+    }
+
+    // moves iUp (child of iA) into iA's place, iA keeps iStay and takes the shorter child of iUp
+    int32 rotateUp(int32 iA, int32 iUp, int32 iStay, bool upIsChild1)
+    {
+        Node& A = m_nodes[iA];
+        Node& up = m_nodes[iUp];
+        Node const& stay = m_nodes[iStay];
+
+        int32 const iF = up.child1;
+        int32 const iG = up.child2;
+        Node& F = m_nodes[iF];
+        Node& G = m_nodes[iG];
+
+        up.child1 = iA;
+        up.parent = A.parent;
+        A.parent = iUp;
+
+        if (up.parent != NullNode)
+            replaceChild(up.parent, iA, iUp);
+        else
+            m_root = iUp;
+
+        int32 const iKeep = F.height > G.height ? iF : iG;
+        int32 const iGive = F.height > G.height ? iG : iF;
+        Node& keep = m_nodes[iKeep];
+        Node& give = m_nodes[iGive];
+
+        up.child2 = iKeep;
+        if (upIsChild1)
+            A.child1 = iGive;
+        else
+            A.child2 = iGive;
+        give.parent = iA;
+
+        A.bounds = merge(stay.bounds, give.bounds);
+        up.bounds = merge(A.bounds, keep.bounds);
+        A.height = 1 + std::max(stay.height, give.height);
+        up.height = 1 + std::max(A.height, keep.height);
+        return iUp;
+    }
+
+    std::vector<Node> m_nodes;
+    std::unordered_map<T const*, int32> m_objectToLeaf;
+    int32 m_root;
+    int32 m_freeList;
+};
+
+#endif // _DYNAMIC_BVH_H
@@ -18,11 +18,10 @@
 #include "DynamicTree.h"
 //#include "QuadTree.h"
 //#include "RegularGrid.h"
-#include "BoundingIntervalHierarchyWrapper.h"
+#include "DynamicBoundingVolumeHierarchy.h"
 
 #include "Log.h"
 #include "RegularGrid.h"
-#include "Timer.h"
 #include "GameObjectModel.h"
 #include "ModelInstance.h"
 #include "ModelIgnoreFlags.h"
@@ -33,12 +32,6 @@
 
 using VMAP::ModelInstance;
 
-namespace {
-
-int CHECK_TREE_PERIOD = 200;
-
-} // namespace
-
 template<> struct HashTrait< GameObjectModel>{
     static size_t hashCode(const GameObjectModel& g) { return (size_t)(void*)&g; }
 };
@@ -58,53 +51,12 @@ static bool operator == (const GameObjectModel& mdl, const GameObjectModel& mdl2
 }
 */
 
-typedef RegularGrid2D<GameObjectModel, BIHWrap<GameObjectModel> > ParentTree;
+typedef RegularGrid2D<GameObjectModel, DynamicBVH<GameObjectModel> > ParentTree;
 
 struct DynTreeImpl : public ParentTree/*, public Intersectable*/
 {
     typedef GameObjectModel Model;
     typedef ParentTree base;
-
-    DynTreeImpl() :
-        rebalance_timer(CHECK_TREE_PERIOD),
-        unbalanced_times(0)
-    {
-    }
-
-    void insert(const Model& mdl)
-    {
-        base::insert(mdl);
-        ++unbalanced_times;
-    }
-
-    void remove(const Model& mdl)
-    {
-        base::remove(mdl);
-        ++unbalanced_times;
-    }
-
-    void balance()
-    {
-        base::balance();
-        unbalanced_times = 0;
-    }
-
-    void update(uint32 difftime)
-    {
-        if (empty())
-            return;
-
-        rebalance_timer.Update(difftime);
-        if (rebalance_timer.Passed())
-        {
-            rebalance_timer.Reset(CHECK_TREE_PERIOD);
-            if (unbalanced_times > 0)
-                balance();
-        }
-    }
-
-    TimeTrackerSmall rebalance_timer;
-    int unbalanced_times;
 };
 
 DynamicMapTree::DynamicMapTree() : impl(new DynTreeImpl()) { }
@@ -129,37 +81,35 @@ bool DynamicMapTree::contains(const GameObjectModel& mdl) const
     return impl->contains(mdl);
 }
 
-void DynamicMapTree::balance()
-{
-    impl->balance();
-}
-
-void DynamicMapTree::update(uint32 t_diff)
+void DynamicMapTree::update(const GameObjectModel& mdl)
 {
-    impl->update(t_diff);
+    impl->update(mdl);
 }
 
 struct DynamicTreeIntersectionCallback
 {
-    DynamicTreeIntersectionCallback(PhaseShift const& phaseShift) : _didHit(false), _phaseShift(phaseShift) { }
+    // without stopAtFirstHit the nearest hit is searched, intersectRay shortens distance to every hit
+    DynamicTreeIntersectionCallback(PhaseShift const& phaseShift, bool stopAtFirstHit) : _didHit(false), _stopAtFirstHit(stopAtFirstHit), _phaseShift(phaseShift) { }
 
     bool operator()(G3D::Ray const& r, GameObjectModel const& obj, float& distance)
     {
-        _didHit = obj.intersectRay(r, distance, true, _phaseShift, VMAP::ModelIgnoreFlags::Nothing);
-        return _didHit;
+        if (obj.intersectRay(r, distance, true, _phaseShift, VMAP::ModelIgnoreFlags::Nothing))
+            _didHit = true;
+        return _didHit && _stopAtFirstHit;
     }
 
     bool didHit() const { return _didHit; }
 
 private:
     bool _didHit;
+    bool _stopAtFirstHit;
     PhaseShift const& _phaseShift;
 };
 
 bool DynamicMapTree::getIntersectionTime(G3D::Ray const& ray, G3D::Vector3 const& endPos, PhaseShift const& phaseShift, float& maxDist) const
 {
     float distance = maxDist;
-    DynamicTreeIntersectionCallback callback(phaseShift);
+    DynamicTreeIntersectionCallback callback(phaseShift, false);
     impl->intersectRay(ray, callback, distance, endPos);
     if (callback.didHit())
         maxDist = distance;
@@ -212,7 +162,7 @@ bool DynamicMapTree::isInLineOfSight(G3D::Vector3 const& startPos, G3D::Vector3
         return true;
 
     G3D::Ray r(startPos, (endPos - startPos) / maxDist);
-    DynamicTreeIntersectionCallback callback(phaseShift);
+    DynamicTreeIntersectionCallback callback(phaseShift, true);
     impl->intersectRay(r, callback, maxDist, endPos);
 
     return !callback.didHit();
@@ -222,7 +172,7 @@ float DynamicMapTree::getHeight(float x, float y, float z, float maxSearchDist,
 {
     G3D::Vector3 v(x, y, z);
     G3D::Ray r(v, G3D::Vector3(0, 0, -1));
-    DynamicTreeIntersectionCallback callback(phaseShift);
+    DynamicTreeIntersectionCallback callback(phaseShift, false);
     impl->intersectZAllignedRay(r, callback, maxSearchDist);
 
     if (callback.didHit())
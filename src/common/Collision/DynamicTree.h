@@ -48,10 +48,9 @@ public:
 
     void insert(const GameObjectModel&);
     void remove(const GameObjectModel&);
+    // must be called after bounds of an inserted model changed
+    void update(const GameObjectModel&);
     bool contains(const GameObjectModel&) const;
-
-    void balance();
-    void update(uint32 diff);
 };
 
 #endif // _DYNTREE_H
@@ -30,7 +30,8 @@ namespace MMAP
     MMapManager::~MMapManager()
     {
         for (MMapDataSet::iterator i = loadedMMaps.begin(); i != loadedMMaps.end(); ++i)
-            delete i->second;
+            if (i->second)
+                MMapData::Release(i->second);
 
         // by now we should not have maps loaded
         // if we had, tiles in MMapData->mmapLoadedTiles, their actual data is lost!
@@ -211,6 +212,8 @@ namespace MMAP
         dtMeshHeader* header = (dtMeshHeader*)data;
         dtTileRef tileRef = 0;
 
+        std::unique_lock<std::shared_mutex> tileLock(mmap->tileLock);
+
         // memory allocated for data is now managed by detour, and will be deallocated when the tile is removed
         if (dtStatusSucceed(mmap->navMesh->addTile(data, fileHeader.size, DT_TILE_FREE_DATA, 0, &tileRef)))
         {
@@ -299,6 +302,8 @@ namespace MMAP
             return false;
         }
 
+        std::unique_lock<std::shared_mutex> tileLock(mmap->tileLock);
+
         // unload, and mark as non loaded
         if (dtStatusFailed(mmap->navMesh->removeTile(tileRefItr->second, nullptr, nullptr)))
         {
@@ -341,6 +346,7 @@ namespace MMAP
 
         // unload all tiles from given map
         MMapData* mmap = itr->second;
+        std::unique_lock<std::shared_mutex> tileLock(mmap->tileLock);
         for (MMapTileSet::iterator i = mmap->loadedTileRefs.begin(); i != mmap->loadedTileRefs.end(); ++i)
         {
             uint32 x = (i->first >> 16);
@@ -354,7 +360,8 @@ namespace MMAP
             }
         }
 
-        delete mmap;
+        tileLock.unlock();
+        MMapData::Release(mmap);
         itr->second = nullptr;
         TC_LOG_DEBUG("maps", "MMAP:unloadMap: Unloaded %03i.mmap", mapId);
 
@@ -409,4 +416,39 @@ namespace MMAP
 
         return queryItr->second;
     }
+
+    std::shared_ptr<MMapData> MMapManager::PinNavMesh(uint32 mapId)
+    {
+        auto itr = GetMMapData(mapId);
+        if (itr == loadedMMaps.end())
+            return nullptr;
+
+        MMapData* mmap = itr->second;
+        ++mmap->references;
+        return std::shared_ptr<MMapData>(mmap, &MMapData::Release);
+    }
+
+    dtNavMeshQuery const* MMapManager::GetAsyncNavMeshQuery(MMapData* mmap, uint32 threadIndex, std::shared_lock<std::shared_mutex>& tileLock)
+    {
+        tileLock = std::shared_lock<std::shared_mutex>(mmap->tileLock);
+
+        std::lock_guard<std::mutex> lock(mmap->asyncNavMeshQueriesLock);
+        auto queryItr = mmap->asyncNavMeshQueries.find(threadIndex);
+        if (queryItr != mmap->asyncNavMeshQueries.end())
+            return queryItr->second;
+
+        dtNavMeshQuery* query = dtAllocNavMeshQuery();
+        ASSERT(query);
+        if (dtStatusFailed(query->init(mmap->navMesh, 1024)))
+        {
+            dtFreeNavMeshQuery(query);
+            TC_LOG_ERROR("maps", "MMAP:GetAsyncNavMeshQuery: Failed to initialize dtNavMeshQuery for thread %u", threadIndex);
+            tileLock.unlock();
+            return nullptr;
+        }
+
+        TC_LOG_DEBUG("maps", "MMAP:GetAsyncNavMeshQuery: created dtNavMeshQuery for thread %u", threadIndex);
+        mmap->asyncNavMeshQueries.insert(std::pair<uint32, dtNavMeshQuery*>(threadIndex, query));
+        return query;
+    }
 }
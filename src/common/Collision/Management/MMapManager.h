@@ -21,6 +21,10 @@
 #include "Define.h"
 #include "DetourNavMesh.h"
 #include "DetourNavMeshQuery.h"
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
 #include <string>
 #include <unordered_map>
 #include <vector>
@@ -34,12 +38,15 @@ namespace MMAP
     // dummy struct to hold map's mmap data
     struct TC_COMMON_API MMapData
     {
-        MMapData(dtNavMesh* mesh) : navMesh(mesh) { }
+        MMapData(dtNavMesh* mesh) : navMesh(mesh), references(1) { }
         ~MMapData()
         {
             for (NavMeshQuerySet::iterator i = navMeshQueries.begin(); i != navMeshQueries.end(); ++i)
                 dtFreeNavMeshQuery(i->second);
 
+            for (NavMeshQuerySet::iterator i = asyncNavMeshQueries.begin(); i != asyncNavMeshQueries.end(); ++i)
+                dtFreeNavMeshQuery(i->second);
+
             if (navMesh)
                 dtFreeNavMesh(navMesh);
         }
@@ -47,9 +54,25 @@ namespace MMAP
         // we have to use single dtNavMeshQuery for every instance, since those are not thread safe
         NavMeshQuerySet navMeshQueries;     // instanceId to query
 
+        // queries used by path finding threads, outside of map updates
+        NavMeshQuerySet asyncNavMeshQueries; // path finding thread index to query
+        std::mutex asyncNavMeshQueriesLock;
+
+        // held exclusively while tiles are added or removed, shared by path finding threads while they query
+        std::shared_mutex tileLock;
+
         dtNavMesh* navMesh;
 
         MMapTileSet loadedTileRefs;        // maps [map grid coords] to [dtTile]
+
+        // one held by the manager while the map is loaded, one by each pin (see MMapManager::PinNavMesh)
+        std::atomic<uint32> references;
+
+        static void Release(MMapData* data)
+        {
+            if (--data->references == 0)
+                delete data;
+        }
     };
 
 
@@ -74,6 +97,13 @@ namespace MMAP
             dtNavMeshQuery const* GetNavMeshQuery(uint32 mapId, uint32 instanceId);
             dtNavMesh const* GetNavMesh(uint32 mapId);
 
+            // keeps the navmesh of the map from being deleted until the returned pin is released, even if the map gets unloaded
+            // must be called from the same thread as loading and unloading, the pin can be released from any thread
+            std::shared_ptr<MMapData> PinNavMesh(uint32 mapId);
+
+            // query owned by the given path finding thread, tiles of the navmesh are not added or removed while tileLock is held
+            static dtNavMeshQuery const* GetAsyncNavMeshQuery(MMapData* mmap, uint32 threadIndex, std::shared_lock<std::shared_mutex>& tileLock);
+
             uint32 getLoadedTilesCount() const { return loadedTiles; }
             uint32 getLoadedMapsCount() const { return uint32(loadedMMaps.size()); }
         private:
@@ -23,6 +23,7 @@
 #include <G3D/Ray.h>
 #include <G3D/BoundsTrait.h>
 #include <G3D/PositionTrait.h>
+#include <algorithm>
 #include <unordered_map>
 
 template<class Node>
@@ -89,12 +90,35 @@ public:
         memberTable.erase(&value);
     }
 
-    void balance()
+    // refits the value after its bounds changed, only touches the cell trees if it moved across cells
+    void update(const T& value)
     {
-        for (int x = 0; x < CELL_NUMBER; ++x)
-            for (int y = 0; y < CELL_NUMBER; ++y)
-                if (Node* n = nodes[x][y])
-                    n->balance();
+        G3D::AABox bounds;
+        BoundsFunc::getBounds(value, bounds);
+        Cell low = Cell::ComputeCell(bounds.low().x, bounds.low().y);
+        Cell high = Cell::ComputeCell(bounds.high().x, bounds.high().y);
+
+        auto members = Trinity::Containers::MapEqualRange(memberTable, &value);
+        std::size_t memberCount = std::distance(members.begin(), members.end());
+        bool sameCells = memberCount == std::size_t((high.x - low.x + 1) * (high.y - low.y + 1));
+        for (int x = low.x; x <= high.x && sameCells; ++x)
+        {
+            for (int y = low.y; y <= high.y && sameCells; ++y)
+            {
+                Node* node = nodes[x][y];
+                sameCells = node && std::any_of(members.begin(), members.end(), [node](typename MemberTable::value_type const& p) { return p.second == node; });
+            }
+        }
+
+        if (!sameCells)
+        {
+            remove(value);
+            insert(value);
+            return;
+        }
+
+        for (auto& p : members)
+            p.second->update(value);
     }
 
     bool contains(const T& value) const { return memberTable.count(&value) > 0; }
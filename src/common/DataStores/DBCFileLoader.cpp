@@ -20,70 +20,47 @@
 #include <string.h>
 
 #include "DBCFileLoader.h"
+#include "DataFileMapping.h"
 #include "Errors.h"
 
-DBCFileLoader::DBCFileLoader() : recordSize(0), recordCount(0), fieldCount(0), stringSize(0), fieldsOffset(nullptr), data(nullptr), stringTable(nullptr) { }
-
-bool DBCFileLoader::Load(char const* filename, char const* fmt)
+namespace
 {
-    uint32 header;
-    if (data)
-    {
-        delete [] data;
-        data = nullptr;
-    }
-
-    FILE* f = fopen(filename, "rb");
-    if (!f)
-        return false;
-
-    if (fread(&header, 4, 1, f) != 1)                        // Number of records
-    {
-        fclose(f);
-        return false;
-    }
-
+    uint32 const DBCHeaderSize = 5 * sizeof(uint32);
 
-    EndianConvert(header);
-
-    if (header != 0x43424457)                                //'WDBC'
+    uint32 ReadHeaderField(unsigned char const* header, uint32 index)
     {
-        fclose(f);
-        return false;
+        uint32 value;
+        memcpy(&value, header + index * sizeof(uint32), sizeof(uint32));
+        EndianConvert(value);
+        return value;
     }
+}
 
-    if (fread(&recordCount, 4, 1, f) != 1)                   // Number of records
-    {
-        fclose(f);
-        return false;
-    }
+DBCFileLoader::DBCFileLoader() : recordSize(0), recordCount(0), fieldCount(0), stringSize(0), fieldsOffset(nullptr), data(nullptr), stringTable(nullptr) { }
 
-    EndianConvert(recordCount);
+bool DBCFileLoader::Load(char const* filename, char const* fmt)
+{
+    mapping.reset();
+    data = nullptr;
+    stringTable = nullptr;
 
-    if (fread(&fieldCount, 4, 1, f) != 1)                    // Number of fields
-    {
-        fclose(f);
+    std::shared_ptr<DataFileMapping> file = std::make_shared<DataFileMapping>(filename);
+    if (!file->IsOpen() || file->GetSize() < DBCHeaderSize)
         return false;
-    }
 
-    EndianConvert(fieldCount);
-
-    if (fread(&recordSize, 4, 1, f) != 1)                    // Size of a record
-    {
-        fclose(f);
+    unsigned char* header = file->GetData();
+    if (ReadHeaderField(header, 0) != 0x43424457)           //'WDBC'
         return false;
-    }
 
-    EndianConvert(recordSize);
+    recordCount = ReadHeaderField(header, 1);               // Number of records
+    fieldCount = ReadHeaderField(header, 2);                // Number of fields
+    recordSize = ReadHeaderField(header, 3);                // Size of a record
+    stringSize = ReadHeaderField(header, 4);                // String size
 
-    if (fread(&stringSize, 4, 1, f) != 1)                    // String size
-    {
-        fclose(f);
+    if (!fieldCount || DBCHeaderSize + std::size_t(recordSize) * recordCount + stringSize > file->GetSize())
         return false;
-    }
-
-    EndianConvert(stringSize);
 
+    delete[] fieldsOffset;
     fieldsOffset = new uint32[fieldCount];
     fieldsOffset[0] = 0;
     for (uint32 i = 1; i < fieldCount; ++i)
@@ -97,24 +74,16 @@ bool DBCFileLoader::Load(char const* filename, char const* fmt)
             fieldsOffset[i] += sizeof(uint32);
     }
 
-    data = new unsigned char[recordSize * recordCount + stringSize];
-    stringTable = data + recordSize*recordCount;
-
-    if (fread(data, recordSize * recordCount + stringSize, 1, f) != 1)
-    {
-        fclose(f);
-        return false;
-    }
-
-    fclose(f);
+    // records and strings are read from the mapped file, nothing is copied here
+    mapping = std::move(file);
+    data = header + DBCHeaderSize;
+    stringTable = data + recordSize * recordCount;
 
     return true;
 }
 
 DBCFileLoader::~DBCFileLoader()
 {
-    delete[] data;
-
     delete[] fieldsOffset;
 }
 
@@ -169,6 +138,42 @@ uint32 DBCFileLoader::GetFormatRecordSize(char const* format, int32* index_pos)
     return recordsize;
 }
 
+bool DBCFileLoader::CanUseRecordsInPlace(char const* format) const
+{
+#if TRINITY_ENDIAN == TRINITY_BIGENDIAN
+    (void)format;
+    return false;
+#else
+    if (strlen(format) != fieldCount || GetFormatRecordSize(format) != recordSize)
+        return false;
+
+    // strings are pointers in memory, skipped and sort fields are not there
+    std::size_t alignment = alignof(uint32);
+    for (uint32 x = 0; format[x]; ++x)
+    {
+        switch (format[x])
+        {
+            case FT_LONG:
+                alignment = alignof(uint64);
+                break;
+            case FT_FLOAT:
+            case FT_INT:
+            case FT_IND:
+            case FT_BYTE:
+                break;
+            default:
+                return false;
+        }
+    }
+
+    // every record is read through the entry struct, so each one must start suitably aligned
+    if (reinterpret_cast<uintptr_t>(data) % alignment != 0 || recordSize % alignment != 0)
+        return false;
+
+    return true;
+#endif
+}
+
 char* DBCFileLoader::AutoProduceData(char const* format, uint32& records, char**& indexTable)
 {
     /*
@@ -212,6 +217,20 @@ char* DBCFileLoader::AutoProduceData(char const* format, uint32& records, char**
         indexTable = new ptr[recordCount];
     }
 
+    if (CanUseRecordsInPlace(format))
+    {
+        for (uint32 y = 0; y < recordCount; ++y)
+        {
+            char* record = reinterpret_cast<char*>(data + y * recordSize);
+            if (i >= 0)
+                indexTable[getRecord(y).getUInt(i)] = record;
+            else
+                indexTable[y] = record;
+        }
+
+        return nullptr;
+    }
+
     char* dataTable = new char[recordCount * recordsize];
 
     uint32 offset = 0;
@@ -262,13 +281,10 @@ char* DBCFileLoader::AutoProduceData(char const* format, uint32& records, char**
     return dataTable;
 }
 
-char* DBCFileLoader::AutoProduceStrings(char const* format, char* dataTable)
+void DBCFileLoader::AutoProduceStrings(char const* format, char* dataTable)
 {
-    if (strlen(format) != fieldCount)
-        return nullptr;
-
-    char* stringPool = new char[stringSize];
-    memcpy(stringPool, stringTable, stringSize);
+    if (strlen(format) != fieldCount || !strchr(format, FT_STRING))
+        return;
 
     uint32 offset = 0;
 
@@ -296,10 +312,7 @@ char* DBCFileLoader::AutoProduceStrings(char const* format, char* dataTable)
                     // fill only not filled entries
                     char** slot = (char**)(&dataTable[offset]);
                     if (!*slot || !**slot)
-                    {
-                        const char * st = getRecord(y).getString(x);
-                        *slot = stringPool + (st - (char const*)stringTable);
-                    }
+                        *slot = const_cast<char*>(getRecord(y).getString(x));
                     offset += sizeof(char*);
                     break;
                  }
@@ -313,6 +326,4 @@ char* DBCFileLoader::AutoProduceStrings(char const* format, char* dataTable)
             }
         }
     }
-
-    return stringPool;
 }
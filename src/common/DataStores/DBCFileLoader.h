@@ -21,6 +21,9 @@
 #include "Define.h"
 #include "Errors.h"
 #include "Utilities/ByteConverter.h"
+#include <memory>
+
+class DataFileMapping;
 
 class TC_COMMON_API DBCFileLoader
 {
@@ -91,8 +94,13 @@ class TC_COMMON_API DBCFileLoader
         uint32 GetCols() const { return fieldCount; }
         uint32 GetOffset(size_t id) const { return (fieldsOffset != nullptr && id < fieldCount) ? fieldsOffset[id] : 0; }
         bool IsLoaded() const { return data != nullptr; }
+        // records used in place and strings point into the mapped file, it has to be kept while they are used
+        std::shared_ptr<DataFileMapping> GetMapping() const { return mapping; }
+        // true when the file records have the layout of fmt in memory
+        bool CanUseRecordsInPlace(char const* fmt) const;
+        // returns the converted records, nullptr when the records are used in place
         char* AutoProduceData(char const* fmt, uint32& count, char**& indexTable);
-        char* AutoProduceStrings(char const* fmt, char* dataTable);
+        void AutoProduceStrings(char const* fmt, char* dataTable);
         static uint32 GetFormatRecordSize(char const* format, int32* index_pos = nullptr);
 
     private:
@@ -101,6 +109,7 @@ class TC_COMMON_API DBCFileLoader
         uint32 fieldCount;
         uint32 stringSize;
         uint32 *fieldsOffset;
+        std::shared_ptr<DataFileMapping> mapping;
         unsigned char *data;
         unsigned char *stringTable;
 
@@ -0,0 +1,48 @@
+/*
+ * This file is part of the TrinityCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "DataFileMapping.h"
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+
+struct DataFileMapping::Region
+{
+    boost::interprocess::file_mapping File;
+    boost::interprocess::mapped_region View;
+};
+
+DataFileMapping::DataFileMapping(char const* filename) : _data(nullptr), _size(0)
+{
+    try
+    {
+        std::unique_ptr<Region> region = std::make_unique<Region>();
+        region->File = boost::interprocess::file_mapping(filename, boost::interprocess::read_only);
+        region->View = boost::interprocess::mapped_region(region->File, boost::interprocess::copy_on_write);
+
+        _data = static_cast<unsigned char*>(region->View.get_address());
+        _size = region->View.get_size();
+        _region = std::move(region);
+    }
+    catch (boost::interprocess::interprocess_exception const&)
+    {
+        // missing, unreadable or empty file
+        _data = nullptr;
+        _size = 0;
+    }
+}
+
+DataFileMapping::~DataFileMapping() = default;
@@ -0,0 +1,48 @@
+/*
+ * This file is part of the TrinityCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef DATA_FILE_MAPPING_H
+#define DATA_FILE_MAPPING_H
+
+#include "Define.h"
+#include <cstddef>
+#include <memory>
+
+// A client data file mapped copy-on-write. The pages are shared with the page cache and other processes
+// mapping the same file until they are written to, writes stay private to the process.
+class TC_COMMON_API DataFileMapping
+{
+    public:
+        explicit DataFileMapping(char const* filename);
+        ~DataFileMapping();
+
+        bool IsOpen() const { return _data != nullptr; }
+        unsigned char* GetData() const { return _data; }
+        std::size_t GetSize() const { return _size; }
+
+    private:
+        struct Region;
+
+        std::unique_ptr<Region> _region;
+        unsigned char* _data;
+        std::size_t _size;
+
+        DataFileMapping(DataFileMapping const& right) = delete;
+        DataFileMapping& operator=(DataFileMapping const& right) = delete;
+};
+
+#endif
@@ -0,0 +1,75 @@
+/*
+ * This file is part of the TrinityCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "CaseInsensitiveName.h"
+#include "Util.h"
+#include <utf8.h>
+
+namespace
+{
+    // lowercased code point at itr, advances itr past it
+    uint32 NextFoldedChar(std::string::const_iterator& itr, std::string::const_iterator end)
+    {
+        std::string::const_iterator start = itr;
+        uint32 codePoint;
+        if (utf8::internal::validate_next(itr, end, codePoint) != utf8::internal::UTF8_OK)
+        {
+            itr = start + 1;
+            codePoint = uint8(*start);
+        }
+
+        // wcharToLower only folds characters of the basic multilingual plane
+        return codePoint <= 0xFFFF ? uint32(wcharToLower(wchar_t(codePoint))) : codePoint;
+    }
+
+    // compares until either string ends, iterators are left where comparison stopped
+    bool CompareFolded(std::string::const_iterator& leftItr, std::string::const_iterator leftEnd, std::string::const_iterator& rightItr, std::string::const_iterator rightEnd)
+    {
+        while (leftItr != leftEnd && rightItr != rightEnd)
+            if (NextFoldedChar(leftItr, leftEnd) != NextFoldedChar(rightItr, rightEnd))
+                return false;
+
+        return true;
+    }
+}
+
+std::size_t Trinity::CaseInsensitiveNameHash::operator()(std::string const& name) const
+{
+    // FNV-1a over folded code points
+    uint64 hash = UI64LIT(14695981039346656037);
+    for (std::string::const_iterator itr = name.begin(); itr != name.end();)
+    {
+        hash ^= NextFoldedChar(itr, name.end());
+        hash *= UI64LIT(1099511628211);
+    }
+
+    return std::size_t(hash);
+}
+
+bool Trinity::CaseInsensitiveNameEqualTo::operator()(std::string const& left, std::string const& right) const
+{
+    std::string::const_iterator leftItr = left.begin();
+    std::string::const_iterator rightItr = right.begin();
+    return CompareFolded(leftItr, left.end(), rightItr, right.end()) && leftItr == left.end() && rightItr == right.end();
+}
+
+bool Trinity::CaseInsensitiveNameStartsWith(std::string const& name, std::string const& prefix)
+{
+    std::string::const_iterator nameItr = name.begin();
+    std::string::const_iterator prefixItr = prefix.begin();
+    return CompareFolded(nameItr, name.end(), prefixItr, prefix.end()) && prefixItr == prefix.end();
+}
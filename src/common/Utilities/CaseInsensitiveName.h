@@ -0,0 +1,48 @@
+/*
+ * This file is part of the TrinityCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TrinityCore_CaseInsensitiveName_h__
+#define TrinityCore_CaseInsensitiveName_h__
+
+#include "Define.h"
+#include <string>
+#include <unordered_map>
+
+namespace Trinity
+{
+    // Hash and equality of utf8 names ignoring case the same way wstrToLower does,
+    // computed on the fly without converting or copying either string.
+    // Invalid utf8 sequences are compared byte by byte.
+    struct TC_COMMON_API CaseInsensitiveNameHash
+    {
+        std::size_t operator()(std::string const& name) const;
+    };
+
+    struct TC_COMMON_API CaseInsensitiveNameEqualTo
+    {
+        bool operator()(std::string const& left, std::string const& right) const;
+    };
+
+    // true if name begins with prefix, ignoring case
+    TC_COMMON_API bool CaseInsensitiveNameStartsWith(std::string const& name, std::string const& prefix);
+
+    // name -> value, lookups match names differing only in case
+    template<class T>
+    using CaseInsensitiveNameMap = std::unordered_map<std::string, T, CaseInsensitiveNameHash, CaseInsensitiveNameEqualTo>;
+}
+
+#endif // TrinityCore_CaseInsensitiveName_h__
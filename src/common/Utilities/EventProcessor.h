@@ -110,6 +110,7 @@ class TC_COMMON_API EventProcessor
         void ModifyEventTime(BasicEvent* event, uint64 newTime);
         uint64 CalculateTime(uint64 t_offset) const { return m_time + t_offset; }
         std::multimap<uint64, BasicEvent*>& GetEvents() { return m_events; }
+        bool HasEvents() const { return !m_events.empty(); }
 
     protected:
         uint64 m_time;
@@ -126,7 +126,8 @@ enum CharacterDatabaseStatements : uint32
     CHAR_DEL_MAIL_ITEM,
     CHAR_DEL_INVALID_MAIL_ITEM,
     CHAR_DEL_EMPTY_EXPIRED_MAIL,
-    CHAR_SEL_EXPIRED_MAIL,
+    CHAR_SEL_MAIL_EXPIRATIONS,
+    CHAR_SEL_EXPIRED_MAILS,
     CHAR_SEL_EXPIRED_MAIL_ITEMS,
     CHAR_UPD_MAIL_RETURNED,
     CHAR_UPD_MAIL_ITEM_RECEIVER,
@@ -98,6 +98,10 @@ class TC_GAME_API CreatureAI : public UnitAI
 
         bool IsEngaged() const { return _isEngaged; }
 
+        // set for AIs that do nothing in UpdateAI while their creature is idle, see CreatureAIFactory
+        bool CanSkipIdleUpdates() const { return _canSkipIdleUpdates; }
+        void SetCanSkipIdleUpdates(bool apply) { _canSkipIdleUpdates = apply; }
+
         void Talk(uint8 id, WorldObject const* whisperTarget = nullptr);
 
         /// == Reactions At =================================
@@ -256,6 +260,7 @@ class TC_GAME_API CreatureAI : public UnitAI
     private:
         bool _isEngaged;
         bool _moveInLOSLocked;
+        bool _canSkipIdleUpdates;
         void _OnOwnerCombatInteraction(Unit* target);
 };
 
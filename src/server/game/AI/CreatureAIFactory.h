@@ -20,10 +20,16 @@
 
 #include "ObjectRegistry.h"
 #include "SelectableAI.h"
+#include <type_traits>
 
 class Creature;
 class CreatureAI;
 
+// AIs doing nothing in UpdateAI while their creature is idle, specialized where the AIs are registered.
+// Only the exact type counts, script AIs derived from them may do anything.
+template <class REAL_AI>
+struct SkipsIdleUpdates : std::false_type { };
+
 template <class REAL_AI, bool is_db_allowed = true>
 struct CreatureAIFactory : public SelectableAI<Creature, CreatureAI, is_db_allowed>
 {
@@ -31,7 +37,9 @@ struct CreatureAIFactory : public SelectableAI<Creature, CreatureAI, is_db_allow
 
     inline CreatureAI* Create(Creature* c) const override
     {
-        return new REAL_AI(c);
+        REAL_AI* ai = new REAL_AI(c);
+        ai->SetCanSkipIdleUpdates(SkipsIdleUpdates<REAL_AI>::value);
+        return ai;
     }
 
     int32 Permit(Creature const* c) const override
@@ -32,6 +32,17 @@
 #include "RandomMovementGenerator.h"
 #include "WaypointMovementGenerator.h"
 
+template<> struct SkipsIdleUpdates<NullCreatureAI> : std::true_type { };
+template<> struct SkipsIdleUpdates<TriggerAI> : std::true_type { };
+template<> struct SkipsIdleUpdates<AggressorAI> : std::true_type { };
+template<> struct SkipsIdleUpdates<ReactorAI> : std::true_type { };
+template<> struct SkipsIdleUpdates<PassiveAI> : std::true_type { };
+template<> struct SkipsIdleUpdates<CritterAI> : std::true_type { };
+template<> struct SkipsIdleUpdates<GuardAI> : std::true_type { };
+template<> struct SkipsIdleUpdates<CombatAI> : std::true_type { };
+template<> struct SkipsIdleUpdates<ArcherAI> : std::true_type { };
+template<> struct SkipsIdleUpdates<TurretAI> : std::true_type { };
+
 namespace AIRegistry
 {
     void Initialize()
@@ -44,6 +44,7 @@
 #include "SpellMgr.h"
 #include "World.h"
 #include "WorldSession.h"
+#include <algorithm>
 
 bool AchievementCriteriaData::IsValid(AchievementCriteriaEntry const* criteria)
 {
@@ -395,6 +396,36 @@ bool AchievementCriteriaData::Meets(uint32 criteria_id, Player const* source, Un
     return false;
 }
 
+namespace
+{
+    uint32 GetCriteriaDataCost(AchievementCriteriaDataType dataType)
+    {
+        switch (dataType)
+        {
+            case ACHIEVEMENT_CRITERIA_DATA_TYPE_S_AURA:
+            case ACHIEVEMENT_CRITERIA_DATA_TYPE_T_AURA:
+            case ACHIEVEMENT_CRITERIA_DATA_TYPE_MAP_PLAYER_COUNT:
+            case ACHIEVEMENT_CRITERIA_DATA_TYPE_BG_LOSS_TEAM_SCORE:
+            case ACHIEVEMENT_CRITERIA_DATA_TYPE_S_EQUIPPED_ITEM:
+            case ACHIEVEMENT_CRITERIA_DATA_TYPE_S_KNOWN_TITLE:
+                return 1;
+            case ACHIEVEMENT_CRITERIA_DATA_TYPE_SCRIPT:
+            case ACHIEVEMENT_CRITERIA_DATA_TYPE_INSTANCE_SCRIPT:
+                return 2;
+            default:
+                return 0;
+        }
+    }
+}
+
+void AchievementCriteriaDataSet::SortByCost()
+{
+    std::stable_sort(storage.begin(), storage.end(), [](AchievementCriteriaData const& left, AchievementCriteriaData const& right)
+    {
+        return GetCriteriaDataCost(left.dataType) < GetCriteriaDataCost(right.dataType);
+    });
+}
+
 bool AchievementCriteriaDataSet::Meets(Player const* source, Unit const* target, uint32 miscValue1 /*= 0*/, uint32 miscValue2 /*= 0*/) const
 {
     for (Storage::const_iterator itr = storage.begin(); itr != storage.end(); ++itr)
@@ -1154,7 +1185,31 @@ void AchievementMgr<T>::UpdateAchievementCriteria(AchievementCriteriaTypes type,
     if (IsGuild<T>() && !sWorld->getBoolConfig(CONFIG_GUILD_LEVELING_ENABLED))
         return;
 
-    AchievementCriteriaEntryList const& achievementCriteriaList = sAchievementMgr->GetAchievementCriteriaByType(type, miscValue1, IsGuild<T>());
+    AchievementCriteriaEntryList const& achievementCriteriaList = sAchievementMgr->GetAchievementCriteriaByType(type, miscValue1, miscValue3, referencePlayer, IsGuild<T>());
+    UpdateCriteriaList(type, achievementCriteriaList, miscValue1, miscValue2, miscValue3, unit, referencePlayer, go, true);
+}
+
+template<class T>
+void AchievementMgr<T>::FindCriteriaToUpdate(AchievementCriteriaTypes type, uint64 miscValue1, uint64 miscValue2, uint64 miscValue3, Unit const* unit, Player* referencePlayer, GameObject* go, AchievementCriteriaEntryList& criteria) const
+{
+    if (type >= ACHIEVEMENT_CRITERIA_TYPE_TOTAL || !referencePlayer || referencePlayer->IsGameMaster())
+        return;
+
+    for (AchievementCriteriaEntry const* achievementCriteria : sAchievementMgr->GetAchievementCriteriaByType(type, miscValue1, miscValue3, referencePlayer, IsGuild<T>()))
+        if (AchievementEntry const* achievement = sAchievementMgr->GetAchievement(achievementCriteria->ReferredAchievement))
+            if (MeetsCriteriaRequirements(achievementCriteria, achievement, miscValue1, miscValue2, miscValue3, unit, referencePlayer, go))
+                criteria.push_back(achievementCriteria);
+}
+
+template<class T>
+void AchievementMgr<T>::UpdateCriteriaProgress(AchievementCriteriaTypes type, AchievementCriteriaEntryList const& criteria, uint64 miscValue1, uint64 miscValue2, uint64 miscValue3, Player* referencePlayer)
+{
+    UpdateCriteriaList(type, criteria, miscValue1, miscValue2, miscValue3, nullptr, referencePlayer, nullptr, false);
+}
+
+template<class T>
+void AchievementMgr<T>::UpdateCriteriaList(AchievementCriteriaTypes type, AchievementCriteriaEntryList const& achievementCriteriaList, uint64 miscValue1, uint64 miscValue2, uint64 miscValue3, Unit const* unit, Player* referencePlayer, GameObject* go, bool checkRequirements)
+{
     for (AchievementCriteriaEntryList::const_iterator i = achievementCriteriaList.begin(); i != achievementCriteriaList.end(); ++i)
     {
         AchievementCriteriaEntry const* achievementCriteria = (*i);
@@ -1165,23 +1220,11 @@ void AchievementMgr<T>::UpdateAchievementCriteria(AchievementCriteriaTypes type,
             continue;
         }
 
-        if (!CanUpdateCriteria(achievementCriteria, achievement, miscValue1, miscValue2, miscValue3, unit, referencePlayer, go))
+        // requirements of criteria found by FindCriteriaToUpdate were checked when the update happened
+        if (checkRequirements ? !CanUpdateCriteria(achievementCriteria, achievement, miscValue1, miscValue2, miscValue3, unit, referencePlayer, go)
+            : IsCompletedCriteria(achievementCriteria, achievement))
             continue;
 
-        switch (type)
-        {
-            // special cases, db data is checked later
-            case ACHIEVEMENT_CRITERIA_TYPE_WIN_RATED_ARENA:
-            case ACHIEVEMENT_CRITERIA_TYPE_ROLL_NEED_ON_LOOT:
-            case ACHIEVEMENT_CRITERIA_TYPE_ROLL_GREED_ON_LOOT:
-                break;
-            default:
-                if (AchievementCriteriaDataSet const* data = sAchievementMgr->GetCriteriaDataSet(achievementCriteria))
-                    if (!data->Meets(referencePlayer, unit, miscValue1, miscValue2))
-                        continue;
-                break;
-        }
-
         switch (type)
         {
             // std. case: increment at 1
@@ -2331,6 +2374,19 @@ CompletedAchievementData* AchievementMgr<T>::GetCompletedDataForAchievement(uint
 
 template<class T>
 bool AchievementMgr<T>::CanUpdateCriteria(AchievementCriteriaEntry const* criteria, AchievementEntry const* achievement, uint64 miscValue1, uint64 miscValue2, uint64 miscValue3, Unit const* unit, Player* referencePlayer, GameObject* go)
+{
+    if (IsCompletedCriteria(criteria, achievement))
+    {
+        TC_LOG_TRACE("achievement", "CanUpdateCriteria: %s (Id: %u Type %s) Is Completed",
+            criteria->Description, criteria->ID, AchievementGlobalMgr::GetCriteriaTypeString(criteria->Type));
+        return false;
+    }
+
+    return MeetsCriteriaRequirements(criteria, achievement, miscValue1, miscValue2, miscValue3, unit, referencePlayer, go);
+}
+
+template<class T>
+bool AchievementMgr<T>::MeetsCriteriaRequirements(AchievementCriteriaEntry const* criteria, AchievementEntry const* achievement, uint64 miscValue1, uint64 miscValue2, uint64 miscValue3, Unit const* unit, Player* referencePlayer, GameObject* go) const
 {
     if (DisableMgr::IsDisabledFor(DISABLE_TYPE_ACHIEVEMENT_CRITERIA, criteria->ID, nullptr))
     {
@@ -2354,13 +2410,6 @@ bool AchievementMgr<T>::CanUpdateCriteria(AchievementCriteriaEntry const* criter
         return false;
     }
 
-    if (IsCompletedCriteria(criteria, achievement))
-    {
-        TC_LOG_TRACE("achievement", "CanUpdateCriteria: %s (Id: %u Type %s) Is Completed",
-            criteria->Description, criteria->ID, AchievementGlobalMgr::GetCriteriaTypeString(criteria->Type));
-        return false;
-    }
-
     if (!RequirementsSatisfied(criteria, miscValue1, miscValue2, miscValue3, unit, referencePlayer, go))
     {
         TC_LOG_TRACE("achievement", "CanUpdateCriteria: %s (Id: %u Type %s) Requirements not satisfied",
@@ -2382,6 +2431,20 @@ bool AchievementMgr<T>::CanUpdateCriteria(AchievementCriteriaEntry const* criter
         return false;
     }
 
+    switch (AchievementCriteriaTypes(criteria->Type))
+    {
+        // special cases, db data is checked later
+        case ACHIEVEMENT_CRITERIA_TYPE_WIN_RATED_ARENA:
+        case ACHIEVEMENT_CRITERIA_TYPE_ROLL_NEED_ON_LOOT:
+        case ACHIEVEMENT_CRITERIA_TYPE_ROLL_GREED_ON_LOOT:
+            break;
+        default:
+            if (AchievementCriteriaDataSet const* data = sAchievementMgr->GetCriteriaDataSet(criteria))
+                if (!data->Meets(referencePlayer, unit, miscValue1, miscValue2))
+                    return false;
+            break;
+    }
+
     return true;
 }
 
@@ -3278,30 +3341,38 @@ inline bool IsAchievementCriteriaTypeStoredByMiscValue(AchievementCriteriaTypes
     return false;
 }
 
-AchievementCriteriaEntryList const& AchievementGlobalMgr::GetAchievementCriteriaByType(AchievementCriteriaTypes type, uint32 miscValue, bool guild) const
+// value of an update matching the asset the criteria of the type are stored by, 0 when it can match any asset
+inline uint32 GetAchievementCriteriaMiscValue(AchievementCriteriaTypes type, uint64 miscValue1, uint64 miscValue3, Player const* referencePlayer)
 {
-    if (guild)
+    switch (type)
     {
-        if (miscValue && IsAchievementCriteriaTypeStoredByMiscValue(type))
-        {
-            auto itr = m_GuildAchievementCriteriasByMiscValue[type].find(miscValue);
-            if (itr != m_GuildAchievementCriteriasByMiscValue[type].end())
-                return itr->second;
-        }
-
-        return m_GuildAchievementCriteriasByType[type];
+        // checked against the map of the player, miscValue1 is only a counter
+        case ACHIEVEMENT_CRITERIA_TYPE_WIN_BG:
+        case ACHIEVEMENT_CRITERIA_TYPE_COMPLETE_BATTLEGROUND:
+            return miscValue1 ? referencePlayer->GetMapId() : 0;
+        case ACHIEVEMENT_CRITERIA_TYPE_LOOT_TYPE:
+            return uint32(miscValue3);
+        default:
+            return uint32(miscValue1);
     }
-    else
+}
+
+AchievementCriteriaEntryList const& AchievementGlobalMgr::GetAchievementCriteriaByType(AchievementCriteriaTypes type, uint64 miscValue1, uint64 miscValue3, Player const* referencePlayer, bool guild) const
+{
+    static AchievementCriteriaEntryList const EmptyList;
+
+    if (IsAchievementCriteriaTypeStoredByMiscValue(type))
     {
-        if (miscValue && IsAchievementCriteriaTypeStoredByMiscValue(type))
+        // updates with a value only match criteria with that asset
+        if (uint32 miscValue = GetAchievementCriteriaMiscValue(type, miscValue1, miscValue3, referencePlayer))
         {
-            auto itr = m_AchievementCriteriasByMiscValue[type].find(miscValue);
-            if (itr != m_AchievementCriteriasByMiscValue[type].end())
-                return itr->second;
+            AchievementCriteriaListByMiscValue const& criteriasByMiscValue = guild ? m_GuildAchievementCriteriasByMiscValue[type] : m_AchievementCriteriasByMiscValue[type];
+            auto itr = criteriasByMiscValue.find(miscValue);
+            return itr != criteriasByMiscValue.end() ? itr->second : EmptyList;
         }
-
-        return m_AchievementCriteriasByType[type];
     }
+
+    return guild ? m_GuildAchievementCriteriasByType[type] : m_AchievementCriteriasByType[type];
 }
 
 bool AchievementGlobalMgr::IsRealmCompleted(AchievementEntry const* achievement) const
@@ -3375,10 +3446,7 @@ void AchievementGlobalMgr::LoadAchievementCriteriaList()
             else
             {
                 WorldMapOverlayEntry const* worldOverlayEntry = sWorldMapOverlayStore.LookupEntry(criteria->Asset.WorldMapOverlayID);
-                if (!worldOverlayEntry)
-                    break;
-
-                for (uint8 j = 0; j < MAX_WORLD_MAP_OVERLAY_AREA_IDX; ++j)
+                for (uint8 j = 0; worldOverlayEntry && j < MAX_WORLD_MAP_OVERLAY_AREA_IDX; ++j)
                 {
                     if (worldOverlayEntry->AreaID[j])
                     {
@@ -3510,6 +3578,9 @@ void AchievementGlobalMgr::LoadAchievementCriteriaData()
     }
     while (result->NextRow());
 
+    for (auto& dataSet : m_criteriaDataMap)
+        dataSet.second.SortByCost();
+
     TC_LOG_INFO("server.loading", ">> Loaded %u additional achievement criteria data in %u ms", count, GetMSTimeDiffToNow(oldMSTime));
 }
 
@@ -209,6 +209,8 @@ struct TC_GAME_API AchievementCriteriaDataSet
         AchievementCriteriaDataSet() : criteria_id(0) { }
         typedef std::vector<AchievementCriteriaData> Storage;
         void Add(AchievementCriteriaData const& data) { storage.push_back(data); }
+        // orders the data by cost, sets failing a cheap check are rejected before auras and scripts are looked at
+        void SortByCost();
         bool Meets(Player const* source, Unit const* target, uint32 miscValue1 = 0, uint32 miscValue2 = 0) const;
         void SetCriteriaId(uint32 id) {criteria_id = id;}
     private:
@@ -268,6 +270,10 @@ class TC_GAME_API AchievementMgr
         void SaveToDB(CharacterDatabaseTransaction& trans);
         void ResetAchievementCriteria(AchievementCriteriaCondition condition, uint64 value, bool evenIfCriteriaComplete);
         void UpdateAchievementCriteria(AchievementCriteriaTypes type, uint64 miscValue1 = 0, uint64 miscValue2 = 0, uint64 miscValue3 = 0, Unit const* unit = nullptr, Player* referencePlayer = nullptr, GameObject* go = nullptr);
+        // UpdateAchievementCriteria split for updates applied later than they happen (see Guild::UpdateAchievementCriteria)
+        // FindCriteriaToUpdate checks the unit, gameobject and player right away, UpdateCriteriaProgress only the progress of the criteria found
+        void FindCriteriaToUpdate(AchievementCriteriaTypes type, uint64 miscValue1, uint64 miscValue2, uint64 miscValue3, Unit const* unit, Player* referencePlayer, GameObject* go, AchievementCriteriaEntryList& criteria) const;
+        void UpdateCriteriaProgress(AchievementCriteriaTypes type, AchievementCriteriaEntryList const& criteria, uint64 miscValue1, uint64 miscValue2, uint64 miscValue3, Player* referencePlayer);
         void CompletedAchievement(AchievementEntry const* entry, Player* referencePlayer);
         void CheckAllAchievementCriteria(Player* referencePlayer);
         void SendAllAchievementData(Player* receiver) const;
@@ -292,6 +298,8 @@ class TC_GAME_API AchievementMgr
         bool IsCompletedCriteria(AchievementCriteriaEntry const* achievementCriteria, AchievementEntry const* achievement);
         bool IsCompletedAchievement(AchievementEntry const* entry);
         bool CanUpdateCriteria(AchievementCriteriaEntry const* criteria, AchievementEntry const* achievement, uint64 miscValue1, uint64 miscValue2, uint64 miscValue3, Unit const* unit, Player* referencePlayer, GameObject* go = nullptr);
+        bool MeetsCriteriaRequirements(AchievementCriteriaEntry const* criteria, AchievementEntry const* achievement, uint64 miscValue1, uint64 miscValue2, uint64 miscValue3, Unit const* unit, Player* referencePlayer, GameObject* go) const;
+        void UpdateCriteriaList(AchievementCriteriaTypes type, AchievementCriteriaEntryList const& achievementCriteriaList, uint64 miscValue1, uint64 miscValue2, uint64 miscValue3, Unit const* unit, Player* referencePlayer, GameObject* go, bool checkRequirements);
         void SendPacket(WorldPacket const* data) const;
 
         bool ConditionsSatisfied(AchievementCriteriaEntry const* criteria, Player* referencePlayer) const;
@@ -317,7 +325,8 @@ class TC_GAME_API AchievementGlobalMgr
 
         static AchievementGlobalMgr* instance();
 
-        AchievementCriteriaEntryList const& GetAchievementCriteriaByType(AchievementCriteriaTypes type, uint32 miscValue, bool guild = false) const;
+        // criteria of the type that can be updated by an update with those values
+        AchievementCriteriaEntryList const& GetAchievementCriteriaByType(AchievementCriteriaTypes type, uint64 miscValue1, uint64 miscValue3, Player const* referencePlayer, bool guild = false) const;
 
         AchievementCriteriaEntryList const& GetTimedAchievementCriteriaByType(AchievementCriteriaTimedTypes type) const
         {
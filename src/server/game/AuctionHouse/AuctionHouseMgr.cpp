@@ -548,7 +548,7 @@ void AuctionHouseMgr::UpdatePendingAuctions()
             {
                 AuctionEntry* AH = (*AHitr);
                 ++AHitr;
-                AH->expire_time = GameTime::GetGameTime();
+                GetAuctionsMapByHouseId(AH->GetHouseId())->SetExpireTime(AH, GameTime::GetGameTime());
                 AH->DeleteFromDB(trans);
                 AH->SaveToDB(trans);
             }
@@ -599,12 +599,15 @@ void AuctionHouseObject::AddAuction(AuctionEntry* auction)
     ASSERT(auction);
 
     AuctionsMap[auction->Id] = auction;
+    SearchIndex.Insert(auction);
+    ExpirationQueue.emplace(auction->expire_time, auction->Id);
     sScriptMgr->OnAuctionAdd(this, auction);
 }
 
 bool AuctionHouseObject::RemoveAuction(AuctionEntry* auction)
 {
     bool wasInMap = AuctionsMap.erase(auction->Id) ? true : false;
+    SearchIndex.Remove(auction);
 
     sScriptMgr->OnAuctionRemove(this, auction);
 
@@ -613,6 +616,43 @@ bool AuctionHouseObject::RemoveAuction(AuctionEntry* auction)
     return wasInMap;
 }
 
+bool AuctionHouseObject::AddBidder(AuctionEntry* auction, ObjectGuid bidder)
+{
+    if (!auction->bidders.insert(bidder).second)
+        return false;
+
+    SearchIndex.AddBidder(auction, bidder);
+    return true;
+}
+
+void AuctionHouseObject::SetExpireTime(AuctionEntry* auction, time_t expireTime)
+{
+    auction->expire_time = expireTime;
+    ExpirationQueue.emplace(expireTime, auction->Id);
+}
+
+AuctionEntry* AuctionHouseObject::PopExpiredAuction(time_t time)
+{
+    while (!ExpirationQueue.empty() && ExpirationQueue.top().first <= time)
+    {
+        AuctionExpiration expiration = ExpirationQueue.top();
+        ExpirationQueue.pop();
+
+        // already removed (won, cancelled or queued twice)
+        AuctionEntry* auction = GetAuction(expiration.second);
+        if (!auction)
+            continue;
+
+        // expire time was changed, SetExpireTime queued the new one
+        if (auction->expire_time != expiration.first)
+            continue;
+
+        return auction;
+    }
+
+    return nullptr;
+}
+
 void AuctionHouseObject::Update()
 {
     time_t curTime = GameTime::GetGameTime();
@@ -631,19 +671,14 @@ void AuctionHouseObject::Update()
             ++itr;
     }
 
+    ///- filter auctions expired on next update
+    if (ExpirationQueue.empty() || ExpirationQueue.top().first > curTime + 60)
+        return;
+
     CharacterDatabaseTransaction trans = CharacterDatabase.BeginTransaction();
 
-    for (AuctionEntryMap::iterator it = AuctionsMap.begin(); it != AuctionsMap.end();)
+    while (AuctionEntry* auction = PopExpiredAuction(curTime + 60))
     {
-        // from auctionhousehandler.cpp, creates auction pointer & player pointer
-        AuctionEntry* auction = it->second;
-        // Increment iterator due to AuctionEntry deletion
-        ++it;
-
-        ///- filter auctions expired on next update
-        if (auction->expire_time > curTime + 60)
-            continue;
-
         ///- Either cancel the auction if there was no bidder
         if (auction->bidder == 0 && auction->bid == 0)
         {
@@ -674,12 +709,15 @@ void AuctionHouseObject::Update()
 
 void AuctionHouseObject::BuildListBidderItems(WorldPacket& data, Player* player, uint32& count, uint32& totalcount)
 {
-    for (AuctionEntryMap::const_iterator itr = AuctionsMap.begin(); itr != AuctionsMap.end(); ++itr)
+    AuctionHouseSearchIndex::AuctionIdSet const* auctions = SearchIndex.GetBidderAuctions(player->GetGUID());
+    if (!auctions)
+        return;
+
+    for (uint32 auctionId : *auctions)
     {
-        AuctionEntry* Aentry = itr->second;
-        if (Aentry && Aentry->bidders.find(player->GetGUID()) != Aentry->bidders.end())
+        if (AuctionEntry* Aentry = GetAuction(auctionId))
         {
-            if (itr->second->BuildAuctionInfo(data))
+            if (Aentry->BuildAuctionInfo(data))
                 ++count;
 
             ++totalcount;
@@ -689,10 +727,13 @@ void AuctionHouseObject::BuildListBidderItems(WorldPacket& data, Player* player,
 
 void AuctionHouseObject::BuildListOwnerItems(WorldPacket& data, Player* player, uint32& count, uint32& totalcount)
 {
-    for (AuctionEntryMap::const_iterator itr = AuctionsMap.begin(); itr != AuctionsMap.end(); ++itr)
+    AuctionHouseSearchIndex::AuctionIdSet const* auctions = SearchIndex.GetOwnerAuctions(player->GetGUID().GetCounter());
+    if (!auctions)
+        return;
+
+    for (uint32 auctionId : *auctions)
     {
-        AuctionEntry* Aentry = itr->second;
-        if (Aentry && Aentry->owner == player->GetGUID().GetCounter())
+        if (AuctionEntry* Aentry = GetAuction(auctionId))
         {
             if (Aentry->BuildAuctionInfo(data))
                 ++count;
@@ -736,36 +777,35 @@ void AuctionHouseObject::BuildListAuctionItems(WorldPacket& data, Player* player
         return;
     }
 
-    for (AuctionEntryMap::const_iterator itr = AuctionsMap.begin(); itr != AuctionsMap.end(); ++itr)
+    auto checkAuction = [&](AuctionEntry* Aentry)
     {
-        AuctionEntry* Aentry = itr->second;
         // Skip expired auctions
         if (Aentry->expire_time < curTime)
-            continue;
+            return;
 
         Item* item = sAuctionMgr->GetAItem(Aentry->itemGUIDLow);
         if (!item)
-            continue;
+            return;
 
         ItemTemplate const* proto = item->GetTemplate();
 
         if (itemClass != 0xffffffff && proto->GetClass() != itemClass)
-            continue;
+            return;
 
         if (itemSubClass != 0xffffffff && proto->GetSubClass() != itemSubClass)
-            continue;
+            return;
 
         if (inventoryType != 0xffffffff && proto->GetInventoryType() != inventoryType)
-            continue;
+            return;
 
         if (quality != 0xffffffff && proto->GetQuality() != quality)
-            continue;
+            return;
 
         if (levelmin != 0x00 && (proto->GetRequiredLevel() < levelmin || (levelmax != 0 && proto->GetRequiredLevel() > levelmax)))
-            continue;
+            return;
 
         if (usable != 0x00 && player->CanUseItem(item) != EQUIP_ERR_OK)
-            continue;
+            return;
 
         // Allow search by suffix (ie: of the Monkey) or partial name (ie: Monkey)
         // No need to do any of this if no search term was entered
@@ -773,7 +813,7 @@ void AuctionHouseObject::BuildListAuctionItems(WorldPacket& data, Player* player
         {
             std::string name = proto->GetName(player->GetSession()->GetSessionDbcLocale());
             if (name.empty())
-                continue;
+                return;
 
             // DO NOT use GetItemEnchantMod(proto->RandomProperty) as it may return a result
             //  that matches the search but it may not equal item->GetItemRandomPropertyId()
@@ -813,7 +853,7 @@ void AuctionHouseObject::BuildListAuctionItems(WorldPacket& data, Player* player
 
             // Perform the search (with or without suffix)
             if (!Utf8FitTo(name, wsearchedname))
-                continue;
+                return;
         }
 
         // Add the item if no search term or if entered search term was found
@@ -823,6 +863,19 @@ void AuctionHouseObject::BuildListAuctionItems(WorldPacket& data, Player* player
             Aentry->BuildAuctionInfo(data, item);
         }
         ++totalcount;
+    };
+
+    std::vector<uint32> candidates;
+    if (SearchIndex.GetCandidates(wsearchedname, player->GetSession()->GetSessionDbcLocale(), levelmin, levelmax, inventoryType, itemClass, itemSubClass, quality, candidates))
+    {
+        for (uint32 auctionId : candidates)
+            if (AuctionEntry* Aentry = GetAuction(auctionId))
+                checkAuction(Aentry);
+    }
+    else
+    {
+        for (AuctionEntryMap::const_iterator itr = AuctionsMap.begin(); itr != AuctionsMap.end(); ++itr)
+            checkAuction(itr->second);
     }
 }
 
@@ -18,10 +18,12 @@
 #ifndef _AUCTION_HOUSE_MGR_H
 #define _AUCTION_HOUSE_MGR_H
 
+#include "AuctionHouseSearchIndex.h"
 #include "Define.h"
 #include "DatabaseEnvFwd.h"
 #include "ObjectGuid.h"
 #include <map>
+#include <queue>
 #include <set>
 #include <unordered_map>
 
@@ -131,6 +133,15 @@ class TC_GAME_API AuctionHouseObject
 
     bool RemoveAuction(AuctionEntry* auction);
 
+    // returns false if the player already bid on this auction
+    bool AddBidder(AuctionEntry* auction, ObjectGuid bidder);
+
+    // use instead of changing expire_time of an added auction directly
+    void SetExpireTime(AuctionEntry* auction, time_t expireTime);
+
+    // takes the next auction that expires at or before time out of the expiration queue, it stays in the auction house
+    AuctionEntry* PopExpiredAuction(time_t time);
+
     void Update();
 
     void BuildListBidderItems(WorldPacket& data, Player* player, uint32& count, uint32& totalcount);
@@ -143,6 +154,12 @@ class TC_GAME_API AuctionHouseObject
   private:
     AuctionEntryMap AuctionsMap;
 
+    AuctionHouseSearchIndex SearchIndex;
+
+    // min-heap of expire times, entries of removed auctions are skipped when due
+    typedef std::pair<time_t, uint32 /*auctionId*/> AuctionExpiration;
+    std::priority_queue<AuctionExpiration, std::vector<AuctionExpiration>, std::greater<AuctionExpiration>> ExpirationQueue;
+
     // Map of throttled players for GetAll, and throttle expiry time
     // Stored here, rather than player object to maintain persistence after logout
     PlayerGetAllThrottleMap GetAllThrottleMap;
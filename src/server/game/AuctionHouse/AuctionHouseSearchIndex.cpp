@@ -0,0 +1,389 @@
+/*
+ * This file is part of the TrinityCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "AuctionHouseSearchIndex.h"
+#include "AuctionHouseMgr.h"
+#include "DBCStores.h"
+#include "Item.h"
+#include "ItemTemplate.h"
+#include "ObjectMgr.h"
+#include "Util.h"
+#include <algorithm>
+#include <limits>
+
+namespace
+{
+    template<class Index, class Key>
+    void InsertInto(Index& index, Key const& key, uint32 auctionId)
+    {
+        index[key].insert(auctionId);
+    }
+
+    template<class Index, class Key>
+    bool EraseFrom(Index& index, Key const& key, uint32 auctionId)
+    {
+        auto itr = index.find(key);
+        if (itr == index.end())
+            return false;
+
+        itr->second.erase(auctionId);
+        if (!itr->second.empty())
+            return false;
+
+        index.erase(itr);
+        return true;
+    }
+
+    uint64 MakeNameKey(uint32 itemEntry, int32 randomPropertyId)
+    {
+        return (uint64(itemEntry) << 32) | uint32(randomPropertyId);
+    }
+}
+
+AuctionHouseSearchIndex::AuctionHouseSearchIndex() = default;
+
+AuctionHouseSearchIndex::~AuctionHouseSearchIndex() = default;
+
+void AuctionHouseSearchIndex::Insert(AuctionEntry const* auction)
+{
+    if (_auctions.count(auction->Id))
+        return;
+
+    IndexedAuction& indexed = _auctions[auction->Id];
+    indexed.Name = 0;
+    indexed.HasName = false;
+    indexed.HasTemplate = false;
+
+    InsertInto(_byOwner, auction->owner, auction->Id);
+
+    for (ObjectGuid const& bidder : auction->bidders)
+        InsertInto(_byBidder, bidder, auction->Id);
+
+    // still listed to its owner and bidders, name searches check it like other auctions without a name
+    ItemTemplate const* proto = sObjectMgr->GetItemTemplate(auction->itemEntry);
+    if (!proto)
+    {
+        _withoutName.insert(auction->Id);
+        return;
+    }
+
+    indexed.ItemClass = proto->GetClass();
+    indexed.ItemSubClass = proto->GetSubClass();
+    indexed.InventoryType = proto->GetInventoryType();
+    indexed.Quality = proto->GetQuality();
+    indexed.RequiredLevel = proto->GetRequiredLevel();
+    indexed.HasTemplate = true;
+
+    InsertInto(_byClass, indexed.ItemClass, auction->Id);
+    InsertInto(_bySubClass, (indexed.ItemClass << 16) | indexed.ItemSubClass, auction->Id);
+    InsertInto(_byInventoryType, indexed.InventoryType, auction->Id);
+    InsertInto(_byQuality, indexed.Quality, auction->Id);
+    InsertInto(_byRequiredLevel, indexed.RequiredLevel, auction->Id);
+
+    // the random property is part of the searchable name (suffix), it is only known from the item
+    if (Item* item = sAuctionMgr->GetAItem(auction->itemGUIDLow))
+    {
+        indexed.Name = MakeNameKey(auction->itemEntry, item->GetItemRandomPropertyId());
+        indexed.HasName = true;
+
+        AuctionIdSet& auctions = _byName[indexed.Name];
+        if (auctions.empty())
+            for (uint8 locale = 0; locale < TOTAL_LOCALES; ++locale)
+                if (_localeNames[locale])
+                    AddName(*_localeNames[locale], indexed.Name, LocaleConstant(locale));
+
+        auctions.insert(auction->Id);
+    }
+    else
+        _withoutName.insert(auction->Id);
+}
+
+void AuctionHouseSearchIndex::Remove(AuctionEntry const* auction)
+{
+    auto itr = _auctions.find(auction->Id);
+    if (itr == _auctions.end())
+        return;
+
+    IndexedAuction const& indexed = itr->second;
+    if (indexed.HasTemplate)
+    {
+        EraseFrom(_byClass, indexed.ItemClass, auction->Id);
+        EraseFrom(_bySubClass, (indexed.ItemClass << 16) | indexed.ItemSubClass, auction->Id);
+        EraseFrom(_byInventoryType, indexed.InventoryType, auction->Id);
+        EraseFrom(_byQuality, indexed.Quality, auction->Id);
+        EraseFrom(_byRequiredLevel, indexed.RequiredLevel, auction->Id);
+    }
+
+    EraseFrom(_byOwner, auction->owner, auction->Id);
+
+    for (ObjectGuid const& bidder : auction->bidders)
+        EraseFrom(_byBidder, bidder, auction->Id);
+
+    if (indexed.HasName)
+    {
+        if (EraseFrom(_byName, indexed.Name, auction->Id))
+            for (std::unique_ptr<LocaleNames>& names : _localeNames)
+                if (names)
+                    RemoveName(*names, indexed.Name);
+    }
+    else
+        _withoutName.erase(auction->Id);
+
+    _auctions.erase(itr);
+}
+
+void AuctionHouseSearchIndex::AddBidder(AuctionEntry const* auction, ObjectGuid bidder)
+{
+    if (_auctions.count(auction->Id))
+        InsertInto(_byBidder, bidder, auction->Id);
+}
+
+AuctionHouseSearchIndex::AuctionIdSet const* AuctionHouseSearchIndex::GetBidderAuctions(ObjectGuid bidder) const
+{
+    auto itr = _byBidder.find(bidder);
+    return itr != _byBidder.end() ? &itr->second : nullptr;
+}
+
+AuctionHouseSearchIndex::AuctionIdSet const* AuctionHouseSearchIndex::GetOwnerAuctions(ObjectGuid::LowType owner) const
+{
+    auto itr = _byOwner.find(owner);
+    return itr != _byOwner.end() ? &itr->second : nullptr;
+}
+
+bool AuctionHouseSearchIndex::GetCandidates(std::wstring const& searchedName, LocaleConstant locale, uint8 levelmin, uint8 levelmax,
+    uint32 inventoryType, uint32 itemClass, uint32 itemSubClass, uint32 quality, std::vector<uint32>& candidates)
+{
+    candidates.clear();
+
+    // pick the most selective filter, an empty index entry means nothing can match
+    AuctionIdSet const* best = nullptr;
+    auto consider = [&best](auto const& index, auto const& key)
+    {
+        auto itr = index.find(key);
+        if (itr == index.end())
+            return false;
+
+        if (!best || itr->second.size() < best->size())
+            best = &itr->second;
+        return true;
+    };
+
+    if (itemClass != 0xffffffff)
+    {
+        if (!consider(_byClass, itemClass))
+            return true;
+
+        // subclasses are only unique within their class
+        if (itemSubClass != 0xffffffff && !consider(_bySubClass, (itemClass << 16) | itemSubClass))
+            return true;
+    }
+
+    if (inventoryType != 0xffffffff && !consider(_byInventoryType, inventoryType))
+        return true;
+
+    if (quality != 0xffffffff && !consider(_byQuality, quality))
+        return true;
+
+    std::size_t const NotUsed = std::numeric_limits<std::size_t>::max();
+    std::size_t bestSize = best ? best->size() : NotUsed;
+
+    // level range
+    std::map<int32, AuctionIdSet>::const_iterator levelBegin, levelEnd;
+    std::size_t levelSize = NotUsed;
+    if (levelmin != 0x00)
+    {
+        if (levelmax != 0 && levelmax < levelmin)
+            return true;
+
+        levelBegin = _byRequiredLevel.lower_bound(levelmin);
+        levelEnd = levelmax != 0 ? _byRequiredLevel.upper_bound(levelmax) : _byRequiredLevel.end();
+
+        // counting stops once the range can't beat the other filters
+        levelSize = 0;
+        for (auto itr = levelBegin; itr != levelEnd && levelSize < bestSize; ++itr)
+            levelSize += itr->second.size();
+
+        if (!levelSize)
+            return true;
+    }
+
+    // name, auctions without a known name are always checked
+    std::vector<NameKey> nameKeys;
+    std::size_t nameSize = NotUsed;
+    if (!searchedName.empty())
+    {
+        CollectNameCandidates(searchedName, locale, nameKeys);
+
+        nameSize = _withoutName.size();
+        for (NameKey key : nameKeys)
+        {
+            auto itr = _byName.find(key);
+            if (itr != _byName.end())
+                nameSize += itr->second.size();
+        }
+
+        if (!nameSize)
+            return true;
+    }
+
+    if (bestSize == NotUsed && levelSize == NotUsed && nameSize == NotUsed)
+        return false;
+
+    if (nameSize <= bestSize && nameSize <= levelSize)
+    {
+        candidates.reserve(nameSize);
+        candidates.insert(candidates.end(), _withoutName.begin(), _withoutName.end());
+        for (NameKey key : nameKeys)
+        {
+            auto itr = _byName.find(key);
+            if (itr != _byName.end())
+                candidates.insert(candidates.end(), itr->second.begin(), itr->second.end());
+        }
+        std::sort(candidates.begin(), candidates.end());
+    }
+    else if (levelSize < bestSize)
+    {
+        candidates.reserve(levelSize);
+        for (auto itr = levelBegin; itr != levelEnd; ++itr)
+            candidates.insert(candidates.end(), itr->second.begin(), itr->second.end());
+        std::sort(candidates.begin(), candidates.end());
+    }
+    else
+        candidates.assign(best->begin(), best->end());
+
+    return true;
+}
+
+uint64 AuctionHouseSearchIndex::MakeTrigram(wchar_t const* str)
+{
+    return (uint64(uint32(str[0]) & 0x1FFFFF) << 42) | (uint64(uint32(str[1]) & 0x1FFFFF) << 21) | uint64(uint32(str[2]) & 0x1FFFFF);
+}
+
+bool AuctionHouseSearchIndex::BuildName(NameKey key, LocaleConstant locale, std::wstring& name)
+{
+    ItemTemplate const* proto = sObjectMgr->GetItemTemplate(uint32(key >> 32));
+    if (!proto)
+        return false;
+
+    std::string utf8Name = proto->GetName(locale);
+    if (utf8Name.empty())
+        return false;
+
+    // same suffix lookup as AuctionHouseObject::BuildListAuctionItems
+    if (int32 propRefID = int32(uint32(key)))
+    {
+        char* suffix = nullptr;
+        if (propRefID < 0)
+        {
+            if (ItemRandomSuffixEntry const* itemRandSuffix = sItemRandomSuffixStore.LookupEntry(-propRefID))
+                suffix = itemRandSuffix->Name;
+        }
+        else if (ItemRandomPropertiesEntry const* itemRandProp = sItemRandomPropertiesStore.LookupEntry(propRefID))
+            suffix = itemRandProp->Name;
+
+        if (suffix)
+        {
+            utf8Name += ' ';
+            utf8Name += suffix;
+        }
+    }
+
+    if (!Utf8toWStr(utf8Name, name))
+        return false;
+
+    wstrToLower(name);
+    return true;
+}
+
+void AuctionHouseSearchIndex::AddName(LocaleNames& names, NameKey key, LocaleConstant locale)
+{
+    std::wstring name;
+    if (!BuildName(key, locale, name))
+        return;
+
+    for (std::size_t i = 0; i + 3 <= name.length(); ++i)
+        names.Trigrams[MakeTrigram(&name[i])].insert(key);
+
+    names.Names[key] = std::move(name);
+}
+
+void AuctionHouseSearchIndex::RemoveName(LocaleNames& names, NameKey key)
+{
+    auto itr = names.Names.find(key);
+    if (itr == names.Names.end())
+        return;
+
+    std::wstring const& name = itr->second;
+    for (std::size_t i = 0; i + 3 <= name.length(); ++i)
+    {
+        auto trigram = names.Trigrams.find(MakeTrigram(&name[i]));
+        if (trigram == names.Trigrams.end())
+            continue;
+
+        trigram->second.erase(key);
+        if (trigram->second.empty())
+            names.Trigrams.erase(trigram);
+    }
+
+    names.Names.erase(itr);
+}
+
+AuctionHouseSearchIndex::LocaleNames& AuctionHouseSearchIndex::GetLocaleNames(LocaleConstant locale)
+{
+    std::unique_ptr<LocaleNames>& names = _localeNames[locale];
+    if (!names)
+    {
+        names = std::make_unique<LocaleNames>();
+        for (auto const& pair : _byName)
+            AddName(*names, pair.first, locale);
+    }
+
+    return *names;
+}
+
+void AuctionHouseSearchIndex::CollectNameCandidates(std::wstring const& searchedName, LocaleConstant locale, std::vector<NameKey>& keys)
+{
+    LocaleNames const& names = GetLocaleNames(locale);
+
+    // too short for trigrams, still cheaper than converting every item name
+    if (searchedName.length() < 3)
+    {
+        for (auto const& pair : names.Names)
+            if (pair.second.find(searchedName) != std::wstring::npos)
+                keys.push_back(pair.first);
+        return;
+    }
+
+    // names containing the rarest trigram of the search, then the full substring check
+    std::unordered_set<NameKey> const* rarest = nullptr;
+    for (std::size_t i = 0; i + 3 <= searchedName.length(); ++i)
+    {
+        auto itr = names.Trigrams.find(MakeTrigram(&searchedName[i]));
+        if (itr == names.Trigrams.end())
+            return;
+
+        if (!rarest || itr->second.size() < rarest->size())
+            rarest = &itr->second;
+    }
+
+    for (NameKey key : *rarest)
+    {
+        auto itr = names.Names.find(key);
+        if (itr != names.Names.end() && itr->second.find(searchedName) != std::wstring::npos)
+            keys.push_back(key);
+    }
+}
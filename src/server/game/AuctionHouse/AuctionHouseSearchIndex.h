@@ -0,0 +1,109 @@
+/*
+ * This file is part of the TrinityCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _AUCTION_HOUSE_SEARCH_INDEX_H
+#define _AUCTION_HOUSE_SEARCH_INDEX_H
+
+#include "Define.h"
+#include "Common.h"
+#include "ObjectGuid.h"
+#include <array>
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+struct AuctionEntry;
+
+// Secondary indexes of a single auction house, kept up to date by AuctionHouseObject.
+// Searches only narrow down the auctions to look at, every filter is still checked on the
+// candidates so results (and their order, by auction id) are the same as a full scan.
+class TC_GAME_API AuctionHouseSearchIndex
+{
+    public:
+        typedef std::set<uint32> AuctionIdSet;
+
+        AuctionHouseSearchIndex();
+        ~AuctionHouseSearchIndex();
+
+        AuctionHouseSearchIndex(AuctionHouseSearchIndex const&) = delete;
+        AuctionHouseSearchIndex& operator=(AuctionHouseSearchIndex const&) = delete;
+
+        // both may be called again for the same auction
+        void Insert(AuctionEntry const* auction);
+        void Remove(AuctionEntry const* auction);
+
+        void AddBidder(AuctionEntry const* auction, ObjectGuid bidder);
+
+        AuctionIdSet const* GetBidderAuctions(ObjectGuid bidder) const;
+        AuctionIdSet const* GetOwnerAuctions(ObjectGuid::LowType owner) const;
+
+        // Fills candidates with ascending auction ids that may match the filters (same values as CMSG_AUCTION_LIST_ITEMS, searchedName lowercased)
+        // Returns false when no filter narrows the search, every auction has to be checked then
+        bool GetCandidates(std::wstring const& searchedName, LocaleConstant locale, uint8 levelmin, uint8 levelmax,
+            uint32 inventoryType, uint32 itemClass, uint32 itemSubClass, uint32 quality, std::vector<uint32>& candidates);
+
+    private:
+        // item entry and random property id, together they give the searchable name
+        typedef uint64 NameKey;
+
+        // lowercased names of a single locale, built on first search in that locale
+        struct LocaleNames
+        {
+            std::unordered_map<NameKey, std::wstring> Names;
+            std::unordered_map<uint64, std::unordered_set<NameKey>> Trigrams;
+        };
+
+        struct IndexedAuction
+        {
+            uint32 ItemClass;
+            uint32 ItemSubClass;
+            uint32 InventoryType;
+            uint32 Quality;
+            int32 RequiredLevel;
+            NameKey Name;
+            bool HasName;
+            bool HasTemplate;
+        };
+
+        static uint64 MakeTrigram(wchar_t const* str);
+        static bool BuildName(NameKey key, LocaleConstant locale, std::wstring& name);
+
+        void AddName(LocaleNames& names, NameKey key, LocaleConstant locale);
+        void RemoveName(LocaleNames& names, NameKey key);
+        LocaleNames& GetLocaleNames(LocaleConstant locale);
+        void CollectNameCandidates(std::wstring const& searchedName, LocaleConstant locale, std::vector<NameKey>& keys);
+
+        std::unordered_map<uint32, IndexedAuction> _auctions;
+
+        std::unordered_map<uint32, AuctionIdSet> _byClass;
+        std::unordered_map<uint32, AuctionIdSet> _bySubClass;       // class << 16 | subclass
+        std::unordered_map<uint32, AuctionIdSet> _byInventoryType;
+        std::unordered_map<uint32, AuctionIdSet> _byQuality;
+        std::map<int32, AuctionIdSet> _byRequiredLevel;
+        std::unordered_map<ObjectGuid, AuctionIdSet> _byBidder;
+        std::unordered_map<ObjectGuid::LowType, AuctionIdSet> _byOwner;
+        std::unordered_map<NameKey, AuctionIdSet> _byName;
+        AuctionIdSet _withoutName;                                  // item or its template was not loaded when the auction was added
+
+        std::array<std::unique_ptr<LocaleNames>, TOTAL_LOCALES> _localeNames;
+};
+
+#endif
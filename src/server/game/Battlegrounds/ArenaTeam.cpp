@@ -275,7 +275,10 @@ bool ArenaTeam::SetName(std::string const& name)
     if (TeamName == name || name.empty() || name.length() > 24 || sObjectMgr->IsReservedName(name) || !ObjectMgr::IsValidCharterName(name))
         return false;
 
+    std::string oldName = TeamName;
     TeamName = name;
+    sArenaTeamMgr->UpdateArenaTeamName(this, oldName);
+
     CharacterDatabasePreparedStatement* stmt = CharacterDatabase.GetPreparedStatement(CHAR_UPD_ARENA_TEAM_NAME);
     stmt->setString(0, TeamName);
     stmt->setUInt32(1, GetId());
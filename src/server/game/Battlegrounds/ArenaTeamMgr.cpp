@@ -53,15 +53,10 @@ ArenaTeam* ArenaTeamMgr::GetArenaTeamById(uint32 arenaTeamId) const
 
 ArenaTeam* ArenaTeamMgr::GetArenaTeamByName(const std::string& arenaTeamName) const
 {
-    std::string search = arenaTeamName;
-    std::transform(search.begin(), search.end(), search.begin(), ::toupper);
-    for (ArenaTeamContainer::const_iterator itr = ArenaTeamStore.begin(); itr != ArenaTeamStore.end(); ++itr)
-    {
-        std::string teamName = itr->second->GetName();
-        std::transform(teamName.begin(), teamName.end(), teamName.begin(), ::toupper);
-        if (search == teamName)
-            return itr->second;
-    }
+    auto itr = ArenaTeamNameStore.find(arenaTeamName);
+    if (itr != ArenaTeamNameStore.end())
+        return itr->second;
+
     return nullptr;
 }
 
@@ -77,11 +72,29 @@ ArenaTeam* ArenaTeamMgr::GetArenaTeamByCaptain(ObjectGuid guid) const
 void ArenaTeamMgr::AddArenaTeam(ArenaTeam* arenaTeam)
 {
     ArenaTeamStore[arenaTeam->GetId()] = arenaTeam;
+    ArenaTeamNameStore[arenaTeam->GetName()] = arenaTeam;
 }
 
 void ArenaTeamMgr::RemoveArenaTeam(uint32 arenaTeamId)
 {
-    ArenaTeamStore.erase(arenaTeamId);
+    ArenaTeamContainer::iterator itr = ArenaTeamStore.find(arenaTeamId);
+    if (itr == ArenaTeamStore.end())
+        return;
+
+    auto nameItr = ArenaTeamNameStore.find(itr->second->GetName());
+    if (nameItr != ArenaTeamNameStore.end() && nameItr->second == itr->second)
+        ArenaTeamNameStore.erase(nameItr);
+
+    ArenaTeamStore.erase(itr);
+}
+
+void ArenaTeamMgr::UpdateArenaTeamName(ArenaTeam* arenaTeam, std::string const& oldName)
+{
+    auto itr = ArenaTeamNameStore.find(oldName);
+    if (itr != ArenaTeamNameStore.end() && itr->second == arenaTeam)
+        ArenaTeamNameStore.erase(itr);
+
+    ArenaTeamNameStore[arenaTeam->GetName()] = arenaTeam;
 }
 
 uint32 ArenaTeamMgr::GenerateArenaTeamId()
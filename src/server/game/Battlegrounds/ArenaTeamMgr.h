@@ -19,6 +19,7 @@
 #define _ARENATEAMMGR_H
 
 #include "ArenaTeam.h"
+#include "CaseInsensitiveName.h"
 #include <unordered_map>
 
 class TC_GAME_API ArenaTeamMgr
@@ -39,6 +40,7 @@ public:
     void LoadArenaTeams();
     void AddArenaTeam(ArenaTeam* arenaTeam);
     void RemoveArenaTeam(uint32 Id);
+    void UpdateArenaTeamName(ArenaTeam* arenaTeam, std::string const& oldName);
 
     ArenaTeamContainer::iterator GetArenaTeamMapBegin() { return ArenaTeamStore.begin(); }
     ArenaTeamContainer::iterator GetArenaTeamMapEnd()   { return ArenaTeamStore.end(); }
@@ -49,6 +51,7 @@ public:
 protected:
     uint32 NextArenaTeamId;
     ArenaTeamContainer ArenaTeamStore;
+    Trinity::CaseInsensitiveNameMap<ArenaTeam*> ArenaTeamNameStore;
 };
 
 #define sArenaTeamMgr ArenaTeamMgr::instance()
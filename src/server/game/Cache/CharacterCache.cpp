@@ -17,6 +17,7 @@
 
 #include "CharacterCache.h"
 #include "ArenaTeam.h"
+#include "CaseInsensitiveName.h"
 #include "DatabaseEnv.h"
 #include "Log.h"
 #include "Player.h"
@@ -28,7 +29,7 @@
 namespace
 {
     std::unordered_map<ObjectGuid, CharacterCacheEntry> _characterCacheStore;
-    std::unordered_map<std::string, CharacterCacheEntry*> _characterCacheByNameStore;
+    Trinity::CaseInsensitiveNameMap<CharacterCacheEntry*> _characterCacheByNameStore;
 }
 
 CharacterCache::CharacterCache()
@@ -233,6 +233,7 @@ void Channel::JoinChannel(Player* player, std::string const& pass)
     bool newChannel = _playersStore.empty();
 
     PlayerInfo& pinfo = _playersStore[guid];
+    pinfo.player = player;
     pinfo.flags = MEMBER_FLAG_NONE;
     pinfo.invisible = !player->isGMVisible();
 
@@ -654,12 +655,11 @@ void Channel::List(Player const* player) const
     uint32 count  = 0;
     for (PlayerContainer::const_iterator i = _playersStore.begin(); i != _playersStore.end(); ++i)
     {
-        Player* member = ObjectAccessor::FindConnectedPlayer(i->first);
+        Player* member = i->second.player;
 
         // PLAYER can't see MODERATOR, GAME MASTER, ADMINISTRATOR characters
         // MODERATOR, GAME MASTER, ADMINISTRATOR can see all
-        if (member &&
-            (player->GetSession()->HasPermission(rbac::RBAC_PERM_WHO_SEE_ALL_SEC_LEVELS) ||
+        if ((player->GetSession()->HasPermission(rbac::RBAC_PERM_WHO_SEE_ALL_SEC_LEVELS) ||
              member->GetSession()->GetSecurity() <= AccountTypes(gmLevelInWhoList)) &&
             member->IsVisibleGloballyFor(player))
         {
@@ -742,10 +742,7 @@ void Channel::Say(ObjectGuid guid, std::string const& what, uint32 lang) const
     {
         LocaleConstant localeIdx = sWorld->GetAvailableDbcLocale(locale);
 
-        if (Player* player = ObjectAccessor::FindConnectedPlayer(guid))
-            ChatHandler::BuildChatPacket(data, CHAT_MSG_CHANNEL, Language(lang), player, player, what, 0, GetName(localeIdx));
-        else
-            ChatHandler::BuildChatPacket(data, CHAT_MSG_CHANNEL, Language(lang), guid, guid, what, 0, "", "", 0, false, GetName(localeIdx));
+        ChatHandler::BuildChatPacket(data, CHAT_MSG_CHANNEL, Language(lang), info.player, info.player, what, 0, GetName(localeIdx));
     };
 
     SendToAll(builder, !info.IsModerator() ? guid : ObjectGuid::Empty);
@@ -900,9 +897,8 @@ void Channel::SendToAll(Builder& builder, ObjectGuid guid /*= ObjectGuid::Empty*
     Trinity::LocalizedPacketDo<Builder> localizer(builder);
 
     for (PlayerContainer::const_iterator i = _playersStore.begin(); i != _playersStore.end(); ++i)
-        if (Player* player = ObjectAccessor::FindConnectedPlayer(i->first))
-            if (!guid || !player->GetSocial()->HasIgnore(guid))
-                localizer(player);
+        if (!guid || !i->second.player->GetSocial()->HasIgnore(guid))
+            localizer(i->second.player);
 }
 
 template<class Builder>
@@ -912,8 +908,7 @@ void Channel::SendToAllButOne(Builder& builder, ObjectGuid who) const
 
     for (PlayerContainer::const_iterator i = _playersStore.begin(); i != _playersStore.end(); ++i)
         if (i->first != who)
-            if (Player* player = ObjectAccessor::FindConnectedPlayer(i->first))
-                localizer(player);
+            localizer(i->second.player);
 }
 
 template<class Builder>
@@ -118,6 +118,7 @@ class TC_GAME_API Channel
 {
     struct PlayerInfo
     {
+        Player* player;                 // members leave every channel in Player::CleanupsBeforeDelete at the latest
         uint8 flags;
         bool invisible;
 
@@ -21,6 +21,7 @@
 #include "Player.h"
 #include "World.h"
 #include "WorldSession.h"
+#include <utf8.h>
 
 ChannelMgr::~ChannelMgr()
 {
@@ -50,21 +51,13 @@ ChannelMgr* ChannelMgr::forTeam(uint32 team)
 
 Channel* ChannelMgr::GetChannelForPlayerByNamePart(std::string const& namePart, Player* playerSearcher)
 {
-    std::wstring channelNamePart;
-    if (!Utf8toWStr(namePart, channelNamePart))
+    if (!utf8::is_valid(namePart.begin(), namePart.end()))
         return nullptr;
 
-    wstrToLower(channelNamePart);
     for (Channel* channel : playerSearcher->GetJoinedChannels())
     {
         std::string chanName = channel->GetName(playerSearcher->GetSession()->GetSessionDbcLocale());
-
-        std::wstring channelNameW;
-        if (!Utf8toWStr(chanName, channelNameW))
-            continue;
-
-        wstrToLower(channelNameW);
-        if (!channelNameW.compare(0, channelNamePart.size(), channelNamePart))
+        if (Trinity::CaseInsensitiveNameStartsWith(chanName, namePart))
             return channel;
     }
 
@@ -92,17 +85,15 @@ Channel* ChannelMgr::GetJoinChannel(uint32 channelId, std::string const& name, A
     }
     else // custom
     {
-        std::wstring channelName;
-        if (!Utf8toWStr(name, channelName))
+        if (!utf8::is_valid(name.begin(), name.end()))
             return nullptr;
 
-        wstrToLower(channelName);
-        auto itr = _customChannels.find(channelName);
+        auto itr = _customChannels.find(name);
         if (itr != _customChannels.end())
             return itr->second;
 
         Channel* newChannel = new Channel(name, _team);
-        _customChannels[channelName] = newChannel;
+        _customChannels[name] = newChannel;
         return newChannel;
     }
 }
@@ -129,12 +120,10 @@ Channel* ChannelMgr::GetChannel(uint32 channelId, std::string const& name, Playe
     }
     else // custom
     {
-        std::wstring channelName;
-        if (!Utf8toWStr(name, channelName))
+        if (!utf8::is_valid(name.begin(), name.end()))
             return nullptr;
 
-        wstrToLower(channelName);
-        auto itr = _customChannels.find(channelName);
+        auto itr = _customChannels.find(name);
         if (itr != _customChannels.end())
             ret = itr->second;
         else
@@ -156,12 +145,7 @@ Channel* ChannelMgr::GetChannel(uint32 channelId, std::string const& name, Playe
 
 void ChannelMgr::LeftChannel(std::string const& name)
 {
-    std::wstring channelName;
-    if (!Utf8toWStr(name, channelName))
-        return;
-
-    wstrToLower(channelName);
-    auto itr = _customChannels.find(channelName);
+    auto itr = _customChannels.find(name);
     if (itr == _customChannels.end())
         return;
 
@@ -17,6 +17,7 @@
 #ifndef __TRINITY_CHANNELMGR_H
 #define __TRINITY_CHANNELMGR_H
 
+#include "CaseInsensitiveName.h"
 #include "Define.h"
 #include "Hash.h"
 #include <string>
@@ -29,7 +30,7 @@ struct AreaTableEntry;
 
 class TC_GAME_API ChannelMgr
 {
-    typedef std::unordered_map<std::wstring, Channel*> CustomChannelContainer; // custom channels only differ in name
+    typedef Trinity::CaseInsensitiveNameMap<Channel*> CustomChannelContainer; // custom channels only differ in name
     typedef std::unordered_map<std::pair<uint32 /*channelId*/, uint32 /*zoneId*/>, Channel*> BuiltinChannelContainer; //identify builtin (DBC) channels by zoneId instead, since name changes by client locale
 
     protected:
@@ -196,6 +196,10 @@ void LFGMgr::LoadLFGDungeons(bool reload /* = false */)
 {
     uint32 oldMSTime = getMSTime();
 
+    // matchmaking passes read dungeon data
+    for (LfgQueueContainer::const_iterator itr = QueuesStore.begin(); itr != QueuesStore.end(); ++itr)
+        itr->second.WaitForMatchmaking();
+
     LfgDungeonStore.clear();
 
     // Initialize Dungeon map with data from dbcs
@@ -2099,6 +2103,12 @@ LFGQueue& LFGMgr::GetQueue(ObjectGuid guid)
     return QueuesStore[queueId];
 }
 
+void LFGMgr::IgnoreListChanged(ObjectGuid guid)
+{
+    for (LfgQueueContainer::iterator itr = QueuesStore.begin(); itr != QueuesStore.end(); ++itr)
+        itr->second.IgnoreListChanged(guid);
+}
+
 bool LFGMgr::AllQueued(GuidList const& check)
 {
     if (check.empty())
@@ -447,6 +447,8 @@ class TC_GAME_API LFGMgr
         static bool CheckGroupRoles(LfgRolesMap& groles, LFGDungeonData const* dungeon);
         /// Checks if given players are ignoring each other
         static bool HasIgnore(ObjectGuid guid1, ObjectGuid guid2);
+        /// Queues keep a copy of the ignore lists of their players, reloads it
+        void IgnoreListChanged(ObjectGuid guid);
         /// Sends queue status to player
         static void SendLfgQueueStatus(ObjectGuid guid, LfgQueueStatusData const& data);
         /// Returns dungeon datas based on the dungeon ID
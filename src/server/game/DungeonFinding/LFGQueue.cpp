@@ -21,35 +21,70 @@
 #include "DBCStores.h"
 #include "GameTime.h"
 #include "Group.h"
+#include "Hash.h"
 #include "LFGQueue.h"
 #include "LFGMgr.h"
 #include "Log.h"
+#include "ObjectAccessor.h"
+#include "Player.h"
+#include "SocialMgr.h"
+#include <algorithm>
 
 namespace lfg
 {
 
-/**
-   Given a list of guids returns the concatenation using | as delimiter
-
-   @param[in]     check list of guids
-   @returns Concatenated string
-*/
-std::string ConcatenateGuids(GuidList const& check)
+namespace
 {
-    if (check.empty())
-        return "";
+    LfgQueueSlotList SortedKey(LfgQueueSlotList const& check)
+    {
+        LfgQueueSlotList key(check);
+        std::sort(key.begin(), key.end());
+        return key;
+    }
 
-    // need the guids in order to avoid duplicates
-    GuidSet guids(check.begin(), check.end());
+    /**
+       Cheap necessary condition for LFGMgr::CheckGroupRoles, rejects most bad combinations
+       before its backtracking: players with a single role can't outnumber the required ones
 
-    std::ostringstream o;
+       @param[in]     roles Map of roles to check
+       @param[in]     dungeon Dungeon the roles are checked for
+       @return False if roles can't be compatible
+    */
+    bool CanFitRoles(LfgRolesMap const& roles, LFGDungeonData const* dungeon)
+    {
+        uint32 tanks = 0;
+        uint32 healers = 0;
+        uint32 damage = 0;
+        for (LfgRolesMap::const_iterator it = roles.begin(); it != roles.end(); ++it)
+        {
+            switch (it->second & ~PLAYER_ROLE_LEADER)
+            {
+                case PLAYER_ROLE_NONE:
+                    return false;
+                case PLAYER_ROLE_TANK:
+                    ++tanks;
+                    break;
+                case PLAYER_ROLE_HEALER:
+                    ++healers;
+                    break;
+                case PLAYER_ROLE_DAMAGE:
+                    ++damage;
+                    break;
+                default:
+                    break;
+            }
+        }
 
-    GuidSet::const_iterator it = guids.begin();
-    o << it->GetRawValue();
-    for (++it; it != guids.end(); ++it)
-        o << '|' << it->GetRawValue();
+        return tanks <= dungeon->requiredTanks && healers <= dungeon->requiredHealers && damage <= dungeon->requiredDamageDealers;
+    }
+}
 
-    return o.str();
+std::size_t LfgQueueSlotListHash::operator()(LfgQueueSlotList const& slots) const
+{
+    std::size_t hash = 0;
+    for (LfgQueueSlot slot : slots)
+        Trinity::hash_combine(hash, slot);
+    return hash;
 }
 
 char const* GetCompatibleString(LfgCompatibility compatibles)
@@ -81,7 +116,7 @@ char const* GetCompatibleString(LfgCompatibility compatibles)
     }
 }
 
-LfgQueueData::LfgQueueData(): joinTime(GameTime::GetGameTime())
+LfgQueueData::LfgQueueData(): joinTime(GameTime::GetGameTime()), slot(LFG_QUEUE_SLOT_NONE)
 {
     InitializeGroupSetup();
 }
@@ -103,38 +138,45 @@ void LfgQueueData::InitializeGroupSetup()
     }
 }
 
-std::string LFGQueue::GetDetailedMatchRoles(GuidList const& check) const
+LFGQueue::LFGQueue() = default;
+
+LFGQueue::~LFGQueue()
+{
+    WaitForMatchmaking();
+
+    if (MatchmakingWorker.joinable())
+    {
+        MatchmakingTasks.Cancel();
+        MatchmakingWorker.join();
+    }
+}
+
+/**
+   Given a list of slots returns the concatenation of their guids and roles using | as delimiter
+
+   @param[in]     check list of slots
+   @returns Concatenated string
+*/
+std::string LFGQueue::GetDetailedMatchRoles(LfgQueueSlotList const& check) const
 {
     if (check.empty())
         return "";
 
-    // need the guids in order to avoid duplicates
-    GuidSet guids(check.begin(), check.end());
+    // need the slots in order to avoid duplicates
+    LfgQueueSlotList slots = SortedKey(check);
 
     std::ostringstream o;
-
-    GuidSet::const_iterator it = guids.begin();
-    o << it->GetRawValue();
-    LfgQueueDataContainer::const_iterator itQueue = QueueDataStore.find(*it);
-    if (itQueue != QueueDataStore.end())
+    for (LfgQueueSlotList::const_iterator it = slots.begin(); it != slots.end(); ++it)
     {
-        // skip leader flag, log only dps/tank/healer
-        auto role = itQueue->second.roles.find(*it);
-        if (role != itQueue->second.roles.end())
-            o << ' ' << GetRolesString(itQueue->second.roles.at(*it) & uint8(~PLAYER_ROLE_LEADER));
-    }
+        SlotData const& data = Slots[*it];
+        if (it != slots.begin())
+            o << '|';
+        o << data.guid.GetRawValue();
 
-    for (++it; it != guids.end(); ++it)
-    {
-        o << '|' << it->GetRawValue();
-        itQueue = QueueDataStore.find(*it);
-        if (itQueue != QueueDataStore.end())
-        {
-            // skip leader flag, log only dps/tank/healer
-            auto role = itQueue->second.roles.find(*it);
-            if (role != itQueue->second.roles.end())
-                o << ' ' << GetRolesString(itQueue->second.roles.at(*it) & uint8(~PLAYER_ROLE_LEADER));
-        }
+        // skip leader flag, log only dps/tank/healer
+        LfgRolesMap::const_iterator role = data.roles.find(data.guid);
+        if (role != data.roles.end())
+            o << ' ' << GetRolesString(role->second & uint8(~PLAYER_ROLE_LEADER));
     }
 
     return o.str();
@@ -159,27 +201,7 @@ void LFGQueue::RemoveFromQueue(ObjectGuid guid)
 {
     RemoveFromNewQueue(guid);
     RemoveFromCurrentQueue(guid);
-    RemoveFromCompatibles(guid);
-
-    std::ostringstream o;
-    o << guid.GetRawValue();
-    std::string sguid = o.str();
-
-    LfgQueueDataContainer::iterator itDelete = QueueDataStore.end();
-    for (LfgQueueDataContainer::iterator itr = QueueDataStore.begin(); itr != QueueDataStore.end(); ++itr)
-        if (itr->first != guid)
-        {
-            if (std::string::npos != itr->second.bestCompatible.find(sguid))
-            {
-                itr->second.bestCompatible.clear();
-                FindBestCompatibleInQueue(itr);
-            }
-        }
-        else
-            itDelete = itr;
-
-    if (itDelete != QueueDataStore.end())
-        QueueDataStore.erase(itDelete);
+    RemoveQueueData(guid);
 }
 
 void LFGQueue::AddToNewQueue(ObjectGuid guid)
@@ -209,6 +231,7 @@ void LFGQueue::RemoveFromCurrentQueue(ObjectGuid guid)
 
 void LFGQueue::AddQueueData(ObjectGuid guid, time_t joinTime, LfgDungeonSet const& dungeons, LfgRolesMap const& rolesMap)
 {
+    RemoveQueueData(guid);
     QueueDataStore[guid] = LfgQueueData(joinTime, dungeons, rolesMap);
     AddToQueue(guid);
 }
@@ -217,7 +240,13 @@ void LFGQueue::RemoveQueueData(ObjectGuid guid)
 {
     LfgQueueDataContainer::iterator it = QueueDataStore.find(guid);
     if (it != QueueDataStore.end())
+    {
+        // the matchmaker might be using the slot right now
+        if (it->second.slot != LFG_QUEUE_SLOT_NONE)
+            RemovedSlots.push_back(it->second.slot);
+
         QueueDataStore.erase(it);
+    }
 }
 
 void LFGQueue::UpdateWaitTimeAvg(int32 waitTime, uint32 dungeonId)
@@ -249,123 +278,486 @@ void LFGQueue::UpdateWaitTimeDps(int32 waitTime, uint32 dungeonId)
 }
 
 /**
-   Remove from cached compatible dungeons any entry that contains the given guid
+   Takes a snapshot of a queued player/group for the matchmaker
+
+   @param[in]     guid Guid of the queued player/group
+   @param[in]     queueData Queue data of the player/group
+   @return Assigned slot
+*/
+LfgQueueSlot LFGQueue::AssignSlot(ObjectGuid guid, LfgQueueData const& queueData)
+{
+    LfgQueueSlot slot;
+    if (!FreeSlots.empty())
+    {
+        slot = FreeSlots.back();
+        FreeSlots.pop_back();
+    }
+    else
+    {
+        slot = LfgQueueSlot(Slots.size());
+        Slots.emplace_back();
+    }
+
+    SlotData& data = Slots[slot];
+    data.guid = guid;
+    data.roles = queueData.roles;
+    data.tanks = data.neededTanks = queueData.tanks;
+    data.healers = data.neededHealers = queueData.healers;
+    data.dps = data.neededDps = queueData.dps;
+
+    for (uint32 dungeonId : queueData.dungeons)
+    {
+        auto itr = DungeonIndexes.emplace(dungeonId, uint32(DungeonIds.size()));
+        if (itr.second)
+            DungeonIds.push_back(dungeonId);
+
+        if (data.dungeons.size() <= itr.first->second)
+            data.dungeons.resize(itr.first->second + 1);
+        data.dungeons.set(itr.first->second);
+    }
+
+    // Ignore lists are taken when joining the queue, IgnoreListChanged has them reloaded
+    for (LfgRolesMap::const_iterator it = data.roles.begin(); it != data.roles.end(); ++it)
+        if (Player* player = ObjectAccessor::FindConnectedPlayer(it->first))
+            player->GetSocial()->GetSocialsWithFlag(SOCIAL_FLAG_IGNORED, Ignores[it->first]);
+
+    return slot;
+}
+
+/**
+   Refreshes the state of a queued player/group before a matchmaking pass
+
+   @param[in]     slot Slot to refresh
+*/
+void LFGQueue::RefreshSlot(LfgQueueSlot slot)
+{
+    SlotData& data = Slots[slot];
+    data.queued = sLFGMgr->GetState(data.guid) == LFG_STATE_QUEUED;
+    data.lfgGroup = sLFGMgr->IsLfgGroup(data.guid);
 
-   @param[in]     guid Guid to remove from compatible cache
+    // all masks share the same size so the matchmaker can intersect them directly
+    if (data.dungeons.size() < DungeonIds.size())
+        data.dungeons.resize(DungeonIds.size());
+}
+
+bool LFGQueue::HasSlot(LfgQueueSlot slot) const
+{
+    LfgQueueDataContainer::const_iterator itr = QueueDataStore.find(Slots[slot].guid);
+    return itr != QueueDataStore.end() && itr->second.slot == slot;
+}
+
+/**
+   Remove from cached compatible dungeons any entry that contains slots that left the queue,
+   find new best compatible groups for those that included them and free the slots
 */
-void LFGQueue::RemoveFromCompatibles(ObjectGuid guid)
+void LFGQueue::ReleaseRemovedSlots()
 {
-    std::stringstream out;
-    out << guid.GetRawValue();
-    std::string strGuid = out.str();
+    if (RemovedSlots.empty())
+        return;
+
+    boost::dynamic_bitset<> removed(Slots.size());
+    for (LfgQueueSlot slot : RemovedSlots)
+    {
+        TC_LOG_DEBUG("lfg.queue.data.compatibles.remove", "Removing %s", Slots[slot].guid.ToString().c_str());
+        removed.set(slot);
+    }
+
+    auto isRemoved = [&removed](LfgQueueSlot slot) { return removed.test(slot); };
+
+    for (LfgCompatibleContainer::iterator itr = CompatibleMapStore.begin(); itr != CompatibleMapStore.end();)
+    {
+        if (std::any_of(itr->first.begin(), itr->first.end(), isRemoved))
+            itr = CompatibleMapStore.erase(itr);
+        else
+            ++itr;
+    }
 
-    TC_LOG_DEBUG("lfg.queue.data.compatibles.remove", "Removing %s", guid.ToString().c_str());
-    for (LfgCompatibleContainer::iterator itNext = CompatibleMapStore.begin(); itNext != CompatibleMapStore.end();)
+    boost::dynamic_bitset<> affected(Slots.size());
+    for (LfgQueueDataContainer::const_iterator itr = QueueDataStore.begin(); itr != QueueDataStore.end(); ++itr)
     {
-        LfgCompatibleContainer::iterator it = itNext++;
-        if (std::string::npos != it->first.find(strGuid))
-            CompatibleMapStore.erase(it);
+        LfgQueueSlot slot = itr->second.slot;
+        if (slot == LFG_QUEUE_SLOT_NONE)
+            continue;
+
+        SlotData& data = Slots[slot];
+        if (std::any_of(data.bestCompatible.begin(), data.bestCompatible.end(), isRemoved))
+        {
+            data.bestCompatible.clear();
+            data.neededTanks = data.tanks;
+            data.neededHealers = data.healers;
+            data.neededDps = data.dps;
+            affected.set(slot);
+        }
     }
+
+    if (affected.any())
+    {
+        TC_LOG_DEBUG("lfg.queue.compatibles.find", "Finding best compatible groups for %u queued", uint32(affected.count()));
+        for (LfgCompatibleContainer::const_iterator itr = CompatibleMapStore.begin(); itr != CompatibleMapStore.end(); ++itr)
+            if (itr->second.compatibility == LFG_COMPATIBLES_WITH_LESS_PLAYERS)
+                for (LfgQueueSlot slot : itr->first)
+                    if (affected.test(slot))
+                        UpdateBestCompatibleInQueue(slot, itr->first, itr->second.roles);
+
+        for (std::size_t slot = affected.find_first(); slot != boost::dynamic_bitset<>::npos; slot = affected.find_next(slot))
+            PublishBestCompatible(LfgQueueSlot(slot));
+    }
+
+    for (LfgQueueSlot slot : RemovedSlots)
+    {
+        SlotData& data = Slots[slot];
+        for (LfgRolesMap::const_iterator it = data.roles.begin(); it != data.roles.end(); ++it)
+            Ignores.erase(it->first);
+
+        data = SlotData();
+        FreeSlots.push_back(slot);
+    }
+
+    RemovedSlots.clear();
 }
 
 /**
-   Stores the compatibility of a list of guids
+   Stores the compatibility of a combination of slots
 
-   @param[in]     key String concatenation of guids (| used as separator)
+   @param[in]     key Sorted slots
    @param[in]     compatibles type of compatibility
 */
-void LFGQueue::SetCompatibles(std::string const& key, LfgCompatibility compatibles)
+void LFGQueue::SetCompatibles(LfgQueueSlotList const& key, LfgCompatibility compatibles)
 {
     LfgCompatibilityData& data = CompatibleMapStore[key];
     data.compatibility = compatibles;
 }
 
-void LFGQueue::SetCompatibilityData(std::string const& key, LfgCompatibilityData const& data)
+void LFGQueue::SetCompatibilityData(LfgQueueSlotList const& key, LfgCompatibilityData const& data)
 {
     CompatibleMapStore[key] = data;
 }
 
 /**
-   Get the compatibility of a group of guids
+   Get the compatibility of a combination of slots
 
-   @param[in]     key String concatenation of guids (| used as separator)
+   @param[in]     key Sorted slots
    @return LfgCompatibility type of compatibility
 */
-LfgCompatibility LFGQueue::GetCompatibles(std::string const& key)
+LfgCompatibility LFGQueue::GetCompatibles(LfgQueueSlotList const& key) const
 {
-    LfgCompatibleContainer::iterator itr = CompatibleMapStore.find(key);
+    LfgCompatibleContainer::const_iterator itr = CompatibleMapStore.find(key);
     if (itr != CompatibleMapStore.end())
         return itr->second.compatibility;
 
     return LFG_COMPATIBILITY_PENDING;
 }
 
-LfgCompatibilityData* LFGQueue::GetCompatibilityData(std::string const& key)
+uint8 LFGQueue::FindGroups()
 {
-    LfgCompatibleContainer::iterator itr = CompatibleMapStore.find(key);
-    if (itr != CompatibleMapStore.end())
-        return &(itr->second);
+    if (Matchmaking.valid() && Matchmaking.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+        return 0;
 
-    return nullptr;
+    // no pass is running from here on
+    ReloadChangedIgnores();
+
+    uint8 proposals = 0;
+    if (Matchmaking.valid())
+    {
+        MatchmakingPass pass = Matchmaking.get();
+        proposals = ApplyMatchmakingPass(pass);
+    }
+
+    ReleaseRemovedSlots();
+
+    if (newToQueueStore.empty())
+        return proposals;
+
+    std::vector<LfgQueueSlot> newSlots;
+    newSlots.reserve(newToQueueStore.size());
+    for (ObjectGuid guid : newToQueueStore)
+    {
+        LfgQueueDataContainer::iterator itQueue = QueueDataStore.find(guid);
+        if (itQueue == QueueDataStore.end())
+        {
+            TC_LOG_ERROR("lfg.queue.match.check.new", "Guid: [%s] is not queued but listed as queued!", guid.ToString().c_str());
+            continue;
+        }
+
+        if (itQueue->second.slot == LFG_QUEUE_SLOT_NONE)
+            itQueue->second.slot = AssignSlot(guid, itQueue->second);
+
+        newSlots.push_back(itQueue->second.slot);
+    }
+
+    // New groups belong to the matchmaker until the pass is collected
+    newToQueueStore.clear();
+
+    MatchmakingPass pass;
+    pass.current.reserve(currentQueueStore.size() + newSlots.size());
+    for (ObjectGuid guid : currentQueueStore)
+    {
+        LfgQueueDataContainer::iterator itQueue = QueueDataStore.find(guid);
+        if (itQueue == QueueDataStore.end())
+            continue;
+
+        if (itQueue->second.slot == LFG_QUEUE_SLOT_NONE)
+            itQueue->second.slot = AssignSlot(guid, itQueue->second);
+
+        pass.current.push_back(itQueue->second.slot);
+    }
+
+    for (LfgQueueSlot slot : newSlots)
+        RefreshSlot(slot);
+    for (LfgQueueSlot slot : pass.current)
+        RefreshSlot(slot);
+
+    std::packaged_task<MatchmakingPass()>* task = new std::packaged_task<MatchmakingPass()>(
+        [this, newSlots = std::move(newSlots), pass = std::move(pass)]() mutable { return Matchmake(std::move(newSlots), std::move(pass)); });
+    Matchmaking = task->get_future();
+
+    if (!MatchmakingWorker.joinable())
+        MatchmakingWorker = std::thread(&LFGQueue::MatchmakingThread, this);
+
+    MatchmakingTasks.Push(task);
+    return proposals;
 }
 
-uint8 LFGQueue::FindGroups()
+void LFGQueue::WaitForMatchmaking() const
 {
-    uint8 proposals = 0;
-    GuidList firstNew;
-    while (!newToQueueStore.empty())
+    if (Matchmaking.valid())
+        Matchmaking.wait();
+}
+
+void LFGQueue::MatchmakingThread()
+{
+    for (;;)
     {
-        ObjectGuid frontguid = newToQueueStore.front();
-        TC_LOG_DEBUG("lfg.queue.match.check.new", "Checking [%s] newToQueue(%u), currentQueue(%u)", frontguid.ToString().c_str(),
-            uint32(newToQueueStore.size()), uint32(currentQueueStore.size()));
+        std::packaged_task<MatchmakingPass()>* task = nullptr;
+        MatchmakingTasks.WaitAndPop(task);
 
-        firstNew.clear();
-        firstNew.push_back(frontguid);
-        RemoveFromNewQueue(frontguid);
+        // queue cancelled
+        if (!task)
+            return;
 
-        GuidList temporalList = currentQueueStore;
-        LfgCompatibility compatibles = FindNewGroups(firstNew, temporalList);
+        (*task)();
+        delete task;
+    }
+}
 
-        if (compatibles == LFG_COMPATIBLES_MATCH)
-            ++proposals;
+void LFGQueue::IgnoreListChanged(ObjectGuid guid)
+{
+    // players that were offline when queued are not checked for ignores at all
+    if (Ignores.count(guid))
+        ChangedIgnores.insert(guid);
+}
+
+/**
+   Reloads the ignore lists changed since the last pass started and forgets the cached
+   compatibility of every combination of slots containing their players
+*/
+void LFGQueue::ReloadChangedIgnores()
+{
+    if (ChangedIgnores.empty())
+        return;
+
+    boost::dynamic_bitset<> changed(Slots.size());
+    for (ObjectGuid guid : ChangedIgnores)
+    {
+        auto itr = Ignores.find(guid);
+        if (itr == Ignores.end())
+            continue;
+
+        itr->second.clear();
+        if (Player* player = ObjectAccessor::FindConnectedPlayer(guid))
+            player->GetSocial()->GetSocialsWithFlag(SOCIAL_FLAG_IGNORED, itr->second);
+
+        for (std::size_t slot = 0; slot < Slots.size(); ++slot)
+            if (Slots[slot].roles.count(guid))
+                changed.set(slot);
+    }
+
+    ChangedIgnores.clear();
+
+    if (changed.none())
+        return;
+
+    for (LfgCompatibleContainer::iterator itr = CompatibleMapStore.begin(); itr != CompatibleMapStore.end();)
+    {
+        if (std::any_of(itr->first.begin(), itr->first.end(), [&changed](LfgQueueSlot slot) { return changed.test(slot); }))
+            itr = CompatibleMapStore.erase(itr);
         else
-            AddToCurrentQueue(frontguid);                  // Lfg group not found, add this group to the queue.
+            ++itr;
     }
+}
+
+/**
+   Creates proposals for the groups found by a matchmaking pass if everyone is still queued
+
+   @param[in]     pass Finished matchmaking pass
+   @return Number of proposals created
+*/
+uint8 LFGQueue::ApplyMatchmakingPass(MatchmakingPass& pass)
+{
+    uint8 proposals = 0;
+    for (MatchedGroup const& match : pass.matches)
+    {
+        LfgProposal proposal(match.dungeonId);
+        for (LfgQueueSlot slot : match.slots)
+            proposal.queues.push_back(Slots[slot].guid);
+
+        bool stillQueued = std::all_of(match.slots.begin(), match.slots.end(), [this](LfgQueueSlot slot) { return HasSlot(slot); });
+        bool canPropose = stillQueued && sLFGMgr->AllQueued(proposal.queues);
+        // an ignore may have been added while the pass was running
+        bool hasIgnores = canPropose && HasIgnores(match.roles);
+        if (!canPropose || hasIgnores)
+        {
+            TC_LOG_DEBUG("lfg.queue.match.compatibility.check", "Guids: (%s) Group MATCH but can't create proposal!", GetDetailedMatchRoles(match.slots).c_str());
+            SetCompatibles(SortedKey(match.slots), hasIgnores ? LFG_INCOMPATIBLES_HAS_IGNORES : LFG_COMPATIBLES_BAD_STATES);
+
+            // Whoever is still queued goes back to the queue
+            for (LfgQueueSlot slot : match.slots)
+                if (HasSlot(slot) && std::find(currentQueueStore.begin(), currentQueueStore.end(), Slots[slot].guid) == currentQueueStore.end())
+                    AddToCurrentQueue(Slots[slot].guid);
+            continue;
+        }
+
+        // Store group so we don't need to call Mgr to get it later (if it's player group will be 0 otherwise would have joined as group)
+        LfgGroupsMap proposalGroups;
+        uint8 numLfgGroups = 0;
+        for (LfgQueueSlot slot : match.slots)
+        {
+            SlotData const& data = Slots[slot];
+            for (LfgRolesMap::const_iterator it = data.roles.begin(); it != data.roles.end(); ++it)
+                proposalGroups[it->first] = data.guid.IsGroup() ? data.guid : ObjectGuid::Empty;
+
+            if (!numLfgGroups && sLFGMgr->IsLfgGroup(data.guid))
+            {
+                proposal.group = data.guid;
+                ++numLfgGroups;
+            }
+        }
+
+        ObjectGuid gguid = proposal.queues.front();
+        proposal.isNew = numLfgGroups != 1 || sLFGMgr->GetOldState(gguid) != LFG_STATE_DUNGEON;
+
+        // Create a new proposal
+        proposal.cancelTime = GameTime::GetGameTime() + LFG_TIME_PROPOSAL;
+        proposal.state = LFG_PROPOSAL_INITIATING;
+        proposal.leader.Clear();
+
+        bool leader = false;
+        for (LfgRolesMap::const_iterator itRoles = match.roles.begin(); itRoles != match.roles.end(); ++itRoles)
+        {
+            // Assing new leader
+            if (itRoles->second & PLAYER_ROLE_LEADER)
+            {
+                if (!leader || !proposal.leader || urand(0, 1))
+                    proposal.leader = itRoles->first;
+                leader = true;
+            }
+            else if (!leader && (!proposal.leader || urand(0, 1)))
+                proposal.leader = itRoles->first;
+
+            // Assing player data and roles
+            LfgProposalPlayer &data = proposal.players[itRoles->first];
+            data.role = itRoles->second;
+            data.group = proposalGroups.find(itRoles->first)->second;
+            if (!proposal.isNew && data.group && data.group == proposal.group) // Player from existing group, autoaccept
+                data.accept = LFG_ANSWER_AGREE;
+        }
+
+        // Mark proposal members as not queued (but not remove queue data)
+        for (GuidList::const_iterator itQueue = proposal.queues.begin(); itQueue != proposal.queues.end(); ++itQueue)
+        {
+            ObjectGuid guid = (*itQueue);
+            RemoveFromNewQueue(guid);
+            RemoveFromCurrentQueue(guid);
+        }
+
+        sLFGMgr->AddProposal(proposal);
+        ++proposals;
+
+        TC_LOG_DEBUG("lfg.queue.match.compatibility.check", "Guids: (%s) MATCH! Group formed", GetDetailedMatchRoles(match.slots).c_str());
+    }
+
+    // Lfg group not found, add this group to the queue.
+    for (LfgQueueSlot slot : pass.unmatched)
+        if (HasSlot(slot))
+            AddToCurrentQueue(Slots[slot].guid);
+
+    for (LfgQueueSlot slot : pass.bestCompatibleChanged)
+        PublishBestCompatible(slot);
+
     return proposals;
 }
 
+void LFGQueue::PublishBestCompatible(LfgQueueSlot slot)
+{
+    if (!HasSlot(slot))
+        return;
+
+    SlotData const& data = Slots[slot];
+    LfgQueueData& queueData = QueueDataStore[data.guid];
+    queueData.tanks = data.neededTanks;
+    queueData.healers = data.neededHealers;
+    queueData.dps = data.neededDps;
+}
+
+/**
+   Matchmaking pass, runs outside of the world thread and only touches slots,
+   the compatibility cache and the pass itself
+
+   @param[in]     newSlots New groups to find a match for, in queue order
+   @param[in]     pass Pass holding the groups already in queue
+   @return Finished pass
+*/
+LFGQueue::MatchmakingPass LFGQueue::Matchmake(std::vector<LfgQueueSlot> newSlots, MatchmakingPass pass)
+{
+    LfgQueueSlotList check;
+    for (LfgQueueSlot slot : newSlots)
+    {
+        TC_LOG_DEBUG("lfg.queue.match.check.new", "Checking [%s] currentQueue(%u)", Slots[slot].guid.ToString().c_str(), uint32(pass.current.size()));
+
+        check.clear();
+        check.push_back(slot);
+
+        std::size_t nextCurrent = 0;
+        if (FindNewGroups(check, nextCurrent, pass) != LFG_COMPATIBLES_MATCH)
+        {
+            // Lfg group not found, add this group to the queue.
+            pass.current.push_back(slot);
+            pass.unmatched.push_back(slot);
+        }
+    }
+
+    return pass;
+}
+
 /**
    Checks que main queue to try to form a Lfg group. Returns first match found (if any)
 
-   @param[in]     check List of guids trying to match with other groups
-   @param[in]     all List of all other guids in main queue to match against
+   @param[in]     check List of slots trying to match with other groups
+   @param[in]     nextCurrent Position in the current queue of the next group to try
+   @param[in]     pass Running matchmaking pass
    @return LfgCompatibility type of compatibility between groups
 */
-LfgCompatibility LFGQueue::FindNewGroups(GuidList& check, GuidList& all)
+LfgCompatibility LFGQueue::FindNewGroups(LfgQueueSlotList& check, std::size_t& nextCurrent, MatchmakingPass& pass)
 {
-    std::string strGuids = ConcatenateGuids(check);
-    LfgCompatibility compatibles = GetCompatibles(strGuids);
+    LfgCompatibility compatibles = GetCompatibles(SortedKey(check));
 
-    TC_LOG_DEBUG("lfg.queue.match.check", "Guids: (%s): %s - all(%s)", GetDetailedMatchRoles(check).c_str(), GetCompatibleString(compatibles), GetDetailedMatchRoles(all).c_str());
+    TC_LOG_DEBUG("lfg.queue.match.check", "Guids: (%s): %s", GetDetailedMatchRoles(check).c_str(), GetCompatibleString(compatibles));
     if (compatibles == LFG_COMPATIBILITY_PENDING) // Not previously cached, calculate
-        compatibles = CheckCompatibility(check);
-
-    if (compatibles == LFG_COMPATIBLES_BAD_STATES && sLFGMgr->AllQueued(check))
+        compatibles = CheckCompatibility(check, pass);
+    else if (compatibles == LFG_COMPATIBLES_BAD_STATES && AllQueued(check))
     {
         TC_LOG_DEBUG("lfg.queue.match.check", "Guids: (%s) compatibles (cached) changed from bad states to match", GetDetailedMatchRoles(check).c_str());
-        SetCompatibles(strGuids, LFG_COMPATIBLES_MATCH);
-        return LFG_COMPATIBLES_MATCH;
+        compatibles = CheckCompatibility(check, pass);
     }
 
     if (compatibles != LFG_COMPATIBLES_WITH_LESS_PLAYERS)
         return compatibles;
 
     // Try to match with queued groups
-    while (!all.empty())
+    while (nextCurrent < pass.current.size())
     {
-        check.push_back(all.front());
-        all.pop_front();
-        LfgCompatibility subcompatibility = FindNewGroups(check, all);
+        check.push_back(pass.current[nextCurrent++]);
+        LfgCompatibility subcompatibility = FindNewGroups(check, nextCurrent, pass);
         if (subcompatibility == LFG_COMPATIBLES_MATCH)
             return LFG_COMPATIBLES_MATCH;
         check.pop_back();
@@ -373,18 +765,39 @@ LfgCompatibility LFGQueue::FindNewGroups(GuidList& check, GuidList& all)
     return compatibles;
 }
 
+bool LFGQueue::AllQueued(LfgQueueSlotList const& check) const
+{
+    return !check.empty() && std::all_of(check.begin(), check.end(), [this](LfgQueueSlot slot) { return Slots[slot].queued; });
+}
+
+bool LFGQueue::HasIgnore(ObjectGuid guid1, ObjectGuid guid2) const
+{
+    // only connected players have their ignore list stored
+    auto itr1 = Ignores.find(guid1);
+    auto itr2 = Ignores.find(guid2);
+    return itr1 != Ignores.end() && itr2 != Ignores.end() && (itr1->second.count(guid2) || itr2->second.count(guid1));
+}
+
+bool LFGQueue::HasIgnores(LfgRolesMap const& roles) const
+{
+    for (LfgRolesMap::const_iterator itr1 = roles.begin(); itr1 != roles.end(); ++itr1)
+        for (LfgRolesMap::const_iterator itr2 = std::next(itr1); itr2 != roles.end(); ++itr2)
+            if (HasIgnore(itr1->first, itr2->first))
+                return true;
+
+    return false;
+}
+
 /**
-   Check compatibilities between groups. If group is Matched proposal will be created
+   Check compatibilities between groups. If group is Matched it will be added to the pass
 
-   @param[in]     check List of guids to check compatibilities
+   @param[in]     check List of slots to check compatibilities
+   @param[in]     pass Running matchmaking pass
    @return LfgCompatibility type of compatibility
 */
-LfgCompatibility LFGQueue::CheckCompatibility(GuidList check)
+LfgCompatibility LFGQueue::CheckCompatibility(LfgQueueSlotList const& check, MatchmakingPass& pass)
 {
-    std::string strGuids = ConcatenateGuids(check);
-    LfgProposal proposal;
-    LfgDungeonSet proposalDungeons;
-    LfgGroupsMap proposalGroups;
+    LfgQueueSlotList const key = SortedKey(check);
     LfgRolesMap proposalRoles;
 
     // Check for correct size
@@ -397,112 +810,85 @@ LfgCompatibility LFGQueue::CheckCompatibility(GuidList check)
     // Check all-but-new compatiblitity
     if (check.size() > 2)
     {
-        ObjectGuid frontGuid = check.front();
-        check.pop_front();
-
         // Check all-but-new compatibilities (New, A, B, C, D) --> check(A, B, C, D)
-        LfgCompatibility child_compatibles = CheckCompatibility(check);
+        LfgQueueSlotList childCheck(check.begin() + 1, check.end());
+        LfgCompatibility child_compatibles = GetCompatibles(SortedKey(childCheck));
+        if (child_compatibles == LFG_COMPATIBILITY_PENDING)
+            child_compatibles = CheckCompatibility(childCheck, pass);
+
         if (child_compatibles < LFG_COMPATIBLES_WITH_LESS_PLAYERS) // Group not compatible
         {
-            TC_LOG_DEBUG("lfg.queue.match.compatibility.check", "Guids: (%s) child %s not compatibles", strGuids.c_str(), GetDetailedMatchRoles(check).c_str());
-            SetCompatibles(strGuids, child_compatibles);
+            TC_LOG_DEBUG("lfg.queue.match.compatibility.check", "Guids: (%s) child %s not compatibles", GetDetailedMatchRoles(check).c_str(), GetDetailedMatchRoles(childCheck).c_str());
+            SetCompatibles(key, child_compatibles);
             return child_compatibles;
         }
-        check.push_front(frontGuid);
     }
 
-    std::ostringstream o;
-
     // Find compatible dungeons
-    if (check.size() > 1)
-    {
-        GuidList::iterator itguid = check.begin();
-        proposalDungeons = QueueDataStore[*itguid].dungeons;
-
-        for (++itguid; itguid != check.end(); ++itguid)
-        {
-            LfgDungeonSet temporal;
-            LfgDungeonSet& dungeons = QueueDataStore[*itguid].dungeons;
-
-            std::set_intersection(proposalDungeons.begin(), proposalDungeons.end(), dungeons.begin(), dungeons.end(), std::inserter(temporal, temporal.begin()));
-            proposalDungeons = temporal;
-        }
-    }
-    else
-    {
-        proposalDungeons = QueueDataStore[check.front()].dungeons;
-    }
+    boost::dynamic_bitset<> proposalDungeons = Slots[check.front()].dungeons;
+    for (LfgQueueSlotList::const_iterator itr = check.begin() + 1; itr != check.end(); ++itr)
+        proposalDungeons &= Slots[*itr].dungeons;
 
+    uint32 dungeonId = 0;
     LFGDungeonData const* dungeon = nullptr;
     do
     {
-        if (proposalDungeons.empty())
+        std::size_t count = proposalDungeons.count();
+        if (!count)
         {
-            TC_LOG_DEBUG("lfg.queue.match.compatibility.check", "LFGQueue::CheckCompatibility: (%s) No compatible dungeons%s", strGuids.c_str(), o.str().c_str());
-            SetCompatibles(strGuids, LFG_INCOMPATIBLES_NO_DUNGEONS);
+            TC_LOG_DEBUG("lfg.queue.match.compatibility.check", "LFGQueue::CheckCompatibility: (%s) No compatible dungeons", GetDetailedMatchRoles(check).c_str());
+            SetCompatibles(key, LFG_INCOMPATIBLES_NO_DUNGEONS);
             return LFG_INCOMPATIBLES_NO_DUNGEONS;
         }
 
-        proposal.dungeonId = Trinity::Containers::SelectRandomContainerElement(proposalDungeons);
-        proposalDungeons.erase(proposal.dungeonId);
-        dungeon = sLFGMgr->GetLFGDungeon(proposal.dungeonId);
+        std::size_t index = proposalDungeons.find_first();
+        for (uint32 skip = urand(0, uint32(count) - 1); skip; --skip)
+            index = proposalDungeons.find_next(index);
+
+        proposalDungeons.reset(index);
+        dungeonId = DungeonIds[index];
+        dungeon = sLFGMgr->GetLFGDungeon(dungeonId);
     } while (!dungeon);
 
     // Check for correct size
     if (check.size() > dungeon->GetMaxGroupSize())
     {
-        TC_LOG_DEBUG("lfg.queue.match.compatibility.check", "LFGQueue::CheckCompatibility: (%s): Size wrong - Not compatibles", strGuids.c_str());
+        TC_LOG_DEBUG("lfg.queue.match.compatibility.check", "LFGQueue::CheckCompatibility: (%s): Size wrong - Not compatibles", GetDetailedMatchRoles(check).c_str());
         return LFG_INCOMPATIBLES_WRONG_GROUP_SIZE;
     }
 
     // Check if more than one LFG group and number of players joining
     uint8 numPlayers = 0;
     uint8 numLfgGroups = 0;
-    for (GuidList::const_iterator it = check.begin(); it != check.end() && numLfgGroups < 1 && numPlayers <= dungeon->GetMaxGroupSize(); ++it)
+    for (LfgQueueSlotList::const_iterator it = check.begin(); it != check.end() && numLfgGroups < 1 && numPlayers <= dungeon->GetMaxGroupSize(); ++it)
     {
-        ObjectGuid guid = *it;
-        LfgQueueDataContainer::iterator itQueue = QueueDataStore.find(guid);
-        if (itQueue == QueueDataStore.end())
-        {
-            TC_LOG_ERROR("lfg.queue.match.compatibility.check", "Guid: [%s] is not queued but listed as queued!", guid.ToString().c_str());
-            RemoveFromQueue(guid);
-            return LFG_COMPATIBILITY_PENDING;
-        }
+        SlotData const& data = Slots[*it];
+        numPlayers += data.roles.size();
 
-        // Store group so we don't need to call Mgr to get it later (if it's player group will be 0 otherwise would have joined as group)
-        for (LfgRolesMap::const_iterator it2 = itQueue->second.roles.begin(); it2 != itQueue->second.roles.end(); ++it2)
-            proposalGroups[it2->first] = itQueue->first.IsGroup() ? itQueue->first : ObjectGuid::Empty;
-
-        numPlayers += itQueue->second.roles.size();
-
-        if (sLFGMgr->IsLfgGroup(guid))
-        {
-            if (!numLfgGroups)
-                proposal.group = guid;
+        if (data.lfgGroup)
             ++numLfgGroups;
-        }
     }
 
     if (numLfgGroups > 1)
     {
         TC_LOG_DEBUG("lfg.queue.match.compatibility.check", "Guids: (%s) More than one Lfggroup (%u)", GetDetailedMatchRoles(check).c_str(), numLfgGroups);
-        SetCompatibles(strGuids, LFG_INCOMPATIBLES_MULTIPLE_LFG_GROUPS);
+        SetCompatibles(key, LFG_INCOMPATIBLES_MULTIPLE_LFG_GROUPS);
         return LFG_INCOMPATIBLES_MULTIPLE_LFG_GROUPS;
     }
 
     if (numPlayers > dungeon->GetMaxGroupSize())
     {
         TC_LOG_DEBUG("lfg.queue.match.compatibility.check", "Guids: (%s) Too many players (%u)", GetDetailedMatchRoles(check).c_str(), numPlayers);
-        SetCompatibles(strGuids, LFG_INCOMPATIBLES_TOO_MUCH_PLAYERS);
+        SetCompatibles(key, LFG_INCOMPATIBLES_TOO_MUCH_PLAYERS);
         return LFG_INCOMPATIBLES_TOO_MUCH_PLAYERS;
     }
 
     // If it's single group no need to check for duplicate players, ignores, bad roles or bad dungeons as it's been checked before joining
     if (check.size() > 1)
     {
-        for (GuidList::const_iterator it = check.begin(); it != check.end(); ++it)
+        for (LfgQueueSlot slot : check)
         {
-            LfgRolesMap const& roles = QueueDataStore[(*it)].roles;
+            LfgRolesMap const& roles = Slots[slot].roles;
             for (LfgRolesMap::const_iterator itRoles = roles.begin(); itRoles != roles.end(); ++itRoles)
             {
                 LfgRolesMap::const_iterator itPlayer;
@@ -510,7 +896,7 @@ LfgCompatibility LFGQueue::CheckCompatibility(GuidList check)
                 {
                     if (itRoles->first == itPlayer->first)
                         TC_LOG_ERROR("lfg.queue.match.compatibility.check", "Guids: ERROR! Player multiple times in queue! [%s]", itRoles->first.ToString().c_str());
-                    else if (sLFGMgr->HasIgnore(itRoles->first, itPlayer->first))
+                    else if (HasIgnore(itRoles->first, itPlayer->first))
                         break;
                 }
                 if (itPlayer == proposalRoles.end())
@@ -521,25 +907,25 @@ LfgCompatibility LFGQueue::CheckCompatibility(GuidList check)
         if (uint8 playersize = numPlayers - proposalRoles.size())
         {
             TC_LOG_DEBUG("lfg.queue.match.compatibility.check", "Guids: (%s) not compatible, %u players are ignoring each other", GetDetailedMatchRoles(check).c_str(), playersize);
-            SetCompatibles(strGuids, LFG_INCOMPATIBLES_HAS_IGNORES);
+            SetCompatibles(key, LFG_INCOMPATIBLES_HAS_IGNORES);
             return LFG_INCOMPATIBLES_HAS_IGNORES;
         }
 
         LfgRolesMap debugRoles = proposalRoles;
-        if (!LFGMgr::CheckGroupRoles(proposalRoles, dungeon))
+        if (!CanFitRoles(proposalRoles, dungeon) || !LFGMgr::CheckGroupRoles(proposalRoles, dungeon))
         {
             std::ostringstream o;
             for (LfgRolesMap::const_iterator it = debugRoles.begin(); it != debugRoles.end(); ++it)
                 o << ", " << it->first.GetRawValue() << ": " << GetRolesString(it->second);
 
             TC_LOG_DEBUG("lfg.queue.match.compatibility.check", "Guids: (%s) Roles not compatible%s", GetDetailedMatchRoles(check).c_str(), o.str().c_str());
-            SetCompatibles(strGuids, LFG_INCOMPATIBLES_NO_ROLES);
+            SetCompatibles(key, LFG_INCOMPATIBLES_NO_ROLES);
             return LFG_INCOMPATIBLES_NO_ROLES;
         }
     }
     else
     {
-        proposalRoles = QueueDataStore[check.front()].roles;
+        proposalRoles = Slots[check.front()].roles;
         LFGMgr::CheckGroupRoles(proposalRoles, dungeon);    // assign new roles
     }
 
@@ -550,62 +936,36 @@ LfgCompatibility LFGQueue::CheckCompatibility(GuidList check)
         LfgCompatibilityData data(LFG_COMPATIBLES_WITH_LESS_PLAYERS);
         data.roles = proposalRoles;
 
-        for (GuidList::const_iterator itr = check.begin(); itr != check.end(); ++itr)
-            UpdateBestCompatibleInQueue(QueueDataStore.find(*itr), strGuids, data.roles);
+        for (LfgQueueSlot slot : check)
+            if (UpdateBestCompatibleInQueue(slot, key, data.roles))
+                pass.bestCompatibleChanged.push_back(slot);
 
-        SetCompatibilityData(strGuids, data);
+        SetCompatibilityData(key, data);
         return LFG_COMPATIBLES_WITH_LESS_PLAYERS;
     }
 
-    ObjectGuid gguid = check.front();
-    proposal.queues = check;
-    proposal.isNew = numLfgGroups != 1 || sLFGMgr->GetOldState(gguid) != LFG_STATE_DUNGEON;
-
-    if (!sLFGMgr->AllQueued(check))
+    if (!AllQueued(check))
     {
         TC_LOG_DEBUG("lfg.queue.match.compatibility.check", "Guids: (%s) Group MATCH but can't create proposal!", GetDetailedMatchRoles(check).c_str());
-        SetCompatibles(strGuids, LFG_COMPATIBLES_BAD_STATES);
+        SetCompatibles(key, LFG_COMPATIBLES_BAD_STATES);
         return LFG_COMPATIBLES_BAD_STATES;
     }
 
-    // Create a new proposal
-    proposal.cancelTime = GameTime::GetGameTime() + LFG_TIME_PROPOSAL;
-    proposal.state = LFG_PROPOSAL_INITIATING;
-    proposal.leader.Clear();
-
-    bool leader = false;
-    for (LfgRolesMap::const_iterator itRoles = proposalRoles.begin(); itRoles != proposalRoles.end(); ++itRoles)
+    // Proposal is created by the world thread, members can't be matched again in this pass
+    for (LfgQueueSlot slot : check)
     {
-        // Assing new leader
-        if (itRoles->second & PLAYER_ROLE_LEADER)
-        {
-            if (!leader || !proposal.leader || urand(0, 1))
-                proposal.leader = itRoles->first;
-            leader = true;
-        }
-        else if (!leader && (!proposal.leader || urand(0, 1)))
-            proposal.leader = itRoles->first;
-
-        // Assing player data and roles
-        LfgProposalPlayer &data = proposal.players[itRoles->first];
-        data.role = itRoles->second;
-        data.group = proposalGroups.find(itRoles->first)->second;
-        if (!proposal.isNew && data.group && data.group == proposal.group) // Player from existing group, autoaccept
-            data.accept = LFG_ANSWER_AGREE;
-    }
-
-    // Mark proposal members as not queued (but not remove queue data)
-    for (GuidList::const_iterator itQueue = proposal.queues.begin(); itQueue != proposal.queues.end(); ++itQueue)
-    {
-        ObjectGuid guid = (*itQueue);
-        RemoveFromNewQueue(guid);
-        RemoveFromCurrentQueue(guid);
+        pass.current.erase(std::remove(pass.current.begin(), pass.current.end(), slot), pass.current.end());
+        pass.unmatched.erase(std::remove(pass.unmatched.begin(), pass.unmatched.end(), slot), pass.unmatched.end());
     }
 
-    sLFGMgr->AddProposal(proposal);
+    MatchedGroup match;
+    match.slots = check;
+    match.dungeonId = dungeonId;
+    match.roles = std::move(proposalRoles);
+    pass.matches.push_back(std::move(match));
 
-    TC_LOG_DEBUG("lfg.queue.match.compatibility.check", "Guids: (%s) MATCH! Group formed", GetDetailedMatchRoles(check).c_str());
-    SetCompatibles(strGuids, LFG_COMPATIBLES_MATCH);
+    TC_LOG_DEBUG("lfg.queue.match.compatibility.check", "Guids: (%s) MATCH! Group found", GetDetailedMatchRoles(check).c_str());
+    SetCompatibles(key, LFG_COMPATIBLES_MATCH);
     return LFG_COMPATIBLES_MATCH;
 }
 
@@ -654,9 +1014,7 @@ void LFGQueue::UpdateQueueTimers(uint8 queueId, time_t currTime, LfgQueueRoleCon
                 break;
         }
 
-        if (queueinfo.bestCompatible.empty())
-            FindBestCompatibleInQueue(itQueue);
-
+        // Needed roles are published by the matchmaker (see PublishBestCompatible)
         LfgQueueStatusData queueData(queueId, dungeonId, waitTime, wtAvg, wtTank, wtHealer, wtDps, queuedTime, queueinfo.tanks, queueinfo.healers, queueinfo.dps);
         for (LfgRolesMap::const_iterator itPlayer = queueinfo.roles.begin(); itPlayer != queueinfo.roles.end(); ++itPlayer)
         {
@@ -703,12 +1061,22 @@ std::string LFGQueue::DumpQueueInfo() const
 
 std::string LFGQueue::DumpCompatibleInfo(bool full /* = false */) const
 {
+    // the cache belongs to the matchmaker while a pass is running
+    WaitForMatchmaking();
+
     std::ostringstream o;
     o << "Compatible Map size: " << CompatibleMapStore.size() << "\n";
     if (full)
         for (LfgCompatibleContainer::const_iterator itr = CompatibleMapStore.begin(); itr != CompatibleMapStore.end(); ++itr)
         {
-            o << "(" << itr->first << "): " << GetCompatibleString(itr->second.compatibility);
+            o << "(";
+            for (LfgQueueSlotList::const_iterator itSlot = itr->first.begin(); itSlot != itr->first.end(); ++itSlot)
+            {
+                if (itSlot != itr->first.begin())
+                    o << "|";
+                o << Slots[*itSlot].guid.GetRawValue();
+            }
+            o << "): " << GetCompatibleString(itr->second.compatibility);
             if (!itr->second.roles.empty())
             {
                 o << " (";
@@ -728,50 +1096,40 @@ std::string LFGQueue::DumpCompatibleInfo(bool full /* = false */) const
     return o.str();
 }
 
-void LFGQueue::FindBestCompatibleInQueue(LfgQueueDataContainer::iterator itrQueue)
-{
-    TC_LOG_DEBUG("lfg.queue.compatibles.find", "%s", itrQueue->first.ToString().c_str());
-    std::ostringstream o;
-    o << itrQueue->first.GetRawValue();
-    std::string sguid = o.str();
-
-    for (LfgCompatibleContainer::const_iterator itr = CompatibleMapStore.begin(); itr != CompatibleMapStore.end(); ++itr)
-    {
-        if (itr->second.compatibility == LFG_COMPATIBLES_WITH_LESS_PLAYERS && std::string::npos != itr->first.find(sguid))
-        {
-            UpdateBestCompatibleInQueue(itrQueue, itr->first, itr->second.roles);
-        }
-    }
-}
+/**
+   Stores key as best compatible group of slot if it has more groups than the current one
 
-void LFGQueue::UpdateBestCompatibleInQueue(LfgQueueDataContainer::iterator itrQueue, std::string const& key, LfgRolesMap const& roles)
+   @param[in]     slot Slot to update
+   @param[in]     key Sorted slots of the compatible group
+   @param[in]     roles Roles assigned in the compatible group
+   @return True if the best compatible group changed
+*/
+bool LFGQueue::UpdateBestCompatibleInQueue(LfgQueueSlot slot, LfgQueueSlotList const& key, LfgRolesMap const& roles)
 {
-    LfgQueueData& queueData = itrQueue->second;
-
-    uint8 storedSize = queueData.bestCompatible.empty() ? 0 :
-        std::count(queueData.bestCompatible.begin(), queueData.bestCompatible.end(), '|') + 1;
-
-    uint8 size = std::count(key.begin(), key.end(), '|') + 1;
-
-    if (size <= storedSize)
-        return;
+    SlotData& data = Slots[slot];
+    if (key.size() <= data.bestCompatible.size())
+        return false;
 
     TC_LOG_DEBUG("lfg.queue.compatibles.update", "Changed (%s) to (%s) as best compatible group for %s",
-        queueData.bestCompatible.c_str(), key.c_str(), itrQueue->first.ToString().c_str());
+        GetDetailedMatchRoles(data.bestCompatible).c_str(), GetDetailedMatchRoles(key).c_str(), data.guid.ToString().c_str());
 
-    queueData.bestCompatible = key;
-    queueData.InitializeGroupSetup();
+    data.bestCompatible = key;
+    data.neededTanks = data.tanks;
+    data.neededHealers = data.healers;
+    data.neededDps = data.dps;
 
     for (LfgRolesMap::const_iterator it = roles.begin(); it != roles.end(); ++it)
     {
         uint8 role = it->second;
         if (role & PLAYER_ROLE_TANK)
-            --queueData.tanks;
+            --data.neededTanks;
         else if (role & PLAYER_ROLE_HEALER)
-            --queueData.healers;
+            --data.neededHealers;
         else
-            --queueData.dps;
+            --data.neededDps;
     }
+
+    return true;
 }
 
 } // namespace lfg
@@ -19,6 +19,13 @@
 #define _LFGQUEUE_H
 
 #include "LFG.h"
+#include "ProducerConsumerQueue.h"
+#include <boost/container/small_vector.hpp>
+#include <boost/dynamic_bitset.hpp>
+#include <future>
+#include <thread>
+#include <unordered_map>
+#include <vector>
 
 namespace lfg
 {
@@ -37,6 +44,18 @@ enum LfgCompatibility
     LFG_COMPATIBLES_MATCH                                  // Must be the last one
 };
 
+/// Dense index of a queued player or group, reused once it leaves the queue
+typedef uint32 LfgQueueSlot;
+LfgQueueSlot const LFG_QUEUE_SLOT_NONE = 0xFFFFFFFF;
+
+/// Slots of a combination of queued players/groups, sized to avoid allocations for 5 man dungeons
+typedef boost::container::small_vector<LfgQueueSlot, 5> LfgQueueSlotList;
+
+struct LfgQueueSlotListHash
+{
+    std::size_t operator()(LfgQueueSlotList const& slots) const;
+};
+
 struct LfgCompatibilityData
 {
     LfgCompatibilityData(): compatibility(LFG_COMPATIBILITY_PENDING) { }
@@ -54,7 +73,7 @@ struct LfgQueueData
     LfgQueueData();
 
     LfgQueueData(time_t _joinTime, LfgDungeonSet const& _dungeons, LfgRolesMap const& _roles) :
-        joinTime(_joinTime), dungeons(_dungeons), roles(_roles)
+        joinTime(_joinTime), dungeons(_dungeons), roles(_roles), slot(LFG_QUEUE_SLOT_NONE)
     {
         InitializeGroupSetup();
     }
@@ -65,7 +84,7 @@ struct LfgQueueData
     uint8 dps;                                             ///< Dps needed
     LfgDungeonSet dungeons;                                ///< Selected Player/Group Dungeon/s
     LfgRolesMap roles;                                     ///< Selected Player Role/s
-    std::string bestCompatible;                            ///< Best compatible combination of people queued
+    LfgQueueSlot slot;                                     ///< Matchmaking slot, assigned when first matched
 
     void InitializeGroupSetup();
 };
@@ -86,19 +105,27 @@ struct LfgQueueRoleData
 };
 
 typedef std::map<uint32, LfgWaitTime> LfgWaitTimesContainer;
-typedef std::map<std::string, LfgCompatibilityData> LfgCompatibleContainer;
+typedef std::unordered_map<LfgQueueSlotList, LfgCompatibilityData, LfgQueueSlotListHash> LfgCompatibleContainer;
 typedef std::map<ObjectGuid, LfgQueueData> LfgQueueDataContainer;
 typedef std::map<uint32, LfgQueueRoleData> LfgQueueRoleContainer;
 
 /**
     Stores all data related to queue
+
+    Matchmaking runs on a matchmaking thread owned by the queue, on a snapshot of the queued players/groups
+    (slots). While a pass is running the world thread only touches the queue lists and QueueDataStore, slots
+    of players leaving the queue are released and changed ignore lists reloaded once the pass is collected.
 */
 class TC_GAME_API LFGQueue
 {
     public:
+        LFGQueue();
+        ~LFGQueue();
+
+        LFGQueue(LFGQueue const&) = delete;
+        LFGQueue& operator=(LFGQueue const&) = delete;
 
         // Add/Remove from queue
-        std::string GetDetailedMatchRoles(GuidList const& check) const;
         void AddToQueue(ObjectGuid guid, bool reAdd = false);
         void RemoveFromQueue(ObjectGuid guid);
         void AddQueueData(ObjectGuid guid, time_t joinTime, LfgDungeonSet const& dungeons, LfgRolesMap const& rolesMap);
@@ -114,15 +141,54 @@ class TC_GAME_API LFGQueue
         void UpdateQueueTimers(uint8 queueId, time_t currTime, LfgQueueRoleContainer& rolesPerDungeonId);
         time_t GetJoinTime(ObjectGuid guid) const;
 
-        // Find new group
+        // Collects the previous matchmaking pass and starts a new one, returns number of proposals created
         uint8 FindGroups();
+        // Blocks until the running matchmaking pass (if any) is done, must be called before dungeon data is reloaded
+        void WaitForMatchmaking() const;
+        // Queued player added or removed an ignore, reloaded before the next pass
+        void IgnoreListChanged(ObjectGuid guid);
 
         // Just for debugging purposes
         std::string DumpQueueInfo() const;
         std::string DumpCompatibleInfo(bool full = false) const;
 
     private:
-        void SetQueueUpdateData(std::string const& strGuids, LfgRolesMap const& proposalRoles);
+        /// Snapshot of a queued player/group, only touched by the matchmaker or while no pass is running
+        struct SlotData
+        {
+            SlotData() : tanks(0), healers(0), dps(0), neededTanks(0), neededHealers(0), neededDps(0), lfgGroup(false), queued(false) { }
+
+            ObjectGuid guid;
+            boost::dynamic_bitset<> dungeons;              ///< Indexes in DungeonIds
+            LfgRolesMap roles;
+            uint8 tanks;                                   ///< Roles required by the first selected dungeon
+            uint8 healers;
+            uint8 dps;
+            LfgQueueSlotList bestCompatible;               ///< Best compatible combination of people queued
+            uint8 neededTanks;                             ///< Roles still missing in bestCompatible
+            uint8 neededHealers;
+            uint8 neededDps;
+            bool lfgGroup;
+            bool queued;                                   ///< In LFG_STATE_QUEUED when the pass started
+        };
+
+        /// Compatible combination with enough players found by the matchmaker
+        struct MatchedGroup
+        {
+            LfgQueueSlotList slots;                        ///< In check order, first one is the newly queued
+            uint32 dungeonId;
+            LfgRolesMap roles;                             ///< Roles assigned to every player
+        };
+
+        struct MatchmakingPass
+        {
+            std::vector<LfgQueueSlot> current;             ///< Ordered slots to match against
+            std::vector<LfgQueueSlot> unmatched;           ///< New slots to append to current queue
+            std::vector<MatchedGroup> matches;
+            std::vector<LfgQueueSlot> bestCompatibleChanged;
+        };
+
+        std::string GetDetailedMatchRoles(LfgQueueSlotList const& check) const;
 
         void AddToNewQueue(ObjectGuid guid);
         void AddToCurrentQueue(ObjectGuid guid);
@@ -130,21 +196,40 @@ class TC_GAME_API LFGQueue
         void RemoveFromNewQueue(ObjectGuid guid);
         void RemoveFromCurrentQueue(ObjectGuid guid);
 
-        void SetCompatibles(std::string const& key, LfgCompatibility compatibles);
-        LfgCompatibility GetCompatibles(std::string const& key);
-        void RemoveFromCompatibles(ObjectGuid guid);
-
-        void SetCompatibilityData(std::string const& key, LfgCompatibilityData const& compatibles);
-        LfgCompatibilityData* GetCompatibilityData(std::string const& key);
-        void FindBestCompatibleInQueue(LfgQueueDataContainer::iterator itrQueue);
-        void UpdateBestCompatibleInQueue(LfgQueueDataContainer::iterator itrQueue, std::string const& key, LfgRolesMap const& roles);
-
-        LfgCompatibility FindNewGroups(GuidList& check, GuidList& all);
-        LfgCompatibility CheckCompatibility(GuidList check);
+        // Slots, world thread while no pass is running
+        LfgQueueSlot AssignSlot(ObjectGuid guid, LfgQueueData const& queueData);
+        void RefreshSlot(LfgQueueSlot slot);
+        void ReleaseRemovedSlots();
+        void ReloadChangedIgnores();
+        uint8 ApplyMatchmakingPass(MatchmakingPass& pass);
+        void PublishBestCompatible(LfgQueueSlot slot);
+        bool HasSlot(LfgQueueSlot slot) const;
+
+        // Matchmaker
+        void MatchmakingThread();
+        MatchmakingPass Matchmake(std::vector<LfgQueueSlot> newSlots, MatchmakingPass pass);
+        LfgCompatibility FindNewGroups(LfgQueueSlotList& check, std::size_t& nextCurrent, MatchmakingPass& pass);
+        LfgCompatibility CheckCompatibility(LfgQueueSlotList const& check, MatchmakingPass& pass);
+        bool AllQueued(LfgQueueSlotList const& check) const;
+        bool HasIgnore(ObjectGuid guid1, ObjectGuid guid2) const;
+        bool HasIgnores(LfgRolesMap const& roles) const;
+
+        void SetCompatibles(LfgQueueSlotList const& key, LfgCompatibility compatibles);
+        LfgCompatibility GetCompatibles(LfgQueueSlotList const& key) const;
+        void SetCompatibilityData(LfgQueueSlotList const& key, LfgCompatibilityData const& compatibles);
+        bool UpdateBestCompatibleInQueue(LfgQueueSlot slot, LfgQueueSlotList const& key, LfgRolesMap const& roles);
 
         // Queue
         LfgQueueDataContainer QueueDataStore;              ///< Queued groups
-        LfgCompatibleContainer CompatibleMapStore;         ///< Compatible dungeons
+        LfgCompatibleContainer CompatibleMapStore;         ///< Compatible dungeons, keyed by sorted slots
+
+        std::vector<SlotData> Slots;                       ///< Matchmaking snapshot of queued groups
+        std::vector<LfgQueueSlot> FreeSlots;               ///< Released slots, reused before growing Slots
+        std::vector<LfgQueueSlot> RemovedSlots;            ///< Slots left the queue, released when no pass is running
+        std::unordered_map<uint32, uint32> DungeonIndexes; ///< Dungeon id -> bit in SlotData::dungeons
+        std::vector<uint32> DungeonIds;                    ///< Bit in SlotData::dungeons -> dungeon id
+        std::unordered_map<ObjectGuid, GuidUnorderedSet> Ignores; ///< Ignore lists of connected queued players
+        GuidUnorderedSet ChangedIgnores;                   ///< Players in Ignores whose ignore list changed since the pass started
 
         LfgWaitTimesContainer waitTimesAvgStore;           ///< Average wait time to find a group queuing as multiple roles
         LfgWaitTimesContainer waitTimesTankStore;          ///< Average wait time to find a group queuing as tank
@@ -152,6 +237,10 @@ class TC_GAME_API LFGQueue
         LfgWaitTimesContainer waitTimesDpsStore;           ///< Average wait time to find a group queuing as dps
         GuidList currentQueueStore;                        ///< Ordered list. Used to find groups
         GuidList newToQueueStore;                          ///< New groups to add to queue
+
+        std::future<MatchmakingPass> Matchmaking;          ///< Running matchmaking pass
+        ProducerConsumerQueue<std::packaged_task<MatchmakingPass()>*> MatchmakingTasks;
+        std::thread MatchmakingWorker;                     ///< Started with the first pass
 };
 
 } // namespace lfg
@@ -272,7 +272,8 @@ m_respawnDelay(300), m_corpseDelay(60), m_respawnradius(0.0f), m_boundaryCheckTi
 m_defaultMovementType(IDLE_MOTION_TYPE), m_spawnId(0), m_equipmentId(0), m_originalEquipmentId(0), m_AlreadyCallAssistance(false),
 m_AlreadySearchedAssistance(false), m_regenHealth(true), m_cannotReachTarget(false), m_cannotReachTimer(0), m_meleeDamageSchoolMask(SPELL_SCHOOL_MASK_NORMAL),
 m_originalEntry(0), m_homePosition(), m_transportHomePosition(), m_creatureInfo(nullptr), m_creatureData(nullptr), _waypointPathId(0), _currentWaypointNodeInfo(0, 0), _cyclicSplinePathId(0),
-m_formation(nullptr), m_triggerJustAppeared(true), m_respawnCompatibilityMode(false), _lastDamagedTime(0), _isMissingSwimmingFlagOutOfCombat(false), _noNpcDamageBelowPctHealth(0.f)
+m_formation(nullptr), m_triggerJustAppeared(true), m_respawnCompatibilityMode(false), _lastDamagedTime(0), _isMissingSwimmingFlagOutOfCombat(false), _noNpcDamageBelowPctHealth(0.f),
+_updateStateSlot(CreatureUpdateStates::InvalidSlot)
 {
     m_valuesCount = UNIT_END;
 
@@ -302,6 +303,7 @@ void Creature::AddToWorld()
         UpdatePowerRegeneration(GetPowerType());
 
         Unit::AddToWorld();
+        AddToUpdateStates();
         SearchFormation();
         AIM_Initialize();
         if (IsVehicle())
@@ -324,6 +326,8 @@ void Creature::RemoveFromWorld()
 
         Unit::RemoveFromWorld();
 
+        RemoveFromUpdateStates();
+
         if (m_spawnId)
             Trinity::Containers::MultimapErasePair(GetMap()->GetCreatureBySpawnIdStore(), m_spawnId, this);
 
@@ -842,6 +846,84 @@ void Creature::Update(uint32 diff)
     }
 }
 
+uint8 Creature::GetUpdateState(uint32& idleTime) const
+{
+    uint8 flags = 0;
+    if (IsEngaged() || IsInCombat())
+        flags |= CREATURE_UPDATE_STATE_ENGAGED;
+    if (IsInEvadeMode())
+        flags |= CREATURE_UPDATE_STATE_EVADING;
+    if (!movespline->Finalized() || GetMotionMaster()->GetCurrentMovementGeneratorType() != IDLE_MOTION_TYPE)
+        flags |= CREATURE_UPDATE_STATE_MOVING;
+
+    bool busy = m_deathState != ALIVE || !IsAIEnabled() || !AI()->CanSkipIdleUpdates() || IsSummon() || IsCharmed() || GetVehicleKit() || GetVehicle()
+        || m_triggerJustAppeared || _spellFocusInfo.ReacquiringTargetDelay || HasScheduledAIChange() || m_Events.HasEvents()
+        || GetVictim() || !GetTarget().IsEmpty() || !m_removedAuras.empty();
+
+    for (uint32 i = 0; i < CURRENT_MAX_SPELL && !busy; ++i)
+        if (GetCurrentSpell(i))
+            busy = true;
+
+    // permanent auras without periodic effects are left alone by their updates,
+    // area auras pick their targets in them
+    for (AuraMap::const_iterator itr = m_ownedAuras.begin(); itr != m_ownedAuras.end() && !busy; ++itr)
+    {
+        Aura const* aura = itr->second;
+        if (!aura->IsPermanent() || aura->IsArea())
+            busy = true;
+
+        for (uint8 i = 0; i < MAX_SPELL_EFFECTS && !busy; ++i)
+            if (AuraEffect const* effect = aura->GetEffect(i))
+                if (effect->IsPeriodic())
+                    busy = true;
+    }
+
+    if (busy)
+        flags |= CREATURE_UPDATE_STATE_BUSY;
+
+    if (flags)
+        return flags;
+
+    idleTime = sWorld->getIntConfig(CONFIG_CREATURE_IDLE_UPDATE_DELAY);
+    if (!idleTime)
+        return CREATURE_UPDATE_STATE_BUSY;
+
+    // keep the regeneration ticks on time
+    if (GetHealth() < GetMaxHealth())
+    {
+        flags |= CREATURE_UPDATE_STATE_REGENERATING;
+        idleTime = std::min<uint32>(idleTime, std::max<int32>(_healthRegenerationTimer, 0));
+    }
+
+    if (GetPower(GetPowerType()) < GetMaxPower(GetPowerType()))
+    {
+        flags |= CREATURE_UPDATE_STATE_REGENERATING;
+        idleTime = std::min<uint32>(idleTime, std::max<int32>(_powerUpdateTimer, 0));
+    }
+
+    return flags | CREATURE_UPDATE_STATE_IDLE;
+}
+
+void Creature::WakeUpdates(uint8 reason)
+{
+    if (_updateStateSlot != CreatureUpdateStates::InvalidSlot)
+        GetMap()->GetCreatureUpdateStates().Wake(_updateStateSlot, reason);
+}
+
+void Creature::AddToUpdateStates()
+{
+    _updateStateSlot = GetMap()->GetCreatureUpdateStates().Add(this, Trinity::ComputeCellCoord(GetPositionX(), GetPositionY()).GetId());
+}
+
+void Creature::RemoveFromUpdateStates()
+{
+    if (_updateStateSlot == CreatureUpdateStates::InvalidSlot)
+        return;
+
+    GetMap()->GetCreatureUpdateStates().Remove(_updateStateSlot);
+    _updateStateSlot = CreatureUpdateStates::InvalidSlot;
+}
+
 void Creature::RegenerateHealth()
 {
     if (!isRegeneratingHealth())
@@ -1906,6 +1988,7 @@ float Creature::GetAttackDistance(Unit const* player) const
 void Creature::setDeathState(DeathState s)
 {
     Unit::setDeathState(s);
+    WakeUpdates(CREATURE_UPDATE_STATE_BUSY);
 
     if (s == JUST_DIED)
     {
@@ -3345,6 +3428,7 @@ bool Creature::IsEngaged() const
 void Creature::AtEngage(Unit* target)
 {
     Unit::AtEngage(target);
+    WakeUpdates(CREATURE_UPDATE_STATE_ENGAGED);
 
     if (!(GetCreatureTemplate()->type_flags & CREATURE_TYPE_FLAG_MOUNTED_COMBAT_ALLOWED))
         Dismount();
@@ -21,6 +21,7 @@
 #include "Unit.h"
 #include "Common.h"
 #include "CreatureData.h"
+#include "CreatureUpdateStates.h"
 #include "DatabaseEnvFwd.h"
 #include "Duration.h"
 #include "Loot.h"
@@ -380,6 +381,14 @@ class TC_GAME_API Creature : public Unit, public GridObject<Creature>, public Ma
         void ResetNoNpcDamageBelowPctHealthValue() { _noNpcDamageBelowPctHealth = 0.f; }
         float GetNoNpcDamageBelowPctHealthValue() const { return _noNpcDamageBelowPctHealth; }
 
+        // Slot in the update states of the map, see CreatureUpdateStates
+        uint32 GetUpdateStateSlot() const { return _updateStateSlot; }
+        void SetUpdateStateSlot(uint32 slot) { _updateStateSlot = slot; }
+        // CreatureUpdateStateFlags after an update, idleTime is how long the creature can go without updates when idle
+        uint8 GetUpdateState(uint32& idleTime) const;
+        // makes an idle creature update again with the next visit of its cell
+        void WakeUpdates(uint8 reason);
+
     protected:
         bool CreateFromProto(ObjectGuid::LowType guidlow, uint32 entry, CreatureData const* data = nullptr, uint32 vehId = 0);
         bool InitEntry(uint32 entry, CreatureData const* data = nullptr);
@@ -438,6 +447,10 @@ class TC_GAME_API Creature : public Unit, public GridObject<Creature>, public Ma
         // Initializes move speed fields based on template and override data
         void InitializeMovementSpeeds();
 
+        // called when added to and removed from the world, the map updates the creature from then on
+        void AddToUpdateStates();
+        void RemoveFromUpdateStates();
+
     private:
         void ForcedDespawn(uint32 timeMSToDespawn = 0, Seconds forceRespawnTimer = 0s);
         bool CheckNoGrayAggroConfig(uint32 playerLevel, uint32 creatureLevel) const; // No aggro from gray creatures
@@ -465,6 +478,8 @@ class TC_GAME_API Creature : public Unit, public GridObject<Creature>, public Ma
         CreatureMovementInfo _creatureMovementInfo;
 
         float _noNpcDamageBelowPctHealth;
+
+        uint32 _updateStateSlot;
 };
 
 class TC_GAME_API AssistDelayEvent : public BasicEvent
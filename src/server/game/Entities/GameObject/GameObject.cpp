@@ -893,6 +893,7 @@ void GameObject::Update(uint32 diff)
                         }
 
                         m_respawnTime = 0;
+                        InvalidateModelCollision();
                         m_SkillupList.clear();
                         m_usetimes = 0;
 
@@ -1157,6 +1158,7 @@ void GameObject::Update(uint32 diff)
             if (!m_spawnedByDefault)
             {
                 m_respawnTime = 0;
+                InvalidateModelCollision();
 
                 if (m_spawnId)
                     UpdateObjectVisibilityOnDestroy();
@@ -1170,6 +1172,7 @@ void GameObject::Update(uint32 diff)
             if (uint32 scalingMode = sWorld->getIntConfig(CONFIG_RESPAWN_DYNAMICMODE))
                 GetMap()->ApplyDynamicModeRespawnScaling(this, this->m_spawnId, respawnDelay, scalingMode);
             m_respawnTime = GameTime::GetGameTime() + respawnDelay;
+            InvalidateModelCollision();
 
             // if option not set then object will be saved at grid unload
             // Otherwise just save respawn time to map object memory
@@ -1620,6 +1623,7 @@ void GameObject::SetRespawnTime(int32 respawn)
 {
     m_respawnTime = respawn > 0 ? GameTime::GetGameTime() + respawn : 0;
     m_respawnDelayTime = respawn > 0 ? respawn : 0;
+    InvalidateModelCollision();
     if (respawn && !m_spawnedByDefault)
         UpdateObjectVisibility(true);
 }
@@ -2805,6 +2809,14 @@ void GameObject::EnableCollision(bool enable)
         GetMap()->InsertGameObjectModel(*m_model);*/
 
     m_model->enableCollision(enable);
+    InvalidateModelCollision();
+}
+
+void GameObject::InvalidateModelCollision()
+{
+    // GameObjectModel::intersectRay skips models of despawned objects
+    if (m_model && IsInWorld())
+        GetMap()->InvalidateCollisionCache(*m_model);
 }
 
 void GameObject::UpdateModel()
@@ -3070,11 +3082,7 @@ void GameObject::UpdateModelPosition()
         return;
 
     if (GetMap()->ContainsGameObjectModel(*m_model))
-    {
-        GetMap()->RemoveGameObjectModel(*m_model);
-        m_model->UpdatePosition();
-        GetMap()->InsertGameObjectModel(*m_model);
-    }
+        GetMap()->UpdateGameObjectModelPosition(*m_model);
 }
 
 class GameObjectModelOwnerImpl : public GameObjectModelOwnerBase
@@ -343,6 +343,7 @@ class TC_GAME_API GameObject : public WorldObject, public GridObject<GameObject>
     protected:
         GameObjectModel* CreateModel();
         void UpdateModel();                                 // updates model in case displayId were changed
+        void InvalidateModelCollision();                    // call when collision or spawn state changed, drops cached line of sight around the model
         uint32      m_spellId;
         time_t      m_respawnTime;                          // (secs) time of next respawn (or despawn if GO have owner()),
         uint32      m_respawnDelayTime;                     // (secs) if 0 then current GO state no dependent from timer
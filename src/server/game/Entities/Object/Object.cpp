@@ -1201,6 +1201,9 @@ void WorldObject::SetFarVisible(bool on)
         return;
 
     m_isFarVisible = on;
+
+    if (on && IsInWorld())
+        GetMap()->UpdateFarVisibilityRange(this);
 }
 
 void WorldObject::SetVisibilityDistanceOverride(VisibilityDistanceType type)
@@ -1210,6 +1213,9 @@ void WorldObject::SetVisibilityDistanceOverride(VisibilityDistanceType type)
         return;
 
     m_visibilityDistanceOverride = VisibilityDistances[AsUnderlyingType(type)];
+
+    if (IsInWorld())
+        GetMap()->UpdateFarVisibilityRange(this);
 }
 
 void WorldObject::CleanupsBeforeDelete(bool /*finalCleanup*/)
@@ -1249,6 +1255,20 @@ void WorldObject::AddToWorld()
 {
     Object::AddToWorld();
     GetMap()->GetZoneAndAreaId(GetPhaseShift(), m_zoneId, m_areaId, GetPositionX(), GetPositionY(), GetPositionZ());
+    GetMap()->UpdateFarVisibilityRange(this);
+
+    // notifies requested before entering the map
+    if (m_notifyflags)
+        GetMap()->MarkRelocationCell(GetPositionX(), GetPositionY());
+}
+
+void WorldObject::AddToNotify(uint16 f)
+{
+    m_notifyflags |= f;
+
+    // notifiers are only processed for cells with a pending relocation
+    if (IsInWorld())
+        GetMap()->MarkRelocationCell(GetPositionX(), GetPositionY());
 }
 void WorldObject::RemoveFromWorld()
 {
@@ -439,7 +439,7 @@ class TC_GAME_API WorldObject : public Object, public WorldLocation
         void RemoveFromObjectUpdate() override;
 
         //relocation and visibility system functions
-        void AddToNotify(uint16 f) { m_notifyflags |= f;}
+        void AddToNotify(uint16 f);
         bool isNeedNotify(uint16 f) const { return (m_notifyflags & f) != 0; }
         uint16 GetNotifyFlags() const { return m_notifyflags; }
         void ResetAllNotifies() { m_notifyflags = 0; }
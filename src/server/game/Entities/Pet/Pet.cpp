@@ -68,6 +68,7 @@ void Pet::AddToWorld()
         ///- Register the pet for guid lookup
         GetMap()->GetObjectsStore().Insert<Pet>(GetGUID(), this);
         Unit::AddToWorld();
+        AddToUpdateStates();
         AIM_Initialize();
     }
 
@@ -90,6 +91,7 @@ void Pet::RemoveFromWorld()
     {
         ///- Don't call the function for Creature, normal mobs + totems go in a different storage
         Unit::RemoveFromWorld();
+        RemoveFromUpdateStates();
         GetMap()->GetObjectsStore().Remove<Pet>(GetGUID());
     }
 }
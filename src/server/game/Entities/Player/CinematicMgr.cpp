@@ -51,6 +51,7 @@ void CinematicMgr::BeginCinematic()
         // Initialize diff, and set camera
         m_cinematicDiff = 0;
         m_cinematicCamera = flyByCameras;
+        player->GetMap()->UpdateFarVisibilityRange(player);
 
         auto camitr = m_cinematicCamera->begin();
         if (camitr != m_cinematicCamera->end())
@@ -0,0 +1,163 @@
+/*
+ * This file is part of the TrinityCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "ClientGuidSet.h"
+
+namespace
+{
+    std::size_t const InitialCapacity = 64;
+}
+
+ClientGuidSet::const_iterator ClientGuidSet::find(ObjectGuid const& guid) const
+{
+    if (_slots.empty() || guid.IsEmpty())
+        return end();
+
+    std::size_t slot = FindSlot(guid);
+    if (_slots[slot].Guid.IsEmpty())
+        return end();
+
+    return const_iterator(_slots.data() + slot, _slots.data() + _slots.size());
+}
+
+bool ClientGuidSet::insert(ObjectGuid const& guid)
+{
+    if (guid.IsEmpty())
+        return false;
+
+    // keep the load factor under 3/4
+    if ((_size + 1) * 4 > _slots.size() * 3)
+        Grow();
+
+    Slot& slot = _slots[FindSlot(guid)];
+    if (!slot.Guid.IsEmpty())
+        return false;
+
+    // added during an update means found by it
+    slot.Guid = guid;
+    slot.Generation = _generation;
+    ++_size;
+    ++_marked;
+    return true;
+}
+
+std::size_t ClientGuidSet::erase(ObjectGuid const& guid)
+{
+    if (_slots.empty() || guid.IsEmpty())
+        return 0;
+
+    std::size_t mask = _slots.size() - 1;
+    std::size_t hole = FindSlot(guid);
+    if (_slots[hole].Guid.IsEmpty())
+        return 0;
+
+    if (_slots[hole].Generation == _generation)
+        --_marked;
+
+    // shift back the following slots of the probe sequence, the table never holds tombstones
+    for (std::size_t next = (hole + 1) & mask; !_slots[next].Guid.IsEmpty(); next = (next + 1) & mask)
+    {
+        std::size_t home = GetHomeSlot(_slots[next].Guid);
+        if (((next - home) & mask) >= ((next - hole) & mask))
+        {
+            _slots[hole] = _slots[next];
+            hole = next;
+        }
+    }
+
+    _slots[hole].Guid.Clear();
+    --_size;
+    return 1;
+}
+
+void ClientGuidSet::clear()
+{
+    for (Slot& slot : _slots)
+        slot.Guid.Clear();
+
+    _size = 0;
+    _marked = 0;
+}
+
+uint32 ClientGuidSet::StartVisibilityUpdate()
+{
+    if (++_generation == 0)
+    {
+        for (Slot& slot : _slots)
+            slot.Generation = 0;
+
+        _generation = 1;
+    }
+
+    _marked = 0;
+    return _generation;
+}
+
+bool ClientGuidSet::MarkVisible(ObjectGuid const& guid, uint32 generation)
+{
+    if (_slots.empty() || guid.IsEmpty())
+        return false;
+
+    Slot& slot = _slots[FindSlot(guid)];
+    if (slot.Guid.IsEmpty() || slot.Generation >= generation)
+        return false;
+
+    // a nested update may have started since, stamping with the latest generation marks the object for both
+    slot.Generation = _generation;
+    ++_marked;
+    return true;
+}
+
+void ClientGuidSet::GetUnmarked(uint32 generation, std::vector<ObjectGuid>& guids) const
+{
+    if (generation == _generation && _marked == _size)
+        return;
+
+    for (Slot const& slot : _slots)
+        if (!slot.Guid.IsEmpty() && slot.Generation < generation)
+            guids.push_back(slot.Guid);
+}
+
+std::size_t ClientGuidSet::GetHomeSlot(ObjectGuid const& guid) const
+{
+    // raw guid values are sequential, spread them over the table
+    return std::size_t((guid.GetRawValue() * UI64LIT(0x9E3779B97F4A7C15)) >> 32) & (_slots.size() - 1);
+}
+
+std::size_t ClientGuidSet::FindSlot(ObjectGuid const& guid) const
+{
+    std::size_t mask = _slots.size() - 1;
+    std::size_t slot = GetHomeSlot(guid);
+    while (!_slots[slot].Guid.IsEmpty() && _slots[slot].Guid != guid)
+        slot = (slot + 1) & mask;
+
+    return slot;
+}
+
+void ClientGuidSet::Grow()
+{
+    std::vector<Slot> slots(_slots.empty() ? InitialCapacity : _slots.size() * 2, Slot{ ObjectGuid::Empty, 0 });
+    std::swap(slots, _slots);
+
+    for (Slot const& slot : slots)
+    {
+        if (slot.Guid.IsEmpty())
+            continue;
+
+        _slots[FindSlot(slot.Guid)] = slot;
+    }
+}
@@ -0,0 +1,109 @@
+/*
+ * This file is part of the TrinityCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TRINITY_CLIENTGUIDSET_H
+#define TRINITY_CLIENTGUIDSET_H
+
+#include "ObjectGuid.h"
+#include <iterator>
+#include <vector>
+
+// Objects known by a player's client, in a flat open addressing table.
+// Visibility updates stamp every object they find with the generation of the update,
+// whatever is left unstamped went out of range. The set is never copied for that and
+// when every known object was found again the update doesn't look at the set at all.
+class TC_GAME_API ClientGuidSet
+{
+    struct Slot
+    {
+        ObjectGuid Guid;
+        uint32 Generation;
+    };
+
+    public:
+        class const_iterator
+        {
+            public:
+                typedef std::forward_iterator_tag iterator_category;
+                typedef ObjectGuid value_type;
+                typedef std::ptrdiff_t difference_type;
+                typedef ObjectGuid const* pointer;
+                typedef ObjectGuid const& reference;
+
+                const_iterator() : _slot(nullptr), _end(nullptr) { }
+
+                reference operator*() const { return _slot->Guid; }
+                pointer operator->() const { return &_slot->Guid; }
+
+                const_iterator& operator++() { ++_slot; SkipEmpty(); return *this; }
+                const_iterator operator++(int) { const_iterator itr = *this; ++*this; return itr; }
+
+                bool operator==(const_iterator const& right) const { return _slot == right._slot; }
+                bool operator!=(const_iterator const& right) const { return _slot != right._slot; }
+
+            private:
+                friend class ClientGuidSet;
+
+                const_iterator(Slot const* slot, Slot const* end) : _slot(slot), _end(end) { SkipEmpty(); }
+
+                void SkipEmpty()
+                {
+                    while (_slot != _end && _slot->Guid.IsEmpty())
+                        ++_slot;
+                }
+
+                Slot const* _slot;
+                Slot const* _end;
+        };
+
+        typedef const_iterator iterator;
+
+        ClientGuidSet() : _size(0), _generation(1), _marked(0) { }
+
+        bool empty() const { return _size == 0; }
+        std::size_t size() const { return _size; }
+
+        const_iterator begin() const { return const_iterator(_slots.data(), _slots.data() + _slots.size()); }
+        const_iterator end() const { return const_iterator(_slots.data() + _slots.size(), _slots.data() + _slots.size()); }
+
+        const_iterator find(ObjectGuid const& guid) const;
+        std::size_t count(ObjectGuid const& guid) const { return find(guid) != end() ? 1 : 0; }
+
+        bool insert(ObjectGuid const& guid);
+        std::size_t erase(ObjectGuid const& guid);
+        void clear();
+
+        // Starts a visibility update, objects known before are unmarked for the returned generation
+        uint32 StartVisibilityUpdate();
+        // Marks a known object as found by the update, returns false if it is unknown or was marked already
+        bool MarkVisible(ObjectGuid const& guid, uint32 generation);
+        // Known objects the update with that generation didn't find
+        void GetUnmarked(uint32 generation, std::vector<ObjectGuid>& guids) const;
+
+    private:
+        std::size_t GetHomeSlot(ObjectGuid const& guid) const;
+        // slot holding guid or the empty slot ending its probe sequence
+        std::size_t FindSlot(ObjectGuid const& guid) const;
+        void Grow();
+
+        std::vector<Slot> _slots;
+        std::size_t _size;
+        uint32 _generation;
+        std::size_t _marked;        // known objects stamped with _generation
+};
+
+#endif // TRINITY_CLIENTGUIDSET_H
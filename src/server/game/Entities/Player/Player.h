@@ -19,6 +19,7 @@
 #define _PLAYER_H
 
 #include "Unit.h"
+#include "ClientGuidSet.h"
 #include "CUFProfile.h"
 #include "DatabaseEnvFwd.h"
 #include "DBCEnums.h"
@@ -1928,7 +1929,7 @@ class TC_GAME_API Player : public Unit, public GridObject<Player>
         bool IsBeingTeleportedNear() const { return mSemaphoreTeleport_Near; }
         bool IsBeingTeleportedFar() const { return mSemaphoreTeleport_Far; }
         void SetSemaphoreTeleportNear(bool semphsetting) { mSemaphoreTeleport_Near = semphsetting; }
-        void SetSemaphoreTeleportFar(bool semphsetting) { mSemaphoreTeleport_Far = semphsetting; }
+        void SetSemaphoreTeleportFar(bool semphsetting);
         void ProcessDelayedOperations();
 
         void CheckAreaExploreAndOutdoor(void);
@@ -2055,6 +2056,7 @@ class TC_GAME_API Player : public Unit, public GridObject<Player>
         void SendInitWorldStates(uint32 zone, uint32 area);
         void SendUpdateWorldState(uint32 variable, uint32 value, bool hidden = false) const;
         void SendDirectMessage(WorldPacket const* data) const;
+        void SendDirectMessage(std::shared_ptr<WorldPacket const> const& data) const;
         void SendBGWeekendWorldStates() const;
         void SendBattlefieldWorldStates() const;
 
@@ -2181,7 +2183,7 @@ class TC_GAME_API Player : public Unit, public GridObject<Player>
         WorldLocation GetStartPosition() const;
 
         // currently visible objects at player client
-        GuidUnorderedSet m_clientGUIDs;
+        ClientGuidSet m_clientGUIDs;
         GuidUnorderedSet m_visibleTransports;
 
         bool HaveAtClient(Object const* u) const;
@@ -38,6 +38,13 @@ uint32 PlayerSocial::GetNumberOfSocialsWithFlag(SocialFlag flag)
     return counter;
 }
 
+void PlayerSocial::GetSocialsWithFlag(SocialFlag flag, GuidUnorderedSet& guids) const
+{
+    for (PlayerSocialMap::const_iterator itr = _playerSocialMap.begin(); itr != _playerSocialMap.end(); ++itr)
+        if ((itr->second.Flags & flag) != 0)
+            guids.insert(itr->first);
+}
+
 bool PlayerSocial::AddToSocialList(ObjectGuid const& friendGuid, SocialFlag flag)
 {
     // check client limits
@@ -70,6 +77,9 @@ bool PlayerSocial::AddToSocialList(ObjectGuid const& friendGuid, SocialFlag flag
         CharacterDatabase.Execute(stmt);
     }
 
+    if (flag & SOCIAL_FLAG_IGNORED)
+        AddToIgnoreFilter(_ignoreFilter, friendGuid);
+
     return true;
 }
 
@@ -102,6 +112,9 @@ void PlayerSocial::RemoveFromSocialList(ObjectGuid const& friendGuid, SocialFlag
 
         CharacterDatabase.Execute(stmt);
     }
+
+    if (flag & SOCIAL_FLAG_IGNORED)
+        RebuildIgnoreFilter();
 }
 
 void PlayerSocial::SetFriendNote(ObjectGuid const& friendGuid, std::string const& note)
@@ -180,9 +193,30 @@ bool PlayerSocial::HasFriend(ObjectGuid const& friendGuid)
 
 bool PlayerSocial::HasIgnore(ObjectGuid const& ignoreGuid)
 {
+    IgnoreFilter filter;
+    AddToIgnoreFilter(filter, ignoreGuid);
+    if ((_ignoreFilter & filter) != filter)
+        return false;
+
     return _HasContact(ignoreGuid, SOCIAL_FLAG_IGNORED);
 }
 
+void PlayerSocial::AddToIgnoreFilter(IgnoreFilter& filter, ObjectGuid const& guid)
+{
+    // two independent bits per guid, taken from the top of a multiplicative hash
+    uint64 hash = guid.GetRawValue() * UI64LIT(0x9E3779B97F4A7C15);
+    filter.set(hash >> 56);
+    filter.set((hash >> 48) & 0xFF);
+}
+
+void PlayerSocial::RebuildIgnoreFilter()
+{
+    _ignoreFilter.reset();
+    for (PlayerSocialMap::const_iterator itr = _playerSocialMap.begin(); itr != _playerSocialMap.end(); ++itr)
+        if (itr->second.Flags & SOCIAL_FLAG_IGNORED)
+            AddToIgnoreFilter(_ignoreFilter, itr->first);
+}
+
 SocialMgr* SocialMgr::instance()
 {
     static SocialMgr instance;
@@ -322,5 +356,7 @@ PlayerSocial* SocialMgr::LoadFromDB(PreparedQueryResult result, ObjectGuid const
         while (result->NextRow());
     }
 
+    social->RebuildIgnoreFilter();
+
     return social;
 }
@@ -21,6 +21,7 @@
 #include "DatabaseEnvFwd.h"
 #include "Common.h"
 #include "ObjectGuid.h"
+#include <bitset>
 #include <map>
 
 class Player;
@@ -120,12 +121,19 @@ class TC_GAME_API PlayerSocial
         void SetPlayerGUID(ObjectGuid const& guid) { _playerGUID = guid; }
 
         uint32 GetNumberOfSocialsWithFlag(SocialFlag flag);
+        void GetSocialsWithFlag(SocialFlag flag, GuidUnorderedSet& guids) const;
 
     private:
         bool _HasContact(ObjectGuid const& guid, SocialFlag flags);
 
+        // bloom filter of ignored guids, lets broadcasts skip the map lookup for almost every recipient
+        typedef std::bitset<256> IgnoreFilter;
+        static void AddToIgnoreFilter(IgnoreFilter& filter, ObjectGuid const& guid);
+        void RebuildIgnoreFilter();
+
         typedef std::map<ObjectGuid, FriendInfo> PlayerSocialMap;
         PlayerSocialMap _playerSocialMap;
+        IgnoreFilter _ignoreFilter;
 
         ObjectGuid _playerGUID;
 };
@@ -81,6 +81,7 @@
 #include "Util.h"
 #include "Vehicle.h"
 #include "VehiclePackets.h"
+#include "WhoListStorage.h"
 #include "World.h"
 #include "WorldPacket.h"
 #include "WorldSession.h"
@@ -324,6 +325,8 @@ Unit::Unit(bool isWorldObject) :
     m_state = 0;
     m_deathState = ALIVE;
 
+    m_procAuras.SetVersion(sSpellMgr->GetSpellProcVersion());
+
     for (uint8 i = 0; i < CURRENT_MAX_SPELL; ++i)
         m_currentSpells[i] = nullptr;
 
@@ -2956,6 +2959,9 @@ void Unit::SetCurrentCastSpell(Spell* pSpell)
     // break same type spell if it is not delayed
     InterruptSpell(CSpellType, false, true, pSpell);
 
+    if (Creature* creature = ToCreature())
+        creature->WakeUpdates(CREATURE_UPDATE_STATE_BUSY);
+
     // special breakage effects:
     switch (CSpellType)
     {
@@ -3271,6 +3277,9 @@ void Unit::_AddAura(UnitAura* aura, Unit* caster)
     ASSERT(!m_cleanupDone);
     m_ownedAuras.insert(AuraMap::value_type(aura->GetId(), aura));
 
+    if (Creature* creature = ToCreature())
+        creature->WakeUpdates(CREATURE_UPDATE_STATE_BUSY);
+
     _RemoveNoStackAurasDueToAura(aura);
 
     if (aura->IsRemoved())
@@ -3343,6 +3352,9 @@ AuraApplication * Unit::_CreateAuraApplication(Aura* aura, uint8 effMask)
     AuraApplication * aurApp = new AuraApplication(this, caster, aura, effMask);
     m_appliedAuras.insert(AuraApplicationMap::value_type(aurId, aurApp));
 
+    if (SpellProcEntry const* procEntry = aurSpellInfo->GetProcEntry())
+        m_procAuras.Insert(aurApp, aurId, *procEntry);
+
     if (aurSpellInfo->HasAnyAuraInterruptFlag())
     {
         m_interruptableAuras.push_back(aurApp);
@@ -3430,6 +3442,7 @@ void Unit::_UnapplyAura(AuraApplicationMap::iterator &i, AuraRemoveFlags removeM
 
     // Remove all pointers from lists here to prevent possible pointer invalidation on spellcast/auraapply/auraremove
     m_appliedAuras.erase(i);
+    m_procAuras.Remove(aurApp);
 
     if (aura->GetSpellInfo()->HasAnyAuraInterruptFlag())
     {
@@ -8921,6 +8934,9 @@ void Unit::SetVisible(bool x)
     else
         m_serverSideVisibility.SetValue(SERVERSIDE_VISIBILITY_GM, SEC_PLAYER);
 
+    if (GetTypeId() == TYPEID_PLAYER)
+        sWhoListStorageMgr->MarkDirty(GetGUID());
+
     UpdateObjectVisibility();
 }
 
@@ -10026,6 +10042,7 @@ void Unit::SetLevel(uint8 lvl)
             player->SetGroupUpdateFlag(GROUP_UPDATE_FLAG_LEVEL);
 
         sCharacterCache->UpdateCharacterLevel(GetGUID(), lvl);
+        sWhoListStorageMgr->MarkDirty(GetGUID());
     }
 }
 
@@ -10044,6 +10061,9 @@ void Unit::SetHealth(uint32 val)
 
     SetUInt32Value(UNIT_FIELD_HEALTH, val);
 
+    if (Creature* creature = ToCreature())
+        creature->WakeUpdates(CREATURE_UPDATE_STATE_REGENERATING);
+
     // group update
     if (Player* player = ToPlayer())
     {
@@ -10119,6 +10139,10 @@ void Unit::SetPower(Powers power, int32 val, bool withPowerUpdate /*= true*/)
 
     SetInt32Value(UNIT_FIELD_POWER1 + powerIndex, val);
 
+    if (val < maxPower)
+        if (Creature* creature = ToCreature())
+            creature->WakeUpdates(CREATURE_UPDATE_STATE_REGENERATING);
+
     if (IsInWorld() && withPowerUpdate)
     {
         WorldPackets::Combat::PowerUpdate packet;
@@ -10312,6 +10336,9 @@ void Unit::AIUpdateTick(uint32 diff)
 void Unit::PushAI(UnitAI* newAI)
 {
     i_AIs.emplace(newAI);
+
+    if (Creature* creature = ToCreature())
+        creature->WakeUpdates(CREATURE_UPDATE_STATE_BUSY);
 }
 
 void Unit::SetAI(UnitAI* newAI)
@@ -10945,20 +10972,34 @@ void Unit::GetProcAurasTriggeredOnEvent(AuraApplicationProcContainer& aurasTrigg
             }
         }
     }
-    // or generate one on our own
+    // or generate one on our own, from the auras that can match the event
     else
     {
-        for (AuraApplicationMap::iterator itr = GetAppliedAuras().begin(); itr != GetAppliedAuras().end(); ++itr)
+        if (m_procAuras.GetVersion() != sSpellMgr->GetSpellProcVersion())
+            _RebuildProcAuraIndex();
+
+        m_procAuras.Visit(ProcAuraIndex::MakeFilter(eventInfo.GetTypeMask(), eventInfo.GetSpellInfo()), [&](AuraApplication* aurApp)
         {
-            if (uint8 procEffectMask = itr->second->GetBase()->GetProcEffectMask(itr->second, eventInfo, now))
+            if (uint8 procEffectMask = aurApp->GetBase()->GetProcEffectMask(aurApp, eventInfo, now))
             {
-                itr->second->GetBase()->PrepareProcToTrigger(itr->second, eventInfo, now);
-                aurasTriggeringProc.emplace_back(procEffectMask, itr->second);
+                aurApp->GetBase()->PrepareProcToTrigger(aurApp, eventInfo, now);
+                aurasTriggeringProc.emplace_back(procEffectMask, aurApp);
             }
-        }
+        });
     }
 }
 
+void Unit::_RebuildProcAuraIndex()
+{
+    // spell_proc was reloaded, auras may have gained or lost their proc data
+    m_procAuras.Clear();
+    for (AuraApplicationMap::value_type const& pair : m_appliedAuras)
+        if (SpellProcEntry const* procEntry = pair.second->GetBase()->GetSpellInfo()->GetProcEntry())
+            m_procAuras.Insert(pair.second, pair.first, *procEntry);
+
+    m_procAuras.SetVersion(sSpellMgr->GetSpellProcVersion());
+}
+
 void Unit::TriggerAurasProcOnEvent(CalcDamageInfo& damageInfo)
 {
     DamageInfo dmgInfo = DamageInfo(damageInfo);
@@ -13710,227 +13751,17 @@ void Unit::NearTeleportTo(Position const& pos, bool casting /*= false*/)
 
 void Unit::WriteMovementInfo(WorldPacket& data, Movement::ExtraMovementStatusElement* extras /*= nullptr*/, uint32* movementCounter /*= nullptr*/)
 {
-    MovementInfo const& mi = m_movementInfo;
-
-    bool hasMovementFlags = GetUnitMovementFlags() != 0;
-    bool hasMovementFlags2 = GetExtraUnitMovementFlags() != 0;
-    bool hasTimestamp = true;
-    bool hasOrientation = !G3D::fuzzyEq(GetOrientation(), 0.0f);
-    bool hasTransportData = GetTransGUID() != 0;
-    bool hasSpline = IsSplineEnabled();
-
-    bool hasTransportTime2 = hasTransportData && m_movementInfo.transport.time2 != 0;
-    bool hasTransportVehicleId = hasTransportData && m_movementInfo.transport.vehicleId != 0;
-    bool hasPitch = HasUnitMovementFlag(MovementFlags(MOVEMENTFLAG_SWIMMING | MOVEMENTFLAG_FLYING)) || HasExtraUnitMovementFlag(MOVEMENTFLAG2_ALWAYS_ALLOW_PITCHING);
-    bool hasFallDirection = HasUnitMovementFlag(MOVEMENTFLAG_FALLING);
-    bool hasFallData = hasFallDirection || m_movementInfo.jump.fallTime != 0;
-    bool hasSplineElevation = HasUnitMovementFlag(MOVEMENTFLAG_SPLINE_ELEVATION);
+    Movement::MovementStatusWriteData status;
+    status.Info = &m_movementInfo;
+    status.Pos = GetPosition();
+    status.Guid = GetGUID();
+    status.TransportGuid = GetTransGUID();
+    status.HasSpline = IsSplineEnabled();
+    status.Counter = movementCounter ? *movementCounter : 0;
+    status.Extras = extras;
 
-    MovementStatusElements const* sequence = GetMovementStatusElementsSequence(static_cast<OpcodeClient>(data.GetOpcode()));
-    if (!sequence)
-    {
+    if (!Movement::WriteMovementStatus(data, data.GetOpcode(), status))
         TC_LOG_ERROR("network", "Unit::WriteMovementInfo: No movement sequence found for opcode %s", GetOpcodeNameForLogging(static_cast<OpcodeClient>(data.GetOpcode())).c_str());
-        return;
-    }
-
-    ObjectGuid guid = GetGUID();
-    ObjectGuid tguid = hasTransportData ? GetTransGUID() : ObjectGuid::Empty;
-
-    for (; *sequence != MSEEnd; ++sequence)
-    {
-        MovementStatusElements const& element = *sequence;
-
-        switch (element)
-        {
-            case MSEHasGuidByte0:
-            case MSEHasGuidByte1:
-            case MSEHasGuidByte2:
-            case MSEHasGuidByte3:
-            case MSEHasGuidByte4:
-            case MSEHasGuidByte5:
-            case MSEHasGuidByte6:
-            case MSEHasGuidByte7:
-                data.WriteBit(guid[element - MSEHasGuidByte0]);
-                break;
-            case MSEHasTransportGuidByte0:
-            case MSEHasTransportGuidByte1:
-            case MSEHasTransportGuidByte2:
-            case MSEHasTransportGuidByte3:
-            case MSEHasTransportGuidByte4:
-            case MSEHasTransportGuidByte5:
-            case MSEHasTransportGuidByte6:
-            case MSEHasTransportGuidByte7:
-                if (hasTransportData)
-                    data.WriteBit(tguid[element - MSEHasTransportGuidByte0]);
-                break;
-            case MSEGuidByte0:
-            case MSEGuidByte1:
-            case MSEGuidByte2:
-            case MSEGuidByte3:
-            case MSEGuidByte4:
-            case MSEGuidByte5:
-            case MSEGuidByte6:
-            case MSEGuidByte7:
-                data.WriteByteSeq(guid[element - MSEGuidByte0]);
-                break;
-            case MSETransportGuidByte0:
-            case MSETransportGuidByte1:
-            case MSETransportGuidByte2:
-            case MSETransportGuidByte3:
-            case MSETransportGuidByte4:
-            case MSETransportGuidByte5:
-            case MSETransportGuidByte6:
-            case MSETransportGuidByte7:
-                if (hasTransportData)
-                    data.WriteByteSeq(tguid[element - MSETransportGuidByte0]);
-                break;
-            case MSEHasMovementFlags:
-                data.WriteBit(!hasMovementFlags);
-                break;
-            case MSEHasMovementFlags2:
-                data.WriteBit(!hasMovementFlags2);
-                break;
-            case MSEHasTimestamp:
-                data.WriteBit(!hasTimestamp);
-                break;
-            case MSEHasOrientation:
-                data.WriteBit(!hasOrientation);
-                break;
-            case MSEHasTransportData:
-                data.WriteBit(hasTransportData);
-                break;
-            case MSEHasTransportTime2:
-                if (hasTransportData)
-                    data.WriteBit(hasTransportTime2);
-                break;
-            case MSEHasVehicleId:
-                if (hasTransportData)
-                    data.WriteBit(hasTransportVehicleId);
-                break;
-            case MSEHasPitch:
-                data.WriteBit(!hasPitch);
-                break;
-            case MSEHasFallData:
-                data.WriteBit(hasFallData);
-                break;
-            case MSEHasFallDirection:
-                if (hasFallData)
-                    data.WriteBit(hasFallDirection);
-                break;
-            case MSEHasSplineElevation:
-                data.WriteBit(!hasSplineElevation);
-                break;
-            case MSEHasSpline:
-                data.WriteBit(hasSpline);
-                break;
-            case MSEHasHeightChangeFailed:
-                data.WriteBit(mi.HasHeightChangeFailed());
-                break;
-            case MSEMovementFlags:
-                if (hasMovementFlags)
-                    data.WriteBits(GetUnitMovementFlags(), 30);
-                break;
-            case MSEMovementFlags2:
-                if (hasMovementFlags2)
-                    data.WriteBits(GetExtraUnitMovementFlags(), 12);
-                break;
-            case MSETimestamp:
-                if (hasTimestamp)
-                    data << mi.time;
-                break;
-            case MSEPositionX:
-                data << GetPositionX();
-                break;
-            case MSEPositionY:
-                data << GetPositionY();
-                break;
-            case MSEPositionZ:
-                data << GetPositionZ();
-                break;
-            case MSEOrientation:
-                if (hasOrientation)
-                    data << GetOrientation();
-                break;
-            case MSETransportPositionX:
-                if (hasTransportData)
-                    data << GetTransOffsetX();
-                break;
-            case MSETransportPositionY:
-                if (hasTransportData)
-                    data << GetTransOffsetY();
-                break;
-            case MSETransportPositionZ:
-                if (hasTransportData)
-                    data << GetTransOffsetZ();
-                break;
-            case MSETransportOrientation:
-                if (hasTransportData)
-                    data << GetTransOffsetO();
-                break;
-            case MSETransportSeat:
-                if (hasTransportData)
-                    data << GetTransSeat();
-                break;
-            case MSETransportTime:
-                if (hasTransportData)
-                    data << GetTransTime();
-                break;
-            case MSETransportTime2:
-                if (hasTransportData && hasTransportTime2)
-                    data << mi.transport.time2;
-                break;
-            case MSETransportVehicleId:
-                if (hasTransportData && hasTransportVehicleId)
-                    data << mi.transport.vehicleId;
-                break;
-            case MSEPitch:
-                if (hasPitch)
-                    data << mi.pitch;
-                break;
-            case MSEFallTime:
-                if (hasFallData)
-                    data << mi.jump.fallTime;
-                break;
-            case MSEFallVerticalSpeed:
-                if (hasFallData)
-                    data << mi.jump.zspeed;
-                break;
-            case MSEFallCosAngle:
-                if (hasFallData && hasFallDirection)
-                    data << mi.jump.cosAngle;
-                break;
-            case MSEFallSinAngle:
-                if (hasFallData && hasFallDirection)
-                    data << mi.jump.sinAngle;
-                break;
-            case MSEFallHorizontalSpeed:
-                if (hasFallData && hasFallDirection)
-                    data << mi.jump.xyspeed;
-                break;
-            case MSESplineElevation:
-                if (hasSplineElevation)
-                    data << mi.splineElevation;
-                break;
-            case MSECounter:
-                data << uint32(movementCounter ? *movementCounter : 0);
-                break;
-            case MSEZeroBit:
-                data.WriteBit(0);
-                break;
-            case MSEOneBit:
-                data.WriteBit(1);
-                break;
-            case MSEFlushBits:
-                data.FlushBits();
-                break;
-            case MSEExtraElement:
-                extras->WriteNextElement(data);
-                break;
-            default:
-                ASSERT(Movement::PrintInvalidSequenceElement(element, __FUNCTION__));
-                break;
-        }
-    }
 }
 
 void Unit::SendTeleportPacket(Position const& pos)
@@ -21,6 +21,7 @@
 #include "Object.h"
 #include "EventProcessor.h"
 #include "CombatManager.h"
+#include "ProcAuraIndex.h"
 #include "SpellAuraDefines.h"
 #include "SpellDefines.h"
 #include "ThreatManager.h"
@@ -1341,6 +1342,7 @@ class TC_GAME_API Unit : public WorldObject
         void _UnapplyAura(AuraApplication * aurApp, AuraRemoveFlags removeMode);
         void _RemoveNoStackAurasDueToAura(Aura* aura);
         void _RegisterAuraEffect(AuraEffect* aurEff, bool apply);
+        void _RebuildProcAuraIndex();
 
         // m_ownedAuras container management
         AuraMap      & GetOwnedAuras()       { return m_ownedAuras; }
@@ -1891,6 +1893,7 @@ class TC_GAME_API Unit : public WorldObject
         AuraEffectList m_modAuras[TOTAL_AURAS];
         AurasBySpellIdMap m_ltAuras;               // cast limited target auras
         AuraApplicationList m_interruptableAuras;  // auras which have interrupt mask applied on unit
+        ProcAuraIndex m_procAuras;                 // applied auras with proc data, asked by proc events
         AuraStateAurasMap m_auraStateAuras;        // Used for improve performance of aura state checks on aura apply/remove
         EnumFlag<SpellAuraInterruptFlags> m_interruptMask;
         EnumFlag<SpellAuraInterruptFlags2> m_interruptMask2;
@@ -5881,130 +5881,190 @@ void ObjectMgr::LoadNpcTextLocales()
     TC_LOG_INFO("server.loading", ">> Loaded %u NpcText locale strings in %u ms", uint32(_npcTextLocaleStore.size()), GetMSTimeDiffToNow(oldMSTime));
 }
 
-//not very fast function but it is called only once a day, or on starting-up
+void ObjectMgr::ScheduleMailExpiration(uint32 mailId, time_t expireTime)
+{
+    std::lock_guard<std::mutex> lock(_mailExpirationsLock);
+    _mailExpirations.emplace(expireTime, mailId);
+}
+
 void ObjectMgr::ReturnOrDeleteOldMails(bool serverUp)
 {
     uint32 oldMSTime = getMSTime();
 
     time_t curTime = GameTime::GetGameTime();
-    tm lt;
-    localtime_r(&curTime, &lt);
     uint64 basetime(curTime);
-    TC_LOG_INFO("misc", "Returning mails current time: hour: %d, minute: %d, second: %d ", lt.tm_hour, lt.tm_min, lt.tm_sec);
 
     // Delete all old mails without item and without body immediately, if starting server
+    // then queue every remaining mail, later calls only look at the ones due
     if (!serverUp)
     {
+        tm lt;
+        localtime_r(&curTime, &lt);
+        TC_LOG_INFO("misc", "Returning mails current time: hour: %d, minute: %d, second: %d ", lt.tm_hour, lt.tm_min, lt.tm_sec);
+
         CharacterDatabasePreparedStatement* stmt = CharacterDatabase.GetPreparedStatement(CHAR_DEL_EMPTY_EXPIRED_MAIL);
         stmt->setUInt64(0, basetime);
-        CharacterDatabase.Execute(stmt);
+        CharacterDatabase.DirectExecute(stmt);
+
+        std::lock_guard<std::mutex> lock(_mailExpirationsLock);
+        _mailExpirations = MailExpirationQueue();
+
+        stmt = CharacterDatabase.GetPreparedStatement(CHAR_SEL_MAIL_EXPIRATIONS);
+        if (PreparedQueryResult result = CharacterDatabase.Query(stmt))
+        {
+            do
+            {
+                Field* fields = result->Fetch();
+                _mailExpirations.emplace(time_t(fields[1].GetUInt32()), fields[0].GetUInt32());
+            } while (result->NextRow());
+        }
     }
-    CharacterDatabasePreparedStatement* stmt = CharacterDatabase.GetPreparedStatement(CHAR_SEL_EXPIRED_MAIL);
-    stmt->setUInt64(0, basetime);
-    PreparedQueryResult result = CharacterDatabase.Query(stmt);
-    if (!result)
+
+    std::vector<uint32> dueMails;
     {
-        TC_LOG_INFO("server.loading", ">> No expired mails found.");
-        return;                                             // any mails need to be returned or deleted
+        std::lock_guard<std::mutex> lock(_mailExpirationsLock);
+        while (!_mailExpirations.empty() && _mailExpirations.top().first < curTime)
+        {
+            dueMails.push_back(_mailExpirations.top().second);
+            _mailExpirations.pop();
+        }
     }
 
-    std::map<uint32 /*messageId*/, MailItemInfoVec> itemsCache;
-    stmt = CharacterDatabase.GetPreparedStatement(CHAR_SEL_EXPIRED_MAIL_ITEMS);
-    stmt->setUInt32(0, (uint32)basetime);
-    if (PreparedQueryResult items = CharacterDatabase.Query(stmt))
+    if (dueMails.empty())
     {
-        MailItemInfo item;
-        do
-        {
-            Field* fields = items->Fetch();
-            item.item_guid = fields[0].GetUInt32();
-            item.item_template = fields[1].GetUInt32();
-            uint32 mailId = fields[2].GetUInt32();
-            itemsCache[mailId].push_back(item);
-        } while (items->NextRow());
+        if (!serverUp)
+            TC_LOG_INFO("server.loading", ">> No expired mails found.");
+        return;                                             // any mails need to be returned or deleted
     }
 
+    // the same mail may be queued more than once (expire time changed), stale entries are filtered by expire_time in the queries below
+    std::sort(dueMails.begin(), dueMails.end());
+    dueMails.erase(std::unique(dueMails.begin(), dueMails.end()), dueMails.end());
+
     uint32 deletedCount = 0;
     uint32 returnedCount = 0;
-    do
+    for (std::size_t batchStart = 0; batchStart < dueMails.size(); batchStart += MAIL_EXPIRATION_BATCH_SIZE)
     {
-        Field* fields = result->Fetch();
-        ObjectGuid::LowType receiver = fields[3].GetUInt32();
-        if (serverUp && ObjectAccessor::FindConnectedPlayer(ObjectGuid(HighGuid::Player, receiver)))
+        std::size_t batchEnd = std::min(batchStart + std::size_t(MAIL_EXPIRATION_BATCH_SIZE), dueMails.size());
+
+        // the statements take a full batch of ids, the last one fills the rest
+        CharacterDatabasePreparedStatement* stmt = CharacterDatabase.GetPreparedStatement(CHAR_SEL_EXPIRED_MAILS);
+        for (std::size_t i = 0; i < MAIL_EXPIRATION_BATCH_SIZE; ++i)
+            stmt->setUInt32(i, dueMails[std::min(batchStart + i, batchEnd - 1)]);
+        stmt->setUInt64(MAIL_EXPIRATION_BATCH_SIZE, basetime);
+        PreparedQueryResult result = CharacterDatabase.Query(stmt);
+        if (!result)
             continue;
 
-        Mail* m = new Mail;
-        m->messageID      = fields[0].GetUInt32();
-        m->messageType    = fields[1].GetUInt8();
-        m->sender         = fields[2].GetUInt32();
-        m->receiver       = receiver;
-        bool has_items    = fields[4].GetBool();
-        m->expire_time    = time_t(fields[5].GetUInt32());
-        m->deliver_time   = 0;
-        m->COD            = fields[6].GetUInt64();
-        m->checked        = fields[7].GetUInt8();
-        m->mailTemplateId = fields[8].GetInt16();
-
-        // Delete or return mail
-        if (has_items)
-        {
-            // read items from cache
-            m->items.swap(itemsCache[m->messageID]);
-
-            // if it is mail from non-player, or if it's already return mail, it shouldn't be returned, but deleted
-            if (m->messageType != MAIL_NORMAL || (m->checked & (MAIL_CHECK_MASK_COD_PAYMENT | MAIL_CHECK_MASK_RETURNED)))
-            {
-                // mail open and then not returned
-                for (MailItemInfoVec::iterator itr2 = m->items.begin(); itr2 != m->items.end(); ++itr2)
-                {
-                    stmt = CharacterDatabase.GetPreparedStatement(CHAR_DEL_ITEM_INSTANCE);
-                    stmt->setUInt32(0, itr2->item_guid);
-                    CharacterDatabase.Execute(stmt);
-                }
+        std::map<uint32 /*messageId*/, MailItemInfoVec> itemsCache;
+        stmt = CharacterDatabase.GetPreparedStatement(CHAR_SEL_EXPIRED_MAIL_ITEMS);
+        for (std::size_t i = 0; i < MAIL_EXPIRATION_BATCH_SIZE; ++i)
+            stmt->setUInt32(i, dueMails[std::min(batchStart + i, batchEnd - 1)]);
+        stmt->setUInt64(MAIL_EXPIRATION_BATCH_SIZE, basetime);
+        if (PreparedQueryResult items = CharacterDatabase.Query(stmt))
+        {
+            MailItemInfo item;
+            do
+            {
+                Field* fields = items->Fetch();
+                item.item_guid = fields[0].GetUInt32();
+                item.item_template = fields[1].GetUInt32();
+                uint32 mailId = fields[2].GetUInt32();
+                itemsCache[mailId].push_back(item);
+            } while (items->NextRow());
+        }
 
-                stmt = CharacterDatabase.GetPreparedStatement(CHAR_DEL_MAIL_ITEM_BY_ID);
-                stmt->setUInt32(0, m->messageID);
-                CharacterDatabase.Execute(stmt);
+        CharacterDatabaseTransaction trans = CharacterDatabase.BeginTransaction();
+        do
+        {
+            Field* fields = result->Fetch();
+            uint32 messageID = fields[0].GetUInt32();
+            ObjectGuid::LowType receiver = fields[3].GetUInt32();
+            if (serverUp && ObjectAccessor::FindConnectedPlayer(ObjectGuid(HighGuid::Player, receiver)))
+            {
+                // the player holds the mail now, try again once they may be gone
+                ScheduleMailExpiration(messageID, curTime + HOUR);
+                continue;
             }
-            else
+
+            Mail* m = new Mail;
+            m->messageID      = messageID;
+            m->messageType    = fields[1].GetUInt8();
+            m->sender         = fields[2].GetUInt32();
+            m->receiver       = receiver;
+            bool has_items    = fields[4].GetBool();
+            m->expire_time    = time_t(fields[5].GetUInt32());
+            m->deliver_time   = 0;
+            m->COD            = fields[6].GetUInt64();
+            m->checked        = fields[7].GetUInt8();
+            m->mailTemplateId = fields[8].GetInt16();
+
+            // Delete or return mail
+            if (has_items)
             {
-                // Mail will be returned
-                stmt = CharacterDatabase.GetPreparedStatement(CHAR_UPD_MAIL_RETURNED);
-                stmt->setUInt32(0, m->receiver);
-                stmt->setUInt32(1, m->sender);
-                stmt->setUInt32(2, basetime + 30 * DAY);
-                stmt->setUInt32(3, basetime);
-                stmt->setUInt8 (4, uint8(MAIL_CHECK_MASK_RETURNED));
-                stmt->setUInt32(5, m->messageID);
-                CharacterDatabase.Execute(stmt);
-                for (MailItemInfoVec::iterator itr2 = m->items.begin(); itr2 != m->items.end(); ++itr2)
+                // read items from cache
+                m->items.swap(itemsCache[m->messageID]);
+
+                // if it is mail from non-player, or if it's already return mail, it shouldn't be returned, but deleted
+                if (m->messageType != MAIL_NORMAL || (m->checked & (MAIL_CHECK_MASK_COD_PAYMENT | MAIL_CHECK_MASK_RETURNED)))
                 {
-                    // Update receiver in mail items for its proper delivery, and in instance_item for avoid lost item at sender delete
-                    stmt = CharacterDatabase.GetPreparedStatement(CHAR_UPD_MAIL_ITEM_RECEIVER);
-                    stmt->setUInt32(0, m->sender);
-                    stmt->setUInt32(1, itr2->item_guid);
-                    CharacterDatabase.Execute(stmt);
-
-                    stmt = CharacterDatabase.GetPreparedStatement(CHAR_UPD_ITEM_OWNER);
-                    stmt->setUInt32(0, m->sender);
-                    stmt->setUInt32(1, itr2->item_guid);
-                    CharacterDatabase.Execute(stmt);
+                    // mail open and then not returned
+                    for (MailItemInfoVec::iterator itr2 = m->items.begin(); itr2 != m->items.end(); ++itr2)
+                    {
+                        stmt = CharacterDatabase.GetPreparedStatement(CHAR_DEL_ITEM_INSTANCE);
+                        stmt->setUInt32(0, itr2->item_guid);
+                        trans->Append(stmt);
+                    }
+
+                    stmt = CharacterDatabase.GetPreparedStatement(CHAR_DEL_MAIL_ITEM_BY_ID);
+                    stmt->setUInt32(0, m->messageID);
+                    trans->Append(stmt);
+                }
+                else
+                {
+                    // Mail will be returned
+                    stmt = CharacterDatabase.GetPreparedStatement(CHAR_UPD_MAIL_RETURNED);
+                    stmt->setUInt32(0, m->receiver);
+                    stmt->setUInt32(1, m->sender);
+                    stmt->setUInt32(2, basetime + 30 * DAY);
+                    stmt->setUInt32(3, basetime);
+                    stmt->setUInt8 (4, uint8(MAIL_CHECK_MASK_RETURNED));
+                    stmt->setUInt32(5, m->messageID);
+                    trans->Append(stmt);
+                    for (MailItemInfoVec::iterator itr2 = m->items.begin(); itr2 != m->items.end(); ++itr2)
+                    {
+                        // Update receiver in mail items for its proper delivery, and in instance_item for avoid lost item at sender delete
+                        stmt = CharacterDatabase.GetPreparedStatement(CHAR_UPD_MAIL_ITEM_RECEIVER);
+                        stmt->setUInt32(0, m->sender);
+                        stmt->setUInt32(1, itr2->item_guid);
+                        trans->Append(stmt);
+
+                        stmt = CharacterDatabase.GetPreparedStatement(CHAR_UPD_ITEM_OWNER);
+                        stmt->setUInt32(0, m->sender);
+                        stmt->setUInt32(1, itr2->item_guid);
+                        trans->Append(stmt);
+                    }
+
+                    ScheduleMailExpiration(m->messageID, time_t(basetime + 30 * DAY));
+                    delete m;
+                    ++returnedCount;
+                    continue;
                 }
-                delete m;
-                ++returnedCount;
-                continue;
             }
+
+            stmt = CharacterDatabase.GetPreparedStatement(CHAR_DEL_MAIL_BY_ID);
+            stmt->setUInt32(0, m->messageID);
+            trans->Append(stmt);
+            delete m;
+            ++deletedCount;
         }
+        while (result->NextRow());
 
-        stmt = CharacterDatabase.GetPreparedStatement(CHAR_DEL_MAIL_BY_ID);
-        stmt->setUInt32(0, m->messageID);
-        CharacterDatabase.Execute(stmt);
-        delete m;
-        ++deletedCount;
+        CharacterDatabase.CommitTransaction(trans);
     }
-    while (result->NextRow());
 
-    TC_LOG_INFO("server.loading", ">> Processed %u expired mails: %u deleted and %u returned in %u ms", deletedCount + returnedCount, deletedCount, returnedCount, GetMSTimeDiffToNow(oldMSTime));
+    if (!serverUp || deletedCount || returnedCount)
+        TC_LOG_INFO(serverUp ? "misc" : "server.loading", ">> Processed %u expired mails: %u deleted and %u returned in %u ms", deletedCount + returnedCount, deletedCount, returnedCount, GetMSTimeDiffToNow(oldMSTime));
 }
 
 void ObjectMgr::LoadQuestAreaTriggers()
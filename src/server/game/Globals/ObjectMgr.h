@@ -38,6 +38,8 @@
 #include "VehicleDefines.h"
 #include <iterator>
 #include <map>
+#include <mutex>
+#include <queue>
 #include <unordered_map>
 
 class Item;
@@ -1281,7 +1283,9 @@ class TC_GAME_API ObjectMgr
             return itr != _fishingBaseForAreaStore.end() ? itr->second : 0;
         }
 
+        // on startup queues every mail by expire time, then returns or deletes the mails due
         void ReturnOrDeleteOldMails(bool serverUp);
+        void ScheduleMailExpiration(uint32 mailId, time_t expireTime);
 
         CreatureBaseStats const* GetCreatureBaseStats(uint8 level, uint8 unitClass);
 
@@ -1622,6 +1626,12 @@ class TC_GAME_API ObjectMgr
         std::atomic<uint32> _hiPetNumber;
         uint64 _voidItemId;
 
+        // min-heap of mail expire times, entries may be outdated and are checked against the db when due
+        typedef std::pair<time_t, uint32 /*mailId*/> MailExpiration;
+        typedef std::priority_queue<MailExpiration, std::vector<MailExpiration>, std::greater<MailExpiration>> MailExpirationQueue;
+        MailExpirationQueue _mailExpirations;
+        std::mutex _mailExpirationsLock;
+
         ObjectGuid::LowType _creatureSpawnId;
         ObjectGuid::LowType _gameObjectSpawnId;
 
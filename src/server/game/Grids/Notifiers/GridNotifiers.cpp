@@ -23,9 +23,25 @@
 #include "Transport.h"
 #include "ObjectAccessor.h"
 #include "CellImpl.h"
+#include <deque>
 
 using namespace Trinity;
 
+namespace
+{
+    // players standing in the same cell search mostly the same cells, each cell is searched once for all of them
+    struct PlayerRelocationBatch
+    {
+        std::deque<PlayerRelocationNotifier> notifiers;
+
+        template<class T> void Visit(GridRefManager<T> &m)
+        {
+            for (PlayerRelocationNotifier& notifier : notifiers)
+                notifier.Visit(m);
+        }
+    };
+}
+
 void VisibleNotifier::SendToSelf()
 {
     // at this moment i_clientGUIDs have guids that not iterate at grid level checks
@@ -34,10 +50,8 @@ void VisibleNotifier::SendToSelf()
     {
         for (Transport::PassengerSet::const_iterator itr = transport->GetPassengers().begin(); itr != transport->GetPassengers().end(); ++itr)
         {
-            if (vis_guids.find((*itr)->GetGUID()) != vis_guids.end())
+            if (i_player.m_clientGUIDs.MarkVisible((*itr)->GetGUID(), i_generation))
             {
-                vis_guids.erase((*itr)->GetGUID());
-
                 switch ((*itr)->GetTypeId())
                 {
                     case TYPEID_GAMEOBJECT:
@@ -64,7 +78,9 @@ void VisibleNotifier::SendToSelf()
         }
     }
 
-    for (auto it = vis_guids.begin(); it != vis_guids.end(); ++it)
+    std::vector<ObjectGuid> outOfRange;
+    i_player.m_clientGUIDs.GetUnmarked(i_generation, outOfRange);
+    for (auto it = outOfRange.begin(); it != outOfRange.end(); ++it)
     {
         i_player.m_clientGUIDs.erase(*it);
         i_data.AddOutOfRangeGUID(*it);
@@ -149,7 +165,7 @@ void PlayerRelocationNotifier::Visit(PlayerMapType &m)
     {
         Player* player = iter->GetSource();
 
-        vis_guids.erase(player->GetGUID());
+        i_player.m_clientGUIDs.MarkVisible(player->GetGUID(), i_generation);
 
         i_player.UpdateVisibilityOf(player, i_data, i_visibleNow);
 
@@ -168,7 +184,7 @@ void PlayerRelocationNotifier::Visit(CreatureMapType &m)
     {
         Creature* c = iter->GetSource();
 
-        vis_guids.erase(c->GetGUID());
+        i_player.m_clientGUIDs.MarkVisible(c->GetGUID(), i_generation);
 
         i_player.UpdateVisibilityOf(c, i_data, i_visibleNow);
 
@@ -225,6 +241,9 @@ void DelayedUnitRelocation::Visit(CreatureMapType &m)
 
 void DelayedUnitRelocation::Visit(PlayerMapType &m)
 {
+    PlayerRelocationBatch batch;
+    CellArea area;
+
     for (PlayerMapType::iterator iter = m.begin(); iter != m.end(); ++iter)
     {
         Player* player = iter->GetSource();
@@ -233,13 +252,55 @@ void DelayedUnitRelocation::Visit(PlayerMapType &m)
         if (!viewPoint->isNeedNotify(NOTIFY_VISIBILITY_CHANGED))
             continue;
 
-        if (player != viewPoint && !viewPoint->IsPositionValid())
+        if (player != viewPoint)
+        {
+            if (!viewPoint->IsPositionValid())
+                continue;
+
+            PlayerRelocationNotifier relocate(*player);
+            Cell::VisitAllObjects(viewPoint, relocate, i_radius, false);
+            relocate.SendToSelf();
             continue;
+        }
+
+        // same search area as Cell::Visit
+        CellArea playerArea = Cell::CalculateCellArea(player->GetPositionX(), player->GetPositionY(), std::min(i_radius + player->GetCombatReach(), float(SIZE_OF_GRIDS)));
+        if (batch.notifiers.empty())
+            area = playerArea;
+        else
+        {
+            area.low_bound.x_coord = std::min(area.low_bound.x_coord, playerArea.low_bound.x_coord);
+            area.low_bound.y_coord = std::min(area.low_bound.y_coord, playerArea.low_bound.y_coord);
+            area.high_bound.x_coord = std::max(area.high_bound.x_coord, playerArea.high_bound.x_coord);
+            area.high_bound.y_coord = std::max(area.high_bound.y_coord, playerArea.high_bound.y_coord);
+        }
 
-        PlayerRelocationNotifier relocate(*player);
-        Cell::VisitAllObjects(viewPoint, relocate, i_radius, false);
-        relocate.SendToSelf();
+        batch.notifiers.emplace_back(*player);
     }
+
+    if (batch.notifiers.empty())
+        return;
+
+    if (batch.notifiers.size() == 1)
+        Cell::VisitAllObjects(&batch.notifiers.front().i_player, batch.notifiers.front(), i_radius, false);
+    else
+    {
+        TypeContainerVisitor<PlayerRelocationBatch, WorldTypeMapContainer> world_relocation(batch);
+        TypeContainerVisitor<PlayerRelocationBatch, GridTypeMapContainer> grid_relocation(batch);
+
+        for (uint32 x = area.low_bound.x_coord; x <= area.high_bound.x_coord; ++x)
+        {
+            for (uint32 y = area.low_bound.y_coord; y <= area.high_bound.y_coord; ++y)
+            {
+                Cell r_zone(CellCoord(x, y));
+                i_map.Visit(r_zone, world_relocation);
+                i_map.Visit(r_zone, grid_relocation);
+            }
+        }
+    }
+
+    for (PlayerRelocationNotifier& notifier : batch.notifiers)
+        notifier.SendToSelf();
 }
 
 void AIRelocationNotifier::Visit(CreatureMapType &m)
@@ -261,7 +322,7 @@ void MessageDistDeliverer::Visit(PlayerMapType &m)
         if (!target->IsInPhase(i_source))
             continue;
 
-        if (target->GetExactDist2dSq(i_source) > i_distSq)
+        if (!CheckDistance(target))
             continue;
 
         // Send packet to all who are sharing the player's vision
@@ -286,7 +347,7 @@ void MessageDistDeliverer::Visit(CreatureMapType &m)
         if (!target->IsInPhase(i_source))
             continue;
 
-        if (target->GetExactDist2dSq(i_source) > i_distSq)
+        if (!CheckDistance(target))
             continue;
 
         // Send packet to all who are sharing the creature's vision
@@ -308,7 +369,7 @@ void MessageDistDeliverer::Visit(DynamicObjectMapType &m)
         if (!target->IsInPhase(i_source))
             continue;
 
-        if (target->GetExactDist2dSq(i_source) > i_distSq)
+        if (!CheckDistance(target))
             continue;
 
         if (Unit* caster = target->GetCaster())
@@ -438,7 +499,6 @@ bool AnyDeadUnitSpellTargetInRangeCheck::operator()(Creature* u)
     return AnyDeadUnitObjectInRangeCheck::operator()(u) && i_check(u);
 }
 
-template void ObjectUpdater::Visit<Creature>(CreatureMapType&);
 template void ObjectUpdater::Visit<GameObject>(GameObjectMapType&);
 template void ObjectUpdater::Visit<DynamicObject>(DynamicObjectMapType&);
 template void ObjectUpdater::Visit<AreaTrigger>(AreaTriggerMapType &);
@@ -38,9 +38,9 @@ namespace Trinity
         Player &i_player;
         UpdateData i_data;
         std::set<Unit*> i_visibleNow;
-        GuidUnorderedSet vis_guids;
+        uint32 i_generation;                            // objects of m_clientGUIDs not marked with it went out of range
 
-        VisibleNotifier(Player &player) : i_player(player), i_data(player.GetMapId()), vis_guids(player.m_clientGUIDs) { }
+        VisibleNotifier(Player &player) : i_player(player), i_data(player.GetMapId()), i_generation(player.m_clientGUIDs.StartVisibilityUpdate()) { }
         template<class T> void Visit(GridRefManager<T> &m);
         void SendToSelf(void);
     };
@@ -120,13 +120,18 @@ namespace Trinity
     {
         WorldObject const* i_source;
         WorldPacket const* i_message;
+        std::shared_ptr<WorldPacket const> i_sharedMessage;    // copy of i_message queued to every receiver, made on first send
         float i_distSq;
+        float i_throttledDistSq;                                // receivers further than this are only counted in throttled
         uint32 team;
         Player const* skipped_receiver;
+        uint32 sent;
+        uint32 throttled;
         MessageDistDeliverer(WorldObject const* src, WorldPacket const* msg, float dist, bool own_team_only = false, Player const* skipped = nullptr)
-            : i_source(src), i_message(msg), i_distSq(dist * dist)
+            : i_source(src), i_message(msg), i_distSq(dist * dist), i_throttledDistSq(i_distSq)
             , team(0)
             , skipped_receiver(skipped)
+            , sent(0), throttled(0)
         {
             if (own_team_only)
                 if (Player const* player = src->ToPlayer())
@@ -147,7 +152,27 @@ namespace Trinity
             if (!player->HaveAtClient(i_source))
                 return;
 
-            player->SendDirectMessage(i_message);
+            if (!i_sharedMessage)
+                i_sharedMessage = std::make_shared<WorldPacket const>(*i_message);
+
+            player->SendDirectMessage(i_sharedMessage);
+            ++sent;
+        }
+
+        // false when the packet must not be sent to whoever sees through target
+        bool CheckDistance(WorldObject const* target)
+        {
+            float distSq = target->GetExactDist2dSq(i_source);
+            if (distSq > i_distSq)
+                return false;
+
+            if (distSq > i_throttledDistSq)
+            {
+                ++throttled;
+                return false;
+            }
+
+            return true;
         }
     };
 
@@ -183,6 +208,7 @@ namespace Trinity
         explicit ObjectUpdater(const uint32 diff) : i_timeDiff(diff) { }
         template<class T> void Visit(GridRefManager<T> &m);
         void Visit(PlayerMapType &) { }
+        void Visit(CreatureMapType &) { }   // updated by the CreatureUpdateStates of the map
         void Visit(CorpseMapType &) { }
     };
 
@@ -1581,22 +1607,18 @@ namespace Trinity
     // Player checks and do
 
     // Prepare using Builder localized packets with caching and send to player
+    // every player of the same locale gets the same packet, its payload is not copied per recipient
     template<class Builder>
     class LocalizedPacketDo
     {
         public:
             explicit LocalizedPacketDo(Builder& builder) : i_builder(builder) { }
 
-            ~LocalizedPacketDo()
-            {
-                for (size_t i = 0; i < i_data_cache.size(); ++i)
-                    delete i_data_cache[i];
-            }
             void operator()(Player* p);
 
         private:
             Builder& i_builder;
-            std::vector<WorldPacket*> i_data_cache;         // 0 = default, i => i-1 locale index
+            std::vector<std::shared_ptr<WorldPacket const>> i_data_cache;   // 0 = default, i => i-1 locale index
     };
 
     // Prepare using Builder localized packets with caching and send to player
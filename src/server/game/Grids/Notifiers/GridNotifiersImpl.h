@@ -32,7 +32,7 @@ inline void Trinity::VisibleNotifier::Visit(GridRefManager<T> &m)
 {
     for (typename GridRefManager<T>::iterator iter = m.begin(); iter != m.end(); ++iter)
     {
-        vis_guids.erase(iter->GetSource()->GetGUID());
+        i_player.m_clientGUIDs.MarkVisible(iter->GetSource()->GetGUID(), i_generation);
         i_player.UpdateVisibilityOf(iter->GetSource(), i_data, i_visibleNow);
     }
 }
@@ -562,7 +562,6 @@ void Trinity::LocalizedPacketDo<Builder>::operator()(Player* p)
 {
     LocaleConstant loc_idx = p->GetSession()->GetSessionDbLocaleIndex();
     uint32 cache_idx = loc_idx+1;
-    WorldPacket* data;
 
     // create if not cached yet
     if (i_data_cache.size() < cache_idx + 1 || !i_data_cache[cache_idx])
@@ -570,16 +569,14 @@ void Trinity::LocalizedPacketDo<Builder>::operator()(Player* p)
         if (i_data_cache.size() < cache_idx + 1)
             i_data_cache.resize(cache_idx + 1);
 
-        data = new WorldPacket();
+        std::shared_ptr<WorldPacket> data = std::make_shared<WorldPacket>();
 
         i_builder(*data, loc_idx);
 
-        i_data_cache[cache_idx] = data;
+        i_data_cache[cache_idx] = std::move(data);
     }
-    else
-        data = i_data_cache[cache_idx];
 
-    p->SendDirectMessage(data);
+    p->SendDirectMessage(i_data_cache[cache_idx]);
 }
 
 template<class Builder>
@@ -98,6 +98,16 @@ void AddObjectHelper(CellCoord &cell, GridRefManager<T> &m, uint32 &count, Map*
     ++count;
 }
 
+// cells of prefetched grids are loaded after the grid is marked as loaded, the object may have been spawned already
+template <class T>
+bool IsSpawnedOnMap(Map* /*map*/, ObjectGuid::LowType /*spawnId*/) { return false; } // Creature::LoadFromDB checks for duplicates
+
+template <>
+bool IsSpawnedOnMap<GameObject>(Map* map, ObjectGuid::LowType spawnId)
+{
+    return map->GetGameObjectBySpawnIdStore().count(spawnId) != 0;
+}
+
 template <class T>
 void LoadHelper(CellGuidSet const& guid_set, CellCoord &cell, GridRefManager<T> &m, uint32 &count, Map* map)
 {
@@ -105,7 +115,7 @@ void LoadHelper(CellGuidSet const& guid_set, CellCoord &cell, GridRefManager<T>
     {
         // Don't spawn at all if there's a respawn timer
         ObjectGuid::LowType guid = *i_guid;
-        if (!map->ShouldBeSpawnedOnGridLoad<T>(guid))
+        if (!map->ShouldBeSpawnedOnGridLoad<T>(guid) || IsSpawnedOnMap<T>(map, guid))
             continue;
 
         T* obj = new T;
@@ -155,31 +165,32 @@ void ObjectWorldLoader::Visit(CorpseMapType& /*m*/)
 void ObjectGridLoader::LoadN(void)
 {
     i_gameObjects = 0; i_creatures = 0; i_corpses = 0;
-    i_cell.data.Part.cell_y = 0;
     for (uint32 x = 0; x < MAX_NUMBER_OF_CELLS; ++x)
-    {
-        i_cell.data.Part.cell_x = x;
         for (uint32 y = 0; y < MAX_NUMBER_OF_CELLS; ++y)
-        {
-            i_cell.data.Part.cell_y = y;
-
-            //Load creatures and game objects
-            {
-                TypeContainerVisitor<ObjectGridLoader, GridTypeMapContainer> visitor(*this);
-                i_grid.VisitGrid(x, y, visitor);
-            }
-
-            //Load corpses (not bones)
-            {
-                ObjectWorldLoader worker(*this);
-                TypeContainerVisitor<ObjectWorldLoader, WorldTypeMapContainer> visitor(worker);
-                i_grid.VisitGrid(x, y, visitor);
-            }
-        }
-    }
+            LoadCell(x, y);
+
     TC_LOG_DEBUG("maps", "%u GameObjects, %u Creatures, and %u Corpses/Bones loaded for grid %u on map %u", i_gameObjects, i_creatures, i_corpses, i_grid.GetGridId(), i_map->GetId());
 }
 
+void ObjectGridLoader::LoadCell(uint32 x, uint32 y)
+{
+    i_cell.data.Part.cell_x = x;
+    i_cell.data.Part.cell_y = y;
+
+    //Load creatures and game objects
+    {
+        TypeContainerVisitor<ObjectGridLoader, GridTypeMapContainer> visitor(*this);
+        i_grid.VisitGrid(x, y, visitor);
+    }
+
+    //Load corpses (not bones)
+    {
+        ObjectWorldLoader worker(*this);
+        TypeContainerVisitor<ObjectWorldLoader, WorldTypeMapContainer> visitor(worker);
+        i_grid.VisitGrid(x, y, visitor);
+    }
+}
+
 template<class T>
 void ObjectGridUnloader::Visit(GridRefManager<T> &m)
 {
@@ -43,6 +43,8 @@ class TC_GAME_API ObjectGridLoader
         void Visit(AreaTriggerMapType &) const { }
 
         void LoadN(void);
+        // loads a single cell of the grid, counters are not reset
+        void LoadCell(uint32 x, uint32 y);
 
         static void SetObjectCell(MapObject* obj, CellCoord const& cellCoord);
 
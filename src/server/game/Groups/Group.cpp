@@ -1838,6 +1838,8 @@ void Group::BroadcastAddonMessagePacket(WorldPacket const* packet, const std::st
 
 void Group::BroadcastPacket(WorldPacket const* packet, bool ignorePlayersInBGRaid, int group, ObjectGuid ignoredPlayer)
 {
+    // copied once, every member's socket shares the same payload
+    std::shared_ptr<WorldPacket const> shared;
     for (GroupReference* itr = GetFirstMember(); itr != nullptr; itr = itr->next())
     {
         Player* player = itr->GetSource();
@@ -1845,7 +1847,12 @@ void Group::BroadcastPacket(WorldPacket const* packet, bool ignorePlayersInBGRai
             continue;
 
         if (player->GetSession() && (group == -1 || itr->getSubGroup() == group))
-            player->SendDirectMessage(packet);
+        {
+            if (!shared)
+                shared = std::make_shared<WorldPacket>(*packet);
+
+            player->SendDirectMessage(shared);
+        }
     }
 }
 
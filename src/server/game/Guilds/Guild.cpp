@@ -37,6 +37,7 @@
 #include "ScriptMgr.h"
 #include "SocialMgr.h"
 #include "SpellAuraEffects.h"
+#include "WhoListStorage.h"
 #include "World.h"
 #include "WorldSession.h"
 #include "Group.h"
@@ -1504,7 +1505,10 @@ bool Guild::SetName(std::string const& name)
     if (m_name == name || name.empty() || name.length() > 24 || sObjectMgr->IsReservedName(name) || !ObjectMgr::IsValidCharterName(name))
         return false;
 
+    std::string oldName = m_name;
     m_name = name;
+    sGuildMgr->UpdateGuildName(this, oldName);
+
     CharacterDatabasePreparedStatement* stmt = CharacterDatabase.GetPreparedStatement(CHAR_UPD_GUILD_NAME);
     stmt->setString(0, m_name);
     stmt->setUInt32(1, GetId());
@@ -1514,6 +1518,9 @@ bool Guild::SetName(std::string const& name)
     guildNameChanged.GuildGUID = GetGUID();
     guildNameChanged.GuildName = name;
     BroadcastPacket(guildNameChanged.Write());
+
+    for (auto itr = m_members.begin(); itr != m_members.end(); ++itr)
+        sWhoListStorageMgr->MarkDirty(itr->second->GetGUID());
     return true;
 }
 
@@ -2765,13 +2772,14 @@ void Guild::BroadcastToGuild(WorldSession* session, bool officerOnly, std::strin
 {
     if (session && session->GetPlayer() && _HasRankRight(session->GetPlayer(), officerOnly ? GR_RIGHT_OFFCHATSPEAK : GR_RIGHT_GCHATSPEAK))
     {
-        WorldPacket data;
-        ChatHandler::BuildChatPacket(data, officerOnly ? CHAT_MSG_OFFICER : CHAT_MSG_GUILD, Language(language), session->GetPlayer(), nullptr, msg);
+        std::shared_ptr<WorldPacket> data = std::make_shared<WorldPacket>();
+        ChatHandler::BuildChatPacket(*data, officerOnly ? CHAT_MSG_OFFICER : CHAT_MSG_GUILD, Language(language), session->GetPlayer(), nullptr, msg);
         for (auto itr = m_members.begin(); itr != m_members.end(); ++itr)
-            if (Player* player = itr->second->FindConnectedPlayer())
-                if (player->GetSession() && _HasRankRight(player, officerOnly ? GR_RIGHT_OFFCHATLISTEN : GR_RIGHT_GCHATLISTEN) &&
-                    !player->GetSocial()->HasIgnore(session->GetPlayer()->GetGUID()))
-                    player->SendDirectMessage(&data);
+            if (itr->second->IsOnline())
+                if (Player* player = itr->second->FindConnectedPlayer())
+                    if (player->GetSession() && _HasRankRight(player, officerOnly ? GR_RIGHT_OFFCHATLISTEN : GR_RIGHT_GCHATLISTEN) &&
+                        !player->GetSocial()->HasIgnore(session->GetPlayer()->GetGUID()))
+                        player->SendDirectMessage(data);
     }
 }
 
@@ -2779,38 +2787,53 @@ void Guild::BroadcastAddonToGuild(WorldSession* session, bool officerOnly, std::
 {
     if (session && session->GetPlayer() && _HasRankRight(session->GetPlayer(), officerOnly ? GR_RIGHT_OFFCHATSPEAK : GR_RIGHT_GCHATSPEAK))
     {
-        WorldPacket data;
-        ChatHandler::BuildChatPacket(data, officerOnly ? CHAT_MSG_OFFICER : CHAT_MSG_GUILD, LANG_ADDON, session->GetPlayer(), nullptr, msg, 0, "", DEFAULT_LOCALE, prefix);
+        std::shared_ptr<WorldPacket> data = std::make_shared<WorldPacket>();
+        ChatHandler::BuildChatPacket(*data, officerOnly ? CHAT_MSG_OFFICER : CHAT_MSG_GUILD, LANG_ADDON, session->GetPlayer(), nullptr, msg, 0, "", DEFAULT_LOCALE, prefix);
         for (Members::const_iterator itr = m_members.begin(); itr != m_members.end(); ++itr)
-            if (Player* player = itr->second->FindPlayer())
-                if (player->GetSession() && _HasRankRight(player, officerOnly ? GR_RIGHT_OFFCHATLISTEN : GR_RIGHT_GCHATLISTEN) &&
-                    !player->GetSocial()->HasIgnore(session->GetPlayer()->GetGUID()) &&
-                    player->GetSession()->IsAddonRegistered(prefix))
-                        player->SendDirectMessage(&data);
+            if (itr->second->IsOnline())
+                if (Player* player = itr->second->FindPlayer())
+                    if (player->GetSession() && _HasRankRight(player, officerOnly ? GR_RIGHT_OFFCHATLISTEN : GR_RIGHT_GCHATLISTEN) &&
+                        !player->GetSocial()->HasIgnore(session->GetPlayer()->GetGUID()) &&
+                        player->GetSession()->IsAddonRegistered(prefix))
+                        player->SendDirectMessage(data);
     }
 }
 
+// Broadcasts copy the packet once and share it between all recipients,
+// offline members are skipped before looking them up
 void Guild::BroadcastPacketToRank(WorldPacket const* packet, uint8 rankId) const
 {
+    std::shared_ptr<WorldPacket const> shared;
     for (auto itr = m_members.begin(); itr != m_members.end(); ++itr)
-        if (itr->second->IsRank(rankId))
+        if (itr->second->IsOnline() && itr->second->IsRank(rankId))
             if (Player* player = itr->second->FindConnectedPlayer())
-                player->SendDirectMessage(packet);
+                player->SendDirectMessage(ShareBroadcastPacket(packet, shared));
 }
 
 void Guild::BroadcastPacket(WorldPacket const* packet) const
 {
+    std::shared_ptr<WorldPacket const> shared;
     for (auto itr = m_members.begin(); itr != m_members.end(); ++itr)
-        if (Player* player = itr->second->FindPlayer())
-            player->SendDirectMessage(packet);
+        if (itr->second->IsOnline())
+            if (Player* player = itr->second->FindPlayer())
+                player->SendDirectMessage(ShareBroadcastPacket(packet, shared));
 }
 
 void Guild::BroadcastPacketIfTrackingAchievement(WorldPacket const* packet, uint32 criteriaId) const
 {
+    std::shared_ptr<WorldPacket const> shared;
     for (Members::const_iterator itr = m_members.begin(); itr != m_members.end(); ++itr)
-        if (itr->second->IsTrackingCriteriaId(criteriaId))
+        if (itr->second->IsOnline() && itr->second->IsTrackingCriteriaId(criteriaId))
             if (Player* player = itr->second->FindPlayer())
-                player->SendDirectMessage(packet);
+                player->SendDirectMessage(ShareBroadcastPacket(packet, shared));
+}
+
+std::shared_ptr<WorldPacket const> const& Guild::ShareBroadcastPacket(WorldPacket const* packet, std::shared_ptr<WorldPacket const>& shared)
+{
+    if (!shared)
+        shared = std::make_shared<WorldPacket>(*packet);
+
+    return shared;
 }
 
 void Guild::MassInviteToEvent(WorldSession* session, uint32 minLevel, uint32 maxLevel, uint32 minRank)
@@ -3983,7 +4006,42 @@ bool Guild::HasAchieved(uint32 achievementId) const
 
 void Guild::UpdateAchievementCriteria(AchievementCriteriaTypes type, uint64 miscValue1, uint64 miscValue2, uint64 miscValue3, Unit* unit, Player* player, GameObject* go)
 {
-    m_achievementMgr->UpdateAchievementCriteria(type, miscValue1, miscValue2, miscValue3, unit, player, go);
+    if (!player || !sWorld->getBoolConfig(CONFIG_GUILD_LEVELING_ENABLED))
+        return;
+
+    // unit and gameobject are only safe to use on the map thread of the player, check everything depending on them now
+    AchievementCriteriaEntryList criteria;
+    m_achievementMgr->FindCriteriaToUpdate(type, miscValue1, miscValue2, miscValue3, unit, player, go, criteria);
+    if (criteria.empty())
+        return;
+
+    bool schedule;
+    {
+        std::lock_guard<std::mutex> lock(_pendingAchievementCriteriaLock);
+        schedule = _pendingAchievementCriteria.empty();
+        _pendingAchievementCriteria.push_back({ type, std::move(criteria), miscValue1, miscValue2, miscValue3, player->GetGUID() });
+    }
+
+    if (schedule)
+        sGuildMgr->ScheduleAchievementCriteriaUpdate(m_id);
+}
+
+void Guild::UpdatePendingAchievementCriteria()
+{
+    std::vector<PendingAchievementCriteria> updates;
+    {
+        std::lock_guard<std::mutex> lock(_pendingAchievementCriteriaLock);
+        std::swap(updates, _pendingAchievementCriteria);
+    }
+
+    for (PendingAchievementCriteria const& update : updates)
+    {
+        Player* player = ObjectAccessor::FindConnectedPlayer(update.PlayerGUID);
+        if (!player)
+            continue;
+
+        m_achievementMgr->UpdateCriteriaProgress(update.Type, update.Criteria, update.MiscValue1, update.MiscValue2, update.MiscValue3, player);
+    }
 }
 
 void Guild::HandleNewsSetSticky(WorldSession* session, uint32 newsId, bool sticky)
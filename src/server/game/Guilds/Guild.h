@@ -23,7 +23,10 @@
 #include "SharedDefines.h"
 
 #include <array>
+#include <memory>
+#include <mutex>
 #include <unordered_map>
+#include <vector>
 
 template<class T>
 class AchievementMgr;
@@ -34,6 +37,7 @@ class Unit;
 class GameObject;
 class WorldPacket;
 class WorldSession;
+struct AchievementCriteriaEntry;
 struct ItemPosCount;
 enum AchievementCriteriaTypes : uint8;
 enum InventoryResult : uint8;
@@ -852,9 +856,10 @@ public:
     void BroadcastWorker(Do& _do, Player* except = nullptr)
     {
         for (auto itr = m_members.begin(); itr != m_members.end(); ++itr)
-            if (Player* player = itr->second->FindConnectedPlayer())
-                if (player != except)
-                    _do(player);
+            if (itr->second->IsOnline())
+                if (Player* player = itr->second->FindConnectedPlayer())
+                    if (player != except)
+                        _do(player);
     }
 
     // Members
@@ -891,7 +896,10 @@ public:
     void ResetTimes(bool weekly);
 
     bool HasAchieved(uint32 achievementId) const;
+    // queued, members update criteria from map threads. Requirements are checked right away, progress is applied once per
+    // world update by UpdatePendingAchievementCriteria
     void UpdateAchievementCriteria(AchievementCriteriaTypes type, uint64 miscValue1, uint64 miscValue2, uint64 miscValue3, Unit* unit, Player* player, GameObject* go = nullptr);
+    void UpdatePendingAchievementCriteria();
 
     inline void SetAchievementPointsFor(ObjectGuid guid, uint32 achievementPoint)
     {
@@ -930,6 +938,19 @@ protected:
     LogHolder* m_newsLog;
     AchievementMgr<Guild>* m_achievementMgr;
 
+    struct PendingAchievementCriteria
+    {
+        AchievementCriteriaTypes Type;
+        std::vector<AchievementCriteriaEntry const*> Criteria;
+        uint64 MiscValue1;
+        uint64 MiscValue2;
+        uint64 MiscValue3;
+        ObjectGuid PlayerGUID;
+    };
+
+    std::vector<PendingAchievementCriteria> _pendingAchievementCriteria;
+    std::mutex _pendingAchievementCriteriaLock;
+
     uint8 _level;
     uint64 _experience;
     uint64 _todayExperience;
@@ -1017,5 +1038,7 @@ private:
     void SendGuildRanksUpdate(ObjectGuid setterGuid, ObjectGuid targetGuid, uint32 rank);
 
     void _BroadcastEvent(GuildEvents guildEvent, ObjectGuid guid, char const* param1 = nullptr, char const* param2 = nullptr, char const* param3 = nullptr) const;
+    // copies packet into shared on first use
+    static std::shared_ptr<WorldPacket const> const& ShareBroadcastPacket(WorldPacket const* packet, std::shared_ptr<WorldPacket const>& shared);
 };
 #endif
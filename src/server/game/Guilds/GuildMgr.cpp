@@ -36,11 +36,49 @@ GuildMgr::~GuildMgr()
 void GuildMgr::AddGuild(Guild* guild)
 {
     GuildStore[guild->GetId()] = guild;
+    GuildNameStore[guild->GetName()] = guild;
+}
+
+void GuildMgr::ScheduleAchievementCriteriaUpdate(ObjectGuid::LowType guildId)
+{
+    std::lock_guard<std::mutex> lock(_pendingAchievementCriteriaLock);
+    _pendingAchievementCriteriaGuilds.push_back(guildId);
+}
+
+void GuildMgr::UpdatePendingAchievementCriteria()
+{
+    std::vector<ObjectGuid::LowType> guildIds;
+    {
+        std::lock_guard<std::mutex> lock(_pendingAchievementCriteriaLock);
+        std::swap(guildIds, _pendingAchievementCriteriaGuilds);
+    }
+
+    // disbanded guilds are not found anymore
+    for (ObjectGuid::LowType guildId : guildIds)
+        if (Guild* guild = GetGuildById(guildId))
+            guild->UpdatePendingAchievementCriteria();
 }
 
 void GuildMgr::RemoveGuild(ObjectGuid::LowType guildId)
 {
-    GuildStore.erase(guildId);
+    GuildContainer::iterator itr = GuildStore.find(guildId);
+    if (itr == GuildStore.end())
+        return;
+
+    auto nameItr = GuildNameStore.find(itr->second->GetName());
+    if (nameItr != GuildNameStore.end() && nameItr->second == itr->second)
+        GuildNameStore.erase(nameItr);
+
+    GuildStore.erase(itr);
+}
+
+void GuildMgr::UpdateGuildName(Guild* guild, std::string const& oldName)
+{
+    auto itr = GuildNameStore.find(oldName);
+    if (itr != GuildNameStore.end() && itr->second == guild)
+        GuildNameStore.erase(itr);
+
+    GuildNameStore[guild->GetName()] = guild;
 }
 
 void GuildMgr::SaveGuilds()
@@ -82,15 +120,10 @@ Guild* GuildMgr::GetGuildByGuid(ObjectGuid guid) const
 
 Guild* GuildMgr::GetGuildByName(const std::string& guildName) const
 {
-    std::string search = guildName;
-    std::transform(search.begin(), search.end(), search.begin(), ::toupper);
-    for (GuildContainer::const_iterator itr = GuildStore.begin(); itr != GuildStore.end(); ++itr)
-    {
-        std::string gname = itr->second->GetName();
-        std::transform(gname.begin(), gname.end(), gname.begin(), ::toupper);
-        if (search == gname)
-            return itr->second;
-    }
+    auto itr = GuildNameStore.find(guildName);
+    if (itr != GuildNameStore.end())
+        return itr->second;
+
     return nullptr;
 }
 
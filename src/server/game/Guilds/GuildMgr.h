@@ -18,8 +18,10 @@
 #ifndef _GUILDMGR_H
 #define _GUILDMGR_H
 
+#include "CaseInsensitiveName.h"
 #include "Define.h"
 #include "ObjectGuid.h"
+#include <mutex>
 #include <unordered_map>
 #include <vector>
 
@@ -75,6 +77,7 @@ public:
     void LoadGuilds();
     void AddGuild(Guild* guild);
     void RemoveGuild(ObjectGuid::LowType guildId);
+    void UpdateGuildName(Guild* guild, std::string const& oldName);
     void SaveGuilds();
 
     ObjectGuid::LowType GenerateGuildId();
@@ -87,15 +90,23 @@ public:
 
     void ResetTimes(bool week);
     void ClearExpiredGuildNews();
+
+    // the guild has achievement criteria updates queued, can be called from map threads
+    void ScheduleAchievementCriteriaUpdate(ObjectGuid::LowType guildId);
+    // world thread, once map updates are done
+    void UpdatePendingAchievementCriteria();
 protected:
     typedef std::unordered_map<ObjectGuid::LowType, Guild*> GuildContainer;
     typedef std::unordered_map<uint32 /*skillID*/, std::vector<GuildProfession>> GuildProfessionMap;
     ObjectGuid::LowType NextGuildId;
     GuildContainer GuildStore;
+    Trinity::CaseInsensitiveNameMap<Guild*> GuildNameStore;
     GuildProfessionMap GuildProfessionStore;
     std::vector<uint64> GuildXPperLevel;
     std::vector<GuildReward> GuildRewards;
     std::vector<GuildChallenge> GuildChallenges;
+    std::vector<ObjectGuid::LowType> _pendingAchievementCriteriaGuilds;
+    std::mutex _pendingAchievementCriteriaLock;
 };
 
 #define sGuildMgr GuildMgr::instance()
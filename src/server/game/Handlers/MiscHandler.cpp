@@ -230,46 +230,47 @@ void WorldSession::HandleWhoOpcode(WorldPackets::Who::WhoRequestPkt& whoRequest)
 
     WorldPackets::Who::WhoResponsePkt response;
 
-    WhoListInfoVector const& whoList = sWhoListStorageMgr->GetWhoList();
-    for (WhoListPlayerInfo const& target : whoList)
+    WhoListInfoVector whoList;
+    sWhoListStorageMgr->GetCandidates(request.MinLevel, request.MaxLevel, request.ClassFilter, request.RaceFilter, request.Areas, wPlayerName, whoList);
+    for (WhoListPlayerInfo const* target : whoList)
     {
         // player can see member of other team only if has RBAC_PERM_TWO_SIDE_WHO_LIST
-        if (target.GetTeam() != team && !HasPermission(rbac::RBAC_PERM_TWO_SIDE_WHO_LIST))
+        if (target->GetTeam() != team && !HasPermission(rbac::RBAC_PERM_TWO_SIDE_WHO_LIST))
             continue;
 
         // player can see MODERATOR, GAME MASTER, ADMINISTRATOR only if has RBAC_PERM_WHO_SEE_ALL_SEC_LEVELS
-        if (target.GetSecurity() > AccountTypes(gmLevelInWhoList) && !HasPermission(rbac::RBAC_PERM_WHO_SEE_ALL_SEC_LEVELS))
+        if (target->GetSecurity() > AccountTypes(gmLevelInWhoList) && !HasPermission(rbac::RBAC_PERM_WHO_SEE_ALL_SEC_LEVELS))
             continue;
 
         // check if target is globally visible for player
-        if (_player->GetGUID() != target.GetGuid() && !target.IsVisible())
-            if (AccountMgr::IsPlayerAccount(_player->GetSession()->GetSecurity()) || target.GetSecurity() > _player->GetSession()->GetSecurity())
+        if (_player->GetGUID() != target->GetGuid() && !target->IsVisible())
+            if (AccountMgr::IsPlayerAccount(_player->GetSession()->GetSecurity()) || target->GetSecurity() > _player->GetSession()->GetSecurity())
                 continue;
 
         // check if target's level is in level range
-        uint8 lvl = target.GetLevel();
+        uint8 lvl = target->GetLevel();
         if (lvl < request.MinLevel || lvl > request.MaxLevel)
             continue;
 
         // check if class matches classmask
-        if (request.ClassFilter >= 0 && !(request.ClassFilter & (1 << target.GetClass())))
+        if (request.ClassFilter >= 0 && !(request.ClassFilter & (1 << target->GetClass())))
             continue;
 
         // check if race matches racemask
-        if (request.RaceFilter >= 0 && (request.RaceFilter & (1 << target.GetRace())))
+        if (request.RaceFilter >= 0 && (request.RaceFilter & (1 << target->GetRace())))
             continue;
 
         if (!whoRequest.Request.Areas.empty())
         {
-            if (std::find(whoRequest.Request.Areas.begin(), whoRequest.Request.Areas.end(), int32(target.GetZoneId())) == whoRequest.Request.Areas.end())
+            if (std::find(whoRequest.Request.Areas.begin(), whoRequest.Request.Areas.end(), int32(target->GetZoneId())) == whoRequest.Request.Areas.end())
                 continue;
         }
 
-        std::wstring const& wTargetName = target.GetWidePlayerName();
+        std::wstring const& wTargetName = target->GetWidePlayerName();
         if (!(wPlayerName.empty() || wTargetName.find(wPlayerName) != std::wstring::npos))
             continue;
 
-        std::wstring const& wTargetGuildName = target.GetWideGuildName();
+        std::wstring const& wTargetGuildName = target->GetWideGuildName();
 
         if (!wGuildName.empty() && wTargetGuildName.find(wGuildName) == std::wstring::npos)
             continue;
@@ -277,7 +278,7 @@ void WorldSession::HandleWhoOpcode(WorldPackets::Who::WhoRequestPkt& whoRequest)
         if (!wWords.empty())
         {
             std::string aName;
-            if (AreaTableEntry const* areaEntry = sAreaTableStore.LookupEntry(target.GetZoneId()))
+            if (AreaTableEntry const* areaEntry = sAreaTableStore.LookupEntry(target->GetZoneId()))
                 aName = areaEntry->AreaName[GetSessionDbcLocale()];
 
             bool show = false;
@@ -300,13 +301,13 @@ void WorldSession::HandleWhoOpcode(WorldPackets::Who::WhoRequestPkt& whoRequest)
         }
 
         WorldPackets::Who::WhoEntry whoEntry;
-        if (!whoEntry.PlayerData.Initialize(target.GetGuid(), nullptr))
+        if (!whoEntry.PlayerData.Initialize(target->GetGuid(), nullptr))
             continue;
 
-        if (!target.GetGuildName().empty())
-            whoEntry.GuildName = target.GetGuildName();
+        if (!target->GetGuildName().empty())
+            whoEntry.GuildName = target->GetGuildName();
 
-        whoEntry.AreaID = target.GetZoneId();
+        whoEntry.AreaID = target->GetZoneId();
 
         response.Response.Entries.push_back(whoEntry);
 
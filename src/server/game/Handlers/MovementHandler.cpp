@@ -27,6 +27,7 @@
 #include "MapManager.h"
 #include "MotionMaster.h"
 #include "MovementGenerator.h"
+#include "MovementRelay.h"
 #include "MovementPacketSender.h"
 #include "MovementPackets.h"
 #include "MovementStructures.h"
@@ -419,9 +420,14 @@ void WorldSession::HandleMovementOpcode(uint16 opcode, MovementInfo& movementInf
 
     mover->UpdatePosition(movementInfo.pos);
 
-    WorldPacket data(SMSG_MOVE_UPDATE);
-    mover->WriteMovementInfo(data);
-    mover->SendMessageToSet(&data, _player);
+    if (mover->IsInWorld())
+        mover->GetMap()->GetMovementRelay().Relay(mover, _player, opcode == MSG_MOVE_HEARTBEAT);
+    else
+    {
+        WorldPacket data(SMSG_MOVE_UPDATE);
+        mover->WriteMovementInfo(data);
+        mover->SendMessageToSet(&data, _player);
+    }
 
     if (plrMover)                                            // nothing is charmed, or player charmed
     {
@@ -18,6 +18,7 @@
 #include "WorldSession.h"
 #include "AccountMgr.h"
 #include "CharacterCache.h"
+#include "LFGMgr.h"
 #include "Log.h"
 #include "ObjectAccessor.h"
 #include "ObjectMgr.h"
@@ -156,6 +157,8 @@ void WorldSession::HandleAddIgnoreOpcode(WorldPacket& recvData)
             // ignore list full
             if (!GetPlayer()->GetSocial()->AddToSocialList(ignoreGuid, SOCIAL_FLAG_IGNORED))
                 ignoreResult = FRIEND_IGNORE_FULL;
+            else
+                sLFGMgr->IgnoreListChanged(GetPlayer()->GetGUID());
         }
     }
 
@@ -170,6 +173,7 @@ void WorldSession::HandleDelIgnoreOpcode(WorldPacket& recvData)
     TC_LOG_DEBUG("network", "WorldSession::HandleDelIgnoreOpcode: %s", ignoreGuid.ToString().c_str());
 
     _player->GetSocial()->RemoveFromSocialList(ignoreGuid, SOCIAL_FLAG_IGNORED);
+    sLFGMgr->IgnoreListChanged(_player->GetGUID());
 
     sSocialMgr->SendFriendStatus(GetPlayer(), FRIEND_IGNORE_REMOVED, ignoreGuid);
 }
@@ -230,6 +230,8 @@ void MailDraft::SendMailTo(CharacterDatabaseTransaction& trans, MailReceiver con
     stmt->setUInt8 (++index, uint8(checked));
     trans->Append(stmt);
 
+    sObjectMgr->ScheduleMailExpiration(mailId, expire_time);
+
     for (MailItemMap::const_iterator mailItemIter = m_items.begin(); mailItemIter != m_items.end(); ++mailItemIter)
     {
         Item* pItem = mailItemIter->second;
@@ -31,6 +31,7 @@ class Player;
 
 #define MAIL_BODY_ITEM_TEMPLATE 8383                        // - plain letter, A Dusty Unsent Letter: 889
 #define MAX_MAIL_ITEMS 12
+#define MAIL_EXPIRATION_BATCH_SIZE 50                       // expired mails selected by id and handled per character db transaction
 
 enum MailMessageType
 {
@@ -0,0 +1,135 @@
+/*
+ * This file is part of the TrinityCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "CreatureUpdateStates.h"
+#include "Creature.h"
+#include <algorithm>
+#include <functional>
+
+std::atomic<uint64> CreatureUpdateStates::_updated(0);
+std::atomic<uint64> CreatureUpdateStates::_skipped(0);
+
+uint32 CreatureUpdateStates::Add(Creature* creature, uint32 cellId)
+{
+    _creatures.push_back(creature);
+    _cells.push_back(cellId);
+    _wakeTimes.push_back(0);
+    _sleptTimes.push_back(0);
+    _flags.push_back(CREATURE_UPDATE_STATE_BUSY);
+    return uint32(_creatures.size() - 1);
+}
+
+void CreatureUpdateStates::Remove(uint32 slot)
+{
+    // slots must stay where they are while the update walks them
+    if (_updating)
+    {
+        _creatures[slot] = nullptr;
+        _removedSlots.push_back(slot);
+        return;
+    }
+
+    std::size_t last = _creatures.size() - 1;
+    if (slot != last)
+    {
+        _creatures[slot] = _creatures[last];
+        _cells[slot] = _cells[last];
+        _wakeTimes[slot] = _wakeTimes[last];
+        _sleptTimes[slot] = _sleptTimes[last];
+        _flags[slot] = _flags[last];
+        _creatures[slot]->SetUpdateStateSlot(slot);
+    }
+
+    _creatures.pop_back();
+    _cells.pop_back();
+    _wakeTimes.pop_back();
+    _sleptTimes.pop_back();
+    _flags.pop_back();
+}
+
+void CreatureUpdateStates::Update(uint32 diff, uint32 time, std::bitset<TOTAL_NUMBER_OF_CELLS_PER_MAP * TOTAL_NUMBER_OF_CELLS_PER_MAP> const& visitedCells)
+{
+    uint64 updated = 0;
+    uint64 skipped = 0;
+
+    _updating = true;
+    _awakeCount = 0;
+    _engagedCount = 0;
+
+    // creatures added by the update wait for the next one
+    std::size_t const count = _creatures.size();
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        if (!visitedCells.test(_cells[i]) || !_creatures[i])
+            continue;
+
+        if ((_flags[i] & CREATURE_UPDATE_STATE_IDLE) && int32(_wakeTimes[i] - time) > 0)
+        {
+            _sleptTimes[i] += diff;
+            ++skipped;
+            continue;
+        }
+
+        Creature* creature = _creatures[i];
+        uint32 creatureDiff = _sleptTimes[i] + diff;
+        _sleptTimes[i] = 0;
+        _flags[i] = 0;
+
+        creature->Update(creatureDiff);
+        ++updated;
+
+        // removed from world by its update
+        if (_creatures[i] != creature)
+            continue;
+
+        uint32 idleTime = 0;
+        _flags[i] |= creature->GetUpdateState(idleTime);
+        _wakeTimes[i] = time + idleTime;
+
+        if (!(_flags[i] & CREATURE_UPDATE_STATE_IDLE))
+            ++_awakeCount;
+        if (_flags[i] & (CREATURE_UPDATE_STATE_ENGAGED | CREATURE_UPDATE_STATE_EVADING))
+            ++_engagedCount;
+    }
+
+    _updating = false;
+    Compact();
+
+    _updated += updated;
+    _skipped += skipped;
+}
+
+CreatureUpdateStates::Stats CreatureUpdateStates::ConsumeStats()
+{
+    Stats stats;
+    stats.Updated = _updated.exchange(0);
+    stats.Skipped = _skipped.exchange(0);
+    return stats;
+}
+
+void CreatureUpdateStates::Compact()
+{
+    if (_removedSlots.empty())
+        return;
+
+    // highest first, every slot after the one removed is valid then
+    std::sort(_removedSlots.begin(), _removedSlots.end(), std::greater<uint32>());
+    for (uint32 slot : _removedSlots)
+        Remove(slot);
+
+    _removedSlots.clear();
+}
@@ -0,0 +1,92 @@
+/*
+ * This file is part of the TrinityCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TRINITY_CREATUREUPDATESTATES_H
+#define TRINITY_CREATUREUPDATESTATES_H
+
+#include "GridDefines.h"
+#include <atomic>
+#include <bitset>
+#include <vector>
+
+class Creature;
+
+enum CreatureUpdateStateFlags : uint8
+{
+    CREATURE_UPDATE_STATE_IDLE          = 0x01,     // nothing to do before the wake time
+    CREATURE_UPDATE_STATE_ENGAGED       = 0x02,
+    CREATURE_UPDATE_STATE_EVADING       = 0x04,
+    CREATURE_UPDATE_STATE_MOVING        = 0x08,     // movement generator or spline running
+    CREATURE_UPDATE_STATE_REGENERATING  = 0x10,
+    CREATURE_UPDATE_STATE_BUSY          = 0x20      // spells, auras, events, death or an AI that needs its updates
+};
+
+// Per tick state of the creatures of a map, kept in arrays so a map update finds the creatures of the
+// visited cells and skips idle ones without touching them. Idle creatures get the time they slept with
+// their next update.
+class TC_GAME_API CreatureUpdateStates
+{
+    public:
+        struct Stats
+        {
+            uint64 Updated = 0;
+            uint64 Skipped = 0;
+        };
+
+        static uint32 const InvalidSlot = 0xFFFFFFFF;
+
+        CreatureUpdateStates() : _updating(false), _awakeCount(0), _engagedCount(0) { }
+
+        CreatureUpdateStates(CreatureUpdateStates const&) = delete;
+        CreatureUpdateStates& operator=(CreatureUpdateStates const&) = delete;
+
+        uint32 Add(Creature* creature, uint32 cellId);
+        void Remove(uint32 slot);
+
+        void SetCell(uint32 slot, uint32 cellId) { _cells[slot] = cellId; }
+        // something happened to the creature, it is updated with the next visit of its cell
+        void Wake(uint32 slot, uint8 reason) { _flags[slot] = reason; }
+        uint8 GetFlags(uint32 slot) const { return _flags[slot]; }
+
+        // updates the creatures in the visited cells, time is the game time in milliseconds
+        void Update(uint32 diff, uint32 time, std::bitset<TOTAL_NUMBER_OF_CELLS_PER_MAP * TOTAL_NUMBER_OF_CELLS_PER_MAP> const& visitedCells);
+
+        // creatures left awake and engaged or evading by the last update
+        uint32 GetAwakeCount() const { return _awakeCount; }
+        uint32 GetEngagedCount() const { return _engagedCount; }
+
+        static Stats ConsumeStats();
+
+    private:
+        void Compact();
+
+        std::vector<Creature*> _creatures;      // null for creatures removed during an update
+        std::vector<uint32> _cells;
+        std::vector<uint32> _wakeTimes;
+        std::vector<uint32> _sleptTimes;        // diffs skipped while idle
+        std::vector<uint8> _flags;
+
+        std::vector<uint32> _removedSlots;
+        bool _updating;
+        uint32 _awakeCount;
+        uint32 _engagedCount;
+
+        static std::atomic<uint64> _updated;
+        static std::atomic<uint64> _skipped;
+};
+
+#endif // TRINITY_CREATUREUPDATESTATES_H
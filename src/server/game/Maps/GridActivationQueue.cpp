@@ -0,0 +1,363 @@
+/*
+ * This file is part of the TrinityCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "GridActivationQueue.h"
+#include "FlightPathMovementGenerator.h"
+#include "Log.h"
+#include "Map.h"
+#include "MapManager.h"
+#include "MapTree.h"
+#include "MotionMaster.h"
+#include "ObjectGridLoader.h"
+#include "Player.h"
+#include "StringFormat.h"
+#include "World.h"
+#include <cmath>
+#include <cstdio>
+#include <limits>
+
+namespace
+{
+    // at most this many grids are prefetched at the same time on a map
+    std::size_t const MaxActivations = 8;
+
+    uint32 const PrefetchInterval = 500;
+
+    uint32 const CellsPerGrid = MAX_NUMBER_OF_CELLS * MAX_NUMBER_OF_CELLS;
+
+    // reads the whole file so the map thread finds it in the page cache
+    void ReadFile(std::string const& fileName)
+    {
+        FILE* file = fopen(fileName.c_str(), "rb");
+        if (!file)
+            return;
+
+        char buffer[64 * 1024];
+        while (fread(buffer, 1, sizeof(buffer), file) == sizeof(buffer))
+            ;
+
+        fclose(file);
+    }
+}
+
+PreparedGrid::PreparedGrid(std::vector<uint32> terrainMapIds, int32 gx, int32 gy) : _gx(gx), _gy(gy), _ready(false)
+{
+    _terrains.reserve(terrainMapIds.size());
+    for (uint32 mapId : terrainMapIds)
+        _terrains.push_back({ mapId, nullptr });
+}
+
+PreparedGrid::~PreparedGrid() = default;
+
+bool PreparedGrid::TakeGridMap(uint32 terrainMapId, std::shared_ptr<GridMap>& gridMap)
+{
+    for (Terrain& terrain : _terrains)
+    {
+        if (terrain.MapId == terrainMapId)
+        {
+            gridMap = std::move(terrain.Data);
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void PreparedGrid::Prepare()
+{
+    std::string const& dataPath = sWorld->GetDataPath();
+    for (Terrain& terrain : _terrains)
+    {
+        std::string fileName = Trinity::StringFormat("%smaps/%03u%02u%02u.map", dataPath.c_str(), terrain.MapId, _gx, _gy);
+        std::shared_ptr<GridMap> gridMap = std::make_shared<GridMap>();
+        GridMap::LoadResult result = gridMap->loadData(fileName.c_str());
+        if (result == GridMap::LoadResult::Ok)
+            terrain.Data = std::move(gridMap);
+        else if (result == GridMap::LoadResult::InvalidFile)
+            TC_LOG_ERROR("maps", "Error loading map file: %s", fileName.c_str());
+    }
+
+    // vmap and mmap tiles are shared with other map threads and are loaded when the map creates the grid
+    if (!_terrains.empty())
+    {
+        ReadFile(dataPath + "vmaps/" + VMAP::StaticMapTree::getTileFileName(_terrains.front().MapId, _gx, _gy));
+        ReadFile(Trinity::StringFormat("%smmaps/%03u%02u%02u.mmtile", dataPath.c_str(), _terrains.front().MapId, _gx, _gy));
+    }
+
+    _ready.store(true, std::memory_order_release);
+}
+
+void GridPreparationProcessor::activate(size_t num_threads)
+{
+    for (size_t i = 0; i < num_threads; ++i)
+        _workerThreads.push_back(std::thread(&GridPreparationProcessor::WorkerThread, this));
+}
+
+void GridPreparationProcessor::deactivate()
+{
+    _cancelationToken = true;
+
+    _queue.Cancel();
+
+    for (auto& thread : _workerThreads)
+        thread.join();
+
+    _workerThreads.clear();
+}
+
+void GridPreparationProcessor::schedule(std::shared_ptr<PreparedGrid> grid)
+{
+    _queue.Push(std::move(grid));
+}
+
+void GridPreparationProcessor::WorkerThread()
+{
+    while (1)
+    {
+        std::shared_ptr<PreparedGrid> grid;
+
+        _queue.WaitAndPop(grid);
+
+        if (_cancelationToken)
+            return;
+
+        // the map may have given up on the grid already
+        if (grid && grid.use_count() > 1)
+            grid->Prepare();
+    }
+}
+
+GridActivationQueue::GridActivationQueue(Map* map) : _map(map)
+{
+    _prefetchTimer.SetInterval(PrefetchInterval);
+}
+
+GridActivationQueue::~GridActivationQueue() = default;
+
+void GridActivationQueue::Update(uint32 diff)
+{
+    _prefetchTimer.Update(diff);
+    if (_prefetchTimer.Passed())
+    {
+        _prefetchTimer.Reset();
+
+        Map::PlayerList const& players = _map->GetPlayers();
+        for (Map::PlayerList::const_iterator itr = players.begin(); itr != players.end(); ++itr)
+            if (Player* player = itr->GetSource())
+                if (player->IsInWorld())
+                    PrefetchAhead(player);
+    }
+
+    if (_activations.empty())
+        return;
+
+    uint32 const budget = sWorld->getIntConfig(CONFIG_GRID_ACTIVATION_BUDGET);
+    uint32 const startTime = getMSTime();
+    for (auto itr = _order.begin(); itr != _order.end();)
+    {
+        Activation& activation = _activations.at(*itr);
+        if (!activation.Started)
+        {
+            // loaded synchronously in the meantime
+            if (_map->IsGridLoaded(activation.Coord))
+            {
+                _activations.erase(*itr);
+                itr = _order.erase(itr);
+                continue;
+            }
+
+            if (!Start(activation))
+            {
+                ++itr;
+                continue;
+            }
+        }
+
+        uint32 elapsed = GetMSTimeDiffToNow(startTime);
+        if (elapsed >= budget)
+            break;
+
+        if (LoadCells(activation, budget - elapsed))
+        {
+            _activations.erase(*itr);
+            itr = _order.erase(itr);
+        }
+        else
+            break;
+    }
+}
+
+void GridActivationQueue::Finish(GridCoord const& p)
+{
+    auto itr = _activations.find(p.GetId());
+    if (itr == _activations.end() || !itr->second.Started)
+        return;
+
+    // needed by an object of one of its cells, the cells after it stay empty until LoadCells gets to them
+    if (itr->second.Loading)
+    {
+        TC_LOG_WARN("maps", "Grid[%u, %u] for map %u instance %u needed while loading cell %u, remaining cells are not loaded yet",
+            p.x_coord, p.y_coord, _map->GetId(), _map->GetInstanceId(), itr->second.NextCell);
+        return;
+    }
+
+    LoadCells(itr->second, std::numeric_limits<uint32>::max());
+    _order.remove(p.GetId());
+    _activations.erase(itr);
+}
+
+void GridActivationQueue::Cancel(GridCoord const& p)
+{
+    if (_activations.erase(p.GetId()))
+        _order.remove(p.GetId());
+}
+
+void GridActivationQueue::Prefetch(GridCoord const& p)
+{
+    if (!p.IsCoordValid() || _activations.size() >= MaxActivations || _activations.count(p.GetId()) || _map->IsGridLoaded(p))
+        return;
+
+    std::shared_ptr<PreparedGrid> prepared;
+
+    // terrain file coordinates are mirrored
+    int32 gx = (MAX_NUMBER_OF_GRIDS - 1) - p.x_coord;
+    int32 gy = (MAX_NUMBER_OF_GRIDS - 1) - p.y_coord;
+    GridPreparationProcessor* processor = sMapMgr->GetGridPreparationProcessor();
+    if (processor->activated())
+    {
+        Map* rootParentTerrainMap = _map->m_parentMap->GetRootParentTerrainMap();
+        std::vector<uint32> terrainMapIds;
+        {
+            // terrain of the parent map is also loaded from map threads of child terrain maps, always under this lock
+            std::lock_guard<std::mutex> lock(rootParentTerrainMap->_gridLock);
+            if (!_map->m_parentMap->GridMaps[gx][gy])
+                CollectTerrainMapIds(rootParentTerrainMap, terrainMapIds);
+        }
+
+        if (!terrainMapIds.empty())
+        {
+            prepared = std::make_shared<PreparedGrid>(std::move(terrainMapIds), gx, gy);
+            processor->schedule(prepared);
+        }
+    }
+
+    _activations.emplace(p.GetId(), Activation{ p, std::move(prepared), 0, false, false });
+    _order.push_back(p.GetId());
+}
+
+void GridActivationQueue::PrefetchAhead(Player const* player)
+{
+    float distance = sWorld->getFloatConfig(CONFIG_GRID_PREFETCH_DISTANCE);
+    if (distance <= 0.0f)
+        return;
+
+    float range = _map->GetVisibilityRange();
+    if (player->IsInFlight())
+    {
+        if (player->GetMotionMaster()->GetCurrentMovementGeneratorType() != FLIGHT_MOTION_TYPE)
+            return;
+
+        // upcoming nodes of the flight path on this map
+        FlightPathMovementGenerator* flight = static_cast<FlightPathMovementGenerator*>(player->GetMotionMaster()->top());
+        TaxiPathNodeList const& path = flight->GetPath();
+        float x = player->GetPositionX();
+        float y = player->GetPositionY();
+        float traveled = 0.0f;
+        for (uint32 i = flight->GetCurrentNode(); i < path.size() && traveled < distance; ++i)
+        {
+            if (path[i]->ContinentID != _map->GetId())
+                break;
+
+            traveled += std::sqrt((path[i]->Loc.X - x) * (path[i]->Loc.X - x) + (path[i]->Loc.Y - y) * (path[i]->Loc.Y - y));
+            x = path[i]->Loc.X;
+            y = path[i]->Loc.Y;
+            PrefetchAround(x, y, range);
+        }
+        return;
+    }
+
+    if (!player->isMoving())
+        return;
+
+    float forward = player->HasUnitMovementFlag(MOVEMENTFLAG_FORWARD) ? 1.0f : player->HasUnitMovementFlag(MOVEMENTFLAG_BACKWARD) ? -1.0f : 0.0f;
+    float strafe = player->HasUnitMovementFlag(MOVEMENTFLAG_STRAFE_LEFT) ? 1.0f : player->HasUnitMovementFlag(MOVEMENTFLAG_STRAFE_RIGHT) ? -1.0f : 0.0f;
+    float angle = player->GetOrientation();
+    if (forward != 0.0f || strafe != 0.0f)
+        angle += std::atan2(strafe, forward);
+
+    PrefetchAround(player->GetPositionX() + std::cos(angle) * distance, player->GetPositionY() + std::sin(angle) * distance, range);
+}
+
+void GridActivationQueue::PrefetchAround(float x, float y, float range)
+{
+    // every grid overlapped by the visibility range around the point
+    float lowX = x - range, lowY = y - range, highX = x + range, highY = y + range;
+    Trinity::NormalizeMapCoord(lowX);
+    Trinity::NormalizeMapCoord(lowY);
+    Trinity::NormalizeMapCoord(highX);
+    Trinity::NormalizeMapCoord(highY);
+
+    GridCoord low = Trinity::ComputeGridCoord(lowX, lowY);
+    GridCoord high = Trinity::ComputeGridCoord(highX, highY);
+    for (uint32 gridX = low.x_coord; gridX <= high.x_coord; ++gridX)
+        for (uint32 gridY = low.y_coord; gridY <= high.y_coord; ++gridY)
+            Prefetch(GridCoord(gridX, gridY));
+}
+
+void GridActivationQueue::CollectTerrainMapIds(Map* terrainMap, std::vector<uint32>& terrainMapIds)
+{
+    // same order as Map::LoadMap
+    terrainMapIds.push_back(terrainMap->GetId());
+    for (Map* childTerrainMap : *terrainMap->m_childTerrainMaps)
+        CollectTerrainMapIds(childTerrainMap, terrainMapIds);
+}
+
+bool GridActivationQueue::Start(Activation& activation)
+{
+    if (activation.Prepared && !activation.Prepared->IsReady())
+        return false;
+
+    TC_LOG_DEBUG("maps", "Activating prefetched grid[%u, %u] for map %u instance %u", activation.Coord.x_coord, activation.Coord.y_coord, _map->GetId(), _map->GetInstanceId());
+
+    _map->EnsureGridCreated(activation.Coord, activation.Prepared.get());
+    activation.Prepared.reset();
+
+    // objects spawned from now on are added to the grid directly, stored spawns are loaded by cell
+    _map->setGridObjectDataLoaded(true, activation.Coord.x_coord, activation.Coord.y_coord);
+    _map->LoadGridRespawns(activation.Coord);
+    activation.Started = true;
+    return true;
+}
+
+bool GridActivationQueue::LoadCells(Activation& activation, uint32 budget)
+{
+    NGridType* grid = _map->getNGrid(activation.Coord.x_coord, activation.Coord.y_coord);
+    ObjectGridLoader loader(*grid, _map, Cell(CellCoord(activation.Coord.x_coord * MAX_NUMBER_OF_CELLS, activation.Coord.y_coord * MAX_NUMBER_OF_CELLS)));
+
+    // creature scripts may look at the grid while it is loaded, Finish must not start over
+    activation.Loading = true;
+
+    uint32 const startTime = getMSTime();
+    do
+    {
+        loader.LoadCell(activation.NextCell / MAX_NUMBER_OF_CELLS, activation.NextCell % MAX_NUMBER_OF_CELLS);
+        ++activation.NextCell;
+    } while (activation.NextCell < CellsPerGrid && GetMSTimeDiffToNow(startTime) < budget);
+
+    activation.Loading = false;
+    return activation.NextCell >= CellsPerGrid;
+}
@@ -0,0 +1,138 @@
+/*
+ * This file is part of the TrinityCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TRINITY_GRIDACTIVATIONQUEUE_H
+#define TRINITY_GRIDACTIVATIONQUEUE_H
+
+#include "GridDefines.h"
+#include "ProducerConsumerQueue.h"
+#include "Timer.h"
+#include <atomic>
+#include <list>
+#include <memory>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+class GridMap;
+class Map;
+class Player;
+
+// Terrain files of a grid, read by a preparation thread before the map thread creates the grid.
+// Only touches files, everything shared with map threads stays on the map thread.
+class TC_GAME_API PreparedGrid
+{
+    public:
+        // gx and gy are terrain file coordinates, terrainMapIds the maps sharing the terrain (root parent first)
+        PreparedGrid(std::vector<uint32> terrainMapIds, int32 gx, int32 gy);
+        ~PreparedGrid();
+
+        PreparedGrid(PreparedGrid const&) = delete;
+        PreparedGrid& operator=(PreparedGrid const&) = delete;
+
+        bool IsReady() const { return _ready.load(std::memory_order_acquire); }
+
+        // map thread, once ready. Returns false when the terrain of that map was not prepared,
+        // gridMap is null when its file could not be loaded
+        bool TakeGridMap(uint32 terrainMapId, std::shared_ptr<GridMap>& gridMap);
+
+    private:
+        friend class GridPreparationProcessor;
+
+        struct Terrain
+        {
+            uint32 MapId;
+            std::shared_ptr<GridMap> Data;
+        };
+
+        void Prepare();
+
+        std::vector<Terrain> _terrains;
+        int32 _gx;
+        int32 _gy;
+        std::atomic<bool> _ready;
+};
+
+// Threads reading terrain files of prefetched grids for all maps
+class TC_GAME_API GridPreparationProcessor
+{
+    public:
+        GridPreparationProcessor() : _cancelationToken(false) { }
+
+        void activate(size_t num_threads);
+
+        void deactivate();
+
+        bool activated() const { return !_workerThreads.empty(); }
+
+        void schedule(std::shared_ptr<PreparedGrid> grid);
+
+    private:
+        void WorkerThread();
+
+        ProducerConsumerQueue<std::shared_ptr<PreparedGrid>> _queue;
+        std::vector<std::thread> _workerThreads;
+        std::atomic<bool> _cancelationToken;
+};
+
+// Per map loading of grids ahead of the players. Grids along a player's heading or flight path are
+// prepared by GridPreparationProcessor and then activated a few cells at a time during map updates.
+// An activating grid counts as loaded, anything needing one of its cells finishes the activation first.
+class TC_GAME_API GridActivationQueue
+{
+    public:
+        explicit GridActivationQueue(Map* map);
+        ~GridActivationQueue();
+
+        GridActivationQueue(GridActivationQueue const&) = delete;
+        GridActivationQueue& operator=(GridActivationQueue const&) = delete;
+
+        void Update(uint32 diff);
+
+        bool IsActivating(GridCoord const& p) const { return !_activations.empty() && _activations.count(p.GetId()); }
+        // loads every remaining cell of the grid right away
+        void Finish(GridCoord const& p);
+        // grid is being unloaded
+        void Cancel(GridCoord const& p);
+
+        void Prefetch(GridCoord const& p);
+        void PrefetchAhead(Player const* player);
+
+    private:
+        struct Activation
+        {
+            GridCoord Coord;
+            std::shared_ptr<PreparedGrid> Prepared;
+            uint32 NextCell;
+            bool Started;
+            bool Loading;
+        };
+
+        static void CollectTerrainMapIds(Map* terrainMap, std::vector<uint32>& terrainMapIds);
+
+        void PrefetchAround(float x, float y, float range);
+        bool Start(Activation& activation);
+        // returns true once every cell is loaded
+        bool LoadCells(Activation& activation, uint32 budget);
+
+        Map* _map;
+        std::unordered_map<uint32, Activation> _activations;
+        std::list<uint32> _order;
+        IntervalTimer _prefetchTimer;
+};
+
+#endif // TRINITY_GRIDACTIVATIONQUEUE_H
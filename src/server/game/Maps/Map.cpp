@@ -18,6 +18,7 @@
 #include "Map.h"
 #include "Battleground.h"
 #include "CellImpl.h"
+#include "CinematicMgr.h"
 #include "DatabaseEnv.h"
 #include "DBCStores.h"
 #include "DisableMgr.h"
@@ -27,6 +28,7 @@
 #include "GridNotifiers.h"
 #include "GridNotifiersImpl.h"
 #include "GridStates.h"
+#include "GridActivationQueue.h"
 #include "Group.h"
 #include "InstanceScript.h"
 #include "InstancePackets.h"
@@ -36,9 +38,11 @@
 #include "MMapFactory.h"
 #include "MiscPackets.h"
 #include "MotionMaster.h"
+#include "MovementRelay.h"
 #include "ObjectAccessor.h"
 #include "ObjectGridLoader.h"
 #include "ObjectMgr.h"
+#include "PathRequestQueue.h"
 #include "Pet.h"
 #include "PoolMgr.h"
 #include "PhasingHandler.h"
@@ -52,12 +56,10 @@
 #include "World.h"
 #include "WorldStateMgr.h"
 #include "WorldStatePackets.h"
+#include <atomic>
 #include <unordered_set>
 #include <vector>
 
-#include "Hacks/boost_1_74_fibonacci_heap.h"
-BOOST_1_74_FIBONACCI_HEAP_MSVC_COMPILE_FIX(RespawnListContainer::value_type)
-
 u_map_magic MapMagic        = { {'M','A','P','S'} };
 uint32 MapVersionMagic      = 10;
 u_map_magic MapAreaMagic    = { {'A','R','E','A'} };
@@ -73,6 +75,19 @@ static uint16 const holetab_v[4] = { 0x000F, 0x00F0, 0x0F00, 0xF000 };
 
 GridState* si_GridStates[MAX_GRID_STATE];
 
+namespace
+{
+    std::atomic<uint64> RelocationVisitedCells(0);
+    std::atomic<uint64> RelocationUpdates(0);
+    std::atomic<uint64> RateUpdates[Map::MAX_UPDATE_RATES] = { };
+    std::atomic<uint64> RateSkippedUpdates(0);
+
+    uint64 MakeRespawnTimeKey(SpawnObjectType type, ObjectGuid::LowType spawnId)
+    {
+        return (uint64(type) << 32) | spawnId;
+    }
+}
+
 ZoneDynamicInfo::ZoneDynamicInfo() : MusicId(0), DefaultWeather(nullptr), WeatherId(WEATHER_STATE_FINE),
 Intensity(0.0f) { }
 
@@ -84,6 +99,7 @@ Map::~Map()
 
     // Delete all waiting spawns, else there will be a memory leak
     // This doesn't delete from database.
+    SavePendingRespawnTimesDB();
     UnloadAllRespawnInfos();
 
     while (!i_worldObjects.empty())
@@ -101,6 +117,9 @@ Map::~Map()
     if (m_parentMap == this)
         delete m_childTerrainMaps;
 
+    // running path requests still use this instance's navmesh
+    _pathRequestQueue->CancelAll();
+
     MMAP::MMapFactory::createOrGetMMapManager()->unloadMapInstance(GetId(), i_InstanceId);
 }
 
@@ -237,25 +256,36 @@ void Map::LoadVMap(int gx, int gy)
     }
 }
 
-void Map::LoadMap(int gx, int gy)
+void Map::LoadMap(int gx, int gy, PreparedGrid* prepared)
 {
-    LoadMapImpl(this, gx, gy);
+    LoadMapImpl(this, gx, gy, prepared);
 
     for (Map* childBaseMap : *m_childTerrainMaps)
-        childBaseMap->LoadMap(gx, gy);
+        childBaseMap->LoadMap(gx, gy, prepared);
 }
 
-void Map::LoadMapImpl(Map* map, int gx, int gy)
+void Map::LoadMapImpl(Map* map, int gx, int gy, PreparedGrid* prepared)
 {
     if (map->GridMaps[gx][gy])
         return;
 
     // map file name
     std::string fileName = Trinity::StringFormat("%smaps/%03u%02u%02u.map", sWorld->GetDataPath().c_str(), map->GetId(), gx, gy);
-    TC_LOG_DEBUG("maps", "Loading map %s", fileName.c_str());
-    // loading data
-    std::shared_ptr<GridMap> gridMap = std::make_shared<GridMap>();
-    GridMap::LoadResult gridMapLoadResult = gridMap->loadData(fileName.c_str());
+    // loading data, prepared grids were read by a preparation thread and already reported invalid files
+    std::shared_ptr<GridMap> gridMap;
+    GridMap::LoadResult gridMapLoadResult = GridMap::LoadResult::FileDoesNotExist;
+    if (prepared && prepared->TakeGridMap(map->GetId(), gridMap))
+    {
+        if (gridMap)
+            gridMapLoadResult = GridMap::LoadResult::Ok;
+    }
+    else
+    {
+        TC_LOG_DEBUG("maps", "Loading map %s", fileName.c_str());
+        gridMap = std::make_shared<GridMap>();
+        gridMapLoadResult = gridMap->loadData(fileName.c_str());
+    }
+
     if (gridMapLoadResult == GridMap::LoadResult::Ok)
         map->GridMaps[gx][gy] = std::move(gridMap);
     else
@@ -291,15 +321,23 @@ void Map::UnloadMapImpl(Map* map, int gx, int gy)
     map->GridMaps[gx][gy] = nullptr;
 }
 
-void Map::LoadMapAndVMap(int gx, int gy)
+void Map::LoadMapAndVMap(int gx, int gy, PreparedGrid* prepared)
 {
-    LoadMap(gx, gy);
+    LoadMap(gx, gy, prepared);
     // Only load the data for the base map
     if (this == m_parentMap)
     {
         LoadVMap(gx, gy);
         LoadMMap(gx, gy);
     }
+
+    // cached results of every map using this terrain are stale now
+    _terrainGeneration.fetch_add(1, std::memory_order_relaxed);
+}
+
+uint32 Map::GetTerrainGeneration() const
+{
+    return m_parentMap->GetRootParentTerrainMap()->_terrainGeneration.load(std::memory_order_relaxed);
 }
 
 void Map::LoadAllCells()
@@ -331,8 +369,9 @@ i_mapEntry(sMapStore.LookupEntry(id)), i_spawnMode(SpawnMode), i_InstanceId(Inst
 m_unloadTimer(0), m_VisibleDistance(DEFAULT_VISIBILITY_DISTANCE),
 m_VisibilityNotifyPeriod(DEFAULT_VISIBILITY_NOTIFY_PERIOD),
 m_activeNonPlayersIter(m_activeNonPlayers.end()), _transportsUpdateIter(_transports.end()),
-i_gridExpiry(expiry),
-i_scriptLock(false), _respawnCheckTimer(0)
+i_gridExpiry(expiry), _farVisibilityRange(0.0f),
+i_scriptLock(false), _respawnCheckTimer(0), _pendingUpdateDiff(0), _terrainGeneration(0), _pathRequestQueue(std::make_unique<PathRequestQueue>(*sMapMgr->GetPathRequestProcessor(), InstanceId)),
+_movementRelay(std::make_unique<MovementRelay>(this)), _gridActivationQueue(std::make_unique<GridActivationQueue>(this))
 {
     if (_parent)
     {
@@ -402,6 +441,9 @@ void Map::AddToGrid(Creature* obj, Cell const& cell)
         grid->GetGridType(cell.CellX(), cell.CellY()).AddGridObject(obj);
 
     obj->SetCurrentCell(cell);
+
+    if (obj->GetUpdateStateSlot() != CreatureUpdateStates::InvalidSlot)
+        _creatureUpdateStates.SetCell(obj->GetUpdateStateSlot(), cell.GetCellCoord().GetId());
 }
 
 template<>
@@ -550,15 +592,15 @@ void Map::DeleteFromWorld(Player* player)
     delete player;
 }
 
-void Map::EnsureGridCreated(const GridCoord &p)
+void Map::EnsureGridCreated(const GridCoord &p, PreparedGrid* prepared /*= nullptr*/)
 {
     std::lock_guard<std::mutex> lock(_gridLock);
-    EnsureGridCreated_i(p);
+    EnsureGridCreated_i(p, prepared);
 }
 
 //Create NGrid so the object can be added to it
 //But object data is not loaded here
-void Map::EnsureGridCreated_i(const GridCoord &p)
+void Map::EnsureGridCreated_i(const GridCoord &p, PreparedGrid* prepared /*= nullptr*/)
 {
     if (!getNGrid(p.x_coord, p.y_coord))
     {
@@ -585,12 +627,13 @@ void Map::EnsureGridCreated_i(const GridCoord &p)
                 lock.lock();
 
             if (!m_parentMap->GridMaps[gx][gy])
-                rootParentTerrainMap->LoadMapAndVMap(gx, gy);
+                rootParentTerrainMap->LoadMapAndVMap(gx, gy, prepared);
 
             if (m_parentMap->GridMaps[gx][gy])
             {
                 GridMaps[gx][gy] = m_parentMap->GridMaps[gx][gy];
                 ++rootParentTerrainMap->GridMapReference[gx][gy];
+                _collisionCache.Invalidate();
             }
         }
     }
@@ -613,6 +656,8 @@ void Map::EnsureGridLoadedForActiveObject(const Cell &cell, WorldObject* object)
 }
 
 //Create NGrid and load the object data in it
+//A grid prefetched by GridActivationQueue counts as loaded and gets its remaining cells loaded first. When reached
+//while one of its cells is loading (e.g. from a script of a creature spawned there) the cells after it are still empty
 bool Map::EnsureGridLoaded(const Cell &cell)
 {
     EnsureGridCreated(GridCoord(cell.GridX(), cell.GridY()));
@@ -624,14 +669,17 @@ bool Map::EnsureGridLoaded(const Cell &cell)
         TC_LOG_DEBUG("maps", "Loading grid[%u, %u] for map %u instance %u", cell.GridX(), cell.GridY(), GetId(), i_InstanceId);
 
         setGridObjectDataLoaded(true, cell.GridX(), cell.GridY());
+        LoadGridRespawns(GridCoord(cell.GridX(), cell.GridY()));
 
         ObjectGridLoader loader(*grid, this, cell);
         loader.LoadN();
-
-        Balance();
         return true;
     }
 
+    // prefetched grid still loading its cells
+    if (_gridActivationQueue->IsActivating(GridCoord(cell.GridX(), cell.GridY())))
+        _gridActivationQueue->Finish(GridCoord(cell.GridX(), cell.GridY()));
+
     return false;
 }
 
@@ -846,7 +894,8 @@ void Map::UpdatePlayerZoneStats(uint32 oldZone, uint32 newZone)
 
 void Map::Update(uint32 t_diff)
 {
-    _dynamicTree.update(t_diff);
+    _pathRequestQueue->Update();
+
     /// update worldsessions for existing players
     for (m_mapRefIter = m_mapRefManager.begin(); m_mapRefIter != m_mapRefManager.end(); ++m_mapRefIter)
     {
@@ -860,19 +909,33 @@ void Map::Update(uint32 t_diff)
         }
     }
 
-    /// process any due respawns
-    if (_respawnCheckTimer <= t_diff)
+    /// relay the movement heartbeats received from the sessions
+    _movementRelay->Update(t_diff);
+
+    // sessions, players and transports are updated every tick, grids and creatures of quiet maps
+    // wait a few ticks and get the time they waited
+    uint32 gridDiff = 0;
+    bool const updateGrids = IsUpdateDue(t_diff, gridDiff);
+
+    if (updateGrids)
     {
-        ProcessRespawns();
-        _respawnCheckTimer = sWorld->getIntConfig(CONFIG_RESPAWN_MINCHECKINTERVALMS);
-    }
-    else
-        _respawnCheckTimer -= t_diff;
+        /// prefetch grids ahead of players and load the objects of prefetched grids
+        _gridActivationQueue->Update(gridDiff);
 
-    /// update active cells around players and active objects
-    resetMarkedCells();
+        /// process any due respawns
+        if (_respawnCheckTimer <= gridDiff)
+        {
+            ProcessRespawns();
+            _respawnCheckTimer = sWorld->getIntConfig(CONFIG_RESPAWN_MINCHECKINTERVALMS);
+        }
+        else
+            _respawnCheckTimer -= gridDiff;
+
+        /// update active cells around players and active objects
+        resetMarkedCells();
+    }
 
-    Trinity::ObjectUpdater updater(t_diff);
+    Trinity::ObjectUpdater updater(gridDiff);
     // for creature
     TypeContainerVisitor<Trinity::ObjectUpdater, GridTypeMapContainer  > grid_object_update(updater);
     // for pets
@@ -890,6 +953,9 @@ void Map::Update(uint32 t_diff)
         // update players at tick
         player->Update(t_diff);
 
+        if (!updateGrids)
+            continue;
+
         VisitNearbyCellsOf(player, grid_object_update, world_object_update);
 
         // If player is using far sight or mind vision, visit that object too
@@ -933,16 +999,22 @@ void Map::Update(uint32 t_diff)
         }
     }
 
-    // non-player active objects, increasing iterator in the loop in case of object removal
-    for (m_activeNonPlayersIter = m_activeNonPlayers.begin(); m_activeNonPlayersIter != m_activeNonPlayers.end();)
+    if (updateGrids)
     {
-        WorldObject* obj = *m_activeNonPlayersIter;
-        ++m_activeNonPlayersIter;
+        // non-player active objects, increasing iterator in the loop in case of object removal
+        for (m_activeNonPlayersIter = m_activeNonPlayers.begin(); m_activeNonPlayersIter != m_activeNonPlayers.end();)
+        {
+            WorldObject* obj = *m_activeNonPlayersIter;
+            ++m_activeNonPlayersIter;
 
-        if (!obj || !obj->IsInWorld())
-            continue;
+            if (!obj || !obj->IsInWorld())
+                continue;
+
+            VisitNearbyCellsOf(obj, grid_object_update, world_object_update);
+        }
 
-        VisitNearbyCellsOf(obj, grid_object_update, world_object_update);
+        // creatures of the visited cells
+        _creatureUpdateStates.Update(gridDiff, GameTime::GetGameTimeMS(), marked_cells);
     }
 
     for (_transportsUpdateIter = _transports.begin(); _transportsUpdateIter != _transports.end();)
@@ -980,6 +1052,8 @@ void Map::Update(uint32 t_diff)
         ProcessRelocationNotifies(t_diff);
 
     sScriptMgr->OnMapUpdate(this, t_diff);
+
+    MapCollisionCache::FlushStats();
 }
 
 struct ResetNotifier
@@ -1004,38 +1078,68 @@ void Map::ProcessRelocationNotifies(uint32 diff)
             continue;
 
         grid->getGridInfoRef()->getRelocationTimer().TUpdate(diff);
-        if (!grid->getGridInfoRef()->getRelocationTimer().TPassed())
-            continue;
+    }
 
-        uint32 gx = grid->getX(), gy = grid->getY();
+    // players seeing through another object are notified from their own cell
+    for (MapRefManager::iterator itr = m_mapRefManager.begin(); itr != m_mapRefManager.end(); ++itr)
+    {
+        Player* player = itr->GetSource();
+        if (player->IsInWorld() && player->m_seer != player && player->m_seer->isNeedNotify(NOTIFY_VISIBILITY_CHANGED))
+            MarkRelocationCell(player->GetPositionX(), player->GetPositionY());
+    }
 
-        CellCoord cell_min(gx*MAX_NUMBER_OF_CELLS, gy*MAX_NUMBER_OF_CELLS);
-        CellCoord cell_max(cell_min.x_coord + MAX_NUMBER_OF_CELLS, cell_min.y_coord+MAX_NUMBER_OF_CELLS);
+    float const radius = GetRelocationRange();
+    std::vector<CellCoord> visited;
 
-        for (uint32 x = cell_min.x_coord; x < cell_max.x_coord; ++x)
-        {
-            for (uint32 y = cell_min.y_coord; y < cell_max.y_coord; ++y)
-            {
-                uint32 cell_id = (y * TOTAL_NUMBER_OF_CELLS_PER_MAP) + x;
-                if (!isCellMarked(cell_id))
-                    continue;
+    // cells marked while notifying are appended to the list and processed at the next update
+    std::size_t const count = _relocationCellList.size();
+    std::size_t pending = 0;
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        uint32 cell_id = _relocationCellList[i];
+        CellCoord pair(cell_id % TOTAL_NUMBER_OF_CELLS_PER_MAP, cell_id / TOTAL_NUMBER_OF_CELLS_PER_MAP);
+        Cell cell(pair);
 
-                CellCoord pair(x, y);
-                Cell cell(pair);
-                cell.SetNoCreate();
+        NGridType* grid = getNGrid(cell.GridX(), cell.GridY());
+        if (!grid)
+        {
+            // unloaded along with the objects waiting in it
+            _relocationCells.reset(cell_id);
+            continue;
+        }
 
-                Trinity::DelayedUnitRelocation cell_relocation(cell, pair, *this, MAX_VISIBILITY_DISTANCE);
-                TypeContainerVisitor<Trinity::DelayedUnitRelocation, GridTypeMapContainer  > grid_object_relocation(cell_relocation);
-                TypeContainerVisitor<Trinity::DelayedUnitRelocation, WorldTypeMapContainer > world_object_relocation(cell_relocation);
-                Visit(cell, grid_object_relocation);
-                Visit(cell, world_object_relocation);
-            }
+        // objects not updated this tick wait until they are
+        if (grid->GetGridState() != GRID_STATE_ACTIVE || !grid->getGridInfoRef()->getRelocationTimer().TPassed() || !isCellMarked(cell_id))
+        {
+            _relocationCellList[pending++] = cell_id;
+            continue;
         }
+
+        _relocationCells.reset(cell_id);
+        visited.push_back(pair);
+
+        cell.SetNoCreate();
+
+        Trinity::DelayedUnitRelocation cell_relocation(cell, pair, *this, radius);
+        TypeContainerVisitor<Trinity::DelayedUnitRelocation, GridTypeMapContainer  > grid_object_relocation(cell_relocation);
+        TypeContainerVisitor<Trinity::DelayedUnitRelocation, WorldTypeMapContainer > world_object_relocation(cell_relocation);
+        Visit(cell, grid_object_relocation);
+        Visit(cell, world_object_relocation);
     }
 
+    _relocationCellList.erase(_relocationCellList.begin() + pending, _relocationCellList.begin() + count);
+
     ResetNotifier reset;
     TypeContainerVisitor<ResetNotifier, GridTypeMapContainer >  grid_notifier(reset);
     TypeContainerVisitor<ResetNotifier, WorldTypeMapContainer > world_notifier(reset);
+    for (CellCoord const& pair : visited)
+    {
+        Cell cell(pair);
+        cell.SetNoCreate();
+        Visit(cell, grid_notifier);
+        Visit(cell, world_notifier);
+    }
+
     for (GridRefManager<NGridType>::iterator i = GridRefManager<NGridType>::begin(); i != GridRefManager<NGridType>::end(); ++i)
     {
         NGridType *grid = i->GetSource();
@@ -1047,28 +1151,110 @@ void Map::ProcessRelocationNotifies(uint32 diff)
             continue;
 
         grid->getGridInfoRef()->getRelocationTimer().TReset(diff, m_VisibilityNotifyPeriod);
+    }
 
-        uint32 gx = grid->getX(), gy = grid->getY();
+    RelocationVisitedCells.fetch_add(visited.size(), std::memory_order_relaxed);
+    RelocationUpdates.fetch_add(1, std::memory_order_relaxed);
+}
 
-        CellCoord cell_min(gx*MAX_NUMBER_OF_CELLS, gy*MAX_NUMBER_OF_CELLS);
-        CellCoord cell_max(cell_min.x_coord + MAX_NUMBER_OF_CELLS, cell_min.y_coord+MAX_NUMBER_OF_CELLS);
+void Map::MarkRelocationCell(float x, float y)
+{
+    CellCoord p = Trinity::ComputeCellCoord(x, y);
+    if (!p.IsCoordValid())
+        return;
 
-        for (uint32 x = cell_min.x_coord; x < cell_max.x_coord; ++x)
-        {
-            for (uint32 y = cell_min.y_coord; y < cell_max.y_coord; ++y)
-            {
-                uint32 cell_id = (y * TOTAL_NUMBER_OF_CELLS_PER_MAP) + x;
-                if (!isCellMarked(cell_id))
-                    continue;
+    uint32 cell_id = p.GetId();
+    if (_relocationCells.test(cell_id))
+        return;
 
-                CellCoord pair(x, y);
-                Cell cell(pair);
-                cell.SetNoCreate();
-                Visit(cell, grid_notifier);
-                Visit(cell, world_notifier);
-            }
-        }
+    _relocationCells.set(cell_id);
+    _relocationCellList.push_back(cell_id);
+}
+
+void Map::UpdateFarVisibilityRange(WorldObject const* obj)
+{
+    if (obj->IsFarVisible() || obj->IsVisibilityOverriden())
+        _farVisibilityRange = std::max(_farVisibilityRange, obj->GetVisibilityRange());
+
+    // players watching a cinematic see DEFAULT_VISIBILITY_INSTANCE far, see WorldObject::GetSightRange
+    if (Player const* player = obj->ToPlayer())
+        if (player->GetCinematicMgr()->IsOnCinematic())
+            _farVisibilityRange = std::max(_farVisibilityRange, DEFAULT_VISIBILITY_INSTANCE);
+}
+
+float Map::GetRelocationRange() const
+{
+    return std::max(m_VisibleDistance, _farVisibilityRange);
+}
+
+Map::RelocationStats Map::ConsumeRelocationStats()
+{
+    RelocationStats stats;
+    stats.VisitedCells = RelocationVisitedCells.exchange(0, std::memory_order_relaxed);
+    stats.Updates = RelocationUpdates.exchange(0, std::memory_order_relaxed);
+    return stats;
+}
+
+bool Map::IsUpdateDue(uint32 diff, uint32& updateDiff)
+{
+    _pendingUpdateDiff += diff;
+
+    UpdateRate rate = GetUpdateRate();
+    uint32 interval = 0;
+    switch (rate)
+    {
+        case UPDATE_RATE_IDLE:
+            interval = sWorld->getIntConfig(CONFIG_INTERVAL_MAPUPDATE_IDLE);
+            break;
+        case UPDATE_RATE_EMPTY:
+            interval = sWorld->getIntConfig(CONFIG_INTERVAL_MAPUPDATE_EMPTY);
+            break;
+        default:
+            break;
     }
+
+    if (_pendingUpdateDiff < interval)
+    {
+        RateSkippedUpdates.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    RateUpdates[rate].fetch_add(1, std::memory_order_relaxed);
+    updateDiff = _pendingUpdateDiff;
+    _pendingUpdateDiff = 0;
+    return true;
+}
+
+Map::UpdateRate Map::GetUpdateRate() const
+{
+    // engaged creatures keep fighting (e.g. evading or chasing pets) after the last player left
+    if (_creatureUpdateStates.GetEngagedCount())
+        return UPDATE_RATE_FULL;
+
+    if (!HavePlayers())
+        return UPDATE_RATE_EMPTY;
+
+    uint32 players = 0;
+    for (MapRefManager::const_iterator itr = m_mapRefManager.begin(); itr != m_mapRefManager.end(); ++itr)
+    {
+        if (itr->GetSource()->IsInCombat())
+            return UPDATE_RATE_FULL;
+        ++players;
+    }
+
+    if (players <= sWorld->getIntConfig(CONFIG_MAPUPDATE_IDLE_PLAYERS) || !_creatureUpdateStates.GetAwakeCount())
+        return UPDATE_RATE_IDLE;
+
+    return UPDATE_RATE_FULL;
+}
+
+Map::UpdateRateStats Map::ConsumeUpdateRateStats()
+{
+    UpdateRateStats stats;
+    for (uint8 i = 0; i < MAX_UPDATE_RATES; ++i)
+        stats.Updates[i] = RateUpdates[i].exchange(0, std::memory_order_relaxed);
+    stats.Skipped = RateSkippedUpdates.exchange(0, std::memory_order_relaxed);
+    return stats;
 }
 
 void Map::RemovePlayerFromMap(Player* player, bool remove)
@@ -1634,10 +1820,17 @@ bool Map::UnloadGrid(NGridType& ngrid, bool unloadAll)
 
             if (ActiveObjectsNearGrid(ngrid))
                 return false;
+
+            // terrain still read by a path finding thread
+            if (_pathRequestQueue->IsGridInUse(x, y))
+                return false;
         }
 
         TC_LOG_DEBUG("maps", "Unloading grid[%u, %u] for map %u", x, y, GetId());
 
+        _gridActivationQueue->Cancel(GridCoord(x, y));
+        _respawnScheduler.SetGridLoaded(GridCoord(x, y).GetId(), false);
+
         if (!unloadAll)
         {
             // Finish creature moves, remove and delete all creatures with delayed remove before moving to respawn grids
@@ -1674,6 +1867,8 @@ bool Map::UnloadGrid(NGridType& ngrid, bool unloadAll)
         delete &ngrid;
         setNGrid(nullptr, x, y);
     }
+
+    _collisionCache.Invalidate();
     int gx = (MAX_NUMBER_OF_GRIDS - 1) - x;
     int gy = (MAX_NUMBER_OF_GRIDS - 1) - y;
 
@@ -1686,6 +1881,7 @@ bool Map::UnloadGrid(NGridType& ngrid, bool unloadAll)
             m_parentMap->GetRootParentTerrainMap()->UnloadMap(gx, gy);
             VMAP::VMapFactory::createOrGetVMapManager()->unloadMap(terrainRoot->GetId(), gx, gy);
             MMAP::MMapFactory::createOrGetMMapManager()->unloadMap(terrainRoot->GetId(), gx, gy);
+            terrainRoot->_terrainGeneration.fetch_add(1, std::memory_order_relaxed);
         }
     }
 
@@ -1712,6 +1908,9 @@ void Map::RemoveAllPlayers()
 
 void Map::UnloadAll()
 {
+    // navmesh may be unloaded right after this
+    _pathRequestQueue->CancelAll();
+
     // clear all delayed moves, useless anyway do this moves before map unload.
     _creaturesToMove.clear();
     _gameObjectsToMove.clear();
@@ -2463,8 +2662,23 @@ float Map::GetWaterOrGroundLevel(PhaseShift const& phaseShift, float x, float y,
 
 float Map::GetStaticHeight(PhaseShift const& phaseShift, float x, float y, float z, bool checkVMap /*= true*/, float maxSearchDist /*= DEFAULT_HEIGHT_SEARCH*/)
 {
-    // find raw .map surface under Z coordinates
     uint32 terrainMapId = PhasingHandler::GetTerrainMapId(phaseShift, this, x, y);
+    if (!sWorld->getBoolConfig(CONFIG_COLLISION_QUERY_CACHE))
+        return GetStaticHeight(terrainMapId, x, y, z, checkVMap, maxSearchDist);
+
+    float height;
+    uint32 generation = _collisionCache.GetHeightGeneration(GetTerrainGeneration());
+    if (_collisionCache.FindHeight(generation, terrainMapId, x, y, z, checkVMap, maxSearchDist, height))
+        return height;
+
+    height = GetStaticHeight(terrainMapId, x, y, z, checkVMap, maxSearchDist);
+    _collisionCache.StoreHeight(generation, terrainMapId, x, y, z, checkVMap, maxSearchDist, height);
+    return height;
+}
+
+float Map::GetStaticHeight(uint32 terrainMapId, float x, float y, float z, bool checkVMap, float maxSearchDist)
+{
+    // find raw .map surface under Z coordinates
     float mapHeight = VMAP_INVALID_HEIGHT_VALUE;
     float gridHeight = GetGridHeight(terrainMapId, x, y);
     if (G3D::fuzzyGe(z, gridHeight - GROUND_HEIGHT_TOLERANCE))
@@ -2668,6 +2882,48 @@ ZLiquidStatus Map::GetLiquidStatus(PhaseShift const& phaseShift, float x, float
     return result;
 }
 
+GridMap* Map::GetTerrainGrid(PhaseShift const& phaseShift, float x, float y, uint32& terrainMapId)
+{
+    terrainMapId = PhasingHandler::GetTerrainMapId(phaseShift, this, x, y);
+    return GetGrid(terrainMapId, x, y);
+}
+
+ZLiquidStatus Map::GetGridLiquidStatus(uint32 terrainMapId, GridMap* gmap, float x, float y, float z, uint8 ReqLiquidType, float collisionHeight)
+{
+    ZLiquidStatus result = LIQUID_MAP_NO_WATER;
+    VMAP::IVMapManager* vmgr = VMAP::VMapFactory::createOrGetVMapManager();
+    float liquid_level = INVALID_HEIGHT;
+    float ground_level = INVALID_HEIGHT;
+    uint32 liquid_type = 0;
+    uint32 mogpFlags = 0;
+    bool useGridLiquid = true;
+    if (vmgr->GetLiquidLevel(terrainMapId, x, y, z, ReqLiquidType, liquid_level, ground_level, liquid_type, mogpFlags))
+    {
+        useGridLiquid = !IsInWMOInterior(mogpFlags);
+        if (liquid_level > ground_level && G3D::fuzzyGe(z, ground_level - GROUND_HEIGHT_TOLERANCE))
+        {
+            float delta = liquid_level - z;
+            if (delta > collisionHeight)
+                return LIQUID_MAP_UNDER_WATER;
+            if (delta > 0.0f)
+                return LIQUID_MAP_IN_WATER;
+            if (delta > -0.1f)
+                return LIQUID_MAP_WATER_WALK;
+            result = LIQUID_MAP_ABOVE_WATER;
+        }
+    }
+
+    if (useGridLiquid && gmap)
+    {
+        LiquidData map_data;
+        ZLiquidStatus map_result = gmap->GetLiquidStatus(x, y, z, ReqLiquidType, &map_data, collisionHeight);
+        if (map_result != LIQUID_MAP_NO_WATER && (map_data.level > ground_level))
+            return map_result;
+    }
+
+    return result;
+}
+
 void Map::GetFullTerrainStatusForPosition(PhaseShift const& phaseShift, float x, float y, float z, PositionFullTerrainStatus& data, uint8 reqLiquidType, float collisionHeight)
 {
     VMAP::IVMapManager* vmgr = VMAP::VMapFactory::createOrGetVMapManager();
@@ -2805,13 +3061,53 @@ float Map::GetWaterLevel(PhaseShift const& phaseShift, float x, float y)
 
 bool Map::isInLineOfSight(PhaseShift const& phaseShift, float x1, float y1, float z1, float x2, float y2, float z2, LineOfSightChecks checks, VMAP::ModelIgnoreFlags ignoreFlags) const
 {
+    bool checkGameObjects = sWorld->getBoolConfig(CONFIG_CHECK_GOBJECT_LOS) && (checks & LINEOFSIGHT_CHECK_GOBJECT);
+    uint32 terrainMapId = PhasingHandler::GetTerrainMapId(phaseShift, this, x1, y1);
+    // only gameobject collision depends on phases
+    uint32 phaseHash = checkGameObjects ? phaseShift.GetHash() : 0;
+    uint32 cacheFlags = uint32(checks) | (uint32(ignoreFlags) << 8);
+    uint32 generation = 0;
+    bool useCache = sWorld->getBoolConfig(CONFIG_COLLISION_QUERY_CACHE) && _collisionCache.GetLineOfSightGeneration(GetTerrainGeneration(), x1, y1, x2, y2, generation);
+    bool result = true;
+    if (useCache && _collisionCache.FindLineOfSight(generation, terrainMapId, x1, y1, z1, x2, y2, z2, cacheFlags, phaseHash, result))
+        return result;
+
     if ((checks & LINEOFSIGHT_CHECK_VMAP)
-      && !VMAP::VMapFactory::createOrGetVMapManager()->isInLineOfSight(PhasingHandler::GetTerrainMapId(phaseShift, this, x1, y1), x1, y1, z1, x2, y2, z2, ignoreFlags))
-        return false;
-    if (sWorld->getBoolConfig(CONFIG_CHECK_GOBJECT_LOS) && (checks & LINEOFSIGHT_CHECK_GOBJECT)
-      && !_dynamicTree.isInLineOfSight({x1, y1, z1}, {x2, y2, z2}, phaseShift))
-        return false;
-    return true;
+      && !VMAP::VMapFactory::createOrGetVMapManager()->isInLineOfSight(terrainMapId, x1, y1, z1, x2, y2, z2, ignoreFlags))
+        result = false;
+    else if (checkGameObjects && !_dynamicTree.isInLineOfSight({x1, y1, z1}, {x2, y2, z2}, phaseShift))
+        result = false;
+
+    if (useCache)
+        _collisionCache.StoreLineOfSight(generation, terrainMapId, x1, y1, z1, x2, y2, z2, cacheFlags, phaseHash, result);
+
+    return result;
+}
+
+void Map::RemoveGameObjectModel(const GameObjectModel& model)
+{
+    _dynamicTree.remove(model);
+    InvalidateCollisionCache(model);
+}
+
+void Map::InsertGameObjectModel(const GameObjectModel& model)
+{
+    _dynamicTree.insert(model);
+    InvalidateCollisionCache(model);
+}
+
+void Map::UpdateGameObjectModelPosition(GameObjectModel& model)
+{
+    InvalidateCollisionCache(model);
+    model.UpdatePosition();
+    _dynamicTree.update(model);
+    InvalidateCollisionCache(model);
+}
+
+void Map::InvalidateCollisionCache(const GameObjectModel& model)
+{
+    G3D::AABox const& bounds = model.getBounds();
+    _collisionCache.Invalidate(bounds.low().x, bounds.low().y, bounds.high().x, bounds.high().y);
 }
 
 bool Map::getObjectHitPos(PhaseShift const& phaseShift, float x1, float y1, float z1, float x2, float y2, float z2, float& rx, float& ry, float& rz, float modifyDist)
@@ -3048,7 +3344,8 @@ void Map::Respawn(RespawnInfo* info, CharacterDatabaseTransaction dbTrans)
     if (info->respawnTime <= GameTime::GetGameTime())
         return;
     info->respawnTime = GameTime::GetGameTime();
-    _respawnTimes.increase(info->handle);
+    _respawnScheduler.Erase(info);
+    ScheduleRespawn(info);
     SaveRespawnInfoDB(*info, dbTrans);
 }
 
@@ -3103,11 +3400,42 @@ bool Map::AddRespawnInfo(RespawnInfo const& info)
         ASSERT(false, "Invalid respawn info for spawn id (%u,%u) being inserted", uint32(info.type), info.spawnId);
 
     RespawnInfo* ri = new RespawnInfo(info);
-    ri->handle = _respawnTimes.push(ri);
+    ScheduleRespawn(ri);
     bySpawnIdMap.emplace(ri->spawnId, ri);
     return true;
 }
 
+void Map::ScheduleRespawn(RespawnInfo* info)
+{
+    // pooled respawns are handed to the pool whether their grid is loaded or not
+    uint32 gridId = sPoolMgr->IsPartOfAPool(info->type, info->spawnId) ? RespawnScheduler::AnyGrid : info->gridId;
+    _respawnScheduler.Insert(info, gridId);
+}
+
+void Map::LoadGridRespawns(GridCoord const& p)
+{
+    _respawnScheduler.SetGridLoaded(p.GetId(), true);
+
+    std::vector<RespawnInfo*> due;
+    _respawnScheduler.CollectDue(p.GetId(), GameTime::GetGameTime(), due);
+
+    // nothing of the grid exists yet, the grid loader spawns whatever has no respawn time left
+    for (RespawnInfo* info : due)
+    {
+        if (CheckRespawn(info) || !info->respawnTime)
+        {
+            GetRespawnMapForType(info->type).erase(info->spawnId);
+            RemoveRespawnTime(info->type, info->spawnId, nullptr, true);
+            delete info;
+        }
+        else
+        {
+            ScheduleRespawn(info);
+            SaveRespawnInfoDB(*info);
+        }
+    }
+}
+
 static void PushRespawnInfoFrom(std::vector<RespawnInfo const*>& data, RespawnInfoMap const& map)
 {
     data.reserve(data.size() + map.size());
@@ -3134,9 +3462,11 @@ RespawnInfo* Map::GetRespawnInfo(SpawnObjectType type, ObjectGuid::LowType spawn
 
 void Map::UnloadAllRespawnInfos() // delete everything from memory
 {
-    for (RespawnInfo* info : _respawnTimes)
+    std::vector<RespawnInfo*> respawnInfos;
+    _respawnScheduler.Clear(respawnInfos);
+    for (RespawnInfo* info : respawnInfos)
         delete info;
-    _respawnTimes.clear();
+    _pendingRespawnTimes.clear();
     _creatureRespawnTimesBySpawnId.clear();
     _gameObjectRespawnTimesBySpawnId.clear();
 }
@@ -3153,8 +3483,8 @@ void Map::DeleteRespawnInfo(RespawnInfo* info, CharacterDatabaseTransaction dbTr
     ASSERT(it != range.second, "Respawn stores inconsistent for map %u, spawnid %u (type %u)", GetId(), info->spawnId, uint32(info->type));
     spawnMap.erase(it);
 
-    // respawn heap
-    _respawnTimes.erase(info->handle);
+    // respawn schedule
+    _respawnScheduler.Erase(info);
 
     // database
     DeleteRespawnInfoFromDB(info->type, info->spawnId, dbTrans);
@@ -3165,13 +3495,14 @@ void Map::DeleteRespawnInfo(RespawnInfo* info, CharacterDatabaseTransaction dbTr
 
 void Map::DeleteRespawnInfoFromDB(SpawnObjectType type, ObjectGuid::LowType spawnId, CharacterDatabaseTransaction dbTrans)
 {
-    // database
-    CharacterDatabasePreparedStatement* stmt = CharacterDatabase.GetPreparedStatement(CHAR_DEL_RESPAWN);
-    stmt->setUInt16(0, type);
-    stmt->setUInt32(1, spawnId);
-    stmt->setUInt16(2, GetId());
-    stmt->setUInt32(3, GetInstanceId());
-    CharacterDatabase.ExecuteOrAppend(dbTrans, stmt);
+    if (!dbTrans)
+    {
+        _pendingRespawnTimes[MakeRespawnTimeKey(type, spawnId)] = 0;
+        return;
+    }
+
+    _pendingRespawnTimes.erase(MakeRespawnTimeKey(type, spawnId));
+    SaveRespawnTimeDB(type, spawnId, 0, dbTrans);
 }
 
 void Map::DoRespawn(SpawnObjectType type, ObjectGuid::LowType spawnId, uint32 gridId)
@@ -3203,16 +3534,13 @@ void Map::DoRespawn(SpawnObjectType type, ObjectGuid::LowType spawnId, uint32 gr
 void Map::ProcessRespawns()
 {
     time_t now = GameTime::GetGameTime();
-    while (!_respawnTimes.empty())
+    _respawnScheduler.Update(now);
+    while (RespawnInfo* next = _respawnScheduler.GetNextDue())
     {
-        RespawnInfo* next = _respawnTimes.top();
-        if (now < next->respawnTime) // done for this tick
-            break;
-
         if (uint32 poolId = sPoolMgr->IsPartOfAPool(next->type, next->spawnId)) // is this part of a pool?
         { // if yes, respawn will be handled by (external) pooling logic, just delete the respawn time
             // step 1: remove entry from maps to avoid it being reachable by outside logic
-            _respawnTimes.pop();
+            _respawnScheduler.Erase(next);
             GetRespawnMapForType(next->type).erase(next->spawnId);
 
             // step 2: tell pooling logic to do its thing
@@ -3225,7 +3553,7 @@ void Map::ProcessRespawns()
         else if (CheckRespawn(next)) // see if we're allowed to respawn
         { // ok, respawn
             // step 1: remove entry from maps to avoid it being reachable by outside logic
-            _respawnTimes.pop();
+            _respawnScheduler.Erase(next);
             GetRespawnMapForType(next->type).erase(next->spawnId);
 
             // step 2: do the respawn, which involves external logic
@@ -3237,7 +3565,7 @@ void Map::ProcessRespawns()
         }
         else if (!next->respawnTime)
         { // just remove this respawn entry without rescheduling
-            _respawnTimes.pop();
+            _respawnScheduler.Erase(next);
             GetRespawnMapForType(next->type).erase(next->spawnId);
             RemoveRespawnTime(next->type, next->spawnId, nullptr, true);
             delete next;
@@ -3245,10 +3573,13 @@ void Map::ProcessRespawns()
         else
         { // new respawn time, update heap position
             ASSERT(now < next->respawnTime); // infinite loop guard
-            _respawnTimes.decrease(next->handle);
+            _respawnScheduler.Erase(next);
+            ScheduleRespawn(next);
             SaveRespawnInfoDB(*next);
         }
     }
+
+    SavePendingRespawnTimesDB();
 }
 
 void Map::ApplyDynamicModeRespawnScaling(WorldObject const* obj, ObjectGuid::LowType spawnId, uint32& respawnDelay, uint32 mode) const
@@ -4383,15 +4714,55 @@ void Map::SaveRespawnTime(SpawnObjectType type, ObjectGuid::LowType spawnId, uin
 
 void Map::SaveRespawnInfoDB(RespawnInfo const& info, CharacterDatabaseTransaction dbTrans)
 {
-    CharacterDatabasePreparedStatement* stmt = CharacterDatabase.GetPreparedStatement(CHAR_REP_RESPAWN);
-    stmt->setUInt16(0, info.type);
-    stmt->setUInt32(1, info.spawnId);
-    stmt->setUInt64(2, uint64(info.respawnTime));
-    stmt->setUInt16(3, GetId());
-    stmt->setUInt32(4, GetInstanceId());
+    // without a transaction of the caller the respawn time is written with the next respawn check
+    if (!dbTrans)
+    {
+        _pendingRespawnTimes[MakeRespawnTimeKey(info.type, info.spawnId)] = info.respawnTime;
+        return;
+    }
+
+    _pendingRespawnTimes.erase(MakeRespawnTimeKey(info.type, info.spawnId));
+    SaveRespawnTimeDB(info.type, info.spawnId, info.respawnTime, dbTrans);
+}
+
+void Map::SaveRespawnTimeDB(SpawnObjectType type, ObjectGuid::LowType spawnId, time_t respawnTime, CharacterDatabaseTransaction dbTrans)
+{
+    CharacterDatabasePreparedStatement* stmt;
+    if (respawnTime)
+    {
+        stmt = CharacterDatabase.GetPreparedStatement(CHAR_REP_RESPAWN);
+        stmt->setUInt16(0, type);
+        stmt->setUInt32(1, spawnId);
+        stmt->setUInt64(2, uint64(respawnTime));
+        stmt->setUInt16(3, GetId());
+        stmt->setUInt32(4, GetInstanceId());
+    }
+    else
+    {
+        stmt = CharacterDatabase.GetPreparedStatement(CHAR_DEL_RESPAWN);
+        stmt->setUInt16(0, type);
+        stmt->setUInt32(1, spawnId);
+        stmt->setUInt16(2, GetId());
+        stmt->setUInt32(3, GetInstanceId());
+    }
     CharacterDatabase.ExecuteOrAppend(dbTrans, stmt);
 }
 
+void Map::SavePendingRespawnTimesDB()
+{
+    if (_pendingRespawnTimes.empty())
+        return;
+
+    std::unordered_map<uint64, time_t> pendingRespawnTimes;
+    std::swap(pendingRespawnTimes, _pendingRespawnTimes);
+
+    CharacterDatabaseTransaction trans = CharacterDatabase.BeginTransaction();
+    for (auto const& pair : pendingRespawnTimes)
+        SaveRespawnTimeDB(SpawnObjectType(pair.first >> 32), ObjectGuid::LowType(pair.first), pair.second, trans);
+
+    CharacterDatabase.CommitTransaction(trans);
+}
+
 void Map::LoadRespawnTimes()
 {
     CharacterDatabasePreparedStatement* stmt = CharacterDatabase.GetPreparedStatement(CHAR_SEL_RESPAWNS);
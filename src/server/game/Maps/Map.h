@@ -21,18 +21,20 @@
 #include "Define.h"
 
 #include "Cell.h"
+#include "CreatureUpdateStates.h"
 #include "DynamicTree.h"
 #include "GridDefines.h"
 #include "GridRefManager.h"
+#include "MapCollisionCache.h"
 #include "MapRefManager.h"
 #include "ObjectGuid.h"
 #include "Optional.h"
+#include "RespawnScheduler.h"
 #include "SharedDefines.h"
 #include "SpawnData.h"
 #include "Timer.h"
 #include "Transaction.h"
 #include "Weather.h"
-#include <boost/heap/fibonacci_heap.hpp>
 #include <bitset>
 #include <list>
 #include <memory>
@@ -42,13 +44,17 @@ class Battleground;
 class BattlegroundMap;
 class CreatureGroup;
 class Group;
+class GridActivationQueue;
 class InstanceMap;
 class InstanceSave;
 class InstanceScript;
 class MapInstanced;
+class MovementRelay;
 class Object;
+class PathRequestQueue;
 class PhaseShift;
 class Player;
+class PreparedGrid;
 class TempSummon;
 class Transport;
 class Unit;
@@ -62,7 +68,7 @@ struct ScriptAction;
 struct ScriptInfo;
 struct SummonPropertiesEntry;
 enum Difficulty : uint8;
-namespace Trinity { struct ObjectUpdater; }
+namespace Trinity { struct ObjectUpdater; class SpatialQueryResult; }
 namespace G3D { class Plane; }
 namespace VMAP { enum class ModelIgnoreFlags : uint32; }
 
@@ -302,35 +308,8 @@ struct ZoneDynamicInfo
 
 typedef std::map<uint32/*leaderDBGUID*/, CreatureGroup*>        CreatureGroupHolderType;
 
-struct RespawnInfo; // forward declaration
-struct CompareRespawnInfo
-{
-    bool operator()(RespawnInfo const* a, RespawnInfo const* b) const;
-};
 using ZoneDynamicInfoMap = std::unordered_map<uint32 /*zoneId*/, ZoneDynamicInfo>;
-using RespawnListContainer = boost::heap::fibonacci_heap<RespawnInfo*, boost::heap::compare<CompareRespawnInfo>>;
-using RespawnListHandle = RespawnListContainer::handle_type;
 using RespawnInfoMap = std::unordered_map<ObjectGuid::LowType, RespawnInfo*>;
-struct RespawnInfo
-{
-    SpawnObjectType type;
-    ObjectGuid::LowType spawnId;
-    uint32 entry;
-    time_t respawnTime;
-    uint32 gridId;
-    RespawnListHandle handle;
-};
-inline bool CompareRespawnInfo::operator()(RespawnInfo const* a, RespawnInfo const* b) const
-{
-    if (a == b)
-        return false;
-    if (a->respawnTime != b->respawnTime)
-        return (a->respawnTime > b->respawnTime);
-    if (a->spawnId != b->spawnId)
-        return a->spawnId < b->spawnId;
-    ASSERT(a->type != b->type, "Duplicate respawn entry for spawnId (%u,%u) found!", a->type, a->spawnId);
-    return a->type < b->type;
-}
 
 struct TC_GAME_API SummonCreatureExtraArgs
 {
@@ -354,6 +333,7 @@ public:
 class TC_GAME_API Map : public GridRefManager<NGridType>
 {
     friend class MapReference;
+    friend class GridActivationQueue;
     public:
         Map(uint32 id, time_t, uint32 InstanceId, uint8 SpawnMode, Map* _parent = nullptr);
         virtual ~Map();
@@ -394,6 +374,11 @@ class TC_GAME_API Map : public GridRefManager<NGridType>
         template<class T, class CONTAINER>
         void Visit(Cell const& cell, TypeContainerVisitor<T, CONTAINER> &visitor);
 
+        // Collects objects of the types in typeMask inside a vertical cylinder around center into a reusable result buffer.
+        // Candidates are widened by their own reach plus padding, callers are expected to apply their exact checks afterwards.
+        // Phasing and visibility are not checked. Implemented in SpatialQuery.cpp
+        void QueryObjectsInRange(Trinity::SpatialQueryResult& result, Position const& center, float radius, uint32 typeMask = GRID_MAP_TYPE_MASK_ALL, float padding = 0.0f);
+
         bool IsRemovalGrid(float x, float y) const
         {
             GridCoord p = Trinity::ComputeGridCoord(x, y);
@@ -445,6 +430,12 @@ class TC_GAME_API Map : public GridRefManager<NGridType>
         void GetFullTerrainStatusForPosition(PhaseShift const& phaseShift, float x, float y, float z, PositionFullTerrainStatus& data, uint8 reqLiquidType = MAP_ALL_LIQUIDS, float collisionHeight = 2.03128f); // DEFAULT_COLLISION_HEIGHT in Object.h
         ZLiquidStatus GetLiquidStatus(PhaseShift const& phaseShift, float x, float y, float z, uint8 ReqLiquidType, LiquidData* data = nullptr, float collisionHeight = 2.03128f); // DEFAULT_COLLISION_HEIGHT in Object.h
 
+        // grid GetGridLiquidStatus reads for the point, creating it if needed
+        GridMap* GetTerrainGrid(PhaseShift const& phaseShift, float x, float y, uint32& terrainMapId);
+        // GetLiquidStatus without liquid data, only reads the given grid and vmaps so it can be called outside of the map update
+        // the caller must keep the grid loaded
+        static ZLiquidStatus GetGridLiquidStatus(uint32 terrainMapId, GridMap* gmap, float x, float y, float z, uint8 ReqLiquidType, float collisionHeight);
+
         uint32 GetAreaId(PhaseShift const& phaseShift, float x, float y, float z);
         uint32 GetAreaId(PhaseShift const& phaseShift, Position const& pos)
         {
@@ -528,6 +519,43 @@ class TC_GAME_API Map : public GridRefManager<NGridType>
         bool isCellMarked(uint32 pCellId) { return marked_cells.test(pCellId); }
         void markCell(uint32 pCellId) { marked_cells.set(pCellId); }
 
+        struct RelocationStats
+        {
+            uint64 VisitedCells = 0;        // cells searched for objects waiting for relocation notifiers
+            uint64 Updates = 0;             // map updates that processed relocation notifiers
+        };
+
+        // an object at that position is waiting for its relocation notifiers
+        void MarkRelocationCell(float x, float y);
+        // relocation notifiers have to reach far visible objects and players in cinematics beyond the map's visibility range
+        void UpdateFarVisibilityRange(WorldObject const* obj);
+        float GetRelocationRange() const;
+
+        // summed over all maps since the previous call
+        static RelocationStats ConsumeRelocationStats();
+
+        enum UpdateRate : uint8
+        {
+            UPDATE_RATE_FULL,               // combat or busy, grids updated every tick
+            UPDATE_RATE_IDLE,               // no combat and few players or only idle creatures
+            UPDATE_RATE_EMPTY,              // no players
+            MAX_UPDATE_RATES
+        };
+
+        struct UpdateRateStats
+        {
+            uint64 Updates[MAX_UPDATE_RATES] = { };
+            uint64 Skipped = 0;             // ticks a map waited for its next update
+        };
+
+        // adds diff to the time the grids and creatures wait for their next update, true with the time waited in updateDiff when it is due.
+        // Sessions, players and transports are updated every tick regardless of the rate
+        bool IsUpdateDue(uint32 diff, uint32& updateDiff);
+        virtual UpdateRate GetUpdateRate() const;
+
+        // summed over all maps since the previous call
+        static UpdateRateStats ConsumeUpdateRateStats();
+
         bool HavePlayers() const { return !m_mapRefManager.isEmpty(); }
         uint32 GetPlayersCountExceptGMs() const;
         bool ActiveObjectsNearGrid(NGridType const& ngrid) const;
@@ -590,6 +618,8 @@ class TC_GAME_API Map : public GridRefManager<NGridType>
         GameObjectBySpawnIdContainer& GetGameObjectBySpawnIdStore() { return _gameObjectBySpawnIdStore; }
         GameObjectBySpawnIdContainer const& GetGameObjectBySpawnIdStore() const { return _gameObjectBySpawnIdStore; }
 
+        CreatureUpdateStates& GetCreatureUpdateStates() { return _creatureUpdateStates; }
+
         std::unordered_set<Corpse*> const* GetCorpsesInCell(uint32 cellId) const
         {
             auto itr = _corpsesByCell.find(cellId);
@@ -624,9 +654,15 @@ class TC_GAME_API Map : public GridRefManager<NGridType>
         float GetHeight(PhaseShift const& phaseShift, Position const& pos, bool vmap = true, float maxSearchDist = DEFAULT_HEIGHT_SEARCH) { return GetHeight(phaseShift, pos.GetPositionX(), pos.GetPositionY(), pos.GetPositionZ(), vmap, maxSearchDist); }
 
         bool isInLineOfSight(PhaseShift const& phaseShift, float x1, float y1, float z1, float x2, float y2, float z2, LineOfSightChecks checks, VMAP::ModelIgnoreFlags ignoreFlags) const;
-        void Balance() { _dynamicTree.balance(); }
-        void RemoveGameObjectModel(const GameObjectModel& model) { _dynamicTree.remove(model); }
-        void InsertGameObjectModel(const GameObjectModel& model) { _dynamicTree.insert(model); }
+        void RemoveGameObjectModel(const GameObjectModel& model);
+        void InsertGameObjectModel(const GameObjectModel& model);
+        // moves an inserted model to its owner's current position, the dynamic tree is refit in place
+        void UpdateGameObjectModelPosition(GameObjectModel& model);
+        // must be called when a model already in the dynamic tree changes in place (collision toggled, phases changed, owner (de)spawned)
+        void InvalidateCollisionCache(const GameObjectModel& model);
+
+        PathRequestQueue& GetPathRequestQueue() { return *_pathRequestQueue; }
+        MovementRelay& GetMovementRelay() { return *_movementRelay; }
         bool ContainsGameObjectModel(const GameObjectModel& model) const { return _dynamicTree.contains(model);}
         float GetGameObjectFloor(PhaseShift const& phaseShift, float x, float y, float z, float maxSearchDist = DEFAULT_HEIGHT_SEARCH) const
         {
@@ -703,11 +739,12 @@ class TC_GAME_API Map : public GridRefManager<NGridType>
         }
 
     private:
+        float GetStaticHeight(uint32 terrainMapId, float x, float y, float z, bool checkVMap, float maxSearchDist);
 
-        void LoadMapAndVMap(int gx, int gy);
+        void LoadMapAndVMap(int gx, int gy, PreparedGrid* prepared);
         void LoadVMap(int gx, int gy);
-        void LoadMap(int gx, int gy);
-        static void LoadMapImpl(Map* map, int gx, int gy);
+        void LoadMap(int gx, int gy, PreparedGrid* prepared);
+        static void LoadMapImpl(Map* map, int gx, int gy, PreparedGrid* prepared);
         void UnloadMap(int gx, int gy);
         static void UnloadMapImpl(Map* map, int gx, int gy);
         void LoadMMap(int gx, int gy);
@@ -742,8 +779,8 @@ class TC_GAME_API Map : public GridRefManager<NGridType>
         std::vector<DynamicObject*> _dynamicObjectsToMove;
 
         bool IsGridLoaded(const GridCoord &) const;
-        void EnsureGridCreated(const GridCoord &);
-        void EnsureGridCreated_i(const GridCoord &);
+        void EnsureGridCreated(const GridCoord &, PreparedGrid* prepared = nullptr);
+        void EnsureGridCreated_i(const GridCoord &, PreparedGrid* prepared = nullptr);
         bool EnsureGridLoaded(Cell const&);
         void EnsureGridLoadedForActiveObject(Cell const&, WorldObject* object);
 
@@ -767,12 +804,21 @@ class TC_GAME_API Map : public GridRefManager<NGridType>
         std::mutex _mapLock;
         std::mutex _gridLock;
 
+        // generation of the terrain shared with instances and child terrain maps, for the collision cache
+        uint32 GetTerrainGeneration() const;
+
         MapEntry const* i_mapEntry;
         uint8 i_spawnMode;
         uint32 i_InstanceId;
         uint32 m_unloadTimer;
         float m_VisibleDistance;
         DynamicMapTree _dynamicTree;
+        MapCollisionCache _collisionCache;
+        // only used on the root parent terrain map, grows when terrain of it or of its child terrain maps is loaded or unloaded
+        std::atomic<uint32> _terrainGeneration;
+        std::unique_ptr<PathRequestQueue> _pathRequestQueue;
+        std::unique_ptr<MovementRelay> _movementRelay;
+        std::unique_ptr<GridActivationQueue> _gridActivationQueue;
 
         MapRefManager m_mapRefManager;
         MapRefManager::iterator m_mapRefIter;
@@ -811,6 +857,9 @@ class TC_GAME_API Map : public GridRefManager<NGridType>
         uint16 GridMapReference[MAX_NUMBER_OF_GRIDS][MAX_NUMBER_OF_GRIDS];
         std::bitset<MAX_NUMBER_OF_GRIDS* MAX_NUMBER_OF_GRIDS> i_gridFileExists; // cache what grids are available for this map (not including parent/child maps)
         std::bitset<TOTAL_NUMBER_OF_CELLS_PER_MAP*TOTAL_NUMBER_OF_CELLS_PER_MAP> marked_cells;
+        std::bitset<TOTAL_NUMBER_OF_CELLS_PER_MAP*TOTAL_NUMBER_OF_CELLS_PER_MAP> _relocationCells;
+        std::vector<uint32> _relocationCellList;                    // cells set in _relocationCells
+        float _farVisibilityRange;                                  // largest range of the far visible objects and cinematic viewers added, never shrinks
 
         //these functions used to process player/mob aggro reactions and
         //visibility calculations. Highly optimized for massive calculations
@@ -835,11 +884,18 @@ class TC_GAME_API Map : public GridRefManager<NGridType>
         bool CheckRespawn(RespawnInfo* info);
         void DoRespawn(SpawnObjectType type, ObjectGuid::LowType spawnId, uint32 gridId);
         bool AddRespawnInfo(RespawnInfo const& info);
+        void ScheduleRespawn(RespawnInfo* info);
+        // respawns of the grid that came due while it was unloaded, before its objects are loaded
+        void LoadGridRespawns(GridCoord const& p);
         void UnloadAllRespawnInfos();
         RespawnInfo* GetRespawnInfo(SpawnObjectType type, ObjectGuid::LowType spawnId) const;
         void Respawn(RespawnInfo* info, CharacterDatabaseTransaction dbTrans = nullptr);
         void DeleteRespawnInfo(RespawnInfo* info, CharacterDatabaseTransaction dbTrans = nullptr);
         void DeleteRespawnInfoFromDB(SpawnObjectType type, ObjectGuid::LowType spawnId, CharacterDatabaseTransaction dbTrans = nullptr);
+        // respawn time 0 deletes
+        void SaveRespawnTimeDB(SpawnObjectType type, ObjectGuid::LowType spawnId, time_t respawnTime, CharacterDatabaseTransaction dbTrans);
+        // writes the respawn times saved without a transaction since the last call in a single one
+        void SavePendingRespawnTimesDB();
 
     public:
         void GetRespawnInfo(std::vector<RespawnInfo const*>& respawnData, SpawnObjectTypeMask types) const;
@@ -910,7 +966,8 @@ class TC_GAME_API Map : public GridRefManager<NGridType>
                 m_activeNonPlayers.erase(obj);
         }
 
-        RespawnListContainer _respawnTimes;
+        RespawnScheduler     _respawnScheduler;
+        std::unordered_map<uint64 /*type and spawnId*/, time_t> _pendingRespawnTimes;
         RespawnInfoMap       _creatureRespawnTimesBySpawnId;
         RespawnInfoMap       _gameObjectRespawnTimesBySpawnId;
         RespawnInfoMap& GetRespawnMapForType(SpawnObjectType type)
@@ -942,6 +999,7 @@ class TC_GAME_API Map : public GridRefManager<NGridType>
         std::unordered_set<uint32> _toggledSpawnGroupIds;
 
         uint32 _respawnCheckTimer;
+        uint32 _pendingUpdateDiff;
         std::unordered_map<uint32, uint32> _zonePlayerCountMap;
 
         ZoneDynamicInfoMap _zoneDynamicInfo;
@@ -961,6 +1019,7 @@ class TC_GAME_API Map : public GridRefManager<NGridType>
         MapStoredObjectTypesContainer _objectsStore;
         CreatureBySpawnIdContainer _creatureBySpawnIdStore;
         GameObjectBySpawnIdContainer _gameObjectBySpawnIdStore;
+        CreatureUpdateStates _creatureUpdateStates;
         std::unordered_map<uint32/*cellId*/, std::unordered_set<Corpse*>> _corpsesByCell;
         std::unordered_map<ObjectGuid, Corpse*> _corpsesByPlayer;
         std::unordered_set<Corpse*> _corpseBones;
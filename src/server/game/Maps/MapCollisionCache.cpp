@@ -0,0 +1,233 @@
+/*
+ * This file is part of the TrinityCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "MapCollisionCache.h"
+#include "Hash.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <memory>
+
+namespace
+{
+    // endpoints are snapped to 1/16 yard, height lookups to 1/64 yard as ground height follows x/y closely
+    float const LineOfSightQuantum = 16.0f;
+    float const HeightQuantum = 64.0f;
+
+    // both must be powers of two
+    uint32 const LineOfSightTableSize = 2048;
+    uint32 const HeightTableSize = 2048;
+
+    std::atomic<uint64> NextCacheId(1);
+
+    std::atomic<uint64> LineOfSightHits(0);
+    std::atomic<uint64> LineOfSightMisses(0);
+    std::atomic<uint64> HeightHits(0);
+    std::atomic<uint64> HeightMisses(0);
+
+    struct LineOfSightEntry
+    {
+        uint64 Owner = 0;
+        uint32 Generation = 0;
+        uint32 TerrainMapId = 0;
+        int32 Coords[6] = { };
+        uint32 Flags = 0;
+        uint32 PhaseHash = 0;
+        bool Result = false;
+    };
+
+    struct HeightEntry
+    {
+        uint64 Owner = 0;
+        uint32 Generation = 0;
+        uint32 TerrainMapId = 0;
+        int32 Coords[3] = { };
+        float MaxSearchDist = 0.0f;
+        bool CheckVMap = false;
+        float Result = 0.0f;
+    };
+
+    struct ThreadTables
+    {
+        std::array<LineOfSightEntry, LineOfSightTableSize> LineOfSight;
+        std::array<HeightEntry, HeightTableSize> Height;
+        MapCollisionCache::Stats PendingStats;
+    };
+
+    thread_local std::unique_ptr<ThreadTables> Tables;
+
+    ThreadTables& GetTables()
+    {
+        if (!Tables)
+            Tables = std::make_unique<ThreadTables>();
+        return *Tables;
+    }
+
+    void GetGridRange(float minX, float minY, float maxX, float maxY, uint32& lowX, uint32& lowY, uint32& highX, uint32& highY)
+    {
+        GridCoord low = Trinity::ComputeGridCoord(minX, minY);
+        GridCoord high = Trinity::ComputeGridCoord(maxX, maxY);
+        lowX = std::min<uint32>(low.x_coord, MAX_NUMBER_OF_GRIDS - 1);
+        lowY = std::min<uint32>(low.y_coord, MAX_NUMBER_OF_GRIDS - 1);
+        highX = std::min<uint32>(high.x_coord, MAX_NUMBER_OF_GRIDS - 1);
+        highY = std::min<uint32>(high.y_coord, MAX_NUMBER_OF_GRIDS - 1);
+    }
+
+    int32 Quantize(float value, float quantum)
+    {
+        return int32(std::floor(value * quantum));
+    }
+
+    template<std::size_t N>
+    std::size_t HashKey(uint64 owner, uint32 terrainMapId, int32 const (&coords)[N], uint32 extra)
+    {
+        std::size_t hash = 0;
+        Trinity::hash_combine(hash, owner);
+        Trinity::hash_combine(hash, terrainMapId);
+        for (int32 coord : coords)
+            Trinity::hash_combine(hash, coord);
+        Trinity::hash_combine(hash, extra);
+        return hash;
+    }
+}
+
+MapCollisionCache::MapCollisionCache() : _id(NextCacheId.fetch_add(1, std::memory_order_relaxed)), _generation(0)
+{
+    for (std::atomic<uint32>& generation : _gridGenerations)
+        generation.store(0, std::memory_order_relaxed);
+}
+
+void MapCollisionCache::Invalidate(float minX, float minY, float maxX, float maxY)
+{
+    uint32 lowX, lowY, highX, highY;
+    GetGridRange(minX, minY, maxX, maxY, lowX, lowY, highX, highY);
+    for (uint32 x = lowX; x <= highX; ++x)
+        for (uint32 y = lowY; y <= highY; ++y)
+            _gridGenerations[x * MAX_NUMBER_OF_GRIDS + y].fetch_add(1, std::memory_order_relaxed);
+}
+
+bool MapCollisionCache::GetLineOfSightGeneration(uint32 terrainGeneration, float x1, float y1, float x2, float y2, uint32& generation) const
+{
+    uint32 lowX, lowY, highX, highY;
+    GetGridRange(std::min(x1, x2), std::min(y1, y2), std::max(x1, x2), std::max(y1, y2), lowX, lowY, highX, highY);
+    if (highX - lowX > 1 || highY - lowY > 1)
+        return false;
+
+    // counters only grow, so the sum changes whenever any of them does
+    generation = terrainGeneration + _generation.load(std::memory_order_relaxed);
+    for (uint32 x = lowX; x <= highX; ++x)
+        for (uint32 y = lowY; y <= highY; ++y)
+            generation += _gridGenerations[x * MAX_NUMBER_OF_GRIDS + y].load(std::memory_order_relaxed);
+    return true;
+}
+
+bool MapCollisionCache::FindLineOfSight(uint32 generation, uint32 terrainMapId, float x1, float y1, float z1, float x2, float y2, float z2, uint32 flags, uint32 phaseHash, bool& result) const
+{
+    int32 const coords[6] =
+    {
+        Quantize(x1, LineOfSightQuantum), Quantize(y1, LineOfSightQuantum), Quantize(z1, LineOfSightQuantum),
+        Quantize(x2, LineOfSightQuantum), Quantize(y2, LineOfSightQuantum), Quantize(z2, LineOfSightQuantum)
+    };
+
+    ThreadTables& tables = GetTables();
+
+    LineOfSightEntry const& entry = tables.LineOfSight[HashKey(_id, terrainMapId, coords, flags ^ phaseHash) & (LineOfSightTableSize - 1)];
+    if (entry.Owner == _id && entry.Generation == generation && entry.TerrainMapId == terrainMapId
+        && entry.Flags == flags && entry.PhaseHash == phaseHash && !std::memcmp(entry.Coords, coords, sizeof(coords)))
+    {
+        ++tables.PendingStats.LineOfSightHits;
+        result = entry.Result;
+        return true;
+    }
+
+    ++tables.PendingStats.LineOfSightMisses;
+    return false;
+}
+
+void MapCollisionCache::StoreLineOfSight(uint32 generation, uint32 terrainMapId, float x1, float y1, float z1, float x2, float y2, float z2, uint32 flags, uint32 phaseHash, bool result) const
+{
+    int32 const coords[6] =
+    {
+        Quantize(x1, LineOfSightQuantum), Quantize(y1, LineOfSightQuantum), Quantize(z1, LineOfSightQuantum),
+        Quantize(x2, LineOfSightQuantum), Quantize(y2, LineOfSightQuantum), Quantize(z2, LineOfSightQuantum)
+    };
+
+    LineOfSightEntry& entry = GetTables().LineOfSight[HashKey(_id, terrainMapId, coords, flags ^ phaseHash) & (LineOfSightTableSize - 1)];
+    entry.Owner = _id;
+    entry.Generation = generation;
+    entry.TerrainMapId = terrainMapId;
+    std::memcpy(entry.Coords, coords, sizeof(coords));
+    entry.Flags = flags;
+    entry.PhaseHash = phaseHash;
+    entry.Result = result;
+}
+
+bool MapCollisionCache::FindHeight(uint32 generation, uint32 terrainMapId, float x, float y, float z, bool checkVMap, float maxSearchDist, float& result) const
+{
+    int32 const coords[3] = { Quantize(x, HeightQuantum), Quantize(y, HeightQuantum), Quantize(z, HeightQuantum) };
+
+    ThreadTables& tables = GetTables();
+
+    HeightEntry const& entry = tables.Height[HashKey(_id, terrainMapId, coords, uint32(checkVMap)) & (HeightTableSize - 1)];
+    if (entry.Owner == _id && entry.Generation == generation && entry.TerrainMapId == terrainMapId
+        && entry.CheckVMap == checkVMap && entry.MaxSearchDist == maxSearchDist && !std::memcmp(entry.Coords, coords, sizeof(coords)))
+    {
+        ++tables.PendingStats.HeightHits;
+        result = entry.Result;
+        return true;
+    }
+
+    ++tables.PendingStats.HeightMisses;
+    return false;
+}
+
+void MapCollisionCache::StoreHeight(uint32 generation, uint32 terrainMapId, float x, float y, float z, bool checkVMap, float maxSearchDist, float result) const
+{
+    int32 const coords[3] = { Quantize(x, HeightQuantum), Quantize(y, HeightQuantum), Quantize(z, HeightQuantum) };
+
+    HeightEntry& entry = GetTables().Height[HashKey(_id, terrainMapId, coords, uint32(checkVMap)) & (HeightTableSize - 1)];
+    entry.Owner = _id;
+    entry.Generation = generation;
+    entry.TerrainMapId = terrainMapId;
+    std::memcpy(entry.Coords, coords, sizeof(coords));
+    entry.MaxSearchDist = maxSearchDist;
+    entry.CheckVMap = checkVMap;
+    entry.Result = result;
+}
+
+void MapCollisionCache::FlushStats()
+{
+    if (!Tables)
+        return;
+
+    Stats& pending = Tables->PendingStats;
+    LineOfSightHits.fetch_add(pending.LineOfSightHits, std::memory_order_relaxed);
+    LineOfSightMisses.fetch_add(pending.LineOfSightMisses, std::memory_order_relaxed);
+    HeightHits.fetch_add(pending.HeightHits, std::memory_order_relaxed);
+    HeightMisses.fetch_add(pending.HeightMisses, std::memory_order_relaxed);
+    pending = Stats();
+}
+
+MapCollisionCache::Stats MapCollisionCache::ConsumeStats()
+{
+    Stats stats;
+    stats.LineOfSightHits = LineOfSightHits.exchange(0, std::memory_order_relaxed);
+    stats.LineOfSightMisses = LineOfSightMisses.exchange(0, std::memory_order_relaxed);
+    stats.HeightHits = HeightHits.exchange(0, std::memory_order_relaxed);
+    stats.HeightMisses = HeightMisses.exchange(0, std::memory_order_relaxed);
+    return stats;
+}
@@ -0,0 +1,81 @@
+/*
+ * This file is part of the TrinityCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MapCollisionCache_h__
+#define MapCollisionCache_h__
+
+#include "Define.h"
+#include "GridDefines.h"
+#include <array>
+#include <atomic>
+
+/*
+ * Memoizes line of sight and static height queries of a single map.
+ *
+ * Results are kept in small direct mapped tables owned by the querying thread, so no locking is needed
+ * even when several threads query the same map. Entries are tagged with the owning map and the generation
+ * of the grids they touch: a collision model changing only makes results around it stale, loading or
+ * unloading terrain makes every cached result of that map stale at once. Terrain is shared by instances
+ * and child terrain maps, so its generation is kept by the map owning it and passed into every lookup.
+ */
+class TC_GAME_API MapCollisionCache
+{
+public:
+    struct Stats
+    {
+        uint64 LineOfSightHits = 0;
+        uint64 LineOfSightMisses = 0;
+        uint64 HeightHits = 0;
+        uint64 HeightMisses = 0;
+    };
+
+    MapCollisionCache();
+
+    MapCollisionCache(MapCollisionCache const&) = delete;
+    MapCollisionCache& operator=(MapCollisionCache const&) = delete;
+
+    void Invalidate() { _generation.fetch_add(1, std::memory_order_relaxed); }
+    // invalidates results of all grids overlapping the given area (bounds of a changed collision model)
+    void Invalidate(float minX, float minY, float maxX, float maxY);
+
+    // generation to look up and store a result with, read before running the query so that a change while it runs
+    // leaves the stored result stale; terrainGeneration must grow whenever the terrain used by the map is loaded or unloaded
+    // fails for lines spanning more than 2x2 grids which are not worth caching
+    bool GetLineOfSightGeneration(uint32 terrainGeneration, float x1, float y1, float x2, float y2, uint32& generation) const;
+    // static height does not depend on collision models, only terrain changes matter
+    uint32 GetHeightGeneration(uint32 terrainGeneration) const { return terrainGeneration + _generation.load(std::memory_order_relaxed); }
+
+    // flags must encode everything besides the endpoints the result depends on (checks, ignore flags)
+    // phaseHash must be 0 when the result does not depend on phases
+    bool FindLineOfSight(uint32 generation, uint32 terrainMapId, float x1, float y1, float z1, float x2, float y2, float z2, uint32 flags, uint32 phaseHash, bool& result) const;
+    void StoreLineOfSight(uint32 generation, uint32 terrainMapId, float x1, float y1, float z1, float x2, float y2, float z2, uint32 flags, uint32 phaseHash, bool result) const;
+
+    bool FindHeight(uint32 generation, uint32 terrainMapId, float x, float y, float z, bool checkVMap, float maxSearchDist, float& result) const;
+    void StoreHeight(uint32 generation, uint32 terrainMapId, float x, float y, float z, bool checkVMap, float maxSearchDist, float result) const;
+
+    // folds the counters of the calling thread into the ones returned by ConsumeStats
+    static void FlushStats();
+    // summed over all maps and threads since the previous call, counts of threads that did not flush since are missing
+    static Stats ConsumeStats();
+
+private:
+    uint64 _id;
+    std::atomic<uint32> _generation;
+    std::array<std::atomic<uint32>, MAX_NUMBER_OF_GRIDS * MAX_NUMBER_OF_GRIDS> _gridGenerations;
+};
+
+#endif // MapCollisionCache_h__
@@ -34,6 +34,8 @@ class TC_GAME_API MapInstanced : public Map
         // functions overwrite Map versions
         void Update(uint32) override;
         void DelayedUpdate(uint32 diff) override;
+        // schedules the updates of its instances
+        UpdateRate GetUpdateRate() const override { return UPDATE_RATE_FULL; }
         //void RelocationNotify();
         void UnloadAll() override;
         EnterState CannotEnter(Player* /*player*/) override;
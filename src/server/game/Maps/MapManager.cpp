@@ -53,6 +53,14 @@ void MapManager::Initialize()
     // Start mtmaps if needed.
     if (num_threads > 0)
         m_updater.activate(num_threads);
+
+    int num_path_threads(sWorld->getIntConfig(CONFIG_PATHFINDING_THREADS));
+    if (num_path_threads > 0)
+        _pathRequestProcessor.activate(num_path_threads);
+
+    int num_grid_threads(sWorld->getIntConfig(CONFIG_GRID_PREPARATION_THREADS));
+    if (num_grid_threads > 0)
+        _gridPreparationProcessor.activate(num_grid_threads);
 }
 
 void MapManager::InitializeParentMapData(std::unordered_map<uint32, std::vector<uint32>> const& mapData)
@@ -302,6 +310,13 @@ void MapManager::UnloadAll()
     if (m_updater.activated())
         m_updater.deactivate();
 
+    // maps wait for their path requests when deleted, so the threads can be stopped now
+    if (_pathRequestProcessor.activated())
+        _pathRequestProcessor.deactivate();
+
+    if (_gridPreparationProcessor.activated())
+        _gridPreparationProcessor.deactivate();
+
     Map::DeleteStateMachine();
 }
 
@@ -22,7 +22,9 @@
 #include "Map.h"
 #include "MapInstanced.h"
 #include "GridStates.h"
+#include "GridActivationQueue.h"
 #include "MapUpdater.h"
+#include "PathRequestQueue.h"
 #include <boost/dynamic_bitset.hpp>
 
 class PhaseShift;
@@ -129,6 +131,8 @@ class TC_GAME_API MapManager
         void FreeInstanceId(uint32 instanceId);
 
         MapUpdater * GetMapUpdater() { return &m_updater; }
+        PathRequestProcessor* GetPathRequestProcessor() { return &_pathRequestProcessor; }
+        GridPreparationProcessor* GetGridPreparationProcessor() { return &_gridPreparationProcessor; }
 
         template<typename Worker>
         void DoForAllMaps(Worker&& worker);
@@ -167,6 +171,8 @@ class TC_GAME_API MapManager
         InstanceIds _freeInstanceIds;
         uint32 _nextInstanceId;
         MapUpdater m_updater;
+        PathRequestProcessor _pathRequestProcessor;
+        GridPreparationProcessor _gridPreparationProcessor;
 
         // atomic op counter for active scripts amount
         std::atomic<std::size_t> _scheduledScripts;
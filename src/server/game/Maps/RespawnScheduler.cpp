@@ -0,0 +1,206 @@
+/*
+ * This file is part of the TrinityCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "RespawnScheduler.h"
+#include "Errors.h"
+#include <algorithm>
+
+RespawnScheduler::RespawnScheduler() : _size(0)
+{
+    SetGridLoaded(AnyGrid, true);
+}
+
+void RespawnScheduler::Insert(RespawnInfo* info, uint32 gridId)
+{
+    ASSERT(!info->handle.Bucket, "Respawn info (%u,%u) is scheduled already", uint32(info->type), info->spawnId);
+
+    Grid& grid = GetGrid(gridId);
+    if (grid.Slots.empty())
+        grid.Slots.resize(WheelSlots);
+
+    // anything before the grid's tick goes to the first slot still to be checked
+    time_t tick = std::max(info->respawnTime / SlotSeconds, grid.Tick);
+    Add(grid.Slots[tick % WheelSlots], info);
+    ++_size;
+}
+
+void RespawnScheduler::Erase(RespawnInfo* info)
+{
+    ASSERT(info->handle.Bucket, "Respawn info (%u,%u) is not scheduled", uint32(info->type), info->spawnId);
+
+    if (info->handle.Bucket == &_due)
+    {
+        // keep the due list ordered
+        _due.erase(_due.begin() + info->handle.Index);
+        for (std::size_t i = info->handle.Index; i < _due.size(); ++i)
+            _due[i]->handle.Index = i;
+
+        info->handle = RespawnScheduleHandle();
+    }
+    else
+        Remove(info);
+
+    --_size;
+}
+
+void RespawnScheduler::Clear(std::vector<RespawnInfo*>& infos)
+{
+    infos.reserve(infos.size() + _size);
+    for (auto& pair : _grids)
+    {
+        for (std::vector<RespawnInfo*>& slot : pair.second.Slots)
+        {
+            for (RespawnInfo* info : slot)
+            {
+                info->handle = RespawnScheduleHandle();
+                infos.push_back(info);
+            }
+
+            slot.clear();
+        }
+    }
+
+    for (RespawnInfo* info : _due)
+    {
+        info->handle = RespawnScheduleHandle();
+        infos.push_back(info);
+    }
+
+    _due.clear();
+    _size = 0;
+}
+
+void RespawnScheduler::SetGridLoaded(uint32 gridId, bool loaded)
+{
+    if (!loaded && !_grids.count(gridId))
+        return;
+
+    Grid& grid = GetGrid(gridId);
+    if (grid.Loaded == loaded)
+        return;
+
+    grid.Loaded = loaded;
+    if (loaded)
+    {
+        grid.LoadedIndex = _loadedGrids.size();
+        _loadedGrids.push_back(&grid);
+    }
+    else
+    {
+        Grid* last = _loadedGrids.back();
+        last->LoadedIndex = grid.LoadedIndex;
+        _loadedGrids[grid.LoadedIndex] = last;
+        _loadedGrids.pop_back();
+    }
+}
+
+void RespawnScheduler::Update(time_t now)
+{
+    std::size_t dueCount = _due.size();
+    for (Grid* grid : _loadedGrids)
+        Advance(*grid, now);
+
+    if (_due.size() != dueCount)
+        SortDue();
+}
+
+void RespawnScheduler::CollectDue(uint32 gridId, time_t now, std::vector<RespawnInfo*>& due)
+{
+    auto itr = _grids.find(gridId);
+    if (itr == _grids.end())
+        return;
+
+    std::size_t dueCount = _due.size();
+    Advance(itr->second, now);
+
+    for (std::size_t i = dueCount; i < _due.size(); ++i)
+    {
+        _due[i]->handle = RespawnScheduleHandle();
+        due.push_back(_due[i]);
+    }
+
+    _size -= _due.size() - dueCount;
+    _due.resize(dueCount);
+}
+
+void RespawnScheduler::Add(std::vector<RespawnInfo*>& bucket, RespawnInfo* info)
+{
+    info->handle.Bucket = &bucket;
+    info->handle.Index = bucket.size();
+    bucket.push_back(info);
+}
+
+void RespawnScheduler::Remove(RespawnInfo* info)
+{
+    std::vector<RespawnInfo*>& bucket = *info->handle.Bucket;
+    RespawnInfo* last = bucket.back();
+    last->handle.Index = info->handle.Index;
+    bucket[info->handle.Index] = last;
+    bucket.pop_back();
+
+    info->handle = RespawnScheduleHandle();
+}
+
+RespawnScheduler::Grid& RespawnScheduler::GetGrid(uint32 gridId)
+{
+    auto itr = _grids.find(gridId);
+    if (itr == _grids.end())
+        itr = _grids.emplace(gridId, Grid{ {}, 0, 0, false }).first;
+
+    return itr->second;
+}
+
+void RespawnScheduler::Advance(Grid& grid, time_t now)
+{
+    time_t const tick = std::max(now / SlotSeconds, grid.Tick);
+    if (!grid.Slots.empty())
+    {
+        // a grid that was not advanced for a whole turn of the wheel checks every slot once
+        time_t const slotCount = std::min<time_t>(tick - grid.Tick + 1, WheelSlots);
+        for (time_t i = 0; i < slotCount; ++i)
+        {
+            std::vector<RespawnInfo*>& slot = grid.Slots[(grid.Tick + i) % WheelSlots];
+            // slots also hold respawns of later turns, backwards so removing doesn't skip any
+            for (std::size_t j = slot.size(); j > 0; --j)
+            {
+                RespawnInfo* info = slot[j - 1];
+                if (info->respawnTime > now)
+                    continue;
+
+                Remove(info);
+                Add(_due, info);
+            }
+        }
+    }
+
+    grid.Tick = tick;
+}
+
+void RespawnScheduler::SortDue()
+{
+    std::sort(_due.begin(), _due.end(), [](RespawnInfo const* a, RespawnInfo const* b)
+    {
+        if (a->respawnTime != b->respawnTime)
+            return a->respawnTime > b->respawnTime;
+        if (a->spawnId != b->spawnId)
+            return a->spawnId > b->spawnId;
+        return a->type > b->type;
+    });
+
+    for (std::size_t i = 0; i < _due.size(); ++i)
+        _due[i]->handle.Index = i;
+}
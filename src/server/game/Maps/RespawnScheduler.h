@@ -0,0 +1,106 @@
+/*
+ * This file is part of the TrinityCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TRINITY_RESPAWNSCHEDULER_H
+#define TRINITY_RESPAWNSCHEDULER_H
+
+#include "ObjectGuid.h"
+#include "SpawnData.h"
+#include <ctime>
+#include <limits>
+#include <unordered_map>
+#include <vector>
+
+struct RespawnInfo;
+
+// Position of a scheduled respawn, only used by RespawnScheduler
+struct RespawnScheduleHandle
+{
+    std::vector<RespawnInfo*>* Bucket = nullptr;
+    std::size_t Index = 0;
+};
+
+struct RespawnInfo
+{
+    SpawnObjectType type;
+    ObjectGuid::LowType spawnId;
+    uint32 entry;
+    time_t respawnTime;
+    uint32 gridId;
+    RespawnScheduleHandle handle;
+};
+
+// Respawn times of a map, kept in a timing wheel per grid.
+// Only wheels of loaded grids are advanced, respawns of unloaded grids are left alone until their grid is loaded.
+// Due respawns are moved to a list the map works through, earliest first.
+class TC_GAME_API RespawnScheduler
+{
+    public:
+        // respawns always checked, whether their grid is loaded or not
+        static uint32 const AnyGrid = std::numeric_limits<uint32>::max();
+
+        static uint32 const WheelSlots = 64;
+        static time_t const SlotSeconds = 4;
+
+        RespawnScheduler();
+
+        RespawnScheduler(RespawnScheduler const&) = delete;
+        RespawnScheduler& operator=(RespawnScheduler const&) = delete;
+
+        bool empty() const { return _size == 0; }
+        std::size_t size() const { return _size; }
+
+        // schedules info->respawnTime in the wheel of gridId, info must not be scheduled already
+        void Insert(RespawnInfo* info, uint32 gridId);
+        void Erase(RespawnInfo* info);
+        // all scheduled respawns, the scheduler is empty afterwards
+        void Clear(std::vector<RespawnInfo*>& infos);
+
+        void SetGridLoaded(uint32 gridId, bool loaded);
+
+        // moves respawns of loaded grids due at now to the due list
+        void Update(time_t now);
+        // takes the respawns of a grid due at now out of the scheduler, whether the grid is loaded or not
+        void CollectDue(uint32 gridId, time_t now, std::vector<RespawnInfo*>& due);
+
+        // earliest due respawn, it stays scheduled until erased or inserted again with a new time
+        RespawnInfo* GetNextDue() const { return _due.empty() ? nullptr : _due.back(); }
+        std::size_t GetDueCount() const { return _due.size(); }
+
+    private:
+        struct Grid
+        {
+            std::vector<std::vector<RespawnInfo*>> Slots;   // allocated by the first insert
+            time_t Tick;                                    // slots before this were checked
+            std::size_t LoadedIndex;
+            bool Loaded;
+        };
+
+        static void Add(std::vector<RespawnInfo*>& bucket, RespawnInfo* info);
+        static void Remove(RespawnInfo* info);
+
+        Grid& GetGrid(uint32 gridId);
+        void Advance(Grid& grid, time_t now);
+        void SortDue();
+
+        std::unordered_map<uint32, Grid> _grids;
+        std::vector<Grid*> _loadedGrids;
+        std::vector<RespawnInfo*> _due;                     // latest first
+        std::size_t _size;
+};
+
+#endif // TRINITY_RESPAWNSCHEDULER_H
@@ -0,0 +1,196 @@
+/*
+ * This file is part of the TrinityCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "SpatialQuery.h"
+#include "AreaTrigger.h"
+#include "CellImpl.h"
+#include "Corpse.h"
+#include "Creature.h"
+#include "DBCStores.h"
+#include "DynamicObject.h"
+#include "GameObject.h"
+#include "Map.h"
+#include "Player.h"
+#include <memory>
+
+namespace
+{
+    // buffers currently not owned by any SpatialQueryResult on this thread
+    thread_local std::vector<std::unique_ptr<Trinity::SpatialQueryBuffer>> FreeBuffers;
+
+    // radius of a cylinder fully containing the gameobject's rotated display box, widened for the query radius
+    // (GameObject::IsInRange extends the box by the radius along every local axis)
+    float GetGameObjectReach(GameObject const* go, float radius)
+    {
+        GameObjectDisplayInfoEntry const* info = sGameObjectDisplayInfoStore.LookupEntry(go->GetGOInfo()->displayId);
+        if (!info)
+            return 0.0f;
+
+        float extent = std::max({ std::abs(info->GeoBoxMin.X), std::abs(info->GeoBoxMax.X),
+            std::abs(info->GeoBoxMin.Y), std::abs(info->GeoBoxMax.Y),
+            std::abs(info->GeoBoxMin.Z), std::abs(info->GeoBoxMax.Z) });
+        return float(M_SQRT2) * (extent + radius) - radius;
+    }
+
+    struct SpatialCandidateCollector
+    {
+        Trinity::SpatialQueryBuffer& i_buffer;
+        uint32 i_mapTypeMask;
+        float i_radius;
+
+        SpatialCandidateCollector(Trinity::SpatialQueryBuffer& buffer, uint32 mapTypeMask, float radius)
+            : i_buffer(buffer), i_mapTypeMask(mapTypeMask), i_radius(radius) { }
+
+        void Add(WorldObject* object, float reach)
+        {
+            i_buffer.Candidates.push_back(object);
+            i_buffer.X.push_back(object->GetPositionX());
+            i_buffer.Y.push_back(object->GetPositionY());
+            i_buffer.Z.push_back(object->GetPositionZ());
+            i_buffer.Reach.push_back(reach);
+        }
+
+        void Visit(PlayerMapType& m)
+        {
+            if (!(i_mapTypeMask & GRID_MAP_TYPE_MASK_PLAYER))
+                return;
+
+            for (PlayerMapType::iterator itr = m.begin(); itr != m.end(); ++itr)
+                Add(itr->GetSource(), itr->GetSource()->GetCombatReach());
+        }
+
+        void Visit(CreatureMapType& m)
+        {
+            if (!(i_mapTypeMask & GRID_MAP_TYPE_MASK_CREATURE))
+                return;
+
+            for (CreatureMapType::iterator itr = m.begin(); itr != m.end(); ++itr)
+                Add(itr->GetSource(), itr->GetSource()->GetCombatReach());
+        }
+
+        void Visit(CorpseMapType& m)
+        {
+            if (!(i_mapTypeMask & GRID_MAP_TYPE_MASK_CORPSE))
+                return;
+
+            for (CorpseMapType::iterator itr = m.begin(); itr != m.end(); ++itr)
+                Add(itr->GetSource(), 0.0f);
+        }
+
+        void Visit(GameObjectMapType& m)
+        {
+            if (!(i_mapTypeMask & GRID_MAP_TYPE_MASK_GAMEOBJECT))
+                return;
+
+            for (GameObjectMapType::iterator itr = m.begin(); itr != m.end(); ++itr)
+                Add(itr->GetSource(), GetGameObjectReach(itr->GetSource(), i_radius));
+        }
+
+        void Visit(DynamicObjectMapType& m)
+        {
+            if (!(i_mapTypeMask & GRID_MAP_TYPE_MASK_DYNAMICOBJECT))
+                return;
+
+            for (DynamicObjectMapType::iterator itr = m.begin(); itr != m.end(); ++itr)
+                Add(itr->GetSource(), 0.0f);
+        }
+
+        void Visit(AreaTriggerMapType& m)
+        {
+            if (!(i_mapTypeMask & GRID_MAP_TYPE_MASK_AREATRIGGER))
+                return;
+
+            for (AreaTriggerMapType::iterator itr = m.begin(); itr != m.end(); ++itr)
+                Add(itr->GetSource(), 0.0f);
+        }
+
+        template<class NOT_INTERESTED> void Visit(GridRefManager<NOT_INTERESTED>&) { }
+    };
+}
+
+void Trinity::SpatialQueryBuffer::Clear()
+{
+    Candidates.clear();
+    X.clear();
+    Y.clear();
+    Z.clear();
+    Reach.clear();
+    InRange.clear();
+    Results.clear();
+}
+
+Trinity::SpatialQueryResult::SpatialQueryResult()
+{
+    if (!FreeBuffers.empty())
+    {
+        _buffer = FreeBuffers.back().release();
+        FreeBuffers.pop_back();
+    }
+    else
+        _buffer = new SpatialQueryBuffer();
+}
+
+Trinity::SpatialQueryResult::~SpatialQueryResult()
+{
+    _buffer->Clear();
+    FreeBuffers.emplace_back(_buffer);
+}
+
+void Map::QueryObjectsInRange(Trinity::SpatialQueryResult& result, Position const& center, float radius, uint32 typeMask /*= GRID_MAP_TYPE_MASK_ALL*/, float padding /*= 0.0f*/)
+{
+    Trinity::SpatialQueryBuffer& buffer = result.GetBuffer();
+    buffer.Clear();
+
+    if (!typeMask)
+        return;
+
+    float const x = center.GetPositionX();
+    float const y = center.GetPositionY();
+    float const z = center.GetPositionZ();
+    float const searchRadius = radius + padding;
+
+    // pets and player owned creatures live in the world container, everything else in grid containers
+    bool searchInGrid = (typeMask & (GRID_MAP_TYPE_MASK_CREATURE | GRID_MAP_TYPE_MASK_GAMEOBJECT | GRID_MAP_TYPE_MASK_DYNAMICOBJECT | GRID_MAP_TYPE_MASK_AREATRIGGER)) != 0;
+    bool searchInWorld = (typeMask & (GRID_MAP_TYPE_MASK_CREATURE | GRID_MAP_TYPE_MASK_PLAYER | GRID_MAP_TYPE_MASK_CORPSE | GRID_MAP_TYPE_MASK_DYNAMICOBJECT)) != 0;
+
+    SpatialCandidateCollector collector(buffer, typeMask, radius);
+    if (searchInWorld)
+        Cell::VisitWorldObjects(x, y, this, collector, searchRadius);
+    if (searchInGrid)
+        Cell::VisitGridObjects(x, y, this, collector, searchRadius);
+
+    // distance pass over the packed positions, kept branch free so it can be vectorized
+    std::size_t const count = buffer.Candidates.size();
+    buffer.InRange.resize(count);
+    float const* posX = buffer.X.data();
+    float const* posY = buffer.Y.data();
+    float const* posZ = buffer.Z.data();
+    float const* reach = buffer.Reach.data();
+    uint8* inRange = buffer.InRange.data();
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        float const dx = posX[i] - x;
+        float const dy = posY[i] - y;
+        float const dz = posZ[i] - z;
+        float const limit = searchRadius + reach[i];
+        inRange[i] = uint8(dx * dx + dy * dy <= limit * limit) & uint8(std::abs(dz) <= limit);
+    }
+
+    for (std::size_t i = 0; i < count; ++i)
+        if (inRange[i])
+            buffer.Results.push_back(buffer.Candidates[i]);
+}
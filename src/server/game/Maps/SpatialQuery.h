@@ -0,0 +1,71 @@
+/*
+ * This file is part of the TrinityCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TRINITY_SPATIALQUERY_H
+#define TRINITY_SPATIALQUERY_H
+
+#include "Define.h"
+#include <vector>
+
+class WorldObject;
+
+namespace Trinity
+{
+    // Candidates gathered from the grid cells covered by a query, stored as packed
+    // arrays so the distance pass runs over contiguous floats instead of objects
+    struct SpatialQueryBuffer
+    {
+        std::vector<WorldObject*> Candidates;
+        std::vector<float> X;
+        std::vector<float> Y;
+        std::vector<float> Z;
+        std::vector<float> Reach;
+        std::vector<uint8> InRange;
+        std::vector<WorldObject*> Results;
+
+        void Clear();
+    };
+
+    // Result handle of a spatial query. Buffers are taken from a thread local pool and
+    // given back on destruction, so repeated queries do not allocate once warmed up.
+    // Queries may be nested (a check run on a result may issue another query), each
+    // level gets its own buffer.
+    class TC_GAME_API SpatialQueryResult
+    {
+    public:
+        typedef std::vector<WorldObject*>::const_iterator const_iterator;
+
+        SpatialQueryResult();
+        ~SpatialQueryResult();
+
+        SpatialQueryResult(SpatialQueryResult const&) = delete;
+        SpatialQueryResult& operator=(SpatialQueryResult const&) = delete;
+
+        const_iterator begin() const { return _buffer->Results.begin(); }
+        const_iterator end() const { return _buffer->Results.end(); }
+        std::size_t size() const { return _buffer->Results.size(); }
+        bool empty() const { return _buffer->Results.empty(); }
+        WorldObject* operator[](std::size_t index) const { return _buffer->Results[index]; }
+
+        SpatialQueryBuffer& GetBuffer() { return *_buffer; }
+
+    private:
+        SpatialQueryBuffer* _buffer;
+    };
+}
+
+#endif // TRINITY_SPATIALQUERY_H
@@ -804,6 +804,9 @@ void MotionMaster::Mutate(MovementGenerator *m, MovementSlot slot)
     }
 
     _slot[slot] = m;
+    if (Creature* creature = _owner->ToCreature())
+        creature->WakeUpdates(CREATURE_UPDATE_STATE_MOVING);
+
     if (_top > slot)
         _initialize[slot] = true;
     else
@@ -22,7 +22,8 @@
 #include "G3DPosition.hpp"
 #include "MoveSpline.h"
 #include "MoveSplineInit.h"
-#include "PathGenerator.h"
+#include "Map.h"
+#include "PathRequestQueue.h"
 #include "Unit.h"
 #include "Util.h"
 #include "Vehicle.h"
@@ -75,7 +76,7 @@ inline float GetChaseRange(Unit const* owner, Unit const* target)
     return hitboxSum;
 }
 
-ChaseMovementGenerator::ChaseMovementGenerator(Unit* target, float range, Optional<ChaseAngle> angle) : AbstractPursuer(PursuingType::Chase, ASSERT_NOTNULL(target)), _range(range), _angle(angle) { }
+ChaseMovementGenerator::ChaseMovementGenerator(Unit* target, float range, Optional<ChaseAngle> angle) : AbstractPursuer(PursuingType::Chase, ASSERT_NOTNULL(target)), _range(range), _angle(angle), _pendingBackward(false) { }
 ChaseMovementGenerator::~ChaseMovementGenerator() = default;
 
 void ChaseMovementGenerator::Initialize(Unit* owner)
@@ -85,6 +86,7 @@ void ChaseMovementGenerator::Initialize(Unit* owner)
     _lastTargetPosition.reset();
     _nextMovementTimer.Reset(0);
     _nextRepositioningTimer.Reset(0);
+    _pendingPath.reset();
 }
 
 bool ChaseMovementGenerator::Update(Unit* owner, uint32 diff)
@@ -108,16 +110,32 @@ bool ChaseMovementGenerator::Update(Unit* owner, uint32 diff)
     {
         owner->StopMoving();
         _lastTargetPosition.reset();
+        _pendingPath.reset();
         if (Creature* cOwner = owner->ToCreature())
             cOwner->SetCannotReachTarget(false);
         return true;
     }
 
+    Creature* creature = owner->ToCreature();
+    bool const targetAccessible = !creature || target->isInAccessiblePlaceFor(creature);
+
+    switch (GetPendingPathAction(_pendingPath && _pendingPath->IsReady(), targetAccessible))
+    {
+        case PENDING_PATH_LAUNCH:
+            ApplyPendingPath(owner);
+            break;
+        case PENDING_PATH_DROP:
+            _pendingPath.reset();
+            break;
+        default:
+            break;
+    }
+
     // We are done moving. Trigger movement inform hook and clear chase move state
     if (owner->HasUnitState(UNIT_STATE_CHASE_MOVE) && owner->movespline->Finalized())
     {
-        if (Creature* cOwner = owner->ToCreature())
-            cOwner->SetCannotReachTarget(false);
+        if (creature)
+            creature->SetCannotReachTarget(false);
 
         owner->ClearUnitState(UNIT_STATE_CHASE_MOVE);
         DoMovementInform(owner, target);
@@ -125,19 +143,11 @@ bool ChaseMovementGenerator::Update(Unit* owner, uint32 diff)
     }
 
     // Owner cannot reach target (example: target is in water and owner cannot swim)
-    Creature* creature = owner->ToCreature();
-    if (owner->HasUnitState(UNIT_STATE_CHASE_MOVE) && creature)
-    {
-        if (!target->isInAccessiblePlaceFor(creature))
-        {
-            creature->SetCannotReachTarget(true);
-            creature->StopMoving();
-            return true;
-        }
-    }
-    else if (creature && !target->isInAccessiblePlaceFor(creature))
+    if (!targetAccessible)
     {
         creature->SetCannotReachTarget(true);
+        if (owner->HasUnitState(UNIT_STATE_CHASE_MOVE))
+            creature->StopMoving();
         return true;
     }
 
@@ -178,6 +188,9 @@ bool ChaseMovementGenerator::Update(Unit* owner, uint32 diff)
 
             if (PositionOkay(owner, target, rangeTolerance, chaseAngle))
             {
+                // a path still being built leads somewhere we no longer need to go
+                _pendingPath.reset();
+
                 if (owner->HasUnitState(UNIT_STATE_CHASE_MOVE) && !target->isMoving() && !mutualChase)
                 {
                     // Our current position is fine. Stop movement.
@@ -193,11 +206,21 @@ bool ChaseMovementGenerator::Update(Unit* owner, uint32 diff)
     return true;
 }
 
+ChaseMovementGenerator::PendingPathAction ChaseMovementGenerator::GetPendingPathAction(bool pathReady, bool targetAccessible)
+{
+    // the path was requested towards a target we gave up on, launching it would resume the chase
+    if (!targetAccessible)
+        return PENDING_PATH_DROP;
+
+    return pathReady ? PENDING_PATH_LAUNCH : PENDING_PATH_KEEP;
+}
+
 void ChaseMovementGenerator::Finalize(Unit* owner)
 {
     owner->ClearUnitState(UNIT_STATE_CHASE | UNIT_STATE_CHASE_MOVE);
     if (Creature* cOwner = owner->ToCreature())
         cOwner->SetCannotReachTarget(false);
+    _pendingPath.reset();
 }
 
 void ChaseMovementGenerator::LaunchMovement(Unit* owner, float chaseRange, bool backward /*= false*/, bool mutualChase /*= false*/)
@@ -236,12 +259,21 @@ void ChaseMovementGenerator::LaunchMovement(Unit* owner, float chaseRange, bool
 
     owner->UpdateAllowedPositionZ(dest.GetPositionX(), dest.GetPositionY(), dest.m_positionZ);
 
-    Creature* creature = owner->ToCreature();
-    Movement::MoveSplineInit init(owner);
+    // a newer destination replaces the one still being built
+    _pendingPath = owner->GetMap()->GetPathRequestQueue().Submit(owner, PositionToVector3(dest), owner->CanFly());
+    _pendingBackward = backward;
+
+    if (_pendingPath->IsReady())
+        ApplyPendingPath(owner);
+}
 
-    PathGenerator path(owner);
-    bool success = path.CalculatePath(dest.GetPositionX(), dest.GetPositionY(), dest.GetPositionZ(), owner->CanFly());
-    if (!success || (path.GetPathType() & (PATHFIND_NOPATH /*| PATHFIND_INCOMPLETE*/)))
+void ChaseMovementGenerator::ApplyPendingPath(Unit* owner)
+{
+    std::shared_ptr<PathRequest const> path = std::move(_pendingPath);
+    bool const backward = _pendingBackward;
+
+    Creature* creature = owner->ToCreature();
+    if (path->GetPathType() & (PATHFIND_NOPATH /*| PATHFIND_INCOMPLETE*/))
     {
         if (creature)
             creature->SetCannotReachTarget(true);
@@ -250,12 +282,21 @@ void ChaseMovementGenerator::LaunchMovement(Unit* owner, float chaseRange, bool
         return;
     }
 
-    init.MovebyPath(path.GetPath());
+    Movement::PointsArray points;
+    if (!path->GetPath(owner, points))
+    {
+        // owner moved on too far meanwhile, ask again on the next movement update
+        _lastTargetPosition.reset();
+        return;
+    }
+
+    Movement::MoveSplineInit init(owner);
+    init.MovebyPath(points);
     init.SetWalk(false);
     if (backward)
         init.SetBackward();
     else
-        init.SetFacing(target);
+        init.SetFacing(GetTarget());
 
     init.Launch();
 
@@ -22,7 +22,9 @@
 #include "AbstractPursuer.h"
 #include "Optional.h"
 #include "Timer.h"
+#include <memory>
 
+class PathRequest;
 class Unit;
 
 class ChaseMovementGenerator : public MovementGenerator, public AbstractPursuer
@@ -41,7 +43,18 @@ class ChaseMovementGenerator : public MovementGenerator, public AbstractPursuer
         void UnitSpeedChanged() override { _lastTargetPosition.reset(); }
 
     private:
+        enum PendingPathAction : uint8
+        {
+            PENDING_PATH_KEEP,      // still being built, the current spline keeps running
+            PENDING_PATH_LAUNCH,
+            PENDING_PATH_DROP
+        };
+
+        // what Update does with the path requested last, before deciding on new movement
+        static PendingPathAction GetPendingPathAction(bool pathReady, bool targetAccessible);
+
         void LaunchMovement(Unit* owner, float chaseRange, bool backward = false, bool mutualChase = false);
+        void ApplyPendingPath(Unit* owner);
 
         static constexpr uint32 CHASE_MOVEMENT_INTERVAL = 400; // sniffed value (1 batch update cyclice)
         static constexpr uint32 REPOSITION_MOVEMENT_INTERVAL = 1200; // (3 batch update cycles) TODO: verify
@@ -52,6 +65,10 @@ class ChaseMovementGenerator : public MovementGenerator, public AbstractPursuer
         Optional<Position> _lastTargetPosition;
         float const _range;
         Optional<ChaseAngle> const _angle;
+
+        // path being built by the path finding threads, current spline keeps running meanwhile
+        std::shared_ptr<PathRequest const> _pendingPath;
+        bool _pendingBackward;
 };
 
 #endif
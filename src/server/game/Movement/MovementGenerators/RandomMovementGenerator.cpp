@@ -20,18 +20,12 @@
 #include "Map.h"
 #include "MoveSplineInit.h"
 #include "MoveSpline.h"
-#include "PathGenerator.h"
+#include "PathRequestQueue.h"
 #include "Random.h"
 
 template<class T>
 RandomMovementGenerator<T>::~RandomMovementGenerator() { }
 
-template<>
-RandomMovementGenerator<Creature>::~RandomMovementGenerator()
-{
-    delete _path;
-}
-
 template<class T>
 void RandomMovementGenerator<T>::Pause(uint32) { }
 
@@ -72,6 +66,7 @@ void RandomMovementGenerator<Creature>::DoInitialize(Creature* owner)
     _wanderSteps = urand(2, 10);
 
     _timer.Reset(0);
+    _path.reset();
 }
 
 template<class T>
@@ -83,6 +78,7 @@ void RandomMovementGenerator<Creature>::DoFinalize(Creature* owner)
     owner->ClearUnitState(UNIT_STATE_ROAMING);
     owner->StopMoving();
     owner->SetWalk(false);
+    _path.reset();
 }
 
 template<class T>
@@ -95,37 +91,24 @@ void RandomMovementGenerator<Creature>::DoReset(Creature* owner)
 }
 
 template<class T>
-void RandomMovementGenerator<T>::SetRandomLocation(T*) { }
+void RandomMovementGenerator<T>::LaunchPendingPath(T*) { }
 
 template<>
-void RandomMovementGenerator<Creature>::SetRandomLocation(Creature* owner)
+void RandomMovementGenerator<Creature>::LaunchPendingPath(Creature* owner)
 {
-    if (!owner)
-        return;
+    std::shared_ptr<PathRequest const> path = std::move(_path);
 
-    if (owner->HasUnitState(UNIT_STATE_NOT_MOVE) || owner->IsMovementPreventedByCasting())
+    // PATHFIND_FARFROMPOLY shouldn't be checked as creatures in water are most likely far from poly
+    if ((path->GetPathType() & PATHFIND_NOPATH)
+        || (path->GetPathType() & PATHFIND_SHORTCUT)
+        /*|| (path->GetPathType() & PATHFIND_FARFROMPOLY)*/)
     {
-        _interrupt = true;
-        owner->StopMoving();
+        _timer.Reset(500);
         return;
     }
 
-    owner->AddUnitState(UNIT_STATE_ROAMING_MOVE);
-
-    Position position(_reference);
-    float distance = frand(0.f, _wanderDistance);
-    float angle = frand(0.f, float(M_PI * 2));
-    owner->MovePositionToFirstCollision(position, distance, angle);
-
-    if (!_path)
-        _path = new PathGenerator(owner);
-
-    _path->SetPathLengthLimit(30.0f);
-    bool result = _path->CalculatePath(position.GetPositionX(), position.GetPositionY(), position.GetPositionZ());
-    // PATHFIND_FARFROMPOLY shouldn't be checked as creatures in water are most likely far from poly
-    if (!result || (_path->GetPathType() & PATHFIND_NOPATH)
-        || (_path->GetPathType() & PATHFIND_SHORTCUT)
-        /*|| (_path->GetPathType() & PATHFIND_FARFROMPOLY)*/)
+    Movement::PointsArray points;
+    if (!path->GetPath(owner, points))
     {
         _timer.Reset(500);
         return;
@@ -145,7 +128,7 @@ void RandomMovementGenerator<Creature>::SetRandomLocation(Creature* owner)
     }
 
     Movement::MoveSplineInit init(owner);
-    init.MovebyPath(_path->GetPath());
+    init.MovebyPath(points);
     init.SetWalk(walk);
     int32 splineDuration = init.Launch();
 
@@ -163,6 +146,34 @@ void RandomMovementGenerator<Creature>::SetRandomLocation(Creature* owner)
     owner->SignalFormationMovement();
 }
 
+template<class T>
+void RandomMovementGenerator<T>::SetRandomLocation(T*) { }
+
+template<>
+void RandomMovementGenerator<Creature>::SetRandomLocation(Creature* owner)
+{
+    if (!owner)
+        return;
+
+    if (owner->HasUnitState(UNIT_STATE_NOT_MOVE) || owner->IsMovementPreventedByCasting())
+    {
+        _interrupt = true;
+        owner->StopMoving();
+        return;
+    }
+
+    owner->AddUnitState(UNIT_STATE_ROAMING_MOVE);
+
+    Position position(_reference);
+    float distance = frand(0.f, _wanderDistance);
+    float angle = frand(0.f, float(M_PI * 2));
+    owner->MovePositionToFirstCollision(position, distance, angle);
+
+    _path = owner->GetMap()->GetPathRequestQueue().Submit(owner, G3D::Vector3(position.GetPositionX(), position.GetPositionY(), position.GetPositionZ()), false, 30.0f);
+    if (_path->IsReady())
+        LaunchPendingPath(owner);
+}
+
 template<class T>
 bool RandomMovementGenerator<T>::DoUpdate(T*, uint32)
 {
@@ -179,11 +190,20 @@ bool RandomMovementGenerator<Creature>::DoUpdate(Creature* owner, uint32 diff)
     {
         _interrupt = true;
         owner->StopMoving();
+        _path.reset();
         return true;
     }
     else
         _interrupt = false;
 
+    // waiting for the path finding threads
+    if (_path)
+    {
+        if (_path->IsReady())
+            LaunchPendingPath(owner);
+        return true;
+    }
+
     _timer.Update(diff);
     if (!_interrupt && _timer.Passed() && owner->movespline->Finalized())
         SetRandomLocation(owner);
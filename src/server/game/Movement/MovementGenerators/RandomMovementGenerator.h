@@ -21,12 +21,15 @@
 #include "MovementGenerator.h"
 #include "Position.h"
 #include "Timer.h"
+#include <memory>
+
+class PathRequest;
 
 template<class T>
 class RandomMovementGenerator : public MovementGeneratorMedium< T, RandomMovementGenerator<T> >
 {
     public:
-        explicit RandomMovementGenerator(float distance = 0.0f) : _path(nullptr), _timer(0), _reference(), _wanderDistance(distance), _wanderSteps(0), _interrupt(false), _stalled(false) { }
+        explicit RandomMovementGenerator(float distance = 0.0f) : _timer(0), _reference(), _wanderDistance(distance), _wanderSteps(0), _interrupt(false), _stalled(false) { }
         ~RandomMovementGenerator();
 
         MovementGeneratorType GetMovementGeneratorType() const override { return RANDOM_MOTION_TYPE; }
@@ -41,8 +44,10 @@ class RandomMovementGenerator : public MovementGeneratorMedium< T, RandomMovemen
 
     private:
         void SetRandomLocation(T*);
+        void LaunchPendingPath(T*);
 
-        PathGenerator* _path;
+        // path being built by the path finding threads
+        std::shared_ptr<PathRequest const> _path;
         TimeTracker _timer;
         Position _reference;
         float _wanderDistance;
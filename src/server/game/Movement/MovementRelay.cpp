@@ -0,0 +1,172 @@
+/*
+ * This file is part of the TrinityCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "MovementRelay.h"
+#include "CellImpl.h"
+#include "GameTime.h"
+#include "GridNotifiers.h"
+#include "Map.h"
+#include "Opcodes.h"
+#include "Pet.h"
+#include "Player.h"
+#include "World.h"
+#include "WorldPacket.h"
+#include <atomic>
+
+namespace
+{
+    // far relay times of movers that stopped sending heartbeats are forgotten after this long
+    uint32 const FarRelayPruneInterval = 10 * IN_MILLISECONDS;
+
+    std::atomic<uint64> RelayedHeartbeats(0);
+    std::atomic<uint64> CoalescedHeartbeats(0);
+    std::atomic<uint64> ThrottledPackets(0);
+    std::atomic<uint64> BytesSaved(0);
+}
+
+void MovementRelay::Relay(Unit* mover, Player const* skipped, bool heartbeat)
+{
+    if (heartbeat)
+    {
+        auto itr = _pendingHeartbeats.find(mover->GetGUID());
+        if (itr != _pendingHeartbeats.end())
+        {
+            itr->second.Skipped = skipped;
+            ++itr->second.Superseded;
+        }
+        else
+            _pendingHeartbeats[mover->GetGUID()].Skipped = skipped;
+
+        return;
+    }
+
+    uint32 superseded = 0;
+    auto itr = _pendingHeartbeats.find(mover->GetGUID());
+    if (itr != _pendingHeartbeats.end())
+    {
+        superseded = itr->second.Superseded + 1;
+        _pendingHeartbeats.erase(itr);
+    }
+
+    uint32 packetSize, throttled;
+    uint32 sent = Send(mover, skipped, false, packetSize, throttled);
+
+    _stats.CoalescedHeartbeats += superseded;
+    _stats.BytesSaved += uint64(superseded) * sent * packetSize;
+}
+
+void MovementRelay::Update(uint32 diff)
+{
+    for (auto const& pair : _pendingHeartbeats)
+    {
+        Unit* mover;
+        if (pair.first.IsPlayer())
+            mover = _map->GetPlayer(pair.first);
+        else if (pair.first.IsPet())
+            mover = _map->GetPet(pair.first);
+        else
+            mover = _map->GetCreature(pair.first);
+
+        // gone while its heartbeat was held
+        if (!mover || !mover->IsInWorld())
+            continue;
+
+        uint32 packetSize, throttled;
+        uint32 sent = Send(mover, pair.second.Skipped, true, packetSize, throttled);
+
+        ++_stats.RelayedHeartbeats;
+        _stats.CoalescedHeartbeats += pair.second.Superseded;
+        _stats.ThrottledPackets += throttled;
+        _stats.BytesSaved += (uint64(pair.second.Superseded) * sent + throttled) * packetSize;
+    }
+
+    _pendingHeartbeats.clear();
+
+    if (_farRelayPruneTimer <= diff)
+    {
+        uint32 now = GameTime::GetGameTimeMS();
+        for (auto itr = _lastFarRelay.begin(); itr != _lastFarRelay.end();)
+        {
+            if (now - itr->second > FarRelayPruneInterval)
+                itr = _lastFarRelay.erase(itr);
+            else
+                ++itr;
+        }
+
+        _farRelayPruneTimer = FarRelayPruneInterval;
+    }
+    else
+        _farRelayPruneTimer -= diff;
+
+    if (_stats.RelayedHeartbeats || _stats.CoalescedHeartbeats)
+    {
+        RelayedHeartbeats.fetch_add(_stats.RelayedHeartbeats, std::memory_order_relaxed);
+        CoalescedHeartbeats.fetch_add(_stats.CoalescedHeartbeats, std::memory_order_relaxed);
+        ThrottledPackets.fetch_add(_stats.ThrottledPackets, std::memory_order_relaxed);
+        BytesSaved.fetch_add(_stats.BytesSaved, std::memory_order_relaxed);
+        _stats = Stats();
+    }
+}
+
+uint32 MovementRelay::Send(Unit* mover, Player const* skipped, bool heartbeat, uint32& packetSize, uint32& throttled)
+{
+    WorldPacket data(SMSG_MOVE_UPDATE);
+    mover->WriteMovementInfo(data);
+    packetSize = data.size();
+
+    float range = mover->GetVisibilityRange();
+    Trinity::MessageDistDeliverer notifier(mover, &data, range, false, skipped);
+
+    float farDistance = sWorld->getFloatConfig(CONFIG_MOVEMENT_RELAY_FAR_DISTANCE);
+    uint32 farInterval = sWorld->getIntConfig(CONFIG_MOVEMENT_RELAY_FAR_INTERVAL);
+    if (heartbeat && farInterval && farDistance < range)
+    {
+        uint32 now = GameTime::GetGameTimeMS();
+        auto itr = _lastFarRelay.find(mover->GetGUID());
+        if (itr != _lastFarRelay.end() && now - itr->second < farInterval)
+            notifier.i_throttledDistSq = farDistance * farDistance;
+        else
+            _lastFarRelay[mover->GetGUID()] = now;
+    }
+
+    Cell::VisitWorldObjects(mover, notifier, range);
+
+    uint32 sent = notifier.sent;
+
+    // a charmed player still gets its own movement
+    if (Player* player = mover->ToPlayer())
+    {
+        if (player != skipped)
+        {
+            player->SendDirectMessage(&data);
+            ++sent;
+        }
+    }
+
+    throttled = notifier.throttled;
+    return sent;
+}
+
+MovementRelay::Stats MovementRelay::ConsumeStats()
+{
+    Stats stats;
+    stats.RelayedHeartbeats = RelayedHeartbeats.exchange(0, std::memory_order_relaxed);
+    stats.CoalescedHeartbeats = CoalescedHeartbeats.exchange(0, std::memory_order_relaxed);
+    stats.ThrottledPackets = ThrottledPackets.exchange(0, std::memory_order_relaxed);
+    stats.BytesSaved = BytesSaved.exchange(0, std::memory_order_relaxed);
+    return stats;
+}
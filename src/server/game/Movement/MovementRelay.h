@@ -0,0 +1,77 @@
+/*
+ * This file is part of the TrinityCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TRINITY_MOVEMENTRELAY_H
+#define TRINITY_MOVEMENTRELAY_H
+
+#include "Define.h"
+#include "ObjectGuid.h"
+#include <unordered_map>
+
+class Map;
+class Player;
+class Unit;
+
+// Relays movement of client controlled units to the players around them.
+// Heartbeats only carry the mover's current position, so they are held until the end of the map's
+// session updates: a mover gets at most one relayed heartbeat per map tick, built from its latest state
+// and shared by every receiver. Observers further than MovementRelay.FarDistance get them at most once
+// per MovementRelay.FarInterval. Any other movement update is relayed right away to everyone and makes
+// the held heartbeat obsolete.
+class TC_GAME_API MovementRelay
+{
+    public:
+        struct Stats
+        {
+            uint64 RelayedHeartbeats = 0;       // heartbeats built and sent
+            uint64 CoalescedHeartbeats = 0;     // heartbeats superseded by a newer update of the same tick
+            uint64 ThrottledPackets = 0;        // heartbeat copies not sent to far observers
+            uint64 BytesSaved = 0;
+        };
+
+        explicit MovementRelay(Map* map) : _map(map), _farRelayPruneTimer(0) { }
+
+        MovementRelay(MovementRelay const&) = delete;
+        MovementRelay& operator=(MovementRelay const&) = delete;
+
+        // mover's movement info was updated by the client controlling it, skipped is that client's player
+        void Relay(Unit* mover, Player const* skipped, bool heartbeat);
+
+        // sends held heartbeats, called once per tick after the map's sessions were updated
+        void Update(uint32 diff);
+
+        // summed over all maps since the previous call
+        static Stats ConsumeStats();
+
+    private:
+        struct PendingHeartbeat
+        {
+            Player const* Skipped = nullptr;
+            uint32 Superseded = 0;
+        };
+
+        // returns the number of players the packet was sent to
+        uint32 Send(Unit* mover, Player const* skipped, bool heartbeat, uint32& packetSize, uint32& throttled);
+
+        Map* _map;
+        std::unordered_map<ObjectGuid, PendingHeartbeat> _pendingHeartbeats;
+        std::unordered_map<ObjectGuid, uint32> _lastFarRelay;  // game time in ms of the last heartbeat sent to far observers
+        uint32 _farRelayPruneTimer;
+        Stats _stats;
+};
+
+#endif // TRINITY_MOVEMENTRELAY_H
@@ -18,8 +18,10 @@
 #include "MovementStructures.h"
 #include "Log.h"
 #include "Player.h"
+#include <G3D/g3dmath.h>
+#include <utility>
 
-MovementStatusElements const MovementUpdate[] =
+constexpr MovementStatusElements MovementUpdate[] =
 {
     MSEHasFallData,
     MSEHasGuidByte3,
@@ -92,7 +94,7 @@ MovementStatusElements const MovementUpdate[] =
     MSEEnd
 };
 
-MovementStatusElements const MovementFallLand[] =
+constexpr MovementStatusElements MovementFallLand[] =
 {
     MSEPositionX,
     MSEPositionY,
@@ -164,7 +166,7 @@ MovementStatusElements const MovementFallLand[] =
     MSEEnd,
 };
 
-MovementStatusElements const MovementHeartBeat[] =
+constexpr MovementStatusElements MovementHeartBeat[] =
 {
     MSEPositionZ,
     MSEPositionX,
@@ -236,7 +238,7 @@ MovementStatusElements const MovementHeartBeat[] =
     MSEEnd,
 };
 
-MovementStatusElements const MovementJump[] =
+constexpr MovementStatusElements MovementJump[] =
 {
     MSEPositionY,
     MSEPositionX,
@@ -308,7 +310,7 @@ MovementStatusElements const MovementJump[] =
     MSEEnd,
 };
 
-MovementStatusElements const MovementSetFacing[] =
+constexpr MovementStatusElements MovementSetFacing[] =
 {
     MSEPositionX,
     MSEPositionY,
@@ -380,7 +382,7 @@ MovementStatusElements const MovementSetFacing[] =
     MSEEnd,
 };
 
-MovementStatusElements const MovementSetPitch[] =
+constexpr MovementStatusElements MovementSetPitch[] =
 {
     MSEPositionX,
     MSEPositionZ,
@@ -452,7 +454,7 @@ MovementStatusElements const MovementSetPitch[] =
     MSEEnd,
 };
 
-MovementStatusElements const MovementStartBackward[] =
+constexpr MovementStatusElements MovementStartBackward[] =
 {
     MSEPositionX,
     MSEPositionZ,
@@ -524,7 +526,7 @@ MovementStatusElements const MovementStartBackward[] =
     MSEEnd,
 };
 
-MovementStatusElements const MovementStartForward[] =
+constexpr MovementStatusElements MovementStartForward[] =
 {
     MSEPositionY,
     MSEPositionZ,
@@ -596,7 +598,7 @@ MovementStatusElements const MovementStartForward[] =
     MSEEnd,
 };
 
-MovementStatusElements const MovementStartStrafeLeft[] =
+constexpr MovementStatusElements MovementStartStrafeLeft[] =
 {
     MSEPositionZ,
     MSEPositionX,
@@ -668,7 +670,7 @@ MovementStatusElements const MovementStartStrafeLeft[] =
     MSEEnd,
 };
 
-MovementStatusElements const MovementStartStrafeRight[] =
+constexpr MovementStatusElements MovementStartStrafeRight[] =
 {
     MSEPositionY,
     MSEPositionX,
@@ -740,7 +742,7 @@ MovementStatusElements const MovementStartStrafeRight[] =
     MSEEnd,
 };
 
-MovementStatusElements const MovementStartTurnLeft[] =
+constexpr MovementStatusElements MovementStartTurnLeft[] =
 {
     MSEPositionY,
     MSEPositionX,
@@ -812,7 +814,7 @@ MovementStatusElements const MovementStartTurnLeft[] =
     MSEEnd,
 };
 
-MovementStatusElements const MovementStartTurnRight[] =
+constexpr MovementStatusElements MovementStartTurnRight[] =
 {
     MSEPositionX,
     MSEPositionZ,
@@ -884,7 +886,7 @@ MovementStatusElements const MovementStartTurnRight[] =
     MSEEnd,
 };
 
-MovementStatusElements const MovementStop[] =
+constexpr MovementStatusElements MovementStop[] =
 {
     MSEPositionX,
     MSEPositionY,
@@ -956,7 +958,7 @@ MovementStatusElements const MovementStop[] =
     MSEEnd,
 };
 
-MovementStatusElements const MovementStopStrafe[] =
+constexpr MovementStatusElements MovementStopStrafe[] =
 {
     MSEPositionY,
     MSEPositionZ,
@@ -1028,7 +1030,7 @@ MovementStatusElements const MovementStopStrafe[] =
     MSEEnd,
 };
 
-MovementStatusElements const MovementStopTurn[] =
+constexpr MovementStatusElements MovementStopTurn[] =
 {
     MSEPositionX,
     MSEPositionZ,
@@ -1100,7 +1102,7 @@ MovementStatusElements const MovementStopTurn[] =
     MSEEnd,
 };
 
-MovementStatusElements const MovementStartAscend[] =
+constexpr MovementStatusElements MovementStartAscend[] =
 {
     MSEPositionX,
     MSEPositionY,
@@ -1172,7 +1174,7 @@ MovementStatusElements const MovementStartAscend[] =
     MSEEnd,
 };
 
-MovementStatusElements const MovementStartDescend[] =
+constexpr MovementStatusElements MovementStartDescend[] =
 {
     MSEPositionY,
     MSEPositionZ,
@@ -1244,7 +1246,7 @@ MovementStatusElements const MovementStartDescend[] =
     MSEEnd,
 };
 
-MovementStatusElements const MovementStartSwim[] =
+constexpr MovementStatusElements MovementStartSwim[] =
 {
     MSEPositionZ,
     MSEPositionX,
@@ -1316,7 +1318,7 @@ MovementStatusElements const MovementStartSwim[] =
     MSEEnd,
 };
 
-MovementStatusElements const MovementStopSwim[] =
+constexpr MovementStatusElements MovementStopSwim[] =
 {
     MSEPositionX,
     MSEPositionY,
@@ -1388,7 +1390,7 @@ MovementStatusElements const MovementStopSwim[] =
     MSEEnd,
 };
 
-MovementStatusElements const MovementStopAscend[] =
+constexpr MovementStatusElements MovementStopAscend[] =
 {
     MSEPositionZ,
     MSEPositionY,
@@ -1460,7 +1462,7 @@ MovementStatusElements const MovementStopAscend[] =
     MSEEnd,
 };
 
-MovementStatusElements const MovementStopPitch[] =
+constexpr MovementStatusElements MovementStopPitch[] =
 {
     MSEPositionX,
     MSEPositionZ,
@@ -1532,7 +1534,7 @@ MovementStatusElements const MovementStopPitch[] =
     MSEEnd,
 };
 
-MovementStatusElements const MovementStartPitchDown[] =
+constexpr MovementStatusElements MovementStartPitchDown[] =
 {
     MSEPositionX,
     MSEPositionZ,
@@ -1604,7 +1606,7 @@ MovementStatusElements const MovementStartPitchDown[] =
     MSEEnd,
 };
 
-MovementStatusElements const MovementStartPitchUp[] =
+constexpr MovementStatusElements MovementStartPitchUp[] =
 {
     MSEPositionZ,
     MSEPositionY,
@@ -1676,7 +1678,7 @@ MovementStatusElements const MovementStartPitchUp[] =
     MSEEnd,
 };
 
-MovementStatusElements const MoveChngTransport[]=
+constexpr MovementStatusElements MoveChngTransport[] =
 {
     MSEPositionY,
     MSEPositionX,
@@ -1748,7 +1750,7 @@ MovementStatusElements const MoveChngTransport[]=
     MSEEnd,
 };
 
-MovementStatusElements const MoveSplineDone[] =
+constexpr MovementStatusElements MoveSplineDone[] =
 {
     MSEPositionY,
     MSEPositionX,
@@ -1827,7 +1829,7 @@ MovementStatusElements const MoveSplineDone[] =
     MSEEnd,
 };
 
-MovementStatusElements const MoveNotActiveMover[] =
+constexpr MovementStatusElements MoveNotActiveMover[] =
 {
     MSEPositionZ,
     MSEPositionX,
@@ -1906,7 +1908,7 @@ MovementStatusElements const MoveNotActiveMover[] =
     MSEEnd,
 };
 
-MovementStatusElements const DismissControlledVehicle[] =
+constexpr MovementStatusElements DismissControlledVehicle[] =
 {
     MSEPositionY,
     MSEPositionZ,
@@ -1985,7 +1987,7 @@ MovementStatusElements const DismissControlledVehicle[] =
     MSEEnd,
 };
 
-MovementStatusElements const MovementSetRunMode[] =
+constexpr MovementStatusElements MovementSetRunMode[] =
 {
     MSEPositionY,
     MSEPositionX,
@@ -2057,7 +2059,7 @@ MovementStatusElements const MovementSetRunMode[] =
     MSEEnd
 };
 
-MovementStatusElements const MovementSetWalkMode[] =
+constexpr MovementStatusElements MovementSetWalkMode[] =
 {
     MSEPositionY,
     MSEPositionX,
@@ -2129,7 +2131,7 @@ MovementStatusElements const MovementSetWalkMode[] =
     MSEEnd
 };
 
-MovementStatusElements const MovementSetCanFly[] =
+constexpr MovementStatusElements MovementSetCanFly[] =
 {
     MSEPositionZ,
     MSEPositionX,
@@ -2201,7 +2203,7 @@ MovementStatusElements const MovementSetCanFly[] =
     MSEEnd,
 };
 
-MovementStatusElements const MovementSetCanTransitionBetweenSwimAndFlyAck[] =
+constexpr MovementStatusElements MovementSetCanTransitionBetweenSwimAndFlyAck[] =
 {
     MSEPositionZ,
     MSEPositionY,
@@ -2274,7 +2276,7 @@ MovementStatusElements const MovementSetCanTransitionBetweenSwimAndFlyAck[] =
     MSEEnd,
 };
 
-MovementStatusElements const MovementUpdateSwimSpeed[] =
+constexpr MovementStatusElements MovementUpdateSwimSpeed[] =
 {
     MSEHasMovementFlags,
     MSEHasGuidByte2,
@@ -2348,7 +2350,7 @@ MovementStatusElements const MovementUpdateSwimSpeed[] =
     MSEEnd,
 };
 
-MovementStatusElements const MovementUpdateRunSpeed[] =
+constexpr MovementStatusElements MovementUpdateRunSpeed[] =
 {
     MSEPositionZ,
     MSEPositionX,
@@ -2422,7 +2424,7 @@ MovementStatusElements const MovementUpdateRunSpeed[] =
     MSEEnd,
 };
 
-MovementStatusElements const MovementUpdateFlightSpeed[] =
+constexpr MovementStatusElements MovementUpdateFlightSpeed[] =
 {
     MSEPositionY,
     MSEExtraElement,
@@ -2496,7 +2498,7 @@ MovementStatusElements const MovementUpdateFlightSpeed[] =
     MSEEnd
 };
 
-MovementStatusElements const MovementSetCollisionHeight[] =
+constexpr MovementStatusElements MovementSetCollisionHeight[] =
 {
     MSEExtraElement,
     MSEHasGuidByte6,
@@ -2521,7 +2523,7 @@ MovementStatusElements const MovementSetCollisionHeight[] =
     MSEEnd
 };
 
-MovementStatusElements const MovementUpdateCollisionHeight[] =
+constexpr MovementStatusElements MovementUpdateCollisionHeight[] =
 {
     MSEPositionZ,
     MSEExtraElement,
@@ -2595,7 +2597,7 @@ MovementStatusElements const MovementUpdateCollisionHeight[] =
     MSEEnd,
 };
 
-MovementStatusElements const MovementForceRunSpeedChangeAck[] =
+constexpr MovementStatusElements MovementForceRunSpeedChangeAck[] =
 {
     MSECounter,
     MSEPositionX,
@@ -2669,7 +2671,7 @@ MovementStatusElements const MovementForceRunSpeedChangeAck[] =
     MSEEnd,
 };
 
-MovementStatusElements const MovementSetCollisionHeightAck[] =
+constexpr MovementStatusElements MovementSetCollisionHeightAck[] =
 {
     MSEExtraElement, // Height
     MSEPositionX,
@@ -2744,7 +2746,7 @@ MovementStatusElements const MovementSetCollisionHeightAck[] =
     MSEEnd,
 };
 
-MovementStatusElements const MovementForceFlightSpeedChangeAck[] =
+constexpr MovementStatusElements MovementForceFlightSpeedChangeAck[] =
 {
     MSECounter,
     MSEPositionZ,
@@ -2818,7 +2820,7 @@ MovementStatusElements const MovementForceFlightSpeedChangeAck[] =
     MSEEnd,
 };
 
-MovementStatusElements const MovementSetCanFlyAck[] =
+constexpr MovementStatusElements MovementSetCanFlyAck[] =
 {
     MSEPositionY,
     MSECounter,
@@ -2891,7 +2893,7 @@ MovementStatusElements const MovementSetCanFlyAck[] =
     MSEEnd,
 };
 
-MovementStatusElements MoveForceSwimBackSpeedChangeAck[] =
+constexpr MovementStatusElements MoveForceSwimBackSpeedChangeAck[] =
 {
     MSEExtraElement,
     MSEPositionX,
@@ -2974,7 +2976,7 @@ MovementStatusElements MoveForceSwimBackSpeedChangeAck[] =
 };
 
 //4.3.4
-MovementStatusElements MoveForceFlightBackSpeedChangeAck[] =
+constexpr MovementStatusElements MoveForceFlightBackSpeedChangeAck[] =
 {
     MSEPositionY,
     MSEPositionZ,
@@ -3056,7 +3058,7 @@ MovementStatusElements MoveForceFlightBackSpeedChangeAck[] =
     MSEEnd,
 };
 
-MovementStatusElements const MovementForceSwimSpeedChangeAck[] =
+constexpr MovementStatusElements MovementForceSwimSpeedChangeAck[] =
 {
     MSEPositionX,
     MSECounter,
@@ -3131,7 +3133,7 @@ MovementStatusElements const MovementForceSwimSpeedChangeAck[] =
 };
 
 
-MovementStatusElements const MovementForceWalkSpeedChangeAck[] =
+constexpr MovementStatusElements MovementForceWalkSpeedChangeAck[] =
 {
     MSEPositionZ,
     MSEPositionY,
@@ -3205,7 +3207,7 @@ MovementStatusElements const MovementForceWalkSpeedChangeAck[] =
     MSEEnd,
 };
 
-MovementStatusElements const MovementForceRunBackSpeedChangeAck[] =
+constexpr MovementStatusElements MovementForceRunBackSpeedChangeAck[] =
 {
     MSEExtraElement,
     MSECounter,
@@ -3279,7 +3281,7 @@ MovementStatusElements const MovementForceRunBackSpeedChangeAck[] =
     MSEEnd,
 };
 
-MovementStatusElements const MovementUpdateRunBackSpeed[] =
+constexpr MovementStatusElements MovementUpdateRunBackSpeed[] =
 {
     MSEHasGuidByte1,
     MSEHasGuidByte2,
@@ -3340,7 +3342,7 @@ MovementStatusElements const MovementUpdateRunBackSpeed[] =
     MSEEnd,
 };
 
-MovementStatusElements const MovementUpdateWalkSpeed[] =
+constexpr MovementStatusElements MovementUpdateWalkSpeed[] =
 {
     MSEHasOrientation,
     MSEZeroBit,
@@ -3401,7 +3403,7 @@ MovementStatusElements const MovementUpdateWalkSpeed[] =
     MSEEnd,
 };
 
-MovementStatusElements const ForceMoveRootAck[] =
+constexpr MovementStatusElements ForceMoveRootAck[] =
 {
     MSEPositionY,
     MSEPositionZ,
@@ -3474,7 +3476,7 @@ MovementStatusElements const ForceMoveRootAck[] =
     MSEEnd,
 };
 
-MovementStatusElements const ForceMoveUnrootAck[] =
+constexpr MovementStatusElements ForceMoveUnrootAck[] =
 {
     MSECounter,
     MSEPositionZ,
@@ -3548,7 +3550,7 @@ MovementStatusElements const ForceMoveUnrootAck[] =
 };
 
 //4.3.4
-MovementStatusElements MoveUpdateSwimBackSpeed[] =
+constexpr MovementStatusElements MoveUpdateSwimBackSpeed[] =
 {
     MSEHasGuidByte7,
     MSEHasGuidByte2,
@@ -3622,7 +3624,7 @@ MovementStatusElements MoveUpdateSwimBackSpeed[] =
     MSEEnd
 };
 
-MovementStatusElements const MovementFallReset[] =
+constexpr MovementStatusElements MovementFallReset[] =
 {
     MSEPositionZ,
     MSEPositionX,
@@ -3694,7 +3696,7 @@ MovementStatusElements const MovementFallReset[] =
     MSEEnd,
 };
 
-MovementStatusElements const MovementFeatherFallAck[] =
+constexpr MovementStatusElements MovementFeatherFallAck[] =
 {
     MSEPositionZ,
     MSECounter,
@@ -3767,7 +3769,7 @@ MovementStatusElements const MovementFeatherFallAck[] =
     MSEEnd,
 };
 
-MovementStatusElements const MovementGravityDisableAck[] =
+constexpr MovementStatusElements MovementGravityDisableAck[] =
 {
     MSEPositionZ,
     MSEPositionY,
@@ -3840,7 +3842,7 @@ MovementStatusElements const MovementGravityDisableAck[] =
     MSEEnd,
 };
 
-MovementStatusElements const MovementGravityEnableAck[] =
+constexpr MovementStatusElements MovementGravityEnableAck[] =
 {
     MSEPositionZ,
     MSEPositionX,
@@ -3913,7 +3915,7 @@ MovementStatusElements const MovementGravityEnableAck[] =
     MSEEnd,
 };
 
-MovementStatusElements const MovementHoverAck[] =
+constexpr MovementStatusElements MovementHoverAck[] =
 {
     MSECounter,
     MSEPositionZ,
@@ -3986,7 +3988,7 @@ MovementStatusElements const MovementHoverAck[] =
     MSEEnd,
 };
 
-MovementStatusElements const MovementKnockBackAck[] =
+constexpr MovementStatusElements MovementKnockBackAck[] =
 {
     MSEPositionY,
     MSEPositionZ,
@@ -4059,7 +4061,7 @@ MovementStatusElements const MovementKnockBackAck[] =
     MSEEnd,
 };
 
-MovementStatusElements const MovementWaterWalkAck[] =
+constexpr MovementStatusElements MovementWaterWalkAck[] =
 {
     MSEPositionY,
     MSEPositionZ,
@@ -4132,7 +4134,7 @@ MovementStatusElements const MovementWaterWalkAck[] =
     MSEEnd
 };
 
-MovementStatusElements const MovementUpdateKnockBack[] =
+constexpr MovementStatusElements MovementUpdateKnockBack[] =
 {
     MSEZeroBit,
     MSEHasGuidByte4,
@@ -4192,7 +4194,7 @@ MovementStatusElements const MovementUpdateKnockBack[] =
     MSEEnd,
 };
 
-MovementStatusElements const SplineMoveSetWalkSpeed[] =
+constexpr MovementStatusElements SplineMoveSetWalkSpeed[] =
 {
     MSEHasGuidByte0,
     MSEHasGuidByte6,
@@ -4214,7 +4216,7 @@ MovementStatusElements const SplineMoveSetWalkSpeed[] =
     MSEEnd,
 };
 
-MovementStatusElements const SplineMoveSetRunSpeed[] =
+constexpr MovementStatusElements SplineMoveSetRunSpeed[] =
 {
     MSEHasGuidByte4,
     MSEHasGuidByte0,
@@ -4236,7 +4238,7 @@ MovementStatusElements const SplineMoveSetRunSpeed[] =
     MSEEnd,
 };
 
-MovementStatusElements const SplineMoveSetRunBackSpeed[] =
+constexpr MovementStatusElements SplineMoveSetRunBackSpeed[] =
 {
     MSEHasGuidByte1,
     MSEHasGuidByte2,
@@ -4258,7 +4260,7 @@ MovementStatusElements const SplineMoveSetRunBackSpeed[] =
     MSEEnd,
 };
 
-MovementStatusElements const SplineMoveSetSwimSpeed[] =
+constexpr MovementStatusElements SplineMoveSetSwimSpeed[] =
 {
     MSEHasGuidByte4,
     MSEHasGuidByte2,
@@ -4280,7 +4282,7 @@ MovementStatusElements const SplineMoveSetSwimSpeed[] =
     MSEEnd,
 };
 
-MovementStatusElements const SplineMoveSetSwimBackSpeed[] =
+constexpr MovementStatusElements SplineMoveSetSwimBackSpeed[] =
 {
     MSEHasGuidByte0,
     MSEHasGuidByte1,
@@ -4302,7 +4304,7 @@ MovementStatusElements const SplineMoveSetSwimBackSpeed[] =
     MSEEnd,
 };
 
-MovementStatusElements const SplineMoveSetTurnRate[] =
+constexpr MovementStatusElements SplineMoveSetTurnRate[] =
 {
     MSEHasGuidByte2,
     MSEHasGuidByte4,
@@ -4324,7 +4326,7 @@ MovementStatusElements const SplineMoveSetTurnRate[] =
     MSEEnd,
 };
 
-MovementStatusElements const SplineMoveSetFlightSpeed[] =
+constexpr MovementStatusElements SplineMoveSetFlightSpeed[] =
 {
     MSEHasGuidByte7,
     MSEHasGuidByte4,
@@ -4346,7 +4348,7 @@ MovementStatusElements const SplineMoveSetFlightSpeed[] =
     MSEEnd,
 };
 
-MovementStatusElements const SplineMoveSetFlightBackSpeed[] =
+constexpr MovementStatusElements SplineMoveSetFlightBackSpeed[] =
 {
     MSEHasGuidByte2,
     MSEHasGuidByte1,
@@ -4368,7 +4370,7 @@ MovementStatusElements const SplineMoveSetFlightBackSpeed[] =
     MSEEnd,
 };
 
-MovementStatusElements const SplineMoveSetPitchRate[] =
+constexpr MovementStatusElements SplineMoveSetPitchRate[] =
 {
     MSEHasGuidByte3,
     MSEHasGuidByte5,
@@ -4390,7 +4392,7 @@ MovementStatusElements const SplineMoveSetPitchRate[] =
     MSEEnd,
 };
 
-MovementStatusElements const MoveSetWalkSpeed[] =
+constexpr MovementStatusElements MoveSetWalkSpeed[] =
 {
     MSEHasGuidByte0,
     MSEHasGuidByte4,
@@ -4413,7 +4415,7 @@ MovementStatusElements const MoveSetWalkSpeed[] =
     MSEEnd,
 };
 
-MovementStatusElements const MoveSetRunSpeed[] =
+constexpr MovementStatusElements MoveSetRunSpeed[] =
 {
     MSEHasGuidByte6,
     MSEHasGuidByte1,
@@ -4436,7 +4438,7 @@ MovementStatusElements const MoveSetRunSpeed[] =
     MSEEnd,
 };
 
-MovementStatusElements const MoveSetRunBackSpeed[] =
+constexpr MovementStatusElements MoveSetRunBackSpeed[] =
 {
     MSEHasGuidByte0,
     MSEHasGuidByte6,
@@ -4459,7 +4461,7 @@ MovementStatusElements const MoveSetRunBackSpeed[] =
     MSEEnd,
 };
 
-MovementStatusElements const MoveSetSwimSpeed[] =
+constexpr MovementStatusElements MoveSetSwimSpeed[] =
 {
     MSEHasGuidByte5,
     MSEHasGuidByte4,
@@ -4482,7 +4484,7 @@ MovementStatusElements const MoveSetSwimSpeed[] =
     MSEEnd,
 };
 
-MovementStatusElements const MoveSetSwimBackSpeed[] =
+constexpr MovementStatusElements MoveSetSwimBackSpeed[] =
 {
     MSEHasGuidByte4,
     MSEHasGuidByte2,
@@ -4505,7 +4507,7 @@ MovementStatusElements const MoveSetSwimBackSpeed[] =
     MSEEnd,
 };
 
-MovementStatusElements const MoveSetTurnRate[] =
+constexpr MovementStatusElements MoveSetTurnRate[] =
 {
     MSEHasGuidByte7,
     MSEHasGuidByte2,
@@ -4528,7 +4530,7 @@ MovementStatusElements const MoveSetTurnRate[] =
     MSEEnd,
 };
 
-MovementStatusElements const MoveSetFlightSpeed[] =
+constexpr MovementStatusElements MoveSetFlightSpeed[] =
 {
     MSEHasGuidByte0,
     MSEHasGuidByte5,
@@ -4551,7 +4553,7 @@ MovementStatusElements const MoveSetFlightSpeed[] =
     MSEEnd,
 };
 
-MovementStatusElements const MoveSetFlightBackSpeed[] =
+constexpr MovementStatusElements MoveSetFlightBackSpeed[] =
 {
     MSEHasGuidByte1,
     MSEHasGuidByte2,
@@ -4574,7 +4576,7 @@ MovementStatusElements const MoveSetFlightBackSpeed[] =
     MSEEnd,
 };
 
-MovementStatusElements const MoveSetPitchRate[] =
+constexpr MovementStatusElements MoveSetPitchRate[] =
 {
     MSEHasGuidByte1,
     MSEHasGuidByte2,
@@ -4597,7 +4599,7 @@ MovementStatusElements const MoveSetPitchRate[] =
     MSEEnd,
 };
 
-MovementStatusElements const SplineMoveSetWalkMode[] =
+constexpr MovementStatusElements SplineMoveSetWalkMode[] =
 {
     MSEHasGuidByte7,
     MSEHasGuidByte6,
@@ -4618,7 +4620,7 @@ MovementStatusElements const SplineMoveSetWalkMode[] =
     MSEEnd,
 };
 
-MovementStatusElements const SplineMoveSetRunMode[] =
+constexpr MovementStatusElements SplineMoveSetRunMode[] =
 {
     MSEHasGuidByte5,
     MSEHasGuidByte6,
@@ -4639,7 +4641,7 @@ MovementStatusElements const SplineMoveSetRunMode[] =
     MSEEnd,
 };
 
-MovementStatusElements const SplineMoveGravityDisable[] =
+constexpr MovementStatusElements SplineMoveGravityDisable[] =
 {
     MSEHasGuidByte7,
     MSEHasGuidByte3,
@@ -4660,7 +4662,7 @@ MovementStatusElements const SplineMoveGravityDisable[] =
     MSEEnd,
 };
 
-MovementStatusElements const SplineMoveGravityEnable[] =
+constexpr MovementStatusElements SplineMoveGravityEnable[] =
 {
     MSEHasGuidByte5,
     MSEHasGuidByte4,
@@ -4681,7 +4683,7 @@ MovementStatusElements const SplineMoveGravityEnable[] =
     MSEEnd,
 };
 
-MovementStatusElements const SplineMoveSetHover[] =
+constexpr MovementStatusElements SplineMoveSetHover[] =
 {
     MSEHasGuidByte3,
     MSEHasGuidByte7,
@@ -4702,7 +4704,7 @@ MovementStatusElements const SplineMoveSetHover[] =
     MSEEnd,
 };
 
-MovementStatusElements const SplineMoveUnsetHover[] =
+constexpr MovementStatusElements SplineMoveUnsetHover[] =
 {
     MSEHasGuidByte6,
     MSEHasGuidByte7,
@@ -4723,7 +4725,7 @@ MovementStatusElements const SplineMoveUnsetHover[] =
     MSEEnd,
 };
 
-MovementStatusElements const SplineMoveStartSwim[] =
+constexpr MovementStatusElements SplineMoveStartSwim[] =
 {
     MSEHasGuidByte1,
     MSEHasGuidByte6,
@@ -4744,7 +4746,7 @@ MovementStatusElements const SplineMoveStartSwim[] =
     MSEEnd,
 };
 
-MovementStatusElements const SplineMoveStopSwim[] =
+constexpr MovementStatusElements SplineMoveStopSwim[] =
 {
     MSEHasGuidByte4,
     MSEHasGuidByte1,
@@ -4765,7 +4767,7 @@ MovementStatusElements const SplineMoveStopSwim[] =
     MSEEnd,
 };
 
-MovementStatusElements const SplineMoveSetFlying[] =
+constexpr MovementStatusElements SplineMoveSetFlying[] =
 {
     MSEHasGuidByte0,
     MSEHasGuidByte4,
@@ -4786,7 +4788,7 @@ MovementStatusElements const SplineMoveSetFlying[] =
     MSEEnd,
 };
 
-MovementStatusElements const SplineMoveUnsetFlying[] =
+constexpr MovementStatusElements SplineMoveUnsetFlying[] =
 {
     MSEHasGuidByte5,
     MSEHasGuidByte0,
@@ -4807,7 +4809,7 @@ MovementStatusElements const SplineMoveUnsetFlying[] =
     MSEEnd,
 };
 
-MovementStatusElements const SplineMoveSetWaterWalk[] =
+constexpr MovementStatusElements SplineMoveSetWaterWalk[] =
 {
     MSEHasGuidByte6,
     MSEHasGuidByte1,
@@ -4828,7 +4830,7 @@ MovementStatusElements const SplineMoveSetWaterWalk[] =
     MSEEnd,
 };
 
-MovementStatusElements const SplineMoveSetLandWalk[] =
+constexpr MovementStatusElements SplineMoveSetLandWalk[] =
 {
     MSEHasGuidByte5,
     MSEHasGuidByte0,
@@ -4849,7 +4851,7 @@ MovementStatusElements const SplineMoveSetLandWalk[] =
     MSEEnd,
 };
 
-MovementStatusElements const SplineMoveSetFeatherFall[] =
+constexpr MovementStatusElements SplineMoveSetFeatherFall[] =
 {
     MSEHasGuidByte3,
     MSEHasGuidByte2,
@@ -4870,7 +4872,7 @@ MovementStatusElements const SplineMoveSetFeatherFall[] =
     MSEEnd,
 };
 
-MovementStatusElements const SplineMoveSetNormalFall[] =
+constexpr MovementStatusElements SplineMoveSetNormalFall[] =
 {
     MSEHasGuidByte3,
     MSEHasGuidByte5,
@@ -4891,7 +4893,7 @@ MovementStatusElements const SplineMoveSetNormalFall[] =
     MSEEnd,
 };
 
-MovementStatusElements const SplineMoveRoot[] =
+constexpr MovementStatusElements SplineMoveRoot[] =
 {
     MSEHasGuidByte5,
     MSEHasGuidByte4,
@@ -4912,7 +4914,7 @@ MovementStatusElements const SplineMoveRoot[] =
     MSEEnd,
 };
 
-MovementStatusElements const SplineMoveUnroot[] =
+constexpr MovementStatusElements SplineMoveUnroot[] =
 {
     MSEHasGuidByte0,
     MSEHasGuidByte1,
@@ -4933,7 +4935,7 @@ MovementStatusElements const SplineMoveUnroot[] =
     MSEEnd,
 };
 
-MovementStatusElements const MoveSetCanFly[] =
+constexpr MovementStatusElements MoveSetCanFly[] =
 {
     MSEHasGuidByte1,
     MSEHasGuidByte6,
@@ -4955,7 +4957,7 @@ MovementStatusElements const MoveSetCanFly[] =
     MSEEnd,
 };
 
-MovementStatusElements const MoveUnsetCanFly[] =
+constexpr MovementStatusElements MoveUnsetCanFly[] =
 {
     MSEHasGuidByte1,
     MSEHasGuidByte4,
@@ -4977,7 +4979,7 @@ MovementStatusElements const MoveUnsetCanFly[] =
     MSEEnd,
 };
 
-MovementStatusElements const MoveSetHover[] =
+constexpr MovementStatusElements MoveSetHover[] =
 {
     MSEHasGuidByte1,
     MSEHasGuidByte4,
@@ -4999,7 +5001,7 @@ MovementStatusElements const MoveSetHover[] =
     MSEEnd,
 };
 
-MovementStatusElements const MoveUnsetHover[] =
+constexpr MovementStatusElements MoveUnsetHover[] =
 {
     MSEHasGuidByte4,
     MSEHasGuidByte6,
@@ -5021,7 +5023,7 @@ MovementStatusElements const MoveUnsetHover[] =
     MSEEnd,
 };
 
-MovementStatusElements const MoveWaterWalk[] =
+constexpr MovementStatusElements MoveWaterWalk[] =
 {
     MSEHasGuidByte4,
     MSEHasGuidByte7,
@@ -5043,7 +5045,7 @@ MovementStatusElements const MoveWaterWalk[] =
     MSEEnd,
 };
 
-MovementStatusElements const MoveLandWalk[] =
+constexpr MovementStatusElements MoveLandWalk[] =
 {
     MSEHasGuidByte5,
     MSEHasGuidByte1,
@@ -5065,7 +5067,7 @@ MovementStatusElements const MoveLandWalk[] =
     MSEEnd,
 };
 
-MovementStatusElements const MoveFeatherFall[] =
+constexpr MovementStatusElements MoveFeatherFall[] =
 {
     MSEHasGuidByte3,
     MSEHasGuidByte1,
@@ -5087,7 +5089,7 @@ MovementStatusElements const MoveFeatherFall[] =
     MSEEnd,
 };
 
-MovementStatusElements const MoveNormalFall[] =
+constexpr MovementStatusElements MoveNormalFall[] =
 {
     MSECounter,
     MSEHasGuidByte3,
@@ -5109,7 +5111,7 @@ MovementStatusElements const MoveNormalFall[] =
     MSEEnd,
 };
 
-MovementStatusElements const MoveRoot[] =
+constexpr MovementStatusElements MoveRoot[] =
 {
     MSEHasGuidByte2,
     MSEHasGuidByte7,
@@ -5131,7 +5133,7 @@ MovementStatusElements const MoveRoot[] =
     MSEEnd,
 };
 
-MovementStatusElements const MoveUnroot[] =
+constexpr MovementStatusElements MoveUnroot[] =
 {
     MSEHasGuidByte0,
     MSEHasGuidByte1,
@@ -5153,7 +5155,7 @@ MovementStatusElements const MoveUnroot[] =
     MSEEnd,
 };
 
-MovementStatusElements const ChangeSeatsOnControlledVehicle[] =
+constexpr MovementStatusElements ChangeSeatsOnControlledVehicle[] =
 {
     MSEPositionY,
     MSEPositionX,
@@ -5242,7 +5244,7 @@ MovementStatusElements const ChangeSeatsOnControlledVehicle[] =
     MSEEnd,
 };
 
-MovementStatusElements const CastSpellEmbeddedMovement[] =
+constexpr MovementStatusElements CastSpellEmbeddedMovement[] =
 {
     MSEPositionZ,
     MSEPositionY,
@@ -5314,7 +5316,7 @@ MovementStatusElements const CastSpellEmbeddedMovement[] =
     MSEEnd,
 };
 
-MovementStatusElements const MoveGravityDisable[] =
+constexpr MovementStatusElements MoveGravityDisable[] =
 {
     MSEHasGuidByte0,
     MSEHasGuidByte1,
@@ -5336,7 +5338,7 @@ MovementStatusElements const MoveGravityDisable[] =
     MSEEnd,
 };
 
-MovementStatusElements const MoveGravityEnable[] =
+constexpr MovementStatusElements MoveGravityEnable[] =
 {
     MSEHasGuidByte1,
     MSEHasGuidByte4,
@@ -5358,7 +5360,7 @@ MovementStatusElements const MoveGravityEnable[] =
     MSEEnd,
 };
 
-MovementStatusElements const MoveUpdateFlightBackSpeed[] =
+constexpr MovementStatusElements MoveUpdateFlightBackSpeed[] =
 {
     MSEPositionY,
     MSEExtraElement,
@@ -5430,7 +5432,7 @@ MovementStatusElements const MoveUpdateFlightBackSpeed[] =
     MSEEnd
 };
 
-MovementStatusElements const MoveSetCanTransitionBetweenSwimAndFly[] =
+constexpr MovementStatusElements MoveSetCanTransitionBetweenSwimAndFly[] =
 {
     MSEHasGuidByte4,
     MSEHasGuidByte5,
@@ -5452,7 +5454,7 @@ MovementStatusElements const MoveSetCanTransitionBetweenSwimAndFly[] =
     MSEEnd,
 };
 
-MovementStatusElements const MoveUnsetCanTransitionBetweenSwimAndFly[] =
+constexpr MovementStatusElements MoveUnsetCanTransitionBetweenSwimAndFly[] =
 {
     MSEHasGuidByte3,
     MSEHasGuidByte4,
@@ -5474,6 +5476,456 @@ MovementStatusElements const MoveUnsetCanTransitionBetweenSwimAndFly[] =
     MSEEnd,
 };
 
+namespace
+{
+    constexpr std::size_t GetSequenceLength(MovementStatusElements const* sequence)
+    {
+        std::size_t length = 0;
+        while (sequence[length] != MSEEnd)
+            ++length;
+
+        return length;
+    }
+
+    // extra element values are only allowed in the sequences of ExtraMovementStatusElement
+    constexpr bool IsValidSequence(MovementStatusElements const* sequence)
+    {
+        for (; *sequence != MSEEnd; ++sequence)
+            if (*sequence > MSEFlushBits && *sequence != MSEExtraElement)
+                return false;
+
+        return true;
+    }
+
+    class MovementStatusWriter
+    {
+    public:
+        MovementStatusWriter(ByteBuffer& data, Movement::MovementStatusWriteData const& status) : _data(data), _status(status), _mi(*status.Info)
+        {
+            _hasMovementFlags = _mi.GetMovementFlags() != 0;
+            _hasMovementFlags2 = _mi.GetExtraMovementFlags() != 0;
+            _hasOrientation = !G3D::fuzzyEq(status.Pos.GetOrientation(), 0.0f);
+            _hasTransportData = !status.TransportGuid.IsEmpty();
+            _hasTransportTime2 = _hasTransportData && _mi.transport.time2 != 0;
+            _hasTransportVehicleId = _hasTransportData && _mi.transport.vehicleId != 0;
+            _hasPitch = _mi.HasMovementFlag(MOVEMENTFLAG_SWIMMING | MOVEMENTFLAG_FLYING) || _mi.HasExtraMovementFlag(MOVEMENTFLAG2_ALWAYS_ALLOW_PITCHING);
+            _hasFallDirection = _mi.HasMovementFlag(MOVEMENTFLAG_FALLING);
+            _hasFallData = _hasFallDirection || _mi.jump.fallTime != 0;
+            _hasSplineElevation = _mi.HasMovementFlag(MOVEMENTFLAG_SPLINE_ELEVATION);
+        }
+
+        template<MovementStatusElements Element>
+        void Process()
+        {
+            if constexpr (Element >= MSEHasGuidByte0 && Element <= MSEHasGuidByte7)
+                _data.WriteBit(_status.Guid[Element - MSEHasGuidByte0]);
+            else if constexpr (Element >= MSEHasTransportGuidByte0 && Element <= MSEHasTransportGuidByte7)
+            {
+                if (_hasTransportData)
+                    _data.WriteBit(_status.TransportGuid[Element - MSEHasTransportGuidByte0]);
+            }
+            else if constexpr (Element >= MSEGuidByte0 && Element <= MSEGuidByte7)
+                _data.WriteByteSeq(_status.Guid[Element - MSEGuidByte0]);
+            else if constexpr (Element >= MSETransportGuidByte0 && Element <= MSETransportGuidByte7)
+            {
+                if (_hasTransportData)
+                    _data.WriteByteSeq(_status.TransportGuid[Element - MSETransportGuidByte0]);
+            }
+            else if constexpr (Element == MSEHasMovementFlags)
+                _data.WriteBit(!_hasMovementFlags);
+            else if constexpr (Element == MSEHasMovementFlags2)
+                _data.WriteBit(!_hasMovementFlags2);
+            else if constexpr (Element == MSEHasTimestamp)
+                _data.WriteBit(0);  // always sent
+            else if constexpr (Element == MSEHasOrientation)
+                _data.WriteBit(!_hasOrientation);
+            else if constexpr (Element == MSEHasTransportData)
+                _data.WriteBit(_hasTransportData);
+            else if constexpr (Element == MSEHasTransportTime2)
+            {
+                if (_hasTransportData)
+                    _data.WriteBit(_hasTransportTime2);
+            }
+            else if constexpr (Element == MSEHasVehicleId)
+            {
+                if (_hasTransportData)
+                    _data.WriteBit(_hasTransportVehicleId);
+            }
+            else if constexpr (Element == MSEHasPitch)
+                _data.WriteBit(!_hasPitch);
+            else if constexpr (Element == MSEHasFallData)
+                _data.WriteBit(_hasFallData);
+            else if constexpr (Element == MSEHasFallDirection)
+            {
+                if (_hasFallData)
+                    _data.WriteBit(_hasFallDirection);
+            }
+            else if constexpr (Element == MSEHasSplineElevation)
+                _data.WriteBit(!_hasSplineElevation);
+            else if constexpr (Element == MSEHasSpline)
+                _data.WriteBit(_status.HasSpline);
+            else if constexpr (Element == MSEHasHeightChangeFailed)
+                _data.WriteBit(_mi.HasHeightChangeFailed());
+            else if constexpr (Element == MSEMovementFlags)
+            {
+                if (_hasMovementFlags)
+                    _data.WriteBits(_mi.GetMovementFlags(), 30);
+            }
+            else if constexpr (Element == MSEMovementFlags2)
+            {
+                if (_hasMovementFlags2)
+                    _data.WriteBits(_mi.GetExtraMovementFlags(), 12);
+            }
+            else if constexpr (Element == MSETimestamp)
+                _data << _mi.time;
+            else if constexpr (Element == MSEPositionX)
+                _data << _status.Pos.GetPositionX();
+            else if constexpr (Element == MSEPositionY)
+                _data << _status.Pos.GetPositionY();
+            else if constexpr (Element == MSEPositionZ)
+                _data << _status.Pos.GetPositionZ();
+            else if constexpr (Element == MSEOrientation)
+            {
+                if (_hasOrientation)
+                    _data << _status.Pos.GetOrientation();
+            }
+            else if constexpr (Element == MSETransportPositionX)
+            {
+                if (_hasTransportData)
+                    _data << _mi.transport.pos.GetPositionX();
+            }
+            else if constexpr (Element == MSETransportPositionY)
+            {
+                if (_hasTransportData)
+                    _data << _mi.transport.pos.GetPositionY();
+            }
+            else if constexpr (Element == MSETransportPositionZ)
+            {
+                if (_hasTransportData)
+                    _data << _mi.transport.pos.GetPositionZ();
+            }
+            else if constexpr (Element == MSETransportOrientation)
+            {
+                if (_hasTransportData)
+                    _data << _mi.transport.pos.GetOrientation();
+            }
+            else if constexpr (Element == MSETransportSeat)
+            {
+                if (_hasTransportData)
+                    _data << _mi.transport.seat;
+            }
+            else if constexpr (Element == MSETransportTime)
+            {
+                if (_hasTransportData)
+                    _data << _mi.transport.time;
+            }
+            else if constexpr (Element == MSETransportTime2)
+            {
+                if (_hasTransportTime2)
+                    _data << _mi.transport.time2;
+            }
+            else if constexpr (Element == MSETransportVehicleId)
+            {
+                if (_hasTransportVehicleId)
+                    _data << _mi.transport.vehicleId;
+            }
+            else if constexpr (Element == MSEPitch)
+            {
+                if (_hasPitch)
+                    _data << _mi.pitch;
+            }
+            else if constexpr (Element == MSEFallTime)
+            {
+                if (_hasFallData)
+                    _data << _mi.jump.fallTime;
+            }
+            else if constexpr (Element == MSEFallVerticalSpeed)
+            {
+                if (_hasFallData)
+                    _data << _mi.jump.zspeed;
+            }
+            else if constexpr (Element == MSEFallCosAngle)
+            {
+                if (_hasFallData && _hasFallDirection)
+                    _data << _mi.jump.cosAngle;
+            }
+            else if constexpr (Element == MSEFallSinAngle)
+            {
+                if (_hasFallData && _hasFallDirection)
+                    _data << _mi.jump.sinAngle;
+            }
+            else if constexpr (Element == MSEFallHorizontalSpeed)
+            {
+                if (_hasFallData && _hasFallDirection)
+                    _data << _mi.jump.xyspeed;
+            }
+            else if constexpr (Element == MSESplineElevation)
+            {
+                if (_hasSplineElevation)
+                    _data << _mi.splineElevation;
+            }
+            else if constexpr (Element == MSECounter)
+                _data << uint32(_status.Counter);
+            else if constexpr (Element == MSEZeroBit)
+                _data.WriteBit(0);
+            else if constexpr (Element == MSEOneBit)
+                _data.WriteBit(1);
+            else if constexpr (Element == MSEFlushBits)
+                _data.FlushBits();
+            else if constexpr (Element == MSEExtraElement)
+                _status.Extras->WriteNextElement(_data);
+            else
+                ASSERT(Movement::PrintInvalidSequenceElement(Element, "MovementStatusWriter::Process"));
+        }
+
+    private:
+        ByteBuffer& _data;
+        Movement::MovementStatusWriteData const& _status;
+        MovementInfo const& _mi;
+
+        bool _hasMovementFlags;
+        bool _hasMovementFlags2;
+        bool _hasOrientation;
+        bool _hasTransportData;
+        bool _hasTransportTime2;
+        bool _hasTransportVehicleId;
+        bool _hasPitch;
+        bool _hasFallData;
+        bool _hasFallDirection;
+        bool _hasSplineElevation;
+    };
+
+    class MovementStatusReader
+    {
+    public:
+        MovementStatusReader(ByteBuffer& data, MovementInfo& mi, Movement::ExtraMovementStatusElement* extras) : _data(data), _mi(mi), _extras(extras) { }
+
+        // stores the guids, only once the whole sequence was read
+        void Finish()
+        {
+            _mi.guid = _guid;
+            _mi.transport.guid = _transportGuid;
+        }
+
+        template<MovementStatusElements Element>
+        void Process()
+        {
+            if constexpr (Element >= MSEHasGuidByte0 && Element <= MSEHasGuidByte7)
+                _guid[Element - MSEHasGuidByte0] = _data.ReadBit();
+            else if constexpr (Element >= MSEHasTransportGuidByte0 && Element <= MSEHasTransportGuidByte7)
+            {
+                if (_hasTransportData)
+                    _transportGuid[Element - MSEHasTransportGuidByte0] = _data.ReadBit();
+            }
+            else if constexpr (Element >= MSEGuidByte0 && Element <= MSEGuidByte7)
+                _data.ReadByteSeq(_guid[Element - MSEGuidByte0]);
+            else if constexpr (Element >= MSETransportGuidByte0 && Element <= MSETransportGuidByte7)
+            {
+                if (_hasTransportData)
+                    _data.ReadByteSeq(_transportGuid[Element - MSETransportGuidByte0]);
+            }
+            else if constexpr (Element == MSEHasMovementFlags)
+                _hasMovementFlags = !_data.ReadBit();
+            else if constexpr (Element == MSEHasMovementFlags2)
+                _hasMovementFlags2 = !_data.ReadBit();
+            else if constexpr (Element == MSEHasTimestamp)
+                _hasTimestamp = !_data.ReadBit();
+            else if constexpr (Element == MSEHasOrientation)
+                _hasOrientation = !_data.ReadBit();
+            else if constexpr (Element == MSEHasTransportData)
+                _hasTransportData = _data.ReadBit();
+            else if constexpr (Element == MSEHasTransportTime2)
+            {
+                if (_hasTransportData)
+                    _hasTransportTime2 = _data.ReadBit();
+            }
+            else if constexpr (Element == MSEHasVehicleId)
+            {
+                if (_hasTransportData)
+                    _hasTransportVehicleId = _data.ReadBit();
+            }
+            else if constexpr (Element == MSEHasPitch)
+                _hasPitch = !_data.ReadBit();
+            else if constexpr (Element == MSEHasFallData)
+                _hasFallData = _data.ReadBit();
+            else if constexpr (Element == MSEHasFallDirection)
+            {
+                if (_hasFallData)
+                    _hasFallDirection = _data.ReadBit();
+            }
+            else if constexpr (Element == MSEHasSplineElevation)
+                _hasSplineElevation = !_data.ReadBit();
+            else if constexpr (Element == MSEHasSpline || Element == MSEHasHeightChangeFailed || Element == MSEZeroBit || Element == MSEOneBit)
+                _data.ReadBit();
+            else if constexpr (Element == MSEMovementFlags)
+            {
+                if (_hasMovementFlags)
+                    _mi.flags = _data.ReadBits(30);
+            }
+            else if constexpr (Element == MSEMovementFlags2)
+            {
+                if (_hasMovementFlags2)
+                    _mi.flags2 = _data.ReadBits(12);
+            }
+            else if constexpr (Element == MSETimestamp)
+            {
+                if (_hasTimestamp)
+                    _data >> _mi.time;
+            }
+            else if constexpr (Element == MSEPositionX)
+                _data >> _mi.pos.m_positionX;
+            else if constexpr (Element == MSEPositionY)
+                _data >> _mi.pos.m_positionY;
+            else if constexpr (Element == MSEPositionZ)
+                _data >> _mi.pos.m_positionZ;
+            else if constexpr (Element == MSEOrientation)
+            {
+                if (_hasOrientation)
+                    _mi.pos.SetOrientation(_data.read<float>());
+            }
+            else if constexpr (Element == MSETransportPositionX)
+            {
+                if (_hasTransportData)
+                    _data >> _mi.transport.pos.m_positionX;
+            }
+            else if constexpr (Element == MSETransportPositionY)
+            {
+                if (_hasTransportData)
+                    _data >> _mi.transport.pos.m_positionY;
+            }
+            else if constexpr (Element == MSETransportPositionZ)
+            {
+                if (_hasTransportData)
+                    _data >> _mi.transport.pos.m_positionZ;
+            }
+            else if constexpr (Element == MSETransportOrientation)
+            {
+                if (_hasTransportData)
+                    _mi.transport.pos.SetOrientation(_data.read<float>());
+            }
+            else if constexpr (Element == MSETransportSeat)
+            {
+                if (_hasTransportData)
+                    _data >> _mi.transport.seat;
+            }
+            else if constexpr (Element == MSETransportTime)
+            {
+                if (_hasTransportData)
+                    _data >> _mi.transport.time;
+            }
+            else if constexpr (Element == MSETransportTime2)
+            {
+                if (_hasTransportData && _hasTransportTime2)
+                    _data >> _mi.transport.time2;
+            }
+            else if constexpr (Element == MSETransportVehicleId)
+            {
+                if (_hasTransportData && _hasTransportVehicleId)
+                    _data >> _mi.transport.vehicleId;
+            }
+            else if constexpr (Element == MSEPitch)
+            {
+                if (_hasPitch)
+                    _mi.pitch = G3D::wrap(_data.read<float>(), float(-M_PI), float(M_PI));
+            }
+            else if constexpr (Element == MSEFallTime)
+            {
+                if (_hasFallData)
+                    _data >> _mi.jump.fallTime;
+            }
+            else if constexpr (Element == MSEFallVerticalSpeed)
+            {
+                if (_hasFallData)
+                    _data >> _mi.jump.zspeed;
+            }
+            else if constexpr (Element == MSEFallCosAngle)
+            {
+                if (_hasFallData && _hasFallDirection)
+                    _data >> _mi.jump.cosAngle;
+            }
+            else if constexpr (Element == MSEFallSinAngle)
+            {
+                if (_hasFallData && _hasFallDirection)
+                    _data >> _mi.jump.sinAngle;
+            }
+            else if constexpr (Element == MSEFallHorizontalSpeed)
+            {
+                if (_hasFallData && _hasFallDirection)
+                    _data >> _mi.jump.xyspeed;
+            }
+            else if constexpr (Element == MSESplineElevation)
+            {
+                if (_hasSplineElevation)
+                    _data >> _mi.splineElevation;
+            }
+            else if constexpr (Element == MSECounter)
+                _data >> _mi.movementCounter;
+            else if constexpr (Element == MSEExtraElement)
+                _extras->ReadNextElement(_data);
+            else
+                ASSERT(Movement::PrintInvalidSequenceElement(Element, "MovementStatusReader::Process"));
+        }
+
+    private:
+        ByteBuffer& _data;
+        MovementInfo& _mi;
+        Movement::ExtraMovementStatusElement* _extras;
+
+        ObjectGuid _guid;
+        ObjectGuid _transportGuid;
+
+        bool _hasMovementFlags = false;
+        bool _hasMovementFlags2 = false;
+        bool _hasTimestamp = false;
+        bool _hasOrientation = false;
+        bool _hasTransportData = false;
+        bool _hasTransportTime2 = false;
+        bool _hasTransportVehicleId = false;
+        bool _hasPitch = false;
+        bool _hasFallData = false;
+        bool _hasFallDirection = false;
+        bool _hasSplineElevation = false;
+    };
+
+    // the whole sequence unrolled into straight code
+    template<typename Serializer, MovementStatusElements const* Sequence, std::size_t... Indexes>
+    void ProcessSequence(Serializer& serializer, std::index_sequence<Indexes...>)
+    {
+        (serializer.template Process<Sequence[Indexes]>(), ...);
+    }
+
+    template<MovementStatusElements const* Sequence>
+    void WriteSequence(ByteBuffer& data, Movement::MovementStatusWriteData const& status)
+    {
+        static_assert(IsValidSequence(Sequence), "Movement status sequences can't contain extra element values");
+
+        MovementStatusWriter writer(data, status);
+        ProcessSequence<MovementStatusWriter, Sequence>(writer, std::make_index_sequence<GetSequenceLength(Sequence)>());
+    }
+
+    template<MovementStatusElements const* Sequence>
+    void ReadSequence(ByteBuffer& data, MovementInfo& mi, Movement::ExtraMovementStatusElement* extras)
+    {
+        static_assert(IsValidSequence(Sequence), "Movement status sequences can't contain extra element values");
+
+        MovementStatusReader reader(data, mi, extras);
+        ProcessSequence<MovementStatusReader, Sequence>(reader, std::make_index_sequence<GetSequenceLength(Sequence)>());
+        reader.Finish();
+    }
+
+    struct MovementStatusSerializer
+    {
+        MovementStatusElements const* Sequence;
+        void(*Write)(ByteBuffer& data, Movement::MovementStatusWriteData const& status);
+        void(*Read)(ByteBuffer& data, MovementInfo& mi, Movement::ExtraMovementStatusElement* extras);
+    };
+
+    template<MovementStatusElements const* Sequence>
+    constexpr MovementStatusSerializer Serializer = { Sequence, &WriteSequence<Sequence>, &ReadSequence<Sequence> };
+
+    MovementStatusSerializer const* GetMovementStatusSerializer(uint32 opcode);
+}
+
 void Movement::ExtraMovementStatusElement::ReadNextElement(ByteBuffer& packet)
 {
     MovementStatusElements const element = _elements[_index++];
@@ -5603,233 +6055,264 @@ void Movement::PacketSender::Send() const
     }
 }
 
-MovementStatusElements const* GetMovementStatusElementsSequence(uint32 opcode)
+namespace
 {
-    switch (opcode)
+    MovementStatusSerializer const* GetMovementStatusSerializer(uint32 opcode)
     {
-        case MSG_MOVE_FALL_LAND:
-            return MovementFallLand;
-        case MSG_MOVE_HEARTBEAT:
-            return MovementHeartBeat;
-        case MSG_MOVE_JUMP:
-            return MovementJump;
-        case MSG_MOVE_SET_FACING:
-            return MovementSetFacing;
-        case MSG_MOVE_SET_PITCH:
-            return MovementSetPitch;
-        case MSG_MOVE_START_ASCEND:
-            return MovementStartAscend;
-        case MSG_MOVE_START_BACKWARD:
-            return MovementStartBackward;
-        case MSG_MOVE_START_DESCEND:
-            return MovementStartDescend;
-        case MSG_MOVE_START_FORWARD:
-            return MovementStartForward;
-        case MSG_MOVE_START_PITCH_DOWN:
-            return MovementStartPitchDown;
-        case MSG_MOVE_START_PITCH_UP:
-            return MovementStartPitchUp;
-        case MSG_MOVE_START_STRAFE_LEFT:
-            return MovementStartStrafeLeft;
-        case MSG_MOVE_START_STRAFE_RIGHT:
-            return MovementStartStrafeRight;
-        case MSG_MOVE_START_SWIM:
-            return MovementStartSwim;
-        case MSG_MOVE_START_TURN_LEFT:
-            return MovementStartTurnLeft;
-        case MSG_MOVE_START_TURN_RIGHT:
-            return MovementStartTurnRight;
-        case MSG_MOVE_STOP:
-            return MovementStop;
-        case MSG_MOVE_STOP_ASCEND:
-            return MovementStopAscend;
-        case MSG_MOVE_STOP_PITCH:
-            return MovementStopPitch;
-        case MSG_MOVE_STOP_STRAFE:
-            return MovementStopStrafe;
-        case MSG_MOVE_STOP_SWIM:
-            return MovementStopSwim;
-        case MSG_MOVE_STOP_TURN:
-            return MovementStopTurn;
-        case CMSG_MOVE_CHNG_TRANSPORT:
-            return MoveChngTransport;
-        case CMSG_MOVE_SPLINE_DONE:
-            return MoveSplineDone;
-        case CMSG_MOVE_NOT_ACTIVE_MOVER:
-            return MoveNotActiveMover;
-        case CMSG_DISMISS_CONTROLLED_VEHICLE:
-            return DismissControlledVehicle;
-        case CMSG_FORCE_MOVE_ROOT_ACK:
-            return ForceMoveRootAck;
-        case CMSG_FORCE_MOVE_UNROOT_ACK:
-            return ForceMoveUnrootAck;
-        case CMSG_MOVE_FALL_RESET:
-            return MovementFallReset;
-        case CMSG_MOVE_FEATHER_FALL_ACK:
-            return MovementFeatherFallAck;
-        case CMSG_MOVE_FORCE_FLIGHT_SPEED_CHANGE_ACK:
-            return MovementForceFlightSpeedChangeAck;
-        case CMSG_MOVE_FORCE_RUN_BACK_SPEED_CHANGE_ACK:
-            return MovementForceRunBackSpeedChangeAck;
-        case CMSG_MOVE_FORCE_RUN_SPEED_CHANGE_ACK:
-            return MovementForceRunSpeedChangeAck;
-        case CMSG_MOVE_FORCE_SWIM_SPEED_CHANGE_ACK:
-            return MovementForceSwimSpeedChangeAck;
-        case CMSG_MOVE_FORCE_SWIM_BACK_SPEED_CHANGE_ACK:
-            return MoveForceSwimBackSpeedChangeAck;
-        case CMSG_MOVE_FORCE_FLIGHT_BACK_SPEED_CHANGE_ACK:
-            return MoveForceFlightBackSpeedChangeAck;
-        case CMSG_MOVE_FORCE_WALK_SPEED_CHANGE_ACK:
-            return MovementForceWalkSpeedChangeAck;
-        case CMSG_MOVE_GRAVITY_DISABLE_ACK:
-            return MovementGravityDisableAck;
-        case CMSG_MOVE_GRAVITY_ENABLE_ACK:
-            return MovementGravityEnableAck;
-        case CMSG_MOVE_HOVER_ACK:
-            return MovementHoverAck;
-        case CMSG_MOVE_KNOCK_BACK_ACK:
-            return MovementKnockBackAck;
-        case CMSG_MOVE_SET_CAN_FLY:
-            return MovementSetCanFly;
-        case CMSG_MOVE_SET_CAN_FLY_ACK:
-            return MovementSetCanFlyAck;
-        case CMSG_MOVE_SET_CAN_TRANSITION_BETWEEN_SWIM_AND_FLY_ACK:
-            return MovementSetCanTransitionBetweenSwimAndFlyAck;
-        case CMSG_MOVE_SET_COLLISION_HEIGHT_ACK:
-            return MovementSetCollisionHeightAck;
-        case SMSG_MOVE_SET_COLLISION_HEIGHT:
-            return MovementSetCollisionHeight;
-        case SMSG_MOVE_UPDATE_COLLISION_HEIGHT:
-            return MovementUpdateCollisionHeight;
-        case CMSG_MOVE_WATER_WALK_ACK:
-            return MovementWaterWalkAck;
-        case MSG_MOVE_SET_RUN_MODE:
-            return MovementSetRunMode;
-        case MSG_MOVE_SET_WALK_MODE:
-            return MovementSetWalkMode;
-        case SMSG_MOVE_UPDATE:
-            return MovementUpdate;
-        case SMSG_MOVE_UPDATE_FLIGHT_SPEED:
-            return MovementUpdateFlightSpeed;
-        case SMSG_MOVE_UPDATE_RUN_SPEED:
-            return MovementUpdateRunSpeed;
-        case SMSG_MOVE_UPDATE_KNOCK_BACK:
-            return MovementUpdateKnockBack;
-        case SMSG_MOVE_UPDATE_RUN_BACK_SPEED:
-            return MovementUpdateRunBackSpeed;
-        case SMSG_MOVE_UPDATE_SWIM_SPEED:
-            return MovementUpdateSwimSpeed;
-        case SMSG_MOVE_UPDATE_SWIM_BACK_SPEED:
-            return MoveUpdateSwimBackSpeed;
-        case SMSG_MOVE_UPDATE_WALK_SPEED:
-            return MovementUpdateWalkSpeed;
-        case SMSG_SPLINE_MOVE_SET_WALK_SPEED:
-            return SplineMoveSetWalkSpeed;
-        case SMSG_SPLINE_MOVE_SET_RUN_SPEED:
-            return SplineMoveSetRunSpeed;
-        case SMSG_SPLINE_MOVE_SET_RUN_BACK_SPEED:
-            return SplineMoveSetRunBackSpeed;
-        case SMSG_SPLINE_MOVE_SET_SWIM_SPEED:
-            return SplineMoveSetSwimSpeed;
-        case SMSG_SPLINE_MOVE_SET_SWIM_BACK_SPEED:
-            return SplineMoveSetSwimBackSpeed;
-        case SMSG_SPLINE_MOVE_SET_TURN_RATE:
-            return SplineMoveSetTurnRate;
-        case SMSG_SPLINE_MOVE_SET_FLIGHT_SPEED:
-            return SplineMoveSetFlightSpeed;
-        case SMSG_SPLINE_MOVE_SET_FLIGHT_BACK_SPEED:
-            return SplineMoveSetFlightBackSpeed;
-        case SMSG_SPLINE_MOVE_SET_PITCH_RATE:
-            return SplineMoveSetPitchRate;
-        case SMSG_MOVE_SET_WALK_SPEED:
-            return MoveSetWalkSpeed;
-        case SMSG_MOVE_SET_RUN_SPEED:
-            return MoveSetRunSpeed;
-        case SMSG_MOVE_SET_RUN_BACK_SPEED:
-            return MoveSetRunBackSpeed;
-        case SMSG_MOVE_SET_SWIM_SPEED:
-            return MoveSetSwimSpeed;
-        case SMSG_MOVE_SET_SWIM_BACK_SPEED:
-            return MoveSetSwimBackSpeed;
-        case SMSG_MOVE_SET_TURN_RATE:
-            return MoveSetTurnRate;
-        case SMSG_MOVE_SET_FLIGHT_SPEED:
-            return MoveSetFlightSpeed;
-        case SMSG_MOVE_SET_FLIGHT_BACK_SPEED:
-            return MoveSetFlightBackSpeed;
-        case SMSG_MOVE_SET_PITCH_RATE:
-            return MoveSetPitchRate;
-        case SMSG_SPLINE_MOVE_SET_WALK_MODE:
-            return SplineMoveSetWalkMode;
-        case SMSG_SPLINE_MOVE_SET_RUN_MODE:
-            return SplineMoveSetRunMode;
-        case SMSG_SPLINE_MOVE_GRAVITY_DISABLE:
-            return SplineMoveGravityDisable;
-        case SMSG_SPLINE_MOVE_GRAVITY_ENABLE:
-            return SplineMoveGravityEnable;
-        case SMSG_SPLINE_MOVE_SET_HOVER:
-            return SplineMoveSetHover;
-        case SMSG_SPLINE_MOVE_UNSET_HOVER:
-            return SplineMoveUnsetHover;
-        case SMSG_SPLINE_MOVE_START_SWIM:
-            return SplineMoveStartSwim;
-        case SMSG_SPLINE_MOVE_STOP_SWIM:
-            return SplineMoveStopSwim;
-        case SMSG_SPLINE_MOVE_SET_FLYING:
-            return SplineMoveSetFlying;
-        case SMSG_SPLINE_MOVE_UNSET_FLYING:
-            return SplineMoveUnsetFlying;
-        case SMSG_SPLINE_MOVE_SET_WATER_WALK:
-            return SplineMoveSetWaterWalk;
-        case SMSG_SPLINE_MOVE_SET_LAND_WALK:
-            return SplineMoveSetLandWalk;
-        case SMSG_SPLINE_MOVE_SET_FEATHER_FALL:
-            return SplineMoveSetFeatherFall;
-        case SMSG_SPLINE_MOVE_SET_NORMAL_FALL:
-            return SplineMoveSetNormalFall;
-        case SMSG_SPLINE_MOVE_ROOT:
-            return SplineMoveRoot;
-        case SMSG_SPLINE_MOVE_UNROOT:
-            return SplineMoveUnroot;
-        case SMSG_MOVE_SET_CAN_FLY:
-            return MoveSetCanFly;
-        case SMSG_MOVE_UNSET_CAN_FLY:
-            return MoveUnsetCanFly;
-        case SMSG_MOVE_SET_HOVER:
-            return MoveSetHover;
-        case SMSG_MOVE_UNSET_HOVER:
-            return MoveUnsetHover;
-        case SMSG_MOVE_WATER_WALK:
-            return MoveWaterWalk;
-        case SMSG_MOVE_LAND_WALK:
-            return MoveLandWalk;
-        case SMSG_MOVE_FEATHER_FALL:
-            return MoveFeatherFall;
-        case SMSG_MOVE_NORMAL_FALL:
-            return MoveNormalFall;
-        case SMSG_MOVE_ROOT:
-            return MoveRoot;
-        case SMSG_MOVE_UNROOT:
-            return MoveUnroot;
-        case CMSG_CHANGE_SEATS_ON_CONTROLLED_VEHICLE:
-            return ChangeSeatsOnControlledVehicle;
-        case CMSG_CAST_SPELL:
-        case CMSG_PET_CAST_SPELL:
-        case CMSG_USE_ITEM:
-            return CastSpellEmbeddedMovement;
-        case SMSG_MOVE_GRAVITY_DISABLE:
-            return MoveGravityDisable;
-        case SMSG_MOVE_GRAVITY_ENABLE:
-            return MoveGravityEnable;
-        case SMSG_MOVE_UPDATE_FLIGHT_BACK_SPEED:
-            return MoveUpdateFlightBackSpeed;
-        case SMSG_MOVE_SET_CAN_TRANSITION_BETWEEN_SWIM_AND_FLY:
-            return MoveSetCanTransitionBetweenSwimAndFly;
-        case SMSG_MOVE_UNSET_CAN_TRANSITION_BETWEEN_SWIM_AND_FLY:
-            return MoveUnsetCanTransitionBetweenSwimAndFly;
-        default:
-            break;
+        switch (opcode)
+        {
+            case MSG_MOVE_FALL_LAND:
+                return &Serializer<MovementFallLand>;
+            case MSG_MOVE_HEARTBEAT:
+                return &Serializer<MovementHeartBeat>;
+            case MSG_MOVE_JUMP:
+                return &Serializer<MovementJump>;
+            case MSG_MOVE_SET_FACING:
+                return &Serializer<MovementSetFacing>;
+            case MSG_MOVE_SET_PITCH:
+                return &Serializer<MovementSetPitch>;
+            case MSG_MOVE_START_ASCEND:
+                return &Serializer<MovementStartAscend>;
+            case MSG_MOVE_START_BACKWARD:
+                return &Serializer<MovementStartBackward>;
+            case MSG_MOVE_START_DESCEND:
+                return &Serializer<MovementStartDescend>;
+            case MSG_MOVE_START_FORWARD:
+                return &Serializer<MovementStartForward>;
+            case MSG_MOVE_START_PITCH_DOWN:
+                return &Serializer<MovementStartPitchDown>;
+            case MSG_MOVE_START_PITCH_UP:
+                return &Serializer<MovementStartPitchUp>;
+            case MSG_MOVE_START_STRAFE_LEFT:
+                return &Serializer<MovementStartStrafeLeft>;
+            case MSG_MOVE_START_STRAFE_RIGHT:
+                return &Serializer<MovementStartStrafeRight>;
+            case MSG_MOVE_START_SWIM:
+                return &Serializer<MovementStartSwim>;
+            case MSG_MOVE_START_TURN_LEFT:
+                return &Serializer<MovementStartTurnLeft>;
+            case MSG_MOVE_START_TURN_RIGHT:
+                return &Serializer<MovementStartTurnRight>;
+            case MSG_MOVE_STOP:
+                return &Serializer<MovementStop>;
+            case MSG_MOVE_STOP_ASCEND:
+                return &Serializer<MovementStopAscend>;
+            case MSG_MOVE_STOP_PITCH:
+                return &Serializer<MovementStopPitch>;
+            case MSG_MOVE_STOP_STRAFE:
+                return &Serializer<MovementStopStrafe>;
+            case MSG_MOVE_STOP_SWIM:
+                return &Serializer<MovementStopSwim>;
+            case MSG_MOVE_STOP_TURN:
+                return &Serializer<MovementStopTurn>;
+            case CMSG_MOVE_CHNG_TRANSPORT:
+                return &Serializer<MoveChngTransport>;
+            case CMSG_MOVE_SPLINE_DONE:
+                return &Serializer<MoveSplineDone>;
+            case CMSG_MOVE_NOT_ACTIVE_MOVER:
+                return &Serializer<MoveNotActiveMover>;
+            case CMSG_DISMISS_CONTROLLED_VEHICLE:
+                return &Serializer<DismissControlledVehicle>;
+            case CMSG_FORCE_MOVE_ROOT_ACK:
+                return &Serializer<ForceMoveRootAck>;
+            case CMSG_FORCE_MOVE_UNROOT_ACK:
+                return &Serializer<ForceMoveUnrootAck>;
+            case CMSG_MOVE_FALL_RESET:
+                return &Serializer<MovementFallReset>;
+            case CMSG_MOVE_FEATHER_FALL_ACK:
+                return &Serializer<MovementFeatherFallAck>;
+            case CMSG_MOVE_FORCE_FLIGHT_SPEED_CHANGE_ACK:
+                return &Serializer<MovementForceFlightSpeedChangeAck>;
+            case CMSG_MOVE_FORCE_RUN_BACK_SPEED_CHANGE_ACK:
+                return &Serializer<MovementForceRunBackSpeedChangeAck>;
+            case CMSG_MOVE_FORCE_RUN_SPEED_CHANGE_ACK:
+                return &Serializer<MovementForceRunSpeedChangeAck>;
+            case CMSG_MOVE_FORCE_SWIM_SPEED_CHANGE_ACK:
+                return &Serializer<MovementForceSwimSpeedChangeAck>;
+            case CMSG_MOVE_FORCE_SWIM_BACK_SPEED_CHANGE_ACK:
+                return &Serializer<MoveForceSwimBackSpeedChangeAck>;
+            case CMSG_MOVE_FORCE_FLIGHT_BACK_SPEED_CHANGE_ACK:
+                return &Serializer<MoveForceFlightBackSpeedChangeAck>;
+            case CMSG_MOVE_FORCE_WALK_SPEED_CHANGE_ACK:
+                return &Serializer<MovementForceWalkSpeedChangeAck>;
+            case CMSG_MOVE_GRAVITY_DISABLE_ACK:
+                return &Serializer<MovementGravityDisableAck>;
+            case CMSG_MOVE_GRAVITY_ENABLE_ACK:
+                return &Serializer<MovementGravityEnableAck>;
+            case CMSG_MOVE_HOVER_ACK:
+                return &Serializer<MovementHoverAck>;
+            case CMSG_MOVE_KNOCK_BACK_ACK:
+                return &Serializer<MovementKnockBackAck>;
+            case CMSG_MOVE_SET_CAN_FLY:
+                return &Serializer<MovementSetCanFly>;
+            case CMSG_MOVE_SET_CAN_FLY_ACK:
+                return &Serializer<MovementSetCanFlyAck>;
+            case CMSG_MOVE_SET_CAN_TRANSITION_BETWEEN_SWIM_AND_FLY_ACK:
+                return &Serializer<MovementSetCanTransitionBetweenSwimAndFlyAck>;
+            case CMSG_MOVE_SET_COLLISION_HEIGHT_ACK:
+                return &Serializer<MovementSetCollisionHeightAck>;
+            case SMSG_MOVE_SET_COLLISION_HEIGHT:
+                return &Serializer<MovementSetCollisionHeight>;
+            case SMSG_MOVE_UPDATE_COLLISION_HEIGHT:
+                return &Serializer<MovementUpdateCollisionHeight>;
+            case CMSG_MOVE_WATER_WALK_ACK:
+                return &Serializer<MovementWaterWalkAck>;
+            case MSG_MOVE_SET_RUN_MODE:
+                return &Serializer<MovementSetRunMode>;
+            case MSG_MOVE_SET_WALK_MODE:
+                return &Serializer<MovementSetWalkMode>;
+            case SMSG_MOVE_UPDATE:
+                return &Serializer<MovementUpdate>;
+            case SMSG_MOVE_UPDATE_FLIGHT_SPEED:
+                return &Serializer<MovementUpdateFlightSpeed>;
+            case SMSG_MOVE_UPDATE_RUN_SPEED:
+                return &Serializer<MovementUpdateRunSpeed>;
+            case SMSG_MOVE_UPDATE_KNOCK_BACK:
+                return &Serializer<MovementUpdateKnockBack>;
+            case SMSG_MOVE_UPDATE_RUN_BACK_SPEED:
+                return &Serializer<MovementUpdateRunBackSpeed>;
+            case SMSG_MOVE_UPDATE_SWIM_SPEED:
+                return &Serializer<MovementUpdateSwimSpeed>;
+            case SMSG_MOVE_UPDATE_SWIM_BACK_SPEED:
+                return &Serializer<MoveUpdateSwimBackSpeed>;
+            case SMSG_MOVE_UPDATE_WALK_SPEED:
+                return &Serializer<MovementUpdateWalkSpeed>;
+            case SMSG_SPLINE_MOVE_SET_WALK_SPEED:
+                return &Serializer<SplineMoveSetWalkSpeed>;
+            case SMSG_SPLINE_MOVE_SET_RUN_SPEED:
+                return &Serializer<SplineMoveSetRunSpeed>;
+            case SMSG_SPLINE_MOVE_SET_RUN_BACK_SPEED:
+                return &Serializer<SplineMoveSetRunBackSpeed>;
+            case SMSG_SPLINE_MOVE_SET_SWIM_SPEED:
+                return &Serializer<SplineMoveSetSwimSpeed>;
+            case SMSG_SPLINE_MOVE_SET_SWIM_BACK_SPEED:
+                return &Serializer<SplineMoveSetSwimBackSpeed>;
+            case SMSG_SPLINE_MOVE_SET_TURN_RATE:
+                return &Serializer<SplineMoveSetTurnRate>;
+            case SMSG_SPLINE_MOVE_SET_FLIGHT_SPEED:
+                return &Serializer<SplineMoveSetFlightSpeed>;
+            case SMSG_SPLINE_MOVE_SET_FLIGHT_BACK_SPEED:
+                return &Serializer<SplineMoveSetFlightBackSpeed>;
+            case SMSG_SPLINE_MOVE_SET_PITCH_RATE:
+                return &Serializer<SplineMoveSetPitchRate>;
+            case SMSG_MOVE_SET_WALK_SPEED:
+                return &Serializer<MoveSetWalkSpeed>;
+            case SMSG_MOVE_SET_RUN_SPEED:
+                return &Serializer<MoveSetRunSpeed>;
+            case SMSG_MOVE_SET_RUN_BACK_SPEED:
+                return &Serializer<MoveSetRunBackSpeed>;
+            case SMSG_MOVE_SET_SWIM_SPEED:
+                return &Serializer<MoveSetSwimSpeed>;
+            case SMSG_MOVE_SET_SWIM_BACK_SPEED:
+                return &Serializer<MoveSetSwimBackSpeed>;
+            case SMSG_MOVE_SET_TURN_RATE:
+                return &Serializer<MoveSetTurnRate>;
+            case SMSG_MOVE_SET_FLIGHT_SPEED:
+                return &Serializer<MoveSetFlightSpeed>;
+            case SMSG_MOVE_SET_FLIGHT_BACK_SPEED:
+                return &Serializer<MoveSetFlightBackSpeed>;
+            case SMSG_MOVE_SET_PITCH_RATE:
+                return &Serializer<MoveSetPitchRate>;
+            case SMSG_SPLINE_MOVE_SET_WALK_MODE:
+                return &Serializer<SplineMoveSetWalkMode>;
+            case SMSG_SPLINE_MOVE_SET_RUN_MODE:
+                return &Serializer<SplineMoveSetRunMode>;
+            case SMSG_SPLINE_MOVE_GRAVITY_DISABLE:
+                return &Serializer<SplineMoveGravityDisable>;
+            case SMSG_SPLINE_MOVE_GRAVITY_ENABLE:
+                return &Serializer<SplineMoveGravityEnable>;
+            case SMSG_SPLINE_MOVE_SET_HOVER:
+                return &Serializer<SplineMoveSetHover>;
+            case SMSG_SPLINE_MOVE_UNSET_HOVER:
+                return &Serializer<SplineMoveUnsetHover>;
+            case SMSG_SPLINE_MOVE_START_SWIM:
+                return &Serializer<SplineMoveStartSwim>;
+            case SMSG_SPLINE_MOVE_STOP_SWIM:
+                return &Serializer<SplineMoveStopSwim>;
+            case SMSG_SPLINE_MOVE_SET_FLYING:
+                return &Serializer<SplineMoveSetFlying>;
+            case SMSG_SPLINE_MOVE_UNSET_FLYING:
+                return &Serializer<SplineMoveUnsetFlying>;
+            case SMSG_SPLINE_MOVE_SET_WATER_WALK:
+                return &Serializer<SplineMoveSetWaterWalk>;
+            case SMSG_SPLINE_MOVE_SET_LAND_WALK:
+                return &Serializer<SplineMoveSetLandWalk>;
+            case SMSG_SPLINE_MOVE_SET_FEATHER_FALL:
+                return &Serializer<SplineMoveSetFeatherFall>;
+            case SMSG_SPLINE_MOVE_SET_NORMAL_FALL:
+                return &Serializer<SplineMoveSetNormalFall>;
+            case SMSG_SPLINE_MOVE_ROOT:
+                return &Serializer<SplineMoveRoot>;
+            case SMSG_SPLINE_MOVE_UNROOT:
+                return &Serializer<SplineMoveUnroot>;
+            case SMSG_MOVE_SET_CAN_FLY:
+                return &Serializer<MoveSetCanFly>;
+            case SMSG_MOVE_UNSET_CAN_FLY:
+                return &Serializer<MoveUnsetCanFly>;
+            case SMSG_MOVE_SET_HOVER:
+                return &Serializer<MoveSetHover>;
+            case SMSG_MOVE_UNSET_HOVER:
+                return &Serializer<MoveUnsetHover>;
+            case SMSG_MOVE_WATER_WALK:
+                return &Serializer<MoveWaterWalk>;
+            case SMSG_MOVE_LAND_WALK:
+                return &Serializer<MoveLandWalk>;
+            case SMSG_MOVE_FEATHER_FALL:
+                return &Serializer<MoveFeatherFall>;
+            case SMSG_MOVE_NORMAL_FALL:
+                return &Serializer<MoveNormalFall>;
+            case SMSG_MOVE_ROOT:
+                return &Serializer<MoveRoot>;
+            case SMSG_MOVE_UNROOT:
+                return &Serializer<MoveUnroot>;
+            case CMSG_CHANGE_SEATS_ON_CONTROLLED_VEHICLE:
+                return &Serializer<ChangeSeatsOnControlledVehicle>;
+            case CMSG_CAST_SPELL:
+            case CMSG_PET_CAST_SPELL:
+            case CMSG_USE_ITEM:
+                return &Serializer<CastSpellEmbeddedMovement>;
+            case SMSG_MOVE_GRAVITY_DISABLE:
+                return &Serializer<MoveGravityDisable>;
+            case SMSG_MOVE_GRAVITY_ENABLE:
+                return &Serializer<MoveGravityEnable>;
+            case SMSG_MOVE_UPDATE_FLIGHT_BACK_SPEED:
+                return &Serializer<MoveUpdateFlightBackSpeed>;
+            case SMSG_MOVE_SET_CAN_TRANSITION_BETWEEN_SWIM_AND_FLY:
+                return &Serializer<MoveSetCanTransitionBetweenSwimAndFly>;
+            case SMSG_MOVE_UNSET_CAN_TRANSITION_BETWEEN_SWIM_AND_FLY:
+                return &Serializer<MoveUnsetCanTransitionBetweenSwimAndFly>;
+            default:
+                break;
+        }
+
+        return nullptr;
     }
+}
+
+MovementStatusElements const* GetMovementStatusElementsSequence(uint32 opcode)
+{
+    if (MovementStatusSerializer const* serializer = GetMovementStatusSerializer(opcode))
+        return serializer->Sequence;
 
     return nullptr;
 }
+
+bool Movement::WriteMovementStatus(ByteBuffer& data, uint32 opcode, MovementStatusWriteData const& status)
+{
+    MovementStatusSerializer const* serializer = GetMovementStatusSerializer(opcode);
+    if (!serializer)
+        return false;
+
+    serializer->Write(data, status);
+    return true;
+}
+
+bool Movement::ReadMovementStatus(ByteBuffer& data, uint32 opcode, MovementInfo& mi, ExtraMovementStatusElement* extras /*= nullptr*/)
+{
+    MovementStatusSerializer const* serializer = GetMovementStatusSerializer(opcode);
+    if (!serializer)
+        return false;
+
+    serializer->Read(data, mi, extras);
+    return true;
+}
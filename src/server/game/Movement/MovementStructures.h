@@ -113,7 +113,7 @@ namespace Movement
 {
     class PacketSender;
 
-    class ExtraMovementStatusElement
+    class TC_GAME_API ExtraMovementStatusElement
     {
         friend class PacketSender;
 
@@ -153,8 +153,24 @@ namespace Movement
     };
 
     bool PrintInvalidSequenceElement(MovementStatusElements element, char const* function);
+
+    // Values of a movement status block being written, position and guids are the unit's ones, not those stored in Info
+    struct MovementStatusWriteData
+    {
+        MovementInfo const* Info = nullptr;
+        Position Pos;
+        ObjectGuid Guid;
+        ObjectGuid TransportGuid;
+        bool HasSpline = false;
+        uint32 Counter = 0;
+        ExtraMovementStatusElement* Extras = nullptr;
+    };
+
+    // Serializers generated at compile time from the sequence of the opcode, return false if it has none
+    TC_GAME_API bool WriteMovementStatus(ByteBuffer& data, uint32 opcode, MovementStatusWriteData const& status);
+    TC_GAME_API bool ReadMovementStatus(ByteBuffer& data, uint32 opcode, MovementInfo& mi, ExtraMovementStatusElement* extras = nullptr);
 }
 
-MovementStatusElements const* GetMovementStatusElementsSequence(uint32 opcode);
+TC_GAME_API MovementStatusElements const* GetMovementStatusElementsSequence(uint32 opcode);
 
 #endif
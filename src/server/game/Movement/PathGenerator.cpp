@@ -33,19 +33,19 @@
 PathGenerator::PathGenerator(WorldObject const* owner) :
     _polyLength(0), _type(PATHFIND_BLANK), _useStraightPath(false),
     _forceDestination(false), _pointPathLimit(MAX_POINT_PATH_LENGTH), _useRaycast(false),
-    _endPosition(G3D::Vector3::zero()), _source(owner), _navMesh(nullptr),
-    _navMeshQuery(nullptr)
+    _endPosition(G3D::Vector3::zero()), _source(owner), _sourceGuid(owner->GetGUID()), _terrainMapId(0),
+    _navMesh(nullptr), _navMeshQuery(nullptr), _async(false), _capturedState(0), _collisionHeight(DEFAULT_COLLISION_HEIGHT)
 {
     memset(_pathPolyRefs, 0, sizeof(_pathPolyRefs));
 
-    TC_LOG_DEBUG("maps.mmaps", "++ PathGenerator::PathGenerator for %u", _source->GetGUID().GetCounter());
+    TC_LOG_DEBUG("maps.mmaps", "++ PathGenerator::PathGenerator for %u", _sourceGuid.GetCounter());
 
-    uint32 mapId = PhasingHandler::GetTerrainMapId(_source->GetPhaseShift(), _source->GetMap(), _source->GetPositionX(), _source->GetPositionY());
-    if (DisableMgr::IsPathfindingEnabled(mapId))
+    _terrainMapId = PhasingHandler::GetTerrainMapId(_source->GetPhaseShift(), _source->GetMap(), _source->GetPositionX(), _source->GetPositionY());
+    if (DisableMgr::IsPathfindingEnabled(_terrainMapId))
     {
         MMAP::MMapManager* mmap = MMAP::MMapFactory::createOrGetMMapManager();
-        _navMesh = mmap->GetNavMesh(mapId);
-        _navMeshQuery = mmap->GetNavMeshQuery(mapId, _source->GetInstanceId());
+        _navMesh = mmap->GetNavMesh(_terrainMapId);
+        _navMeshQuery = mmap->GetNavMeshQuery(_terrainMapId, _source->GetInstanceId());
     }
 
     CreateFilter();
@@ -53,7 +53,7 @@ PathGenerator::PathGenerator(WorldObject const* owner) :
 
 PathGenerator::~PathGenerator()
 {
-    TC_LOG_DEBUG("maps.mmaps", "++ PathGenerator::~PathGenerator() for %u", _source->GetGUID().GetCounter());
+    TC_LOG_DEBUG("maps.mmaps", "++ PathGenerator::~PathGenerator() for %u", _sourceGuid.GetCounter());
 }
 
 bool PathGenerator::CalculatePath(float destX, float destY, float destZ, bool forceDest /*= false*/)
@@ -73,7 +73,7 @@ bool PathGenerator::CalculatePath(G3D::Vector3 const& startPoint, G3D::Vector3 c
 
     _forceDestination = forceDest;
 
-    TC_LOG_DEBUG("maps.mmaps", "++ PathGenerator::CalculatePath() for %u", _source->GetGUID().GetCounter());
+    TC_LOG_DEBUG("maps.mmaps", "++ PathGenerator::CalculatePath() for %u", _sourceGuid.GetCounter());
 
     // make sure navMesh works - we can run on map w/o mmap
     // check if the start and end point have a .mmtile loaded (can we pass via not loaded tile on the way?)
@@ -92,6 +92,169 @@ bool PathGenerator::CalculatePath(G3D::Vector3 const& startPoint, G3D::Vector3 c
     return true;
 }
 
+bool PathGenerator::PrepareAsyncPath(G3D::Vector3 const& startPoint, G3D::Vector3 const& endPoint, bool forceDest /*= false*/)
+{
+    _async = false;
+    _capturedState = 0;
+
+    if (!Trinity::IsValidMapCoord(startPoint.x, startPoint.y, startPoint.z) || !Trinity::IsValidMapCoord(endPoint.x, endPoint.y, endPoint.z))
+    {
+        _type = PATHFIND_NOPATH;
+        return false;
+    }
+
+    SetEndPosition(endPoint);
+    SetStartPosition(startPoint);
+
+    _forceDestination = forceDest;
+
+    const Unit* _sourceUnit = _source->ToUnit();
+    if (!_navMesh || (_sourceUnit && _sourceUnit->HasUnitState(UNIT_STATE_IGNORE_PATHFINDING)) ||
+        !HaveTile(startPoint) || !HaveTile(endPoint))
+    {
+        BuildShortcut();
+        _type = PathType(PATHFIND_NORMAL | PATHFIND_NOT_USING_PATH);
+        return false;
+    }
+
+    UpdateFilter();
+    CaptureSourceState();
+
+    // prepared paths are always built from scratch, the previous poly path may belong to a different query
+    Clear();
+    _async = true;
+    return true;
+}
+
+void PathGenerator::BuildPreparedPath(dtNavMeshQuery const* navMeshQuery)
+{
+    ASSERT(_async);
+
+    TC_METRIC_EVENT("mmap_events", "CalculatePath", "");
+
+    _navMeshQuery = navMeshQuery;
+    if (!_navMeshQuery)
+    {
+        BuildShortcut();
+        _type = PathType(PATHFIND_NORMAL | PATHFIND_NOT_USING_PATH);
+        return;
+    }
+
+    BuildPolyPath(_startPosition, _endPosition);
+}
+
+uint64 PathGenerator::GetPreparedPathFlags() const
+{
+    return uint64(_filter.getIncludeFlags())
+        | (uint64(_filter.getExcludeFlags()) << 16)
+        | (uint64(_capturedState) << 32)
+        | (uint64(_pointPathLimit & 0xFF) << 40)
+        | (uint64(_forceDestination) << 48)
+        | (uint64(_useStraightPath) << 49)
+        | (uint64(_useRaycast) << 50);
+}
+
+void PathGenerator::CaptureSourceState()
+{
+    _capturedState = 0;
+
+    if (Creature const* creature = _source->ToCreature())
+    {
+        if (creature->CanFly())
+            _capturedState |= CAPTURED_STATE_CREATURE_CAN_FLY;
+        if (creature->CanSwim())
+            _capturedState |= CAPTURED_STATE_CREATURE_CAN_SWIM;
+    }
+
+    if (Unit const* unit = _source->ToUnit())
+    {
+        if (unit->CanFly())
+            _capturedState |= CAPTURED_STATE_CAN_FLY;
+        if (unit->CanSwim())
+            _capturedState |= CAPTURED_STATE_CAN_SWIM;
+        if (unit->IsFalling())
+            _capturedState |= CAPTURED_STATE_FALLING;
+    }
+
+    // only the grids are looked up here, liquid is queried by the path finding thread when a shortcut is considered
+    Map* map = _source->GetMap();
+    _startTerrain.Grid = map->GetTerrainGrid(_source->GetPhaseShift(), _startPosition.x, _startPosition.y, _startTerrain.TerrainMapId);
+    _endTerrain.Grid = map->GetTerrainGrid(_source->GetPhaseShift(), _endPosition.x, _endPosition.y, _endTerrain.TerrainMapId);
+    _collisionHeight = _source->GetCollisionHeight();
+}
+
+ZLiquidStatus PathGenerator::GetCapturedLiquidStatus(CapturedTerrain const& terrain, G3D::Vector3 const& p, uint8 reqLiquidType, float collisionHeight)
+{
+    return Map::GetGridLiquidStatus(terrain.TerrainMapId, terrain.Grid, p.x, p.y, p.z, reqLiquidType, collisionHeight);
+}
+
+bool PathGenerator::CanUseShortcutOverHole()
+{
+    // start and end are checked without being normalized to the owner's allowed height, which only changes
+    // the result for points below the ground
+    if (_async)
+        return HasCapturedState(CAPTURED_STATE_CREATURE_CAN_FLY)
+            || (HasCapturedState(CAPTURED_STATE_CREATURE_CAN_SWIM)
+                && GetCapturedLiquidStatus(_startTerrain, _startPosition, MAP_ALL_LIQUIDS, _collisionHeight) != LIQUID_MAP_NO_WATER
+                && GetCapturedLiquidStatus(_endTerrain, _endPosition, MAP_ALL_LIQUIDS, _collisionHeight) != LIQUID_MAP_NO_WATER);
+
+    bool path = _source->GetTypeId() == TYPEID_UNIT && _source->ToCreature()->CanFly();
+
+    bool waterPath = _source->GetTypeId() == TYPEID_UNIT && _source->ToCreature()->CanSwim();
+    if (waterPath)
+    {
+        // Check both start and end points, if they're both in water, then we can *safely* let the creature move
+        for (uint32 i = 0; i < _pathPoints.size(); ++i)
+        {
+            ZLiquidStatus status = _source->GetMap()->GetLiquidStatus(_source->GetPhaseShift(), _pathPoints[i].x, _pathPoints[i].y, _pathPoints[i].z, MAP_ALL_LIQUIDS, nullptr, _source->GetCollisionHeight());
+            // One of the points is not in the water, cancel movement.
+            if (status == LIQUID_MAP_NO_WATER)
+            {
+                waterPath = false;
+                break;
+            }
+        }
+    }
+
+    return path || waterPath;
+}
+
+bool PathGenerator::CanUseShortcutFarFromPoly(bool startFarFromPoly)
+{
+    G3D::Vector3 const& p = startFarFromPoly ? _startPosition : _endPosition;
+    bool underWater = _async
+        ? (GetCapturedLiquidStatus(startFarFromPoly ? _startTerrain : _endTerrain, p, MAP_LIQUID_TYPE_WATER | MAP_LIQUID_TYPE_OCEAN, DEFAULT_COLLISION_HEIGHT) & LIQUID_MAP_UNDER_WATER) != 0
+        : _source->GetMap()->IsUnderWater(_source->GetPhaseShift(), p.x, p.y, p.z);
+
+    if (underWater)
+    {
+        TC_LOG_DEBUG("maps.mmaps", "++ BuildPolyPath :: underWater case");
+        if (_async)
+            return HasCapturedState(CAPTURED_STATE_CAN_SWIM);
+
+        if (const Unit* _sourceUnit = _source->ToUnit())
+            if (_sourceUnit->CanSwim())
+                return true;
+    }
+    else
+    {
+        TC_LOG_DEBUG("maps.mmaps", "++ BuildPolyPath :: flying case");
+        // Allow to build a shortcut if the unit is falling and it's trying to move downwards towards a target (i.e. charging)
+        if (_async)
+            return HasCapturedState(CAPTURED_STATE_CAN_FLY) || (HasCapturedState(CAPTURED_STATE_FALLING) && _endPosition.z < _startPosition.z);
+
+        if (const Unit* _sourceUnit = _source->ToUnit())
+        {
+            if (_sourceUnit->CanFly())
+                return true;
+            else if (_sourceUnit->IsFalling() && _endPosition.z < _startPosition.z)
+                return true;
+        }
+    }
+
+    return false;
+}
+
 dtPolyRef PathGenerator::GetPathPolyByPosition(dtPolyRef const* polyPath, uint32 polyPathSize, float const* point, float* distance) const
 {
     if (!polyPath || !polyPathSize)
@@ -178,25 +341,7 @@ void PathGenerator::BuildPolyPath(G3D::Vector3 const& startPos, G3D::Vector3 con
     {
         TC_LOG_DEBUG("maps.mmaps", "++ BuildPolyPath :: (startPoly == 0 || endPoly == 0)");
         BuildShortcut();
-        bool path = _source->GetTypeId() == TYPEID_UNIT && _source->ToCreature()->CanFly();
-
-        bool waterPath = _source->GetTypeId() == TYPEID_UNIT && _source->ToCreature()->CanSwim();
-        if (waterPath)
-        {
-            // Check both start and end points, if they're both in water, then we can *safely* let the creature move
-            for (uint32 i = 0; i < _pathPoints.size(); ++i)
-            {
-                ZLiquidStatus status = _source->GetMap()->GetLiquidStatus(_source->GetPhaseShift(), _pathPoints[i].x, _pathPoints[i].y, _pathPoints[i].z, MAP_ALL_LIQUIDS, nullptr, _source->GetCollisionHeight());
-                // One of the points is not in the water, cancel movement.
-                if (status == LIQUID_MAP_NO_WATER)
-                {
-                    waterPath = false;
-                    break;
-                }
-            }
-        }
-
-        if (path || waterPath)
+        if (CanUseShortcutOverHole())
         {
             _type = PathType(PATHFIND_NORMAL | PATHFIND_NOT_USING_PATH);
             return;
@@ -217,30 +362,7 @@ void PathGenerator::BuildPolyPath(G3D::Vector3 const& startPos, G3D::Vector3 con
     {
         TC_LOG_DEBUG("maps.mmaps", "++ BuildPolyPath :: farFromPoly distToStartPoly=%.3f distToEndPoly=%.3f", distToStartPoly, distToEndPoly);
 
-        bool buildShotrcut = false;
-
-        G3D::Vector3 const& p = (distToStartPoly > 7.0f) ? startPos : endPos;
-        if (_source->GetMap()->IsUnderWater(_source->GetPhaseShift(), p.x, p.y, p.z))
-        {
-            TC_LOG_DEBUG("maps.mmaps", "++ BuildPolyPath :: underWater case");
-            if (const Unit* _sourceUnit = _source->ToUnit())
-                if (_sourceUnit->CanSwim())
-                    buildShotrcut = true;
-        }
-        else
-        {
-            TC_LOG_DEBUG("maps.mmaps", "++ BuildPolyPath :: flying case");
-            if (const Unit* _sourceUnit = _source->ToUnit())
-            {
-                if (_sourceUnit->CanFly())
-                    buildShotrcut = true;
-                // Allow to build a shortcut if the unit is falling and it's trying to move downwards towards a target (i.e. charging)
-                else if (_sourceUnit->IsFalling() && endPos.z < startPos.z)
-                    buildShotrcut = true;
-            }
-        }
-
-        if (buildShotrcut)
+        if (CanUseShortcutFarFromPoly(startFarFromPoly))
         {
             BuildShortcut();
             _type = PathType(PATHFIND_NORMAL | PATHFIND_NOT_USING_PATH);
@@ -306,7 +428,7 @@ void PathGenerator::BuildPolyPath(G3D::Vector3 const& startPos, G3D::Vector3 con
                 TC_LOG_ERROR("maps.mmaps", "Invalid poly ref in BuildPolyPath. _polyLength: %u, pathStartIndex: %u,"
                                      " startPos: %s, endPos: %s, mapid: %u",
                                      _polyLength, pathStartIndex, startPos.toString().c_str(), endPos.toString().c_str(),
-                                     _source->GetMapId());
+                                     _terrainMapId);
 
                 break;
             }
@@ -381,7 +503,7 @@ void PathGenerator::BuildPolyPath(G3D::Vector3 const& startPos, G3D::Vector3 con
         dtStatus dtResult;
         if (_useRaycast)
         {
-            TC_LOG_ERROR("maps.mmaps", "PathGenerator::BuildPolyPath() called with _useRaycast with a previous path for unit %s", _source->GetGUID().ToString().c_str());
+            TC_LOG_ERROR("maps.mmaps", "PathGenerator::BuildPolyPath() called with _useRaycast with a previous path for unit %s", _sourceGuid.ToString().c_str());
             BuildShortcut();
             _type = PATHFIND_NOPATH;
             return;
@@ -404,7 +526,7 @@ void PathGenerator::BuildPolyPath(G3D::Vector3 const& startPos, G3D::Vector3 con
             // this is probably an error state, but we'll leave it
             // and hopefully recover on the next Update
             // we still need to copy our preffix
-            TC_LOG_ERROR("maps", "%u's Path Build failed: 0 length path", _source->GetGUID().GetCounter());
+            TC_LOG_ERROR("maps", "%u's Path Build failed: 0 length path", _sourceGuid.GetCounter());
         }
 
         TC_LOG_DEBUG("maps.mmaps", "++  m_polyLength=%u prefixPolyLength=%u suffixPolyLength=%u", _polyLength, prefixPolyLength, suffixPolyLength);
@@ -509,7 +631,7 @@ void PathGenerator::BuildPolyPath(G3D::Vector3 const& startPos, G3D::Vector3 con
         if (!_polyLength || dtStatusFailed(dtResult))
         {
             // only happens if we passed bad data to findPath(), or navmesh is messed up
-            TC_LOG_ERROR("maps", "%u's Path Build failed: 0 length path", _source->GetGUID().GetCounter());
+            TC_LOG_ERROR("maps", "%u's Path Build failed: 0 length path", _sourceGuid.GetCounter());
             BuildShortcut();
             _type = PATHFIND_NOPATH;
             return;
@@ -536,7 +658,7 @@ void PathGenerator::BuildPointPath(const float *startPoint, const float *endPoin
     if (_useRaycast)
     {
         // _straightLine uses raycast and it currently doesn't support building a point path, only a 2-point path with start and hitpoint/end is returned
-        TC_LOG_ERROR("maps.mmaps", "PathGenerator::BuildPointPath() called with _useRaycast for unit %s", _source->GetGUID().ToString().c_str());
+        TC_LOG_ERROR("maps.mmaps", "PathGenerator::BuildPointPath() called with _useRaycast for unit %s", _sourceGuid.ToString().c_str());
         BuildShortcut();
         _type = PATHFIND_NOPATH;
         return;
@@ -624,6 +746,10 @@ void PathGenerator::BuildPointPath(const float *startPoint, const float *endPoin
 
 void PathGenerator::NormalizePath()
 {
+    // the owner must not be accessed from path finding threads, normalized when the result is used
+    if (_async)
+        return;
+
     for (uint32 i = 0; i < _pathPoints.size(); ++i)
         _source->UpdateAllowedPositionZ(_pathPoints[i].x, _pathPoints[i].y, _pathPoints[i].z);
 }
@@ -884,7 +1010,7 @@ dtStatus PathGenerator::FindSmoothPath(float const* startPos, float const* endPo
         npolys = FixupCorridor(polys, npolys, MAX_PATH_LENGTH, visited, nvisited);
 
         if (dtStatusFailed(_navMeshQuery->getPolyHeight(polys[0], result, &result[1])))
-            TC_LOG_DEBUG("maps.mmaps", "Cannot find height at position X: %f Y: %f Z: %f for unit %u", result[2], result[0], result[1], _source->GetEntry());
+            TC_LOG_DEBUG("maps.mmaps", "Cannot find height at position X: %f Y: %f Z: %f for unit %u", result[2], result[0], result[1], _sourceGuid.GetEntry());
         result[1] += 0.5f;
         dtVcopy(iterPos, result);
 
@@ -22,9 +22,12 @@
 #include "DetourNavMesh.h"
 #include "DetourNavMeshQuery.h"
 #include "MoveSplineInitArgs.h"
+#include "ObjectGuid.h"
 #include <G3D/Vector3.h>
 
+class GridMap;
 class Unit;
+enum ZLiquidStatus : uint32;
 class WorldObject;
 
 // 74*4.0f=296y  number_of_points*interval = max_path_len
@@ -71,6 +74,19 @@ class TC_GAME_API PathGenerator
         bool CalculatePath(G3D::Vector3 const& startPoint, G3D::Vector3 const& endPoint, bool forceDest = false);
         bool IsInvalidDestinationZ(Unit const* target) const;
 
+        // Splits CalculatePath for building the path on a path finding thread (see PathRequestQueue)
+        // PrepareAsyncPath captures the owner's state and must be called from the map update
+        // return: true if the path still has to be built by BuildPreparedPath, false if the result is already final
+        bool PrepareAsyncPath(G3D::Vector3 const& startPoint, G3D::Vector3 const& endPoint, bool forceDest = false);
+        // never accesses the owner or the map, the grids of the start and end point must be kept loaded meanwhile
+        // resulting points are not normalized to the owner's allowed height
+        // without a query (navmesh not available) a shortcut is built
+        void BuildPreparedPath(dtNavMeshQuery const* navMeshQuery);
+        // everything besides the start and end position a prepared path depends on
+        uint64 GetPreparedPathFlags() const;
+        uint32 GetTerrainMapId() const { return _terrainMapId; }
+        float GetCollisionHeight() const { return _collisionHeight; }
+
         // option setters - use optional
         void SetUseStraightPath(bool useStraightPath) { _useStraightPath = useStraightPath; }
         void SetPathLengthLimit(float length);
@@ -106,11 +122,42 @@ class TC_GAME_API PathGenerator
         G3D::Vector3 _actualEndPosition;    // {x, y, z} of the closest possible point to given destination
 
         WorldObject const* const _source;       // the object that is moving
+        ObjectGuid const _sourceGuid;
+        uint32 _terrainMapId;
         dtNavMesh const* _navMesh;              // the nav mesh
         dtNavMeshQuery const* _navMeshQuery;    // the nav mesh query used to find the path
 
         dtQueryFilter _filter;  // use single filter for all movements, update it when needed
 
+        // owner state captured by PrepareAsyncPath, BuildPolyPath uses it instead of querying the owner
+        enum CapturedState : uint8
+        {
+            CAPTURED_STATE_CREATURE_CAN_FLY     = 0x01,
+            CAPTURED_STATE_CREATURE_CAN_SWIM    = 0x02,
+            CAPTURED_STATE_CAN_FLY              = 0x04,
+            CAPTURED_STATE_CAN_SWIM             = 0x08,
+            CAPTURED_STATE_FALLING              = 0x10
+        };
+
+        // terrain of the start or end point, queried by BuildPreparedPath instead of the map
+        struct CapturedTerrain
+        {
+            uint32 TerrainMapId = 0;
+            GridMap* Grid = nullptr;
+        };
+
+        bool _async;
+        uint8 _capturedState;
+        CapturedTerrain _startTerrain;
+        CapturedTerrain _endTerrain;
+        float _collisionHeight;
+
+        bool HasCapturedState(CapturedState state) const { return (_capturedState & state) != 0; }
+        void CaptureSourceState();
+        static ZLiquidStatus GetCapturedLiquidStatus(CapturedTerrain const& terrain, G3D::Vector3 const& p, uint8 reqLiquidType, float collisionHeight);
+        bool CanUseShortcutOverHole();
+        bool CanUseShortcutFarFromPoly(bool startFarFromPoly);
+
         void SetStartPosition(G3D::Vector3 const& point) { _startPosition = point; }
         void SetEndPosition(G3D::Vector3 const& point) { _actualEndPosition = point; _endPosition = point; }
         void SetActualEndPosition(G3D::Vector3 const& point) { _actualEndPosition = point; }
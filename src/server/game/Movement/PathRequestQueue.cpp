@@ -0,0 +1,275 @@
+/*
+ * This file is part of the TrinityCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "PathRequestQueue.h"
+#include "G3DPosition.hpp"
+#include "Hash.h"
+#include "MMapFactory.h"
+#include "MMapManager.h"
+#include "Object.h"
+#include <cmath>
+#include <cstring>
+#include <shared_mutex>
+
+namespace
+{
+    // movers closer than this to each other share their paths
+    float const RequestQuantum = 2.0f; // 1/2 yard
+
+    // a mover further than this from the start of its path when it is ready asks for a new one
+    float const MaxStartOffset = 2.0f;
+
+    int32 Quantize(float value)
+    {
+        return int32(std::floor(value * RequestQuantum));
+    }
+}
+
+PathRequest::PathRequest(std::unique_ptr<PathGenerator> generator)
+    : PathRequest(generator->GetTerrainMapId(), generator->GetStartPosition(), generator->GetEndPosition(), generator->GetCollisionHeight(), generator->GetPreparedPathFlags())
+{
+    _generator = std::move(generator);
+}
+
+PathRequest::PathRequest(uint32 terrainMapId, G3D::Vector3 const& start, G3D::Vector3 const& end, float collisionHeight, uint64 flags)
+    : _queue(nullptr), _state(STATE_PENDING), _terrainMapId(terrainMapId), _start(start), _end(end), _collisionHeight(collisionHeight), _flags(flags), _gridCount(0)
+{
+}
+
+PathRequest::~PathRequest() = default;
+
+bool PathRequest::GetPath(WorldObject const* owner, Movement::PointsArray& path) const
+{
+    path = _generator->GetPath();
+    if (!path.empty())
+    {
+        G3D::Vector3 const position = PositionToVector3(owner->GetPosition());
+        if ((path.front() - position).squaredLength() > MaxStartOffset * MaxStartOffset)
+            return false;
+
+        // keep the mover from snapping back to where it was when the path was requested
+        path.front() = position;
+    }
+
+    for (G3D::Vector3& point : path)
+        owner->UpdateAllowedPositionZ(point.x, point.y, point.z);
+
+    return true;
+}
+
+void PathRequest::Build(dtNavMeshQuery const* navMeshQuery)
+{
+    _generator->BuildPreparedPath(navMeshQuery);
+}
+
+void PathRequest::Process(uint32 threadIndex)
+{
+    uint8 expected = STATE_PENDING;
+    if (_state.compare_exchange_strong(expected, STATE_RUNNING))
+    {
+        std::shared_lock<std::shared_mutex> tileLock;
+        dtNavMeshQuery const* query = _navMesh ? MMAP::MMapManager::GetAsyncNavMeshQuery(_navMesh.get(), threadIndex, tileLock) : nullptr;
+        Build(query);
+        _state.store(STATE_DONE, std::memory_order_release);
+    }
+
+    _navMesh.reset();
+    _queue->UnpinGrids(*this);
+
+    // the queue may be gone right after this
+    _queue->OnRequestFinished();
+}
+
+void PathRequestProcessor::activate(size_t num_threads)
+{
+    for (size_t i = 0; i < num_threads; ++i)
+        _workerThreads.push_back(std::thread(&PathRequestProcessor::WorkerThread, this, uint32(i)));
+}
+
+void PathRequestProcessor::deactivate()
+{
+    _cancelationToken = true;
+
+    _queue.Cancel();
+
+    for (auto& thread : _workerThreads)
+        thread.join();
+
+    _workerThreads.clear();
+}
+
+void PathRequestProcessor::schedule(std::shared_ptr<PathRequest> request)
+{
+    _queue.Push(std::move(request));
+}
+
+void PathRequestProcessor::WorkerThread(uint32 threadIndex)
+{
+    while (1)
+    {
+        std::shared_ptr<PathRequest> request;
+
+        _queue.WaitAndPop(request);
+
+        if (_cancelationToken)
+            return;
+
+        if (request)
+            request->Process(threadIndex);
+    }
+}
+
+bool PathRequestQueue::RequestKey::operator==(RequestKey const& right) const
+{
+    return TerrainMapId == right.TerrainMapId
+        && !std::memcmp(Start, right.Start, sizeof(Start))
+        && !std::memcmp(End, right.End, sizeof(End))
+        && CollisionHeight == right.CollisionHeight
+        && Flags == right.Flags;
+}
+
+std::size_t PathRequestQueue::RequestKeyHash::operator()(RequestKey const& key) const
+{
+    std::size_t hash = 0;
+    Trinity::hash_combine(hash, key.TerrainMapId);
+    for (int32 coord : key.Start)
+        Trinity::hash_combine(hash, coord);
+    for (int32 coord : key.End)
+        Trinity::hash_combine(hash, coord);
+    Trinity::hash_combine(hash, key.CollisionHeight);
+    Trinity::hash_combine(hash, key.Flags);
+    return hash;
+}
+
+PathRequestQueue::~PathRequestQueue()
+{
+    CancelAll();
+}
+
+std::shared_ptr<PathRequest const> PathRequestQueue::Submit(WorldObject const* owner, G3D::Vector3 const& dest, bool forceDest /*= false*/, float pathLengthLimit /*= 0.0f*/)
+{
+    std::unique_ptr<PathGenerator> generator = std::make_unique<PathGenerator>(owner);
+    if (pathLengthLimit > 0.0f)
+        generator->SetPathLengthLimit(pathLengthLimit);
+
+    // no navmesh involved (shortcut or invalid coordinates), nothing to wait for
+    if (!generator->PrepareAsyncPath(PositionToVector3(owner->GetPosition()), dest, forceDest))
+    {
+        std::shared_ptr<PathRequest> request = std::make_shared<PathRequest>(std::move(generator));
+        request->_state.store(PathRequest::STATE_DONE, std::memory_order_relaxed);
+        return request;
+    }
+
+    return Submit(std::make_shared<PathRequest>(std::move(generator)));
+}
+
+std::shared_ptr<PathRequest const> PathRequestQueue::Submit(std::shared_ptr<PathRequest> request)
+{
+    RequestKey key;
+    key.TerrainMapId = request->_terrainMapId;
+    key.Start[0] = Quantize(request->_start.x);
+    key.Start[1] = Quantize(request->_start.y);
+    key.Start[2] = Quantize(request->_start.z);
+    key.End[0] = Quantize(request->_end.x);
+    key.End[1] = Quantize(request->_end.y);
+    key.End[2] = Quantize(request->_end.z);
+    key.CollisionHeight = request->_collisionHeight;
+    key.Flags = request->_flags;
+
+    std::weak_ptr<PathRequest>& existing = _requests[key];
+    if (std::shared_ptr<PathRequest> other = existing.lock())
+        if (other->_state.load(std::memory_order_relaxed) != PathRequest::STATE_CANCELLED)
+            return other;
+
+    request->_queue = this;
+    existing = request;
+
+    if (!_processor.activated())
+    {
+        request->Build(MMAP::MMapFactory::createOrGetMMapManager()->GetNavMeshQuery(request->_terrainMapId, _instanceId));
+        request->_state.store(PathRequest::STATE_DONE, std::memory_order_relaxed);
+        return request;
+    }
+
+    request->_navMesh = MMAP::MMapFactory::createOrGetMMapManager()->PinNavMesh(request->_terrainMapId);
+    PinGrids(*request);
+
+    {
+        std::lock_guard<std::mutex> lock(_lock);
+        ++_inFlight;
+    }
+
+    _processor.schedule(request);
+    return request;
+}
+
+void PathRequestQueue::Update()
+{
+    for (auto itr = _requests.begin(); itr != _requests.end();)
+    {
+        if (itr->second.expired())
+            itr = _requests.erase(itr);
+        else
+            ++itr;
+    }
+}
+
+void PathRequestQueue::CancelAll()
+{
+    for (auto const& pair : _requests)
+    {
+        if (std::shared_ptr<PathRequest> request = pair.second.lock())
+        {
+            uint8 expected = PathRequest::STATE_PENDING;
+            request->_state.compare_exchange_strong(expected, PathRequest::STATE_CANCELLED);
+        }
+    }
+
+    _requests.clear();
+
+    std::unique_lock<std::mutex> lock(_lock);
+    while (_inFlight > 0)
+        _condition.wait(lock);
+}
+
+void PathRequestQueue::PinGrids(PathRequest& request)
+{
+    // same grids as Map::GetTerrainGrid looked up for the generator
+    request._grids[0] = Trinity::ComputeGridCoordSimple(request._start.x, request._start.y);
+    request._grids[1] = Trinity::ComputeGridCoordSimple(request._end.x, request._end.y);
+    request._gridCount = request._grids[0] == request._grids[1] ? 1 : 2;
+
+    for (uint8 i = 0; i < request._gridCount; ++i)
+        _gridUsers[request._grids[i].x_coord][request._grids[i].y_coord].fetch_add(1, std::memory_order_relaxed);
+}
+
+void PathRequestQueue::UnpinGrids(PathRequest& request)
+{
+    for (uint8 i = 0; i < request._gridCount; ++i)
+        _gridUsers[request._grids[i].x_coord][request._grids[i].y_coord].fetch_sub(1, std::memory_order_release);
+
+    request._gridCount = 0;
+}
+
+void PathRequestQueue::OnRequestFinished()
+{
+    std::lock_guard<std::mutex> lock(_lock);
+
+    --_inFlight;
+
+    _condition.notify_all();
+}
@@ -0,0 +1,188 @@
+/*
+ * This file is part of the TrinityCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TRINITY_PATHREQUESTQUEUE_H
+#define TRINITY_PATHREQUESTQUEUE_H
+
+#include "GridDefines.h"
+#include "PathGenerator.h"
+#include "ProducerConsumerQueue.h"
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+class PathRequestQueue;
+class WorldObject;
+
+namespace MMAP
+{
+    struct MMapData;
+}
+
+// A path being built by a path finding thread. Shared by every mover that asked for
+// the same path (same quantized start and end, same collision height, filter and owner state).
+class TC_GAME_API PathRequest
+{
+    public:
+        explicit PathRequest(std::unique_ptr<PathGenerator> generator);
+        virtual ~PathRequest();
+
+        PathRequest(PathRequest const&) = delete;
+        PathRequest& operator=(PathRequest const&) = delete;
+
+        bool IsReady() const { return _state.load(std::memory_order_acquire) == STATE_DONE; }
+
+        // result getters, only valid once ready
+        PathType GetPathType() const { return _generator->GetPathType(); }
+        // copies the path with every point adjusted to the allowed height of the given mover
+        // the path starts where the first mover asking for it stood, it is moved to the mover's current position
+        // return: false if the mover went too far away from the start meanwhile and should ask for a new path
+        bool GetPath(WorldObject const* owner, Movement::PointsArray& path) const;
+
+    protected:
+        // a request built by an overridden Build, without a generator
+        // flags must encode everything besides the endpoints and collision height the path depends on
+        PathRequest(uint32 terrainMapId, G3D::Vector3 const& start, G3D::Vector3 const& end, float collisionHeight, uint64 flags);
+
+        // runs on a path finding thread, or in the map update without them
+        // navMeshQuery is null if the terrain map has no navmesh loaded
+        virtual void Build(dtNavMeshQuery const* navMeshQuery);
+
+    private:
+        friend class PathRequestQueue;
+        friend class PathRequestProcessor;
+
+        enum State : uint8
+        {
+            STATE_PENDING,
+            STATE_RUNNING,
+            STATE_DONE,
+            STATE_CANCELLED
+        };
+
+        void Process(uint32 threadIndex);
+
+        PathRequestQueue* _queue;
+        std::unique_ptr<PathGenerator> _generator;
+        std::atomic<uint8> _state;
+
+        uint32 _terrainMapId;
+        G3D::Vector3 _start;
+        G3D::Vector3 _end;
+        float _collisionHeight;
+        uint64 _flags;
+
+        // held until the path is built, see PathRequestQueue::PinGrids
+        std::shared_ptr<MMAP::MMapData> _navMesh;
+        GridCoord _grids[2];
+        uint8 _gridCount;
+};
+
+// Threads building paths for all maps, Detour queries run here with navmesh queries owned by each thread
+class TC_GAME_API PathRequestProcessor
+{
+    public:
+        PathRequestProcessor() : _cancelationToken(false) { }
+
+        void activate(size_t num_threads);
+
+        void deactivate();
+
+        bool activated() const { return !_workerThreads.empty(); }
+
+        void schedule(std::shared_ptr<PathRequest> request);
+
+    private:
+        void WorkerThread(uint32 threadIndex);
+
+        ProducerConsumerQueue<std::shared_ptr<PathRequest>> _queue;
+        std::vector<std::thread> _workerThreads;
+        std::atomic<bool> _cancelationToken;
+};
+
+// Per map entry point for asynchronous paths. Requests are submitted from the map update,
+// movers keep their current spline and poll the request on later updates.
+// Without path finding threads requests are built right away and are ready on return.
+class TC_GAME_API PathRequestQueue
+{
+    public:
+        // instanceId selects the navmesh query of the map used without path finding threads
+        PathRequestQueue(PathRequestProcessor& processor, uint32 instanceId) : _processor(processor), _instanceId(instanceId), _inFlight(0), _gridUsers() { }
+        ~PathRequestQueue();
+
+        PathRequestQueue(PathRequestQueue const&) = delete;
+        PathRequestQueue& operator=(PathRequestQueue const&) = delete;
+
+        // path from owner's current position to dest, see PathGenerator::CalculatePath
+        std::shared_ptr<PathRequest const> Submit(WorldObject const* owner, G3D::Vector3 const& dest, bool forceDest = false, float pathLengthLimit = 0.0f);
+
+        // returns the request still alive for the same quantized endpoints, collision height and flags if any,
+        // otherwise schedules the given one (or builds it right away without path finding threads)
+        std::shared_ptr<PathRequest const> Submit(std::shared_ptr<PathRequest> request);
+
+        // forgets requests nobody waits for anymore
+        void Update();
+
+        // cancels pending requests and waits for running ones, must be called before the map's navmesh is unloaded
+        void CancelAll();
+
+        // the terrain of the grid is read by a request being built, it can't be unloaded yet
+        bool IsGridInUse(uint32 x, uint32 y) const { return _gridUsers[x][y].load(std::memory_order_acquire) != 0; }
+
+    private:
+        friend class PathRequest;
+
+        struct RequestKey
+        {
+            uint32 TerrainMapId;
+            int32 Start[3];
+            int32 End[3];
+            // liquid checks of shortcuts depend on it
+            float CollisionHeight;
+            // PathGenerator::GetPreparedPathFlags, walk and swim in the filter, fly and swim in the captured state
+            uint64 Flags;
+
+            bool operator==(RequestKey const& right) const;
+        };
+
+        struct RequestKeyHash
+        {
+            std::size_t operator()(RequestKey const& key) const;
+        };
+
+        void PinGrids(PathRequest& request);
+        void UnpinGrids(PathRequest& request);
+        void OnRequestFinished();
+
+        PathRequestProcessor& _processor;
+        uint32 _instanceId;
+
+        std::unordered_map<RequestKey, std::weak_ptr<PathRequest>, RequestKeyHash> _requests;
+
+        std::mutex _lock;
+        std::condition_variable _condition;
+        uint32 _inFlight;
+
+        // incremented by the map update when a request is submitted, decremented by path finding threads
+        std::atomic<uint16> _gridUsers[MAX_NUMBER_OF_GRIDS][MAX_NUMBER_OF_GRIDS];
+};
+
+#endif // TRINITY_PATHREQUESTQUEUE_H
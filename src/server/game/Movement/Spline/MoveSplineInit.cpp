@@ -121,6 +121,9 @@ namespace Movement
         unit->m_movementInfo.SetMovementFlags(moveFlags);
         move_spline.Initialize(args);
 
+        if (Creature* creature = unit->ToCreature())
+            creature->WakeUpdates(CREATURE_UPDATE_STATE_MOVING);
+
         WorldPackets::Movement::MonsterMove packet(transport);
         packet.MoverGUID = unit->GetGUID();
         packet.Pos = Position(real_position.x, real_position.y, real_position.z, real_position.orientation);
@@ -17,6 +17,7 @@
 
 #include "PhaseShift.h"
 #include "Containers.h"
+#include "Hash.h"
 
 bool PhaseShift::AddPhase(uint32 phaseId, PhaseFlags flags, std::vector<Condition*> const* areaConditions, int32 references /*= 1*/)
 {
@@ -176,3 +177,17 @@ void PhaseShift::UpdateUnphasedFlag()
     else
         Flags |= unphasedFlag;
 }
+
+uint32 PhaseShift::GetHash() const
+{
+    std::size_t hash = 0;
+    Trinity::hash_combine(hash, Flags.AsUnderlyingType());
+    Trinity::hash_combine(hash, PersonalGuid.GetRawValue());
+    for (PhaseRef const& phase : Phases)
+    {
+        Trinity::hash_combine(hash, phase.Id);
+        Trinity::hash_combine(hash, phase.Flags.AsUnderlyingType());
+    }
+    // never 0, reserved for phase independent results
+    return uint32(hash) | 1;
+}
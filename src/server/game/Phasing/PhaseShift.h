@@ -107,6 +107,9 @@ public:
 
     bool CanSee(PhaseShift const& other) const;
 
+    // identifies the set of phases for memoized queries, equal phase shifts always hash equally
+    uint32 GetHash() const;
+
 protected:
     friend class PhasingHandler;
 
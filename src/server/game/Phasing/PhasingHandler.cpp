@@ -20,6 +20,7 @@
 #include "ConditionMgr.h"
 #include "Creature.h"
 #include "DBCStores.h"
+#include "GameObject.h"
 #include "Language.h"
 #include "Map.h"
 #include "MiscPackets.h"
@@ -565,6 +566,11 @@ void PhasingHandler::UpdateVisibilityIfNeeded(WorldObject* object, bool updateVi
         if (Player* player = object->ToPlayer())
             SendToPlayer(player);
 
+        // gameobject collision is phased
+        if (GameObject* go = object->ToGameObject())
+            if (go->m_model)
+                go->GetMap()->InvalidateCollisionCache(*go->m_model);
+
         if (updateVisibility)
         {
             if (Player* player = object->ToPlayer())
@@ -32,6 +32,8 @@ class TC_GAME_API GameClient
         void RemoveAllowedMover(Unit* unit);
         bool IsAllowedToMove(Unit* unit) const;
         bool IsAllowedToMove(ObjectGuid guid) const;
+        // every movement packet of this client is about the same unit
+        bool HasSingleAllowedMover() const { return _allowedMovers.size() == 1; }
         void SetMovedUnit(Unit* target, bool allowMove);
 
         Unit* GetActivelyMovedUnit() const { return _activelyMovedUnit; }
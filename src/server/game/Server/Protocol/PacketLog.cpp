@@ -19,8 +19,14 @@
 #include "PacketLog.h"
 #include "Config.h"
 #include "IpAddress.h"
+#include "Log.h"
+#include "Position.h"
 #include "Timer.h"
+#include "Util.h"
 #include "WorldPacket.h"
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
 
 #pragma pack(push, 1)
 
@@ -58,13 +64,132 @@ struct PacketHeader
 
 #pragma pack(pop)
 
-PacketLog::PacketLog() : _file(nullptr)
+// Single producer single consumer byte ring, records are always complete when published
+class PacketLogRing
+{
+    public:
+        explicit PacketLogRing(std::size_t capacity) : _buffer(capacity), _head(0), _tail(0) { }
+
+        // logging thread only
+        bool Write(PacketHeader const& header, uint8 const* data, std::size_t size)
+        {
+            uint64 head = _head.load(std::memory_order_relaxed);
+            uint64 tail = _tail.load(std::memory_order_acquire);
+            if (_buffer.size() - std::size_t(head - tail) < sizeof(header) + size)
+                return false;
+
+            Copy(head, reinterpret_cast<uint8 const*>(&header), sizeof(header));
+            Copy(head + sizeof(header), data, size);
+            _head.store(head + sizeof(header) + size, std::memory_order_release);
+            return true;
+        }
+
+        // writer thread only, returns the number of bytes written (or discarded without a file)
+        std::size_t Drain(FILE* file)
+        {
+            uint64 tail = _tail.load(std::memory_order_relaxed);
+            uint64 head = _head.load(std::memory_order_acquire);
+            std::size_t count = std::size_t(head - tail);
+            if (!count)
+                return 0;
+
+            if (file)
+            {
+                std::size_t offset = std::size_t(tail % _buffer.size());
+                std::size_t first = std::min(count, _buffer.size() - offset);
+                fwrite(&_buffer[offset], 1, first, file);
+                if (count > first)
+                    fwrite(&_buffer[0], 1, count - first, file);
+            }
+
+            _tail.store(head, std::memory_order_release);
+            return count;
+        }
+
+        bool IsEmpty() const { return _head.load(std::memory_order_acquire) == _tail.load(std::memory_order_relaxed); }
+
+    private:
+        void Copy(uint64 position, uint8 const* data, std::size_t size)
+        {
+            if (!size)
+                return;
+
+            std::size_t offset = std::size_t(position % _buffer.size());
+            std::size_t first = std::min(size, _buffer.size() - offset);
+            memcpy(&_buffer[offset], data, first);
+            if (size > first)
+                memcpy(&_buffer[0], data + first, size - first);
+        }
+
+        std::vector<uint8> _buffer;
+        std::atomic<uint64> _head;
+        std::atomic<uint64> _tail;
+};
+
+namespace
+{
+    // the registry in PacketLog keeps the ring until everything written by an exited thread is on disk
+    thread_local std::shared_ptr<PacketLogRing> ThreadRing;
+
+    std::string GetConfigList(char const* name)
+    {
+        std::string value = sConfigMgr->GetStringDefault(name, "");
+        value.erase(std::remove_if(value.begin(), value.end(), [](char c) { return std::isspace(static_cast<unsigned char>(c)); }), value.end());
+        return value;
+    }
+
+    void LoadNumberList(char const* name, std::unordered_set<uint32>& values)
+    {
+        for (char const* token : Tokenizer(GetConfigList(name), ',', 0, false))
+        {
+            char* end = nullptr;
+            unsigned long value = strtoul(token, &end, 0);
+            if (*end)
+                TC_LOG_ERROR("server.loading", "PacketLog: invalid value '%s' in %s, ignored.", token, name);
+            else
+                values.insert(uint32(value));
+        }
+    }
+}
+
+std::atomic<uint64> PacketLog::_loggedPackets(0);
+std::atomic<uint64> PacketLog::_droppedPackets(0);
+
+bool PacketLogFilter::Matches(uint32 opcode, boost::asio::ip::address const& addr, uint32 accountId, uint32 mapId) const
+{
+    if (!Opcodes.empty() && !Opcodes.count(opcode))
+        return false;
+
+    if (!Accounts.empty() && !Accounts.count(accountId))
+        return false;
+
+    if (!Maps.empty() && !Maps.count(mapId))
+        return false;
+
+    if (!Addresses.empty() && std::find(Addresses.begin(), Addresses.end(), addr) == Addresses.end())
+        return false;
+
+    return true;
+}
+
+PacketLog::PacketLog() : _enabled(false), _ringSize(0), _stopWriter(false), _file(nullptr), _fileSize(0), _maxFileSize(0), _maxFiles(0)
 {
     std::call_once(_initializeFlag, &PacketLog::Initialize, this);
 }
 
 PacketLog::~PacketLog()
 {
+    if (_writerThread.joinable())
+    {
+        {
+            std::lock_guard<std::mutex> lock(_writerLock);
+            _stopWriter = true;
+        }
+
+        _writerCondition.notify_one();
+        _writerThread.join();
+    }
+
     if (_file)
         fclose(_file);
 
@@ -86,29 +211,49 @@ void PacketLog::Initialize()
             logsDir.push_back('/');
 
     std::string logname = sConfigMgr->GetStringDefault("PacketLogFile", "");
-    if (!logname.empty())
+    if (logname.empty())
+        return;
+
+    _fileName = logsDir + logname;
+    _ringSize = std::size_t(std::max(sConfigMgr->GetIntDefault("PacketLog.RingSize", 1024), 64)) * 1024;
+    _maxFileSize = uint64(std::max(sConfigMgr->GetIntDefault("PacketLog.MaxFileSize", 0), 0)) * 1024 * 1024;
+    _maxFiles = uint32(std::max(sConfigMgr->GetIntDefault("PacketLog.MaxFiles", 5), 1));
+
+    if (!OpenFile())
+        return;
+
+    LoadFilterFromConfig();
+
+    _enabled = true;
+    _writerThread = std::thread(&PacketLog::WriterThread, this);
+}
+
+void PacketLog::LoadFilterFromConfig()
+{
+    std::shared_ptr<PacketLogFilter> filter = std::make_shared<PacketLogFilter>();
+    LoadNumberList("PacketLog.Filter.Accounts", filter->Accounts);
+    LoadNumberList("PacketLog.Filter.Opcodes", filter->Opcodes);
+    LoadNumberList("PacketLog.Filter.Maps", filter->Maps);
+
+    for (char const* token : Tokenizer(GetConfigList("PacketLog.Filter.Addresses"), ',', 0, false))
     {
-        _file = fopen((logsDir + logname).c_str(), "wb");
-
-        LogHeader header;
-        header.Signature[0] = 'P'; header.Signature[1] = 'K'; header.Signature[2] = 'T';
-        header.FormatVersion = 0x0301;
-        header.SnifferId = 'T';
-        header.Build = 15595;
-        header.Locale[0] = 'e'; header.Locale[1] = 'n'; header.Locale[2] = 'U'; header.Locale[3] = 'S';
-        std::memset(header.SessionKey, 0, sizeof(header.SessionKey));
-        header.SniffStartUnixtime = GameTime::GetGameTime();
-        header.SniffStartTicks = getMSTime();
-        header.OptionalDataSize = 0;
-
-        if (CanLogPacket())
-            fwrite(&header, sizeof(header), 1, _file);
+        boost::system::error_code error;
+        boost::asio::ip::address address = Trinity::Net::make_address(token, error);
+        if (error)
+            TC_LOG_ERROR("server.loading", "PacketLog: invalid address '%s' in PacketLog.Filter.Addresses, ignored.", token);
+        else
+            filter->Addresses.push_back(address);
     }
+
+    // the replaced filter is freed once the last logging thread using it is done
+    std::atomic_store(&_filter, std::shared_ptr<PacketLogFilter const>(std::move(filter)));
 }
 
-void PacketLog::LogPacket(WorldPacket const& packet, Direction direction, boost::asio::ip::address const& addr, uint16 port)
+void PacketLog::LogPacket(WorldPacket const& packet, Direction direction, boost::asio::ip::address const& addr, uint16 port, uint32 accountId, uint32 mapId)
 {
-    std::lock_guard<std::mutex> lock(_logPacketLock);
+    std::shared_ptr<PacketLogFilter const> filter = std::atomic_load(&_filter);
+    if (filter && !filter->Matches(packet.GetOpcode(), addr, accountId, mapId))
+        return;
 
     PacketHeader header;
     header.Direction = direction == CLIENT_TO_SERVER ? 0x47534d43 : 0x47534d53;
@@ -132,9 +277,125 @@ void PacketLog::LogPacket(WorldPacket const& packet, Direction direction, boost:
     header.Length = packet.size() + sizeof(header.Opcode);
     header.Opcode = packet.GetOpcode();
 
+    if (GetThreadRing()->Write(header, packet.contents(), packet.size()))
+        _loggedPackets.fetch_add(1, std::memory_order_relaxed);
+    else
+        _droppedPackets.fetch_add(1, std::memory_order_relaxed);
+}
+
+PacketLog::Stats PacketLog::ConsumeStats()
+{
+    Stats stats;
+    stats.LoggedPackets = _loggedPackets.exchange(0, std::memory_order_relaxed);
+    stats.DroppedPackets = _droppedPackets.exchange(0, std::memory_order_relaxed);
+    return stats;
+}
+
+PacketLogRing* PacketLog::GetThreadRing()
+{
+    if (!ThreadRing)
+    {
+        ThreadRing = std::make_shared<PacketLogRing>(_ringSize);
+
+        std::lock_guard<std::mutex> lock(_ringsLock);
+        _rings.push_back(ThreadRing);
+    }
+
+    return ThreadRing.get();
+}
+
+void PacketLog::WriterThread()
+{
+    std::unique_lock<std::mutex> lock(_writerLock);
+    while (!_stopWriter)
+    {
+        _writerCondition.wait_for(lock, std::chrono::milliseconds(10));
+
+        lock.unlock();
+        Drain();
+        lock.lock();
+    }
+
+    lock.unlock();
+    Drain();
+}
+
+void PacketLog::Drain()
+{
+    std::lock_guard<std::mutex> lock(_ringsLock);
+
+    bool written = false;
+    for (auto itr = _rings.begin(); itr != _rings.end();)
+    {
+        if (_maxFileSize && _fileSize >= _maxFileSize)
+            RotateFiles();
+
+        std::size_t size = (*itr)->Drain(_file);
+        _fileSize += size;
+        written = written || size;
+
+        // thread exited and everything it logged is written
+        if (itr->use_count() == 1 && (*itr)->IsEmpty())
+            itr = _rings.erase(itr);
+        else
+            ++itr;
+    }
+
+    if (written && _file)
+        fflush(_file);
+}
+
+bool PacketLog::OpenFile()
+{
+    _file = fopen(_fileName.c_str(), "wb");
+    if (!_file)
+        return false;
+
+    LogHeader header;
+    header.Signature[0] = 'P'; header.Signature[1] = 'K'; header.Signature[2] = 'T';
+    header.FormatVersion = 0x0301;
+    header.SnifferId = 'T';
+    header.Build = 15595;
+    header.Locale[0] = 'e'; header.Locale[1] = 'n'; header.Locale[2] = 'U'; header.Locale[3] = 'S';
+    std::memset(header.SessionKey, 0, sizeof(header.SessionKey));
+    header.SniffStartUnixtime = GameTime::GetGameTime();
+    header.SniffStartTicks = getMSTime();
+    header.OptionalDataSize = 0;
+
     fwrite(&header, sizeof(header), 1, _file);
-    if (!packet.empty())
-        fwrite(packet.contents(), 1, packet.size(), _file);
+    _fileSize = sizeof(header);
+    return true;
+}
+
+void PacketLog::RotateFiles()
+{
+    if (_file)
+        fclose(_file);
+
+    // World.pkt -> World.1.pkt -> World.2.pkt ..., the oldest one is removed
+    auto getRotatedName = [this](uint32 index)
+    {
+        std::size_t extension = _fileName.find_last_of('.');
+        std::size_t directory = _fileName.find_last_of("/\\");
+        if (extension == std::string::npos || (directory != std::string::npos && extension < directory))
+            return _fileName + '.' + std::to_string(index);
 
-    fflush(_file);
+        return _fileName.substr(0, extension) + '.' + std::to_string(index) + _fileName.substr(extension);
+    };
+
+    if (_maxFiles > 1)
+    {
+        std::remove(getRotatedName(_maxFiles - 1).c_str());
+        for (uint32 i = _maxFiles - 1; i > 1; --i)
+            std::rename(getRotatedName(i - 1).c_str(), getRotatedName(i).c_str());
+
+        std::rename(_fileName.c_str(), getRotatedName(1).c_str());
+    }
+
+    // packets are discarded when no file can be opened
+    if (!OpenFile())
+    {
+        TC_LOG_ERROR("network", "PacketLog: could not open %s after rotation, packets will not be written anymore.", _fileName.c_str());
+        _fileSize = 0;
+    }
 }
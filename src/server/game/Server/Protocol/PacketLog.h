@@ -21,7 +21,13 @@
 #include "Common.h"
 
 #include <boost/asio/ip/address.hpp>
+#include <atomic>
+#include <condition_variable>
+#include <memory>
 #include <mutex>
+#include <thread>
+#include <unordered_set>
+#include <vector>
 
 enum Direction
 {
@@ -30,24 +36,74 @@ enum Direction
 };
 
 class WorldPacket;
+class PacketLogRing;
 
+// Packets are only logged when every non empty list contains the packet's value
+struct PacketLogFilter
+{
+    std::unordered_set<uint32> Accounts;
+    std::vector<boost::asio::ip::address> Addresses;
+    std::unordered_set<uint32> Opcodes;
+    std::unordered_set<uint32> Maps;
+
+    bool Matches(uint32 opcode, boost::asio::ip::address const& addr, uint32 accountId, uint32 mapId) const;
+};
+
+// Packets are copied into a ring owned by the logging thread and written to disk by a background thread,
+// a full ring drops packets instead of stalling network or map threads
 class TC_GAME_API PacketLog
 {
     private:
         PacketLog();
         ~PacketLog();
-        std::mutex _logPacketLock;
         std::once_flag _initializeFlag;
 
     public:
+        struct Stats
+        {
+            uint64 LoggedPackets = 0;
+            uint64 DroppedPackets = 0;
+        };
+
         static PacketLog* instance();
 
         void Initialize();
-        bool CanLogPacket() const { return (_file != nullptr); }
-        void LogPacket(WorldPacket const& packet, Direction direction, boost::asio::ip::address const& addr, uint16 port);
+        // filters can be changed by a config reload, file settings only on restart
+        void LoadFilterFromConfig();
+        bool CanLogPacket() const { return _enabled; }
+        // accountId is 0 before authentication and mapId MAPID_INVALID while not in world
+        void LogPacket(WorldPacket const& packet, Direction direction, boost::asio::ip::address const& addr, uint16 port, uint32 accountId, uint32 mapId);
+
+        static Stats ConsumeStats();
 
     private:
+        PacketLogRing* GetThreadRing();
+        void WriterThread();
+        void Drain();
+        bool OpenFile();
+        void RotateFiles();
+
+        bool _enabled;
+
+        std::shared_ptr<PacketLogFilter const> _filter;     // only accessed through std::atomic_load/atomic_store
+
+        std::vector<std::shared_ptr<PacketLogRing>> _rings;
+        std::mutex _ringsLock;
+        std::size_t _ringSize;
+
+        std::thread _writerThread;
+        std::mutex _writerLock;
+        std::condition_variable _writerCondition;
+        bool _stopWriter;
+
+        std::string _fileName;
         FILE* _file;
+        uint64 _fileSize;
+        uint64 _maxFileSize;
+        uint32 _maxFiles;
+
+        static std::atomic<uint64> _loggedPackets;
+        static std::atomic<uint64> _droppedPackets;
 };
 
 #define sPacketLog PacketLog::instance()
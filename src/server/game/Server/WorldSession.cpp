@@ -51,6 +51,7 @@
 #include "Vehicle.h"
 #include "WardenMac.h"
 #include "WardenWin.h"
+#include "WhoListStorage.h"
 #include "World.h"
 #include "WorldPacket.h"
 #include "WorldSocket.h"
@@ -60,6 +61,18 @@ namespace {
 
 std::string const DefaultPlayerName = "<none>";
 
+// memory held by a queued packet, empty packets are not free either
+std::size_t GetReceivedPacketSize(WorldPacket const* packet)
+{
+    return sizeof(WorldPacket) + packet->size();
+}
+
+// accepts only heartbeats, queued right behind another heartbeat they make it obsolete
+struct HeartbeatFilter
+{
+    bool Process(WorldPacket* packet) const { return packet->GetOpcode() == MSG_MOVE_HEARTBEAT; }
+};
+
 } // namespace
 
 bool MapSessionFilter::Process(WorldPacket* packet)
@@ -135,6 +148,8 @@ WorldSession::WorldSession(uint32 id, std::string&& name, uint32 battlenetAccoun
     expireTime(60000), // 1 min after socket loss, session is deleted
     forceExit(false),
     m_currentBankerGUID(),
+    _recvQueueSize(0),
+    _transferPending(false),
     _timeSyncClockDeltaQueue(6),
     _timeSyncClockDelta(0),
     _pendingTimeSyncRequests(),
@@ -218,18 +233,18 @@ ObjectGuid::LowType WorldSession::GetGUIDLow() const
     return GetPlayer() ? GetPlayer()->GetGUID().GetCounter() : 0;
 }
 
-/// Send a packet to the client
-void WorldSession::SendPacket(WorldPacket const* packet, bool forced /*= false*/)
+/// Checks and accounts a packet about to be sent, returns the connection to send it on
+bool WorldSession::PrepareSendPacket(WorldPacket const* packet, bool forced, ConnectionType& conIdx)
 {
     if (packet->GetOpcode() == NULL_OPCODE)
     {
         TC_LOG_ERROR("network.opcode", "Prevented sending of NULL_OPCODE to %s", GetPlayerInfo().c_str());
-        return;
+        return false;
     }
     else if (packet->GetOpcode() == UNKNOWN_OPCODE)
     {
         TC_LOG_ERROR("network.opcode", "Prevented sending of UNKNOWN_OPCODE to %s", GetPlayerInfo().c_str());
-        return;
+        return false;
     }
 
     ServerOpcodeHandler const* handler = opcodeTable[static_cast<OpcodeServer>(packet->GetOpcode())];
@@ -237,11 +252,11 @@ void WorldSession::SendPacket(WorldPacket const* packet, bool forced /*= false*/
     if (!handler)
     {
         TC_LOG_ERROR("network.opcode", "Prevented sending of opcode %u with non existing handler to %s", packet->GetOpcode(), GetPlayerInfo().c_str());
-        return;
+        return false;
     }
 
     // Default connection index defined in Opcodes.cpp table
-    ConnectionType conIdx = handler->ConnectionIndex;
+    conIdx = handler->ConnectionIndex;
 
     // Override connection index
     if (packet->GetConnection() != CONNECTION_TYPE_DEFAULT)
@@ -249,7 +264,7 @@ void WorldSession::SendPacket(WorldPacket const* packet, bool forced /*= false*/
         if (packet->GetConnection() != CONNECTION_TYPE_INSTANCE && IsInstanceOnlyOpcode(packet->GetOpcode()))
         {
             TC_LOG_ERROR("network.opcode", "Prevented sending of instance only opcode %u with connection type %u to %s", packet->GetOpcode(), uint32(packet->GetConnection()), GetPlayerInfo().c_str());
-            return;
+            return false;
         }
 
         conIdx = packet->GetConnection();
@@ -258,7 +273,7 @@ void WorldSession::SendPacket(WorldPacket const* packet, bool forced /*= false*/
     if (!m_Socket[conIdx])
     {
         TC_LOG_ERROR("network.opcode", "Prevented sending of %s to non existent socket %u to %s", GetOpcodeNameForLogging(static_cast<OpcodeServer>(packet->GetOpcode())).c_str(), uint32(conIdx), GetPlayerInfo().c_str());
-        return;
+        return false;
     }
 
     if (!forced)
@@ -267,7 +282,7 @@ void WorldSession::SendPacket(WorldPacket const* packet, bool forced /*= false*/
         if (!handler || handler->Status == STATUS_UNHANDLED)
         {
             TC_LOG_ERROR("network.opcode", "Prevented sending disabled opcode %s to %s", GetOpcodeNameForLogging(static_cast<OpcodeServer>(packet->GetOpcode())).c_str(), GetPlayerInfo().c_str());
-            return;
+            return false;
         }
     }
 
@@ -308,15 +323,38 @@ void WorldSession::SendPacket(WorldPacket const* packet, bool forced /*= false*/
     sScriptMgr->OnPacketSend(this, *packet);
 
     TC_LOG_TRACE("network.opcode", "S->C: %s %s", GetPlayerInfo().c_str(), GetOpcodeNameForLogging(static_cast<OpcodeServer>(packet->GetOpcode())).c_str());
-    m_Socket[conIdx]->SendPacket(*packet);
+    return true;
+}
+
+/// Send a packet to the client
+void WorldSession::SendPacket(WorldPacket const* packet, bool forced /*= false*/)
+{
+    ConnectionType conIdx;
+    if (PrepareSendPacket(packet, forced, conIdx))
+        m_Socket[conIdx]->SendPacket(*packet);
+}
+
+/// Send a packet to the client without copying it, the same packet may be sent to many sessions
+void WorldSession::SendPacket(std::shared_ptr<WorldPacket const> const& packet)
+{
+    ConnectionType conIdx;
+    if (PrepareSendPacket(packet.get(), false, conIdx))
+        m_Socket[conIdx]->SendPacket(packet);
 }
 
 /// Add an incoming packet to the queue
 void WorldSession::QueuePacket(WorldPacket* new_packet)
 {
+    _recvQueueSize += GetReceivedPacketSize(new_packet);
     _recvQueue.add(new_packet);
 }
 
+bool WorldSession::IsReceiveQueueFull() const
+{
+    uint32 limit = sWorld->getIntConfig(CONFIG_SESSION_RECV_QUEUE_LIMIT);
+    return limit && !_transferPending.load(std::memory_order_relaxed) && _recvQueueSize.load(std::memory_order_relaxed) >= limit;
+}
+
 /// Logging helper for unexpected opcodes
 void WorldSession::LogUnexpectedOpcode(WorldPacket* packet, char const* status, const char *reason)
 {
@@ -346,6 +384,15 @@ bool WorldSession::Update(uint32 diff, PacketFilter& updater)
     if (IsConnectionIdle() && !HasPermission(rbac::RBAC_PERM_IGNORE_IDLE_CONNECTION))
         m_Socket[CONNECTION_TYPE_REALM]->CloseSocket();
 
+    // sockets can't look at the player to apply packet log map filters
+    if (sPacketLog->CanLogPacket())
+    {
+        uint32 mapId = _player && _player->IsInWorld() ? _player->GetMapId() : MAPID_INVALID;
+        for (std::shared_ptr<WorldSocket> const& socket : m_Socket)
+            if (socket)
+                socket->SetPacketLogMapId(mapId);
+    }
+
     ///- Retrieve packets from the receive queue and call the appropriate handlers
     /// not process packets if socket already closed
     WorldPacket* packet = nullptr;
@@ -353,12 +400,30 @@ bool WorldSession::Update(uint32 diff, PacketFilter& updater)
     bool deletePacket = true;
     std::vector<WorldPacket*> requeuePackets;
     uint32 processedPackets = 0;
+    std::size_t processedBytes = 0;
     time_t currentTime = GameTime::GetGameTime();
 
-    constexpr uint32 MAX_PROCESSED_PACKETS_IN_SAME_WORLDSESSION_UPDATE = 100;
+    // budgets keep a flooding client from stretching the update of everyone sharing its thread
+    uint32 const MAX_PROCESSED_PACKETS_IN_SAME_WORLDSESSION_UPDATE = sWorld->getIntConfig(CONFIG_SESSION_PACKET_BUDGET);
+    std::size_t const maxProcessedBytes = sWorld->getIntConfig(CONFIG_SESSION_BYTE_BUDGET);
 
     while (m_Socket[CONNECTION_TYPE_REALM] && _recvQueue.next(packet, updater))
     {
+        // client is ahead of us, only its latest position matters
+        if (packet->GetOpcode() == MSG_MOVE_HEARTBEAT && _player && _gameClient->HasSingleAllowedMover())
+        {
+            HeartbeatFilter heartbeatFilter;
+            WorldPacket* newerHeartbeat;
+            while (_recvQueue.next(newerHeartbeat, heartbeatFilter))
+            {
+                _recvQueueSize -= GetReceivedPacketSize(packet);
+                delete packet;
+                packet = newerHeartbeat;
+            }
+        }
+
+        std::size_t packetSize = GetReceivedPacketSize(packet);
+
         ClientOpcodeHandler const* opHandle = opcodeTable[static_cast<OpcodeClient>(packet->GetOpcode())];
         try
         {
@@ -457,15 +522,19 @@ bool WorldSession::Update(uint32 diff, PacketFilter& updater)
         }
 
         if (deletePacket)
+        {
+            _recvQueueSize -= packetSize;
             delete packet;
+        }
 
         deletePacket = true;
 
         processedPackets++;
+        processedBytes += packetSize;
 
         //process only a max amout of packets in 1 Update() call.
         //Any leftover will be processed in next update
-        if (processedPackets > MAX_PROCESSED_PACKETS_IN_SAME_WORLDSESSION_UPDATE)
+        if (processedPackets > MAX_PROCESSED_PACKETS_IN_SAME_WORLDSESSION_UPDATE || processedBytes > maxProcessedBytes)
             break;
     }
 
@@ -1126,6 +1195,15 @@ void WorldSession::HandleAddonRegisteredPrefixesOpcode(WorldPacket& recvPacket)
     _filterAddonMessages = true;
 }
 
+void WorldSession::SetSecurity(AccountTypes security)
+{
+    _security = security;
+
+    // who list entries keep the security level for gm visibility
+    if (_player)
+        sWhoListStorageMgr->MarkDirty(_player->GetGUID());
+}
+
 void WorldSession::SetPlayer(Player* player)
 {
     _player = player;
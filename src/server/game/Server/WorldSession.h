@@ -458,6 +458,7 @@ class TC_GAME_API WorldSession
         void SendAddonsInfo();
         bool IsAddonRegistered(const std::string& prefix) const;
         void SendPacket(WorldPacket const* packet, bool forced = false);
+        void SendPacket(std::shared_ptr<WorldPacket const> const& packet);
         void AddInstanceConnection(std::shared_ptr<WorldSocket> sock) { m_Socket[1] = sock; }
 
         void SendNotification(const char *format, ...) ATTR_PRINTF(2, 3);
@@ -489,7 +490,7 @@ class TC_GAME_API WorldSession
         std::string GetPlayerInfo() const;
 
         ObjectGuid::LowType GetGUIDLow() const;
-        void SetSecurity(AccountTypes security) { _security = security; }
+        void SetSecurity(AccountTypes security);
         std::string const& GetRemoteAddress() const { return m_Address; }
         void SetPlayer(Player* player);
         uint8 GetAccountExpansion() const { return m_accountExpansion; }
@@ -520,6 +521,10 @@ class TC_GAME_API WorldSession
 
         void QueuePacket(WorldPacket* new_packet);
         bool Update(uint32 diff, PacketFilter& updater);
+        // received packets hold more memory than Network.SessionReceiveQueueLimit, sockets stop reading
+        // never while a far teleport waits for MSG_MOVE_WORLDPORT_ACK, the queued packets can't be processed before it
+        bool IsReceiveQueueFull() const;
+        void SetTransferPending(bool pending) { _transferPending = pending; }
 
         /// Handle the authentication waiting queue (to be completed)
         void SendAuthWaitQue(uint32 position);
@@ -1313,6 +1318,8 @@ class TC_GAME_API WorldSession
 
         bool CanUseBank(ObjectGuid bankerGUID = ObjectGuid::Empty) const;
 
+        bool PrepareSendPacket(WorldPacket const* packet, bool forced, ConnectionType& conIdx);
+
         // logging helper
         void LogUnexpectedOpcode(WorldPacket* packet, char const* status, const char *reason);
 
@@ -1383,6 +1390,8 @@ class TC_GAME_API WorldSession
         uint32 recruiterId;
         bool isRecruiter;
         LockedQueue<WorldPacket*> _recvQueue;
+        std::atomic<std::size_t> _recvQueueSize;
+        std::atomic<bool> _transferPending;
         rbac::RBACData* _RBACData;
         uint32 expireTime;
         bool forceExit;
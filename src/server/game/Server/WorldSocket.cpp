@@ -42,8 +42,8 @@ std::string const WorldSocket::ClientConnectionInitialize("WORLD OF WARCRAFT CON
 
 WorldSocket::WorldSocket(tcp::socket&& socket) : Socket(std::move(socket)),
     _type(CONNECTION_TYPE_REALM), _authSeed(rand32()), _OverSpeedPings(0), _worldSession(nullptr),
-    _authed(false), _compressionStream(nullptr), _sendBufferSize(4096),
-    _initialized(false)
+    _authed(false), _packetLogAccountId(0), _packetLogMapId(MAPID_INVALID), _compressionStream(nullptr), _sendBufferSize(4096),
+    _initialized(false), _readPaused(false)
 {
     _headerBuffer.Resize(2);
 }
@@ -105,31 +105,32 @@ bool WorldSocket::Update()
     MessageBuffer buffer(_sendBufferSize);
     while (_bufferQueue.Dequeue(queued))
     {
-        if (queued->size() > 0x400 && !queued->IsCompressed())
-            queued->Compress(_compressionStream);
+        if (queued->GetPayload().size() > 0x400 && !queued->GetPayload().IsCompressed())
+            queued->CompressPayload(_compressionStream);
 
-        ServerPktHeader header(queued->size() + 2, queued->GetOpcode());
+        WorldPacket const& payload = queued->GetPayload();
+        ServerPktHeader header(payload.size() + 2, payload.GetOpcode());
         if (queued->NeedsEncryption())
             _authCrypt.EncryptSend(header.header, header.getHeaderLength());
 
-        if (buffer.GetRemainingSpace() < queued->size() + header.getHeaderLength())
+        if (buffer.GetRemainingSpace() < payload.size() + header.getHeaderLength())
         {
             QueuePacket(std::move(buffer));
             buffer.Resize(_sendBufferSize);
         }
 
-        if (buffer.GetRemainingSpace() >= queued->size() + header.getHeaderLength())
+        if (buffer.GetRemainingSpace() >= payload.size() + header.getHeaderLength())
         {
             buffer.Write(header.header, header.getHeaderLength());
-            if (!queued->empty())
-                buffer.Write(queued->contents(), queued->size());
+            if (!payload.empty())
+                buffer.Write(payload.contents(), payload.size());
         }
         else    // single packet larger than 4096 bytes
         {
-            MessageBuffer packetBuffer(queued->size() + header.getHeaderLength());
+            MessageBuffer packetBuffer(payload.size() + header.getHeaderLength());
             packetBuffer.Write(header.header, header.getHeaderLength());
-            if (!queued->empty())
-                packetBuffer.Write(queued->contents(), queued->size());
+            if (!payload.empty())
+                packetBuffer.Write(payload.contents(), payload.size());
 
             QueuePacket(std::move(packetBuffer));
         }
@@ -143,6 +144,12 @@ bool WorldSocket::Update()
     if (!BaseSocket::Update())
         return false;
 
+    if (_readPaused && !IsReceiveQueueFull())
+    {
+        _readPaused = false;
+        AsyncRead();
+    }
+
     _queryProcessor.ProcessReadyCallbacks();
 
     return true;
@@ -228,14 +235,28 @@ void WorldSocket::ReadHandler()
         }
     }
 
+    // stop reading while the session is behind, tcp flow control slows the client down
+    if (IsReceiveQueueFull())
+    {
+        _readPaused = true;
+        return;
+    }
+
     AsyncRead();
 }
 
+bool WorldSocket::IsReceiveQueueFull()
+{
+    std::lock_guard<std::mutex> sessionGuard(_worldSessionLock);
+    return _worldSession && _worldSession->IsReceiveQueueFull();
+}
+
 void WorldSocket::SetWorldSession(WorldSession* session)
 {
     std::lock_guard<std::mutex> sessionGuard(_worldSessionLock);
     _worldSession = session;
     _authed = true;
+    _packetLogAccountId.store(session->GetAccountId(), std::memory_order_relaxed);
 }
 
 bool WorldSocket::ReadHeaderHandler()
@@ -337,7 +358,7 @@ WorldSocket::ReadDataHandlerResult WorldSocket::ReadDataHandler()
         WorldPacket* packetToQueue;
 
         if (sPacketLog->CanLogPacket())
-            sPacketLog->LogPacket(packet, CLIENT_TO_SERVER, GetRemoteIpAddress(), GetRemotePort());
+            LogPacket(packet, CLIENT_TO_SERVER);
 
         std::unique_lock<std::mutex> sessionGuard(_worldSessionLock, std::defer_lock);
 
@@ -519,11 +540,28 @@ void WorldSocket::SendPacket(WorldPacket const& packet)
         return;
 
     if (sPacketLog->CanLogPacket())
-        sPacketLog->LogPacket(packet, SERVER_TO_CLIENT, GetRemoteIpAddress(), GetRemotePort());
+        LogPacket(packet, SERVER_TO_CLIENT);
 
     _bufferQueue.Enqueue(new EncryptablePacket(packet, _authCrypt.IsInitialized()));
 }
 
+void WorldSocket::SendPacket(std::shared_ptr<WorldPacket const> packet)
+{
+    if (!IsOpen())
+        return;
+
+    if (sPacketLog->CanLogPacket())
+        LogPacket(*packet, SERVER_TO_CLIENT);
+
+    _bufferQueue.Enqueue(new EncryptablePacket(std::move(packet), _authCrypt.IsInitialized()));
+}
+
+void WorldSocket::LogPacket(WorldPacket const& packet, Direction direction)
+{
+    sPacketLog->LogPacket(packet, direction, GetRemoteIpAddress(), GetRemotePort(),
+        _packetLogAccountId.load(std::memory_order_relaxed), _packetLogMapId.load(std::memory_order_relaxed));
+}
+
 void WorldSocket::HandleAuthSession(std::shared_ptr<WorldPackets::Auth::AuthSession> authSession)
 {
     // Get the account information from the auth database
@@ -682,6 +720,7 @@ void WorldSocket::HandleAuthSessionCallback(std::shared_ptr<WorldPackets::Auth::
     sScriptMgr->OnAccountLogin(account.Game.Id);
 
     _authed = true;
+    _packetLogAccountId.store(account.Game.Id, std::memory_order_relaxed);
     _worldSession = new WorldSession(account.Game.Id, std::move(authSession->Account), account.BattleNet.Id, shared_from_this(), account.Game.Security,
         account.Game.Expansion, mutetime, account.BattleNet.Locale, account.Game.Recruiter, account.Game.IsRecruiter);
     _worldSession->ReadAddonsInfo(authSession->AddonInfo);
@@ -28,7 +28,10 @@
 #include "WorldPacket.h"
 #include "WorldSession.h"
 #include "MPSCQueue.h"
+#include "PacketLog.h"
+#include <atomic>
 #include <chrono>
+#include <memory>
 #include <boost/asio/ip/tcp.hpp>
 
 using boost::asio::ip::tcp;
@@ -40,11 +43,34 @@ public:
         SocketQueueLink.store(nullptr, std::memory_order_relaxed);
     }
 
+    // payload is not copied, it is shared with every other socket it was sent to
+    EncryptablePacket(std::shared_ptr<WorldPacket const> packet, bool encrypt) : WorldPacket(packet->GetOpcode(), 0), _shared(std::move(packet)), _encrypt(encrypt)
+    {
+        SocketQueueLink.store(nullptr, std::memory_order_relaxed);
+    }
+
     bool NeedsEncryption() const { return _encrypt; }
 
+    WorldPacket const& GetPayload() const { return _shared ? *_shared : *this; }
+
+    // compression state is per socket, a shared payload is compressed into own storage
+    void CompressPayload(z_stream_s* compressionStream)
+    {
+        if (!_shared)
+        {
+            Compress(compressionStream);
+            return;
+        }
+
+        Compress(compressionStream, _shared.get());
+        if (IsCompressed())
+            _shared.reset();
+    }
+
     std::atomic<EncryptablePacket*> SocketQueueLink;
 
 private:
+    std::shared_ptr<WorldPacket const> _shared;
     bool _encrypt;
 };
 
@@ -95,12 +121,15 @@ public:
     bool Update() override;
 
     void SendPacket(WorldPacket const& packet);
+    void SendPacket(std::shared_ptr<WorldPacket const> packet);
     void SetSendBufferSize(std::size_t sendBufferSize) { _sendBufferSize = sendBufferSize; }
 
     ConnectionType GetConnectionType() const { return _type; }
 
     void SendAuthResponseError(uint8 code);
     void SetWorldSession(WorldSession* session);
+    // only kept up to date while packets are logged, see PacketLog.Filter.Maps
+    void SetPacketLogMapId(uint32 mapId) { _packetLogMapId.store(mapId, std::memory_order_relaxed); }
 
 protected:
     void OnClose() override;
@@ -118,12 +147,14 @@ protected:
 
 private:
     void CheckIpCallback(PreparedQueryResult result);
+    bool IsReceiveQueueFull();
 
     /// writes network.opcode log
     /// accessing WorldSession is not threadsafe, only do it when holding _worldSessionLock
     void LogOpcodeText(OpcodeClient opcode, std::unique_lock<std::mutex> const& guard) const;
     /// sends and logs network.opcode without accessing WorldSession
     void SendPacketAndLogOpcode(WorldPacket const& packet);
+    void LogPacket(WorldPacket const& packet, Direction direction);
     void HandleSendAuthSession();
     void HandleAuthSession(std::shared_ptr<WorldPackets::Auth::AuthSession> authSession);
     void HandleAuthSessionCallback(std::shared_ptr<WorldPackets::Auth::AuthSession> authSession, PreparedQueryResult result);
@@ -147,6 +178,10 @@ private:
     WorldSession* _worldSession;
     bool _authed;
 
+    // read by packet logging without holding _worldSessionLock
+    std::atomic<uint32> _packetLogAccountId;
+    std::atomic<uint32> _packetLogMapId;
+
     MessageBuffer _headerBuffer;
     MessageBuffer _packetBuffer;
 
@@ -156,6 +191,7 @@ private:
     std::size_t _sendBufferSize;
 
     bool _initialized;
+    bool _readPaused;           // session has too many packets waiting, reading resumes in Update
 
     QueryCallbackProcessor _queryProcessor;
     std::string _ipCountry;
@@ -0,0 +1,84 @@
+/*
+ * This file is part of the TrinityCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "ProcAuraIndex.h"
+#include "SpellInfo.h"
+#include "SpellMgr.h"
+#include <algorithm>
+
+ProcEventFilter ProcAuraIndex::MakeFilter(uint32 typeMask, SpellInfo const* eventSpellInfo)
+{
+    ProcEventFilter filter;
+    filter.TypeMask = typeMask;
+
+    // these types trigger before the spell family is checked
+    if (eventSpellInfo && (typeMask & SPELL_PROC_FLAG_MASK) && !(typeMask & (PROC_FLAG_HEARTBEAT | PROC_FLAG_KILL | PROC_FLAG_DEATH)))
+    {
+        filter.CheckSpellFamily = true;
+        filter.SpellFamilyName = eventSpellInfo->SpellFamilyName;
+        filter.SpellFamilyFlags = eventSpellInfo->SpellFamilyFlags;
+    }
+
+    return filter;
+}
+
+void ProcAuraIndex::Insert(AuraApplication* aurApp, uint32 spellId, SpellProcEntry const& procEntry)
+{
+    auto itr = std::upper_bound(_entries.begin(), _entries.end(), spellId, [](uint32 id, Entry const& entry)
+    {
+        return id < entry.SpellId;
+    });
+
+    std::size_t position = std::size_t(itr - _entries.begin());
+    _entries.insert(itr, Entry{ aurApp, spellId, procEntry.ProcFlags, procEntry.SpellFamilyName, procEntry.SpellFamilyMask });
+    _procFlags |= procEntry.ProcFlags;
+
+    for (VisitCursor* cursor = _visits; cursor; cursor = cursor->Outer)
+        if (position < cursor->Next)
+            ++cursor->Next;
+}
+
+void ProcAuraIndex::Remove(AuraApplication* aurApp)
+{
+    auto itr = std::find_if(_entries.begin(), _entries.end(), [aurApp](Entry const& entry)
+    {
+        return entry.AurApp == aurApp;
+    });
+
+    if (itr == _entries.end())
+        return;
+
+    std::size_t position = std::size_t(itr - _entries.begin());
+    _entries.erase(itr);
+
+    for (VisitCursor* cursor = _visits; cursor; cursor = cursor->Outer)
+        if (position < cursor->Next)
+            --cursor->Next;
+
+    _procFlags = 0;
+    for (Entry const& entry : _entries)
+        _procFlags |= entry.ProcFlags;
+}
+
+void ProcAuraIndex::Clear()
+{
+    _entries.clear();
+    _procFlags = 0;
+
+    for (VisitCursor* cursor = _visits; cursor; cursor = cursor->Outer)
+        cursor->Next = 0;
+}
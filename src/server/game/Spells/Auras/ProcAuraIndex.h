@@ -0,0 +1,118 @@
+/*
+ * This file is part of the TrinityCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TRINITY_PROCAURAINDEX_H
+#define TRINITY_PROCAURAINDEX_H
+
+#include "Define.h"
+#include "Util.h"
+#include <vector>
+
+class AuraApplication;
+class SpellInfo;
+struct SpellProcEntry;
+
+// The parts of a proc event the index can check before asking the auras
+struct ProcEventFilter
+{
+    uint32 TypeMask = 0;
+    bool CheckSpellFamily = false;      // only where SpellMgr::CanSpellTriggerProcOnEvent checks it
+    uint32 SpellFamilyName = 0;
+    flag96 SpellFamilyFlags;
+};
+
+// Applied auras of a unit that have proc data, in the order of Unit::m_appliedAuras.
+// A proc event only asks the auras whose proc flags and spell family can match it, the others
+// would be rejected by SpellMgr::CanSpellTriggerProcOnEvent anyway.
+class TC_GAME_API ProcAuraIndex
+{
+    public:
+        ProcAuraIndex() : _procFlags(0), _version(0), _visits(nullptr) { }
+
+        ProcAuraIndex(ProcAuraIndex const&) = delete;
+        ProcAuraIndex& operator=(ProcAuraIndex const&) = delete;
+
+        static ProcEventFilter MakeFilter(uint32 typeMask, SpellInfo const* eventSpellInfo);
+
+        // after the auras with the same spell id, like std::multimap::insert
+        void Insert(AuraApplication* aurApp, uint32 spellId, SpellProcEntry const& procEntry);
+        void Remove(AuraApplication* aurApp);
+        void Clear();
+
+        bool empty() const { return _entries.empty(); }
+        std::size_t size() const { return _entries.size(); }
+        uint32 GetProcFlags() const { return _procFlags; }
+
+        // proc data the index was built with, see SpellMgr::GetSpellProcVersion
+        uint32 GetVersion() const { return _version; }
+        void SetVersion(uint32 version) { _version = version; }
+
+        // the visitor may apply and remove auras, like iterating Unit::m_appliedAuras entries
+        // added behind the current one are visited and removed ones are not
+        template<class Visitor>
+        void Visit(ProcEventFilter const& filter, Visitor&& visitor)
+        {
+            if (!(_procFlags & filter.TypeMask))
+                return;
+
+            VisitCursor cursor{ 0, _visits };
+            _visits = &cursor;
+            while (cursor.Next < _entries.size())
+            {
+                Entry const& entry = _entries[cursor.Next++];
+                if (Matches(entry, filter))
+                    visitor(entry.AurApp);
+            }
+            _visits = cursor.Outer;
+        }
+
+    private:
+        // position of a running visit, Insert and Remove keep it on the same entry
+        struct VisitCursor
+        {
+            std::size_t Next;
+            VisitCursor* Outer;
+        };
+
+        struct Entry
+        {
+            AuraApplication* AurApp;
+            uint32 SpellId;
+            uint32 ProcFlags;
+            uint32 SpellFamilyName;
+            flag96 SpellFamilyMask;
+        };
+
+        static bool Matches(Entry const& entry, ProcEventFilter const& filter)
+        {
+            if (!(entry.ProcFlags & filter.TypeMask))
+                return false;
+
+            // same as SpellInfo::IsAffected
+            if (!filter.CheckSpellFamily || !entry.SpellFamilyName)
+                return true;
+
+            return entry.SpellFamilyName == filter.SpellFamilyName && (!entry.SpellFamilyMask || (entry.SpellFamilyMask & filter.SpellFamilyFlags));
+        }
+
+        std::vector<Entry> _entries;
+        uint32 _procFlags;
+        uint32 _version;
+        VisitCursor* _visits;
+};
+
+#endif // TRINITY_PROCAURAINDEX_H
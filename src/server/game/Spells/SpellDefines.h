@@ -26,6 +26,18 @@
 class Item;
 class AuraEffect;
 
+#define SPELL_LINKED_MAX_SPELLS  200000
+
+enum SpellLinkedType
+{
+    SPELL_LINK_CAST     = 0,            // +: cast; -: remove
+    SPELL_LINK_HIT      = 1 * 200000,
+    SPELL_LINK_AURA     = 2 * 200000,   // +: aura; -: immune
+    SPELL_LINK_REMOVE   = 0
+};
+
+#define MAX_SPELL_LINK_TYPES 3
+
 enum class SpellInterruptFlags : uint32
 {
     None                        = 0,
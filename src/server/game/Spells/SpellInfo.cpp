@@ -1055,6 +1055,13 @@ SpellInfo::SpellInfo(SpellEntry const* spellEntry, SpellEffectEntry const** effe
 
     _allowedMechanicMask = 0;
     MaxAuraTargets = 0;
+
+    _procEntry = nullptr;
+    for (auto& linkedSpells : _linkedSpells)
+        linkedSpells[0] = linkedSpells[1] = nullptr;
+    _inSpellGroup = false;
+
+    _LoadEffectFacts();
 }
 
 SpellInfo::~SpellInfo()
@@ -1069,51 +1076,12 @@ uint32 SpellInfo::GetCategory() const
 
 bool SpellInfo::HasEffect(SpellEffects effect) const
 {
-    for (uint8 i = 0; i < MAX_SPELL_EFFECTS; ++i)
-        if (Effects[i].IsEffect(effect))
-            return true;
-    return false;
+    return uint32(effect) < TOTAL_SPELL_EFFECTS && _effectTypes.test(effect);
 }
 
 bool SpellInfo::HasAura(AuraType aura) const
 {
-    for (uint8 i = 0; i < MAX_SPELL_EFFECTS; ++i)
-        if (Effects[i].IsAura(aura))
-            return true;
-    return false;
-}
-
-bool SpellInfo::HasAreaAuraEffect() const
-{
-    for (uint8 i = 0; i < MAX_SPELL_EFFECTS; ++i)
-        if (Effects[i].IsAreaAuraEffect())
-            return true;
-    return false;
-}
-
-bool SpellInfo::HasOnlyDamageEffects() const
-{
-    for (uint8 i = 0; i < MAX_SPELL_EFFECTS; ++i)
-    {
-        if (Effects[i].IsEffect())
-        {
-            switch (Effects[i].Effect)
-            {
-                case SPELL_EFFECT_WEAPON_DAMAGE:
-                case SPELL_EFFECT_WEAPON_DAMAGE_NOSCHOOL:
-                case SPELL_EFFECT_NORMALIZED_WEAPON_DMG:
-                case SPELL_EFFECT_WEAPON_PERCENT_DAMAGE:
-                case SPELL_EFFECT_SCHOOL_DAMAGE:
-                case SPELL_EFFECT_ENVIRONMENTAL_DAMAGE:
-                case SPELL_EFFECT_HEALTH_LEECH:
-                    continue;
-                default:
-                    return false;
-            }
-        }
-    }
-
-    return true;
+    return uint32(aura) < TOTAL_AURAS && _auraTypes.test(aura);
 }
 
 bool SpellInfo::CanBeInterrupted(Unit* interruptTarget, bool ignoreImmunity /*= false*/) const
@@ -1231,22 +1199,7 @@ bool SpellInfo::IsAbilityOfSkillType(uint32 skillType) const
 
 bool SpellInfo::IsAffectingArea() const
 {
-    if (HasAttribute(SPELL_ATTR5_TREAT_AS_AREA_EFFECT))
-        return true;
-
-    for (uint8 i = 0; i < MAX_SPELL_EFFECTS; ++i)
-        if (Effects[i].IsEffect() && (Effects[i].IsTargetingArea() || Effects[i].IsEffect(SPELL_EFFECT_PERSISTENT_AREA_AURA) || Effects[i].IsAreaAuraEffect()))
-            return true;
-    return false;
-}
-
-// checks if spell targets are selected from area, doesn't include spell effects in check (like area wide auras for example)
-bool SpellInfo::IsTargetingArea() const
-{
-    for (uint8 i = 0; i < MAX_SPELL_EFFECTS; ++i)
-        if (Effects[i].IsEffect() && Effects[i].IsTargetingArea())
-            return true;
-    return false;
+    return HasAttribute(SPELL_ATTR5_TREAT_AS_AREA_EFFECT) || (_effectFacts & SPELL_EFFECT_FACT_AFFECTING_AREA);
 }
 
 bool SpellInfo::NeedsExplicitUnitTarget() const
@@ -1290,14 +1243,6 @@ bool SpellInfo::NeedsToBeTriggeredByCaster(SpellInfo const* triggeringSpell) con
     return false;
 }
 
-bool SpellInfo::IsSelfCast() const
-{
-    for (uint8 i = 0; i < MAX_SPELL_EFFECTS; ++i)
-        if (Effects[i].Effect && Effects[i].TargetA.GetTarget() != TARGET_UNIT_CASTER)
-            return false;
-    return true;
-}
-
 bool SpellInfo::IsPassive() const
 {
     return HasAttribute(SPELL_ATTR0_PASSIVE);
@@ -3778,6 +3723,54 @@ bool SpellInfo::IsHighRankOf(SpellInfo const* spellInfo) const
     return false;
 }
 
+void SpellInfo::_LoadEffectFacts()
+{
+    _effectTypes.reset();
+    _auraTypes.reset();
+    _effectFacts = SPELL_EFFECT_FACT_ONLY_DAMAGE | SPELL_EFFECT_FACT_SELF_CAST;
+
+    for (uint8 i = 0; i < MAX_SPELL_EFFECTS; ++i)
+    {
+        SpellEffectInfo const& effect = Effects[i];
+        if (effect.Effect < TOTAL_SPELL_EFFECTS)
+            _effectTypes.set(effect.Effect);
+
+        if (effect.IsAura() && effect.ApplyAuraName < TOTAL_AURAS)
+            _auraTypes.set(effect.ApplyAuraName);
+
+        if (effect.IsAreaAuraEffect())
+            _effectFacts |= SPELL_EFFECT_FACT_AREA_AURA;
+
+        if (!effect.IsEffect())
+            continue;
+
+        // checks if spell targets are selected from area, doesn't include spell effects in check (like area wide auras for example)
+        if (effect.IsTargetingArea())
+            _effectFacts |= SPELL_EFFECT_FACT_TARGETING_AREA;
+
+        if (effect.IsTargetingArea() || effect.IsEffect(SPELL_EFFECT_PERSISTENT_AREA_AURA) || effect.IsAreaAuraEffect())
+            _effectFacts |= SPELL_EFFECT_FACT_AFFECTING_AREA;
+
+        if (effect.TargetA.GetTarget() != TARGET_UNIT_CASTER)
+            _effectFacts &= ~SPELL_EFFECT_FACT_SELF_CAST;
+
+        switch (effect.Effect)
+        {
+            case SPELL_EFFECT_WEAPON_DAMAGE:
+            case SPELL_EFFECT_WEAPON_DAMAGE_NOSCHOOL:
+            case SPELL_EFFECT_NORMALIZED_WEAPON_DMG:
+            case SPELL_EFFECT_WEAPON_PERCENT_DAMAGE:
+            case SPELL_EFFECT_SCHOOL_DAMAGE:
+            case SPELL_EFFECT_ENVIRONMENTAL_DAMAGE:
+            case SPELL_EFFECT_HEALTH_LEECH:
+                break;
+            default:
+                _effectFacts &= ~SPELL_EFFECT_FACT_ONLY_DAMAGE;
+                break;
+        }
+    }
+}
+
 void SpellInfo::_InitializeExplicitTargetMask()
 {
     bool srcSet = false;
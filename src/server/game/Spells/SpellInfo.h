@@ -26,6 +26,7 @@
 #include "SpellDefines.h"
 
 #include <boost/container/flat_set.hpp>
+#include <bitset>
 
 class Unit;
 class Player;
@@ -37,6 +38,7 @@ struct SpellChainNode;
 struct SpellTargetPosition;
 struct SpellDurationEntry;
 struct SpellModifier;
+struct SpellProcEntry;
 struct SpellRangeEntry;
 struct SpellRadiusEntry;
 struct SpellEntry;
@@ -472,8 +474,8 @@ class TC_GAME_API SpellInfo
         uint32 GetCategory() const;
         bool HasEffect(SpellEffects effect) const;
         bool HasAura(AuraType aura) const;
-        bool HasAreaAuraEffect() const;
-        bool HasOnlyDamageEffects() const;
+        bool HasAreaAuraEffect() const { return (_effectFacts & SPELL_EFFECT_FACT_AREA_AURA) != 0; }
+        bool HasOnlyDamageEffects() const { return (_effectFacts & SPELL_EFFECT_FACT_ONLY_DAMAGE) != 0; }
 
         inline bool HasAttribute(SpellAttr0 attribute)  const { return !!(Attributes & attribute); }
         inline bool HasAttribute(SpellAttr1 attribute)  const { return !!(AttributesEx & attribute); }
@@ -508,10 +510,10 @@ class TC_GAME_API SpellInfo
         bool IsAbilityOfSkillType(uint32 skillType) const;
 
         bool IsAffectingArea() const;
-        bool IsTargetingArea() const;
+        bool IsTargetingArea() const { return (_effectFacts & SPELL_EFFECT_FACT_TARGETING_AREA) != 0; }
         bool NeedsExplicitUnitTarget() const;
         bool NeedsToBeTriggeredByCaster(SpellInfo const* triggeringSpell) const;
-        bool IsSelfCast() const;
+        bool IsSelfCast() const { return (_effectFacts & SPELL_EFFECT_FACT_SELF_CAST) != 0; }
 
         bool IsPassive() const;
         bool IsRaidMarker() const;
@@ -618,7 +620,23 @@ class TC_GAME_API SpellInfo
 
         bool IsRollingDurationOver() const;
 
+        // spell_proc data, nullptr if the spell has none
+        SpellProcEntry const* GetProcEntry() const { return _procEntry; }
+        // spell_linked_spell triggers, negative ones are removal (SPELL_LINK_CAST) and immunity (SPELL_LINK_AURA) triggers
+        std::vector<int32> const* GetLinkedSpells(SpellLinkedType type, bool negative = false) const { return _linkedSpells[type / SPELL_LINKED_MAX_SPELLS][negative ? 1 : 0]; }
+        // member of any spell_group, spells that are not never have group stack rules
+        bool IsInSpellGroup() const { return _inSpellGroup; }
+
     private:
+        enum SpellEffectFacts : uint8
+        {
+            SPELL_EFFECT_FACT_AREA_AURA         = 0x01,
+            SPELL_EFFECT_FACT_TARGETING_AREA    = 0x02,
+            SPELL_EFFECT_FACT_AFFECTING_AREA    = 0x04,     // without SPELL_ATTR5_TREAT_AS_AREA_EFFECT, which is checked as is
+            SPELL_EFFECT_FACT_ONLY_DAMAGE       = 0x08,
+            SPELL_EFFECT_FACT_SELF_CAST         = 0x10
+        };
+
         // loading helpers
         void _InitializeExplicitTargetMask();
         bool _IsPositiveEffect(uint8 effIndex, bool deep) const;
@@ -628,6 +646,7 @@ class TC_GAME_API SpellInfo
         void _LoadAuraState();
         void _LoadSpellDiminishInfo();
         void _LoadImmunityInfo();
+        void _LoadEffectFacts();
 
         // unloading helpers
         void _UnloadImplicitTargetConditionLists();
@@ -641,6 +660,16 @@ class TC_GAME_API SpellInfo
         uint32 _allowedMechanicMask;
 
         ImmunityInfo _immunityInfo[MAX_SPELL_EFFECTS];
+
+        // what the effects do, so the hot path queries don't walk them
+        std::bitset<TOTAL_SPELL_EFFECTS> _effectTypes;
+        std::bitset<TOTAL_AURAS> _auraTypes;
+        uint8 _effectFacts;
+
+        // set by the SpellMgr loaders of the tables
+        SpellProcEntry const* _procEntry;
+        std::vector<int32> const* _linkedSpells[MAX_SPELL_LINK_TYPES][2];
+        bool _inSpellGroup;
 };
 
 #endif // _SPELLINFO_H
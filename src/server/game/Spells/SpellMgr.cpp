@@ -55,7 +55,7 @@ bool IsPartOfSkillLine(uint32 skillId, uint32 spellId)
     return false;
 }
 
-SpellMgr::SpellMgr() { }
+SpellMgr::SpellMgr() : mSpellProcVersion(0) { }
 
 SpellMgr::~SpellMgr()
 {
@@ -441,8 +441,13 @@ SpellGroupStackRule SpellMgr::CheckSpellGroupStackRules(SpellInfo const* spellIn
     ASSERT(spellInfo1);
     ASSERT(spellInfo2);
 
-    uint32 spellid_1 = spellInfo1->GetFirstRankSpell()->Id;
-    uint32 spellid_2 = spellInfo2->GetFirstRankSpell()->Id;
+    SpellInfo const* firstRank1 = spellInfo1->GetFirstRankSpell();
+    SpellInfo const* firstRank2 = spellInfo2->GetFirstRankSpell();
+    if (!firstRank1->IsInSpellGroup() || !firstRank2->IsInSpellGroup())
+        return SPELL_GROUP_STACK_RULE_DEFAULT;
+
+    uint32 spellid_1 = firstRank1->Id;
+    uint32 spellid_2 = firstRank2->Id;
 
     // find SpellGroups which are common for both spells
     SpellSpellGroupMapBounds spellGroup1 = GetSpellSpellGroupMapBounds(spellid_1);
@@ -1335,6 +1340,10 @@ void SpellMgr::LoadSpellGroups()
     mSpellSpellGroup.clear();                                  // need for reload case
     mSpellGroupSpell.clear();
 
+    for (SpellInfo* spellInfo : mSpellInfoMap)
+        if (spellInfo)
+            spellInfo->_inSpellGroup = false;
+
     //                                                0     1
     QueryResult result = WorldDatabase.Query("SELECT id, spell_id FROM spell_group");
     if (!result)
@@ -1401,6 +1410,8 @@ void SpellMgr::LoadSpellGroups()
         {
             ++count;
             mSpellSpellGroup.emplace(*spellItr, SpellGroup(*groupItr));
+            if (SpellInfo* spellInfo = _GetSpellInfo(*spellItr))
+                spellInfo->_inSpellGroup = true;
         }
     }
 
@@ -1564,6 +1575,11 @@ void SpellMgr::LoadSpellProcs()
     uint32 oldMSTime = getMSTime();
 
     mSpellProcMap.clear();                             // need for reload case
+    ++mSpellProcVersion;
+
+    for (SpellInfo* spellInfo : mSpellInfoMap)
+        if (spellInfo)
+            spellInfo->_procEntry = nullptr;
 
     //                                                     0           1                2                 3                 4                 5
     QueryResult result = WorldDatabase.Query("SELECT SpellId, SchoolMask, SpellFamilyName, SpellFamilyMask0, SpellFamilyMask1, SpellFamilyMask2, "
@@ -1917,6 +1933,11 @@ void SpellMgr::LoadSpellProcs()
         ++count;
     }
 
+    // pointers to unordered_map values stay valid until the map is cleared by the next reload
+    for (auto const& pair : mSpellProcMap)
+        if (SpellInfo* spellInfo = _GetSpellInfo(pair.first))
+            spellInfo->_procEntry = &pair.second;
+
     TC_LOG_INFO("server.loading", ">> Generated spell proc data for %u spells in %u ms", count, GetMSTimeDiffToNow(oldMSTime));
 }
 
@@ -2128,6 +2149,11 @@ void SpellMgr::LoadSpellLinked()
 
     mSpellLinkedMap.clear();    // need for reload case
 
+    for (SpellInfo* spellInfo : mSpellInfoMap)
+        if (spellInfo)
+            for (auto& linkedSpells : spellInfo->_linkedSpells)
+                linkedSpells[0] = linkedSpells[1] = nullptr;
+
     //                                                0              1             2
     QueryResult result = WorldDatabase.Query("SELECT spell_trigger, spell_effect, type FROM spell_linked_spell");
     if (!result)
@@ -2178,6 +2204,13 @@ void SpellMgr::LoadSpellLinked()
         ++count;
     } while (result->NextRow());
 
+    for (auto const& pair : mSpellLinkedMap)
+    {
+        uint32 trigger = std::abs(pair.first);
+        if (SpellInfo* spellInfo = _GetSpellInfo(trigger % SPELL_LINKED_MAX_SPELLS))
+            spellInfo->_linkedSpells[trigger / SPELL_LINKED_MAX_SPELLS][pair.first < 0 ? 1 : 0] = &pair.second;
+    }
+
     TC_LOG_INFO("server.loading", ">> Loaded %u linked spells in %u ms", count, GetMSTimeDiffToNow(oldMSTime));
 }
 
@@ -6010,6 +6043,9 @@ void SpellMgr::LoadSpellInfoCorrections()
             } 
        }
 
+        // effects are final from here on
+        spellInfo->_LoadEffectFacts();
+
         // disable proc for magnet auras, they're handled differently
         if (spellInfo->HasAura(SPELL_AURA_SPELL_MAGNET))
             spellInfo->ProcFlags = 0;
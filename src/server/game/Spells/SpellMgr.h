@@ -25,6 +25,7 @@
 #include "Duration.h"
 #include "IteratorPair.h"
 #include "SharedDefines.h"
+#include "SpellDefines.h"
 #include "Util.h"
 
 #include <map>
@@ -94,16 +95,6 @@ enum SpellFamilyFlag
 };
 
 
-#define SPELL_LINKED_MAX_SPELLS  200000
-
-enum SpellLinkedType
-{
-    SPELL_LINK_CAST     = 0,            // +: cast; -: remove
-    SPELL_LINK_HIT      = 1 * 200000,
-    SPELL_LINK_AURA     = 2 * 200000,   // +: aura; -: immune
-    SPELL_LINK_REMOVE   = 0
-};
-
 
 // Spell proc event related declarations (accessed using SpellMgr functions)
 enum ProcFlags
@@ -659,6 +650,8 @@ class TC_GAME_API SpellMgr
 
         // Spell proc table
         SpellProcEntry const* GetSpellProcEntry(uint32 spellId) const;
+        // changes with every load of the table, proc data kept from an older one is stale
+        uint32 GetSpellProcVersion() const { return mSpellProcVersion; }
         static bool CanSpellTriggerProcOnEvent(SpellProcEntry const& procEntry, ProcEventInfo& eventInfo);
 
         // Spell bonus data table
@@ -747,6 +740,7 @@ class TC_GAME_API SpellMgr
         SpellGroupStackMap         mSpellGroupStack;
         SameEffectStackMap         mSpellSameEffectStack;
         SpellProcMap               mSpellProcMap;
+        uint32                     mSpellProcVersion;
         SpellBonusMap              mSpellBonusMap;
         SpellThreatMap             mSpellThreatMap;
         SpellPetAuraMap            mSpellPetAuraMap;
@@ -21,6 +21,16 @@
 #include "Player.h"
 #include "GuildMgr.h"
 #include "WorldSession.h"
+#include <algorithm>
+#include <tuple>
+
+namespace
+{
+    uint64 MakeTrigram(wchar_t const* str)
+    {
+        return (uint64(uint32(str[0]) & 0x1FFFFF) << 42) | (uint64(uint32(str[1]) & 0x1FFFFF) << 21) | uint64(uint32(str[2]) & 0x1FFFFF);
+    }
+}
 
 WhoListStorageMgr* WhoListStorageMgr::instance()
 {
@@ -30,32 +40,209 @@ WhoListStorageMgr* WhoListStorageMgr::instance()
 
 void WhoListStorageMgr::Update()
 {
-    // clear current list
-    _whoListStorage.clear();
-    _whoListStorage.reserve(sWorld->GetPlayerCount()+1);
+    GuidUnorderedSet dirty;
+    {
+        std::lock_guard<std::mutex> lock(_dirtyLock);
+        dirty.swap(_dirty);
+    }
 
-    HashMapHolder<Player>::MapType const& m = ObjectAccessor::GetPlayers();
-    for (HashMapHolder<Player>::MapType::const_iterator itr = m.begin(); itr != m.end(); ++itr)
+    for (ObjectGuid const& guid : dirty)
     {
-        if (!itr->second->FindMap() || itr->second->GetSession()->PlayerLoading())
+        Remove(guid);
+
+        Player* player = ObjectAccessor::FindConnectedPlayer(guid);
+        if (!player || !player->FindMap())
             continue;
 
-        std::string playerName = itr->second->GetName();
-        std::wstring widePlayerName;
-        if (!Utf8toWStr(playerName, widePlayerName))
+        // listed once done loading
+        if (player->GetSession()->PlayerLoading())
+        {
+            MarkDirty(guid);
             continue;
+        }
 
-        wstrToLower(widePlayerName);
+        Insert(player);
+    }
+}
 
-        std::string guildName = sGuildMgr->GetGuildNameById(itr->second->GetGuildId());
-        std::wstring wideGuildName;
-        if (!Utf8toWStr(guildName, wideGuildName))
-            continue;
+void WhoListStorageMgr::MarkDirty(ObjectGuid guid)
+{
+    std::lock_guard<std::mutex> lock(_dirtyLock);
+    _dirty.insert(guid);
+}
+
+void WhoListStorageMgr::GetCandidates(int32 minLevel, int32 maxLevel, int32 classFilter, int32 raceFilter, std::vector<int32> const& zones, std::wstring const& playerName,
+    WhoListInfoVector& candidates) const
+{
+    candidates.clear();
+
+    // count the players behind every filter, then only copy the smallest group
+    std::size_t const total = _whoListStorage.size();
 
-        wstrToLower(wideGuildName);
+    int32 const lowLevel = std::max(minLevel, 0);
+    int32 const highLevel = std::min(maxLevel, int32(STRONG_MAX_LEVEL));
 
-        _whoListStorage.emplace_back(itr->second->GetGUID(), itr->second->GetTeam(), itr->second->GetSession()->GetSecurity(), itr->second->getLevel(),
-            itr->second->getClass(), itr->second->getRace(), itr->second->GetZoneId(), itr->second->GetByteValue(PLAYER_BYTES_3, PLAYER_BYTES_3_OFFSET_GENDER), itr->second->IsVisible(),
-            widePlayerName, wideGuildName, playerName, guildName);
+    std::size_t levelCount = 0;
+    for (int32 level = lowLevel; level <= highLevel; ++level)
+        levelCount += _byLevel[level].size();
+
+    std::size_t classCount = total;
+    if (classFilter >= 0)
+    {
+        classCount = 0;
+        for (uint8 i = 0; i < MAX_CLASSES; ++i)
+            if (classFilter & (1 << i))
+                classCount += _byClass[i].size();
+    }
+
+    // races set in the filter are the ones left out, same as HandleWhoOpcode
+    std::size_t raceCount = total;
+    if (raceFilter >= 0)
+    {
+        raceCount = 0;
+        for (uint8 i = 0; i < MAX_RACES; ++i)
+            if (!(raceFilter & (1 << i)))
+                raceCount += _byRace[i].size();
+    }
+
+    std::vector<int32> uniqueZones(zones);
+    std::sort(uniqueZones.begin(), uniqueZones.end());
+    uniqueZones.erase(std::unique(uniqueZones.begin(), uniqueZones.end()), uniqueZones.end());
+
+    std::size_t zoneCount = total;
+    if (!uniqueZones.empty())
+    {
+        zoneCount = 0;
+        for (int32 zoneId : uniqueZones)
+        {
+            auto itr = _byZone.find(uint32(zoneId));
+            if (itr != _byZone.end())
+                zoneCount += itr->second.size();
+        }
+    }
+
+    // a name containing the request must contain each of its trigrams, the rarest one is enough
+    // shorter requests can't be narrowed down by name
+    WhoListInfoSet const* nameSet = nullptr;
+    std::size_t nameCount = total;
+    for (std::size_t i = 0; i + 3 <= playerName.length(); ++i)
+    {
+        auto itr = _byNameTrigram.find(MakeTrigram(&playerName[i]));
+        if (itr == _byNameTrigram.end())
+            return;
+
+        if (itr->second.size() < nameCount)
+        {
+            nameSet = &itr->second;
+            nameCount = nameSet->size();
+        }
     }
+
+    std::size_t const best = std::min({ levelCount, classCount, raceCount, zoneCount, nameCount });
+    candidates.reserve(best);
+
+    if (best == total)
+    {
+        for (auto const& pair : _whoListStorage)
+            candidates.push_back(&pair.second);
+    }
+    else if (best == nameCount)
+        candidates.assign(nameSet->begin(), nameSet->end());
+    else if (best == zoneCount)
+    {
+        for (int32 zoneId : uniqueZones)
+        {
+            auto itr = _byZone.find(uint32(zoneId));
+            if (itr != _byZone.end())
+                candidates.insert(candidates.end(), itr->second.begin(), itr->second.end());
+        }
+    }
+    else if (best == levelCount)
+    {
+        for (int32 level = lowLevel; level <= highLevel; ++level)
+            candidates.insert(candidates.end(), _byLevel[level].begin(), _byLevel[level].end());
+    }
+    else if (best == classCount)
+    {
+        for (uint8 i = 0; i < MAX_CLASSES; ++i)
+            if (classFilter & (1 << i))
+                candidates.insert(candidates.end(), _byClass[i].begin(), _byClass[i].end());
+    }
+    else
+    {
+        for (uint8 i = 0; i < MAX_RACES; ++i)
+            if (!(raceFilter & (1 << i)))
+                candidates.insert(candidates.end(), _byRace[i].begin(), _byRace[i].end());
+    }
+}
+
+void WhoListStorageMgr::Insert(Player const* player)
+{
+    // names are lowercased once here instead of on every who query
+    std::string playerName = player->GetName();
+    std::wstring widePlayerName;
+    if (!Utf8toWStr(playerName, widePlayerName))
+        return;
+
+    wstrToLower(widePlayerName);
+
+    std::string guildName = sGuildMgr->GetGuildNameById(player->GetGuildId());
+    std::wstring wideGuildName;
+    if (!Utf8toWStr(guildName, wideGuildName))
+        return;
+
+    wstrToLower(wideGuildName);
+
+    auto result = _whoListStorage.emplace(std::piecewise_construct, std::forward_as_tuple(player->GetGUID()), std::forward_as_tuple(player->GetGUID(), player->GetTeam(),
+        player->GetSession()->GetSecurity(), player->getLevel(), player->getClass(), player->getRace(), player->GetZoneId(),
+        player->GetByteValue(PLAYER_BYTES_3, PLAYER_BYTES_3_OFFSET_GENDER), player->IsVisible(), widePlayerName, wideGuildName, playerName, guildName));
+
+    WhoListPlayerInfo const* info = &result.first->second;
+    _byLevel[info->GetLevel()].insert(info);
+    if (info->GetClass() < MAX_CLASSES)
+        _byClass[info->GetClass()].insert(info);
+    if (info->GetRace() < MAX_RACES)
+        _byRace[info->GetRace()].insert(info);
+    _byZone[info->GetZoneId()].insert(info);
+
+    std::wstring const& name = info->GetWidePlayerName();
+    for (std::size_t i = 0; i + 3 <= name.length(); ++i)
+        _byNameTrigram[MakeTrigram(&name[i])].insert(info);
+}
+
+void WhoListStorageMgr::Remove(ObjectGuid guid)
+{
+    auto itr = _whoListStorage.find(guid);
+    if (itr == _whoListStorage.end())
+        return;
+
+    WhoListPlayerInfo const* info = &itr->second;
+    _byLevel[info->GetLevel()].erase(info);
+    if (info->GetClass() < MAX_CLASSES)
+        _byClass[info->GetClass()].erase(info);
+    if (info->GetRace() < MAX_RACES)
+        _byRace[info->GetRace()].erase(info);
+
+    auto zone = _byZone.find(info->GetZoneId());
+    if (zone != _byZone.end())
+    {
+        zone->second.erase(info);
+        if (zone->second.empty())
+            _byZone.erase(zone);
+    }
+
+    std::wstring const& name = info->GetWidePlayerName();
+    for (std::size_t i = 0; i + 3 <= name.length(); ++i)
+    {
+        // names can repeat a trigram, it is only in the index once
+        auto trigram = _byNameTrigram.find(MakeTrigram(&name[i]));
+        if (trigram == _byNameTrigram.end())
+            continue;
+
+        trigram->second.erase(info);
+        if (trigram->second.empty())
+            _byNameTrigram.erase(trigram);
+    }
+
+    _whoListStorage.erase(itr);
 }
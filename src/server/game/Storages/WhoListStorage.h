@@ -19,7 +19,15 @@
 #define _WHOLISTSTORAGE_H
 
 #include "Common.h"
+#include "DBCEnums.h"
 #include "ObjectGuid.h"
+#include "SharedDefines.h"
+#include <array>
+#include <mutex>
+#include <unordered_map>
+#include <unordered_set>
+
+class Player;
 
 class WhoListPlayerInfo
 {
@@ -59,8 +67,10 @@ private:
     std::string _guildName;
 };
 
-typedef std::vector<WhoListPlayerInfo> WhoListInfoVector;
+typedef std::vector<WhoListPlayerInfo const*> WhoListInfoVector;
 
+// Who list entries of online players, kept up to date from players marked as changed.
+// Changes are applied by the world update, who queries (map threads) only read it.
 class TC_GAME_API WhoListStorageMgr
 {
 private:
@@ -70,11 +80,32 @@ private:
 public:
     static WhoListStorageMgr* instance();
 
+    // refreshes players marked since the last call, must not run during map updates
     void Update();
-    WhoListInfoVector const& GetWhoList() const { return _whoListStorage; }
+
+    // player was added to or removed from a map, or changed level, zone, guild, visibility or security level
+    void MarkDirty(ObjectGuid guid);
+
+    // fills candidates with the players of the smallest matching index, every filter still has to be checked on them
+    // playerName is the lowercased name filter of the request
+    void GetCandidates(int32 minLevel, int32 maxLevel, int32 classFilter, int32 raceFilter, std::vector<int32> const& zones, std::wstring const& playerName,
+        WhoListInfoVector& candidates) const;
 
 protected:
-    WhoListInfoVector _whoListStorage;
+    typedef std::unordered_set<WhoListPlayerInfo const*> WhoListInfoSet;
+
+    void Insert(Player const* player);
+    void Remove(ObjectGuid guid);
+
+    std::unordered_map<ObjectGuid, WhoListPlayerInfo> _whoListStorage;
+    std::array<WhoListInfoSet, STRONG_MAX_LEVEL + 1> _byLevel;
+    std::array<WhoListInfoSet, MAX_CLASSES> _byClass;
+    std::array<WhoListInfoSet, MAX_RACES> _byRace;
+    std::unordered_map<uint32, WhoListInfoSet> _byZone;
+    std::unordered_map<uint64, WhoListInfoSet> _byNameTrigram;  // three consecutive characters of the lowercased name
+
+    std::mutex _dirtyLock;
+    GuidUnorderedSet _dirty;
 };
 
 #define sWhoListStorageMgr WhoListStorageMgr::instance()
@@ -59,12 +59,14 @@
 #include "LootItemStorage.h"
 #include "LootMgr.h"
 #include "M2Stores.h"
+#include "MapCollisionCache.h"
 #include "MapManager.h"
 #include "Metric.h"
 #include "MMapFactory.h"
 #include "ObjectAccessor.h"
 #include "ObjectMgr.h"
 #include "OutdoorPvPMgr.h"
+#include "PacketLog.h"
 #include "PetitionMgr.h"
 #include "Player.h"
 #include "PlayerDump.h"
@@ -131,9 +133,6 @@ World::World()
     m_defaultDbcLocale = LOCALE_enUS;
     m_availableDbcLocaleMask = 0;
 
-    mail_timer = 0;
-    mail_timer_expires = 0;
-
     m_isClosed = false;
 
     m_CleaningFlags = 0;
@@ -509,6 +508,8 @@ void World::LoadConfigSettings(bool reload)
         }
         sLog->LoadFromConfig();
         sMetric->LoadFromConfigs();
+        if (sPacketLog->CanLogPacket())
+            sPacketLog->LoadFilterFromConfig();
     }
 
     m_defaultDbcLocale = LocaleConstant(sConfigMgr->GetIntDefault("DBC.Locale", 0));
@@ -732,6 +733,13 @@ void World::LoadConfigSettings(bool reload)
         TC_LOG_ERROR("server.loading", "InstanceMapLoadAllGrids enabled, but GridUnload also enabled. GridUnload must be disabled to enable instance map pre-loading. Instance map pre-loading disabled");
         m_bool_configs[CONFIG_INSTANCEMAP_LOAD_GRIDS] = false;
     }
+    m_float_configs[CONFIG_GRID_PREFETCH_DISTANCE] = sConfigMgr->GetFloatDefault("GridPrefetch.Distance", 250.0f);
+    m_int_configs[CONFIG_GRID_ACTIVATION_BUDGET] = sConfigMgr->GetIntDefault("GridPrefetch.ActivationBudget", 2);
+    if (m_int_configs[CONFIG_GRID_ACTIVATION_BUDGET] < 1)
+    {
+        TC_LOG_ERROR("server.loading", "GridPrefetch.ActivationBudget (%u) must be at least 1. Set to 1.", m_int_configs[CONFIG_GRID_ACTIVATION_BUDGET]);
+        m_int_configs[CONFIG_GRID_ACTIVATION_BUDGET] = 1;
+    }
     m_int_configs[CONFIG_INTERVAL_SAVE] = sConfigMgr->GetIntDefault("PlayerSaveInterval", 15 * MINUTE * IN_MILLISECONDS);
     m_int_configs[CONFIG_INTERVAL_DISCONNECT_TOLERANCE] = sConfigMgr->GetIntDefault("DisconnectToleranceInterval", 0);
     m_bool_configs[CONFIG_STATS_SAVE_ONLY_ON_LOGOUT] = sConfigMgr->GetBoolDefault("PlayerSave.Stats.SaveOnlyOnLogout", true);
@@ -761,6 +769,10 @@ void World::LoadConfigSettings(bool reload)
     if (reload)
         sMapMgr->SetMapUpdateInterval(m_int_configs[CONFIG_INTERVAL_MAPUPDATE]);
 
+    m_int_configs[CONFIG_INTERVAL_MAPUPDATE_IDLE] = sConfigMgr->GetIntDefault("MapUpdateInterval.Idle", 100);
+    m_int_configs[CONFIG_INTERVAL_MAPUPDATE_EMPTY] = sConfigMgr->GetIntDefault("MapUpdateInterval.Empty", 1 * IN_MILLISECONDS);
+    m_int_configs[CONFIG_MAPUPDATE_IDLE_PLAYERS] = sConfigMgr->GetIntDefault("MapUpdateInterval.IdlePlayers", 5);
+
     m_int_configs[CONFIG_INTERVAL_CHANGEWEATHER] = sConfigMgr->GetIntDefault("ChangeWeatherInterval", 10 * MINUTE * IN_MILLISECONDS);
 
     if (reload)
@@ -781,6 +793,14 @@ void World::LoadConfigSettings(bool reload)
 
     m_int_configs[CONFIG_SOCKET_TIMEOUTTIME] = sConfigMgr->GetIntDefault("SocketTimeOutTime", 900000);
     m_int_configs[CONFIG_SESSION_ADD_DELAY] = sConfigMgr->GetIntDefault("SessionAddDelay", 10000);
+    m_int_configs[CONFIG_SESSION_PACKET_BUDGET] = std::max(sConfigMgr->GetIntDefault("Network.SessionPacketBudget", 100), 1);
+    m_int_configs[CONFIG_SESSION_BYTE_BUDGET] = sConfigMgr->GetIntDefault("Network.SessionByteBudget", 65536);
+    if (int32(m_int_configs[CONFIG_SESSION_BYTE_BUDGET]) <= 0)
+    {
+        TC_LOG_ERROR("server.loading", "Network.SessionByteBudget (%i) must be > 0. Using 65536 instead.", int32(m_int_configs[CONFIG_SESSION_BYTE_BUDGET]));
+        m_int_configs[CONFIG_SESSION_BYTE_BUDGET] = 65536;
+    }
+    m_int_configs[CONFIG_SESSION_RECV_QUEUE_LIMIT] = sConfigMgr->GetIntDefault("Network.SessionReceiveQueueLimit", 262144);
 
     m_float_configs[CONFIG_GROUP_XP_DISTANCE] = sConfigMgr->GetFloatDefault("MaxGroupXPDistance", 74.0f);
     m_float_configs[CONFIG_MAX_RECRUIT_A_FRIEND_DISTANCE] = sConfigMgr->GetFloatDefault("MaxRecruitAFriendBonusDistance", 100.0f);
@@ -1092,12 +1112,6 @@ void World::LoadConfigSettings(bool reload)
     m_int_configs[CONFIG_GROUP_VISIBILITY] = sConfigMgr->GetIntDefault("Visibility.GroupMode", 1);
 
     m_int_configs[CONFIG_MAIL_DELIVERY_DELAY] = sConfigMgr->GetIntDefault("MailDeliveryDelay", HOUR);
-    m_int_configs[CONFIG_CLEAN_OLD_MAIL_TIME] = sConfigMgr->GetIntDefault("CleanOldMailTime", 4);
-    if (m_int_configs[CONFIG_CLEAN_OLD_MAIL_TIME] > 23)
-    {
-        TC_LOG_ERROR("server.loading", "CleanOldMailTime (%u) must be an hour, between 0 and 23. Set to 4.", m_int_configs[CONFIG_CLEAN_OLD_MAIL_TIME]);
-        m_int_configs[CONFIG_CLEAN_OLD_MAIL_TIME] = 4;
-    }
 
     m_int_configs[CONFIG_UPTIME_UPDATE] = sConfigMgr->GetIntDefault("UpdateUptimeInterval", 10);
     if (int32(m_int_configs[CONFIG_UPTIME_UPDATE]) <= 0)
@@ -1284,6 +1298,7 @@ void World::LoadConfigSettings(bool reload)
 
     m_int_configs[CONFIG_CREATURE_PICKPOCKET_REFILL] = sConfigMgr->GetIntDefault("Creature.PickPocketRefillDelay", 10 * MINUTE);
     m_int_configs[CONFIG_CREATURE_STOP_FOR_PLAYER] = sConfigMgr->GetIntDefault("Creature.MovingStopTimeForPlayer", 3 * MINUTE * IN_MILLISECONDS);
+    m_int_configs[CONFIG_CREATURE_IDLE_UPDATE_DELAY] = sConfigMgr->GetIntDefault("Creature.IdleUpdateDelay", 1 * IN_MILLISECONDS);
 
     if (int32 clientCacheId = sConfigMgr->GetIntDefault("ClientCacheVersion", 0))
     {
@@ -1348,6 +1363,14 @@ void World::LoadConfigSettings(bool reload)
     m_visibility_notify_periodInInstances = sConfigMgr->GetIntDefault("Visibility.Notify.Period.InInstances",   DEFAULT_VISIBILITY_NOTIFY_PERIOD);
     m_visibility_notify_periodInBGArenas = sConfigMgr->GetIntDefault("Visibility.Notify.Period.InBGArenas",    DEFAULT_VISIBILITY_NOTIFY_PERIOD);
 
+    m_float_configs[CONFIG_MOVEMENT_RELAY_FAR_DISTANCE] = sConfigMgr->GetFloatDefault("MovementRelay.FarDistance", 50.0f);
+    if (m_float_configs[CONFIG_MOVEMENT_RELAY_FAR_DISTANCE] < 0.0f)
+    {
+        TC_LOG_ERROR("server.loading", "MovementRelay.FarDistance (%f) can't be negative. Set to 50.", m_float_configs[CONFIG_MOVEMENT_RELAY_FAR_DISTANCE]);
+        m_float_configs[CONFIG_MOVEMENT_RELAY_FAR_DISTANCE] = 50.0f;
+    }
+    m_int_configs[CONFIG_MOVEMENT_RELAY_FAR_INTERVAL] = sConfigMgr->GetIntDefault("MovementRelay.FarInterval", 1000);
+
     ///- Load the CharDelete related config options
     m_int_configs[CONFIG_CHARDELETE_METHOD] = sConfigMgr->GetIntDefault("CharDelete.Method", 0);
     m_int_configs[CONFIG_CHARDELETE_MIN_LEVEL] = sConfigMgr->GetIntDefault("CharDelete.MinLevel", 0);
@@ -1478,6 +1501,8 @@ void World::LoadConfigSettings(bool reload)
     m_bool_configs[CONFIG_SHOW_MUTE_IN_WORLD] = sConfigMgr->GetBoolDefault("ShowMuteInWorld", false);
     m_bool_configs[CONFIG_SHOW_BAN_IN_WORLD] = sConfigMgr->GetBoolDefault("ShowBanInWorld", false);
     m_int_configs[CONFIG_NUMTHREADS] = sConfigMgr->GetIntDefault("MapUpdate.Threads", 1);
+    m_int_configs[CONFIG_PATHFINDING_THREADS] = sConfigMgr->GetIntDefault("MapUpdate.PathfindingThreads", 1);
+    m_int_configs[CONFIG_GRID_PREPARATION_THREADS] = sConfigMgr->GetIntDefault("MapUpdate.GridPreparationThreads", 1);
     m_int_configs[CONFIG_MAX_RESULTS_LOOKUP_COMMANDS] = sConfigMgr->GetIntDefault("Command.LookupMaxResults", 0);
 
     // Warden
@@ -1608,6 +1633,9 @@ void World::LoadConfigSettings(bool reload)
     // Whether to use LoS from game objects
     m_bool_configs[CONFIG_CHECK_GOBJECT_LOS] = sConfigMgr->GetBoolDefault("CheckGameObjectLoS", true);
 
+    // Whether to memoize line of sight and height queries per map
+    m_bool_configs[CONFIG_COLLISION_QUERY_CACHE] = sConfigMgr->GetBoolDefault("CollisionQueryCache", true);
+
     // Allow to cache data queries
     m_bool_configs[CONFIG_CACHE_DATA_QUERIES] = sConfigMgr->GetBoolDefault("CacheDataQueries", true);
 
@@ -2246,19 +2274,6 @@ void World::SetInitialWorldSettings()
 
     m_timers[WUPDATE_GUILDSAVE].SetInterval(getIntConfig(CONFIG_GUILD_SAVE_INTERVAL) * MINUTE * IN_MILLISECONDS);
 
-    //to set mailtimer to return mails every day between 4 and 5 am
-    //mailtimer is increased when updating auctions
-    //one second is 1000 -(tested on win system)
-    /// @todo Get rid of magic numbers
-    tm localTm;
-    time_t gameTime = GameTime::GetGameTime();
-    localtime_r(&gameTime, &localTm);
-    uint8 CleanOldMailsTime = getIntConfig(CONFIG_CLEAN_OLD_MAIL_TIME);
-    mail_timer = ((((localTm.tm_hour + (24 - CleanOldMailsTime)) % 24)* HOUR * IN_MILLISECONDS) / m_timers[WUPDATE_AUCTIONS].GetInterval());
-                                                            //1440
-    mail_timer_expires = ((DAY * IN_MILLISECONDS) / (m_timers[WUPDATE_AUCTIONS].GetInterval()));
-    TC_LOG_INFO("server.loading", "Mail timer set to: " UI64FMTD ", mail return is called every " UI64FMTD " minutes", uint64(mail_timer), uint64(mail_timer_expires));
-
     ///- Initialize MapManager
     TC_LOG_INFO("server.loading", "Starting Map System");
     sMapMgr->Initialize();
@@ -2421,12 +2436,7 @@ void World::Update(uint32 diff)
         m_timers[WUPDATE_AUCTIONS].Reset();
 
         ///- Update mails (return old mails with item, or delete them)
-        //(tested... works on win)
-        if (++mail_timer > mail_timer_expires)
-        {
-            mail_timer = 0;
-            sObjectMgr->ReturnOrDeleteOldMails(true);
-        }
+        sObjectMgr->ReturnOrDeleteOldMails(true);
 
         ///- Handle expired auctions
         sAuctionMgr->Update();
@@ -2499,6 +2509,9 @@ void World::Update(uint32 diff)
     sMapMgr->Update(diff);
     sWorldUpdateTime.RecordUpdateTimeDuration("UpdateMapMgr");
 
+    sGuildMgr->UpdatePendingAchievementCriteria();
+    sWorldUpdateTime.RecordUpdateTimeDuration("UpdateGuildAchievementCriteria");
+
     if (sWorld->getBoolConfig(CONFIG_AUTOBROADCAST))
     {
         if (m_timers[WUPDATE_AUTOBROADCAST].Passed())
@@ -2582,6 +2595,7 @@ void World::Update(uint32 diff)
     sScriptMgr->OnWorldUpdate(diff);
 
     // Stats logger update
+    MapCollisionCache::FlushStats();
     sMetric->Update();
     TC_METRIC_VALUE("update_time_diff", diff);
 }
@@ -185,6 +185,7 @@ enum WorldBoolConfigs
     CONFIG_CHECK_GOBJECT_LOS,
     CONFIG_RESPAWN_DYNAMIC_ESCORTNPC,
     CONFIG_CACHE_DATA_QUERIES,
+    CONFIG_COLLISION_QUERY_CACHE,
     BOOL_CONFIG_VALUE_COUNT
 };
 
@@ -210,6 +211,8 @@ enum WorldFloatConfigs
     CONFIG_ARENA_MATCHMAKER_RATING_MODIFIER,
     CONFIG_RESPAWN_DYNAMICRATE_CREATURE,
     CONFIG_RESPAWN_DYNAMICRATE_GAMEOBJECT,
+    CONFIG_MOVEMENT_RELAY_FAR_DISTANCE,
+    CONFIG_GRID_PREFETCH_DISTANCE,
     FLOAT_CONFIG_VALUE_COUNT
 };
 
@@ -219,12 +222,18 @@ enum WorldIntConfigs
     CONFIG_INTERVAL_SAVE,
     CONFIG_INTERVAL_GRIDCLEAN,
     CONFIG_INTERVAL_MAPUPDATE,
+    CONFIG_INTERVAL_MAPUPDATE_IDLE,
+    CONFIG_INTERVAL_MAPUPDATE_EMPTY,
+    CONFIG_MAPUPDATE_IDLE_PLAYERS,
     CONFIG_INTERVAL_CHANGEWEATHER,
     CONFIG_INTERVAL_DISCONNECT_TOLERANCE,
     CONFIG_PORT_WORLD,
     CONFIG_PORT_INSTANCE,
     CONFIG_SOCKET_TIMEOUTTIME,
     CONFIG_SESSION_ADD_DELAY,
+    CONFIG_SESSION_PACKET_BUDGET,
+    CONFIG_SESSION_BYTE_BUDGET,
+    CONFIG_SESSION_RECV_QUEUE_LIMIT,
     CONFIG_GAME_TYPE,
     CONFIG_REALM_ZONE,
     CONFIG_STRICT_PLAYER_NAMES,
@@ -279,7 +288,6 @@ enum WorldIntConfigs
     CONFIG_FORCE_SHUTDOWN_THRESHOLD,
     CONFIG_GROUP_VISIBILITY,
     CONFIG_MAIL_DELIVERY_DELAY,
-    CONFIG_CLEAN_OLD_MAIL_TIME,
     CONFIG_UPTIME_UPDATE,
     CONFIG_SKILL_CHANCE_ORANGE,
     CONFIG_SKILL_CHANCE_YELLOW,
@@ -339,6 +347,8 @@ enum WorldIntConfigs
     CONFIG_ENABLE_SINFO_LOGIN,
     CONFIG_PLAYER_ALLOW_COMMANDS,
     CONFIG_NUMTHREADS,
+    CONFIG_PATHFINDING_THREADS,
+    CONFIG_GRID_PREPARATION_THREADS,
     CONFIG_LOGDB_CLEARINTERVAL,
     CONFIG_LOGDB_CLEARTIME,
     CONFIG_CLIENTCACHE_VERSION,
@@ -398,6 +408,7 @@ enum WorldIntConfigs
     CONFIG_BG_REWARD_WINNER_CONQUEST_LAST,
     CONFIG_CREATURE_PICKPOCKET_REFILL,
     CONFIG_CREATURE_STOP_FOR_PLAYER,
+    CONFIG_CREATURE_IDLE_UPDATE_DELAY,
     CONFIG_AHBOT_UPDATE_INTERVAL,
     CONFIG_CHARTER_COST_GUILD,
     CONFIG_CHARTER_COST_ARENA_2v2,
@@ -418,6 +429,8 @@ enum WorldIntConfigs
     CONFIG_RESPAWN_GUIDWARNING_FREQUENCY,
     CONFIG_RATED_BATTLEGROUND_ENABLE,
     CONFIG_PENDING_MOVE_CHANGES_TIMEOUT,
+    CONFIG_MOVEMENT_RELAY_FAR_INTERVAL,
+    CONFIG_GRID_ACTIVATION_BUDGET,
     INT_CONFIG_VALUE_COUNT
 };
 
@@ -845,8 +858,6 @@ class TC_GAME_API World
         bool m_isClosed;
 
         IntervalTimer m_timers[WUPDATE_COUNT];
-        time_t mail_timer;
-        time_t mail_timer_expires;
 
         SessionMap m_sessions;
         typedef std::unordered_map<uint32, time_t> DisconnectMap;
@@ -30,6 +30,7 @@ EndScriptData */
 #include "Language.h"
 #include "Log.h"
 #include "Player.h"
+#include "Realm.h"
 #include "ScriptMgr.h"
 #include "World.h"
 #include "WorldSession.h"
@@ -597,7 +598,11 @@ public:
         }
 
         if (WorldSession* session = sWorld->FindSession(accountId))
+        {
             sAccountMgr->UpdateAccountAccess(session->GetRBACData(), accountId, gmLevel, realmId);
+            if (realmId == -1 || realmId == int32(realm.Id.Realm))
+                session->SetSecurity(AccountTypes(gmLevel));
+        }
         else
             sAccountMgr->UpdateAccountAccess(nullptr, accountId, gmLevel, realmId);
 
@@ -19,9 +19,21 @@
 #include "DB2StorageLoader.h"
 #include "Database/Implementation/HotfixDatabase.h"
 #include "Database/DatabaseEnv.h"
+#include "DataFileMapping.h"
 #include "Errors.h"
 #include "Log.h"
 
+namespace
+{
+    uint32 ReadHeaderField(unsigned char const* header, uint32 index)
+    {
+        uint32 value;
+        memcpy(&value, header + index * sizeof(uint32), sizeof(uint32));
+        EndianConvert(value);
+        return value;
+    }
+}
+
 DB2FileLoader::DB2FileLoader()
 {
     recordSize = 0;
@@ -45,125 +57,54 @@ DB2FileLoader::DB2FileLoader()
 
 bool DB2FileLoader::Load(char const* filename, char const* fmt)
 {
-    if (data)
-    {
-        delete [] data;
-        data = nullptr;
-    }
-
-    FILE* f = fopen(filename, "rb");
-    if (!f)
-        return false;
-
-    uint32 header;
-    if (fread(&header, 4, 1, f) != 1)                        // Signature
-    {
-        fclose(f);
-        return false;
-    }
-
-    EndianConvert(header);
-
-    if (header != 0x32424457)
-    {
-        fclose(f);
-        return false;                                       //'WDB2'
-    }
-
-    if (fread(&recordCount, 4, 1, f) != 1)                 // Number of records
-    {
-        fclose(f);
-        return false;
-    }
-
-    EndianConvert(recordCount);
+    mapping.reset();
+    data = nullptr;
+    stringTable = nullptr;
 
-    if (fread(&fieldCount, 4, 1, f) != 1)                 // Number of fields
-    {
-        fclose(f);
+    std::shared_ptr<DataFileMapping> file = std::make_shared<DataFileMapping>(filename);
+    if (!file->IsOpen())
         return false;
-    }
-
-    EndianConvert(fieldCount);
 
-    if (fread(&recordSize, 4, 1, f) != 1)                 // Size of a record
-    {
-        fclose(f);
+    unsigned char* header = file->GetData();
+    std::size_t headerSize = 8 * sizeof(uint32);
+    if (file->GetSize() < headerSize)
         return false;
-    }
 
-    EndianConvert(recordSize);
-
-    if (fread(&stringSize, 4, 1, f) != 1)                 // String size
-    {
-        fclose(f);
+    if (ReadHeaderField(header, 0) != 0x32424457)           //'WDB2'
         return false;
-    }
 
-    EndianConvert(stringSize);
+    recordCount = ReadHeaderField(header, 1);               // Number of records
+    fieldCount = ReadHeaderField(header, 2);                // Number of fields
+    recordSize = ReadHeaderField(header, 3);                // Size of a record
+    stringSize = ReadHeaderField(header, 4);                // String size
 
     /* NEW WDB2 FIELDS*/
-    if (fread(&tableHash, 4, 1, f) != 1)                  // Table hash
-    {
-        fclose(f);
-        return false;
-    }
-
-    EndianConvert(tableHash);
-
-    if (fread(&build, 4, 1, f) != 1)                     // Build
-    {
-        fclose(f);
-        return false;
-    }
-
-    EndianConvert(build);
-
-    if (fread(&unk1, 4, 1, f) != 1)                     // Unknown WDB2
-    {
-        fclose(f);
-        return false;
-    }
-
-    EndianConvert(unk1);
+    tableHash = ReadHeaderField(header, 5);                 // Table hash
+    build = ReadHeaderField(header, 6);                     // Build
+    unk1 = int32(ReadHeaderField(header, 7));               // Unknown WDB2
 
     if (build > 12880)
     {
-        if (fread(&minIndex, 4, 1, f) != 1)                           // MinIndex WDB2
-        {
-            fclose(f);
+        headerSize += 4 * sizeof(uint32);
+        if (file->GetSize() < headerSize)
             return false;
-        }
-        EndianConvert(minIndex);
 
-        if (fread(&maxIndex, 4, 1, f) != 1)                           // MaxIndex WDB2
-        {
-            fclose(f);
-            return false;
-        }
-        EndianConvert(maxIndex);
-
-        if (fread(&locale, 4, 1, f) != 1)                             // Locales
-        {
-            fclose(f);
-            return false;
-        }
-        EndianConvert(locale);
-
-        if (fread(&unk5, 4, 1, f) != 1)                               // Unknown WDB2
-        {
-            fclose(f);
-            return false;
-        }
-        EndianConvert(unk5);
+        minIndex = int32(ReadHeaderField(header, 8));       // MinIndex WDB2
+        maxIndex = int32(ReadHeaderField(header, 9));       // MaxIndex WDB2
+        locale = int32(ReadHeaderField(header, 10));        // Locales
+        unk5 = int32(ReadHeaderField(header, 11));          // Unknown WDB2
     }
 
     if (maxIndex != 0)
     {
         int32 diff = maxIndex - minIndex + 1;
-        fseek(f, diff * 4 + diff * 2, SEEK_CUR);    // diff * 4: an index for rows, diff * 2: a memory allocation bank
+        headerSize += diff * 4 + diff * 2;                  // diff * 4: an index for rows, diff * 2: a memory allocation bank
     }
 
+    if (!fieldCount || headerSize + std::size_t(recordSize) * recordCount + stringSize > file->GetSize())
+        return false;
+
+    delete[] fieldsOffset;
     fieldsOffset = new uint32[fieldCount];
     fieldsOffset[0] = 0;
     for (uint32 i = 1; i < fieldCount; i++)
@@ -175,25 +116,17 @@ bool DB2FileLoader::Load(char const* filename, char const* fmt)
             fieldsOffset[i] += 4;
     }
 
-    data = new unsigned char[recordSize * recordCount + stringSize];
+    // records and strings are read from the mapped file, nothing is copied here
+    mapping = std::move(file);
+    data = header + headerSize;
     stringTable = data + recordSize * recordCount;
 
-    if (fread(data, recordSize * recordCount + stringSize, 1, f) != 1)
-    {
-        fclose(f);
-        return false;
-    }
-
-    fclose(f);
     return true;
 }
 
 DB2FileLoader::~DB2FileLoader()
 {
-    if (data)
-        delete [] data;
-    if (fieldsOffset)
-        delete [] fieldsOffset;
+    delete[] fieldsOffset;
 }
 
 DB2FileLoader::Record DB2FileLoader::getRecord(size_t id)
@@ -246,6 +179,38 @@ uint32 DB2FileLoader::GetFormatStringFieldCount(char const* format)
     return stringfields;
 }
 
+bool DB2FileLoader::CanUseRecordsInPlace(char const* format) const
+{
+#if TRINITY_ENDIAN == TRINITY_BIGENDIAN
+    (void)format;
+    return false;
+#else
+    if (strlen(format) != fieldCount || GetFormatRecordSize(format) != recordSize)
+        return false;
+
+    // strings are pointers to string holders in memory, sort fields are not there
+    for (uint32 x = 0; format[x]; ++x)
+    {
+        switch (format[x])
+        {
+            case FT_FLOAT:
+            case FT_INT:
+            case FT_IND:
+            case FT_BYTE:
+                break;
+            default:
+                return false;
+        }
+    }
+
+    // the data section of a db2 may start only 2 byte aligned (the index table before it has 6 byte entries)
+    if (reinterpret_cast<uintptr_t>(data) % alignof(uint32) != 0 || recordSize % alignof(uint32) != 0)
+        return false;
+
+    return true;
+#endif
+}
+
 char* DB2FileLoader::AutoProduceData(char const* format, uint32& records, char**& indexTable)
 {
     typedef char * ptr;
@@ -278,6 +243,20 @@ char* DB2FileLoader::AutoProduceData(char const* format, uint32& records, char**
         indexTable = new ptr[recordCount];
     }
 
+    if (CanUseRecordsInPlace(format))
+    {
+        for (uint32 y = 0; y < recordCount; y++)
+        {
+            char* record = reinterpret_cast<char*>(data + y * recordSize);
+            if (indexField >= 0)
+                indexTable[getRecord(y).getUInt(indexField)] = record;
+            else
+                indexTable[y] = record;
+        }
+
+        return nullptr;
+    }
+
     char* dataTable = new char[recordCount * recordsize];
 
     uint32 offset = 0;
@@ -378,13 +357,10 @@ char* DB2FileLoader::AutoProduceStringsArrayHolders(char const* format, char* da
     return stringHoldersPool;
 }
 
-char* DB2FileLoader::AutoProduceStrings(char const* format, char* dataTable, uint32 locale)
+void DB2FileLoader::AutoProduceStrings(char const* format, char* dataTable, uint32 locale)
 {
     if (strlen(format) != fieldCount)
-        return nullptr;
-
-    char* stringPool = new char[stringSize];
-    memcpy(stringPool, stringTable, stringSize);
+        return;
 
     uint32 offset = 0;
 
@@ -407,10 +383,7 @@ char* DB2FileLoader::AutoProduceStrings(char const* format, char* dataTable, uin
                     // fill only not filled entries
                     LocalizedString* db2str = *(LocalizedString**)(&dataTable[offset]);
                     if (db2str->Str[locale] == nullStr)
-                    {
-                        const char* st = getRecord(y).getString(x);
-                        db2str->Str[locale] = stringPool + (st - (const char*)stringTable);
-                    }
+                        db2str->Str[locale] = getRecord(y).getString(x);
 
                     offset += sizeof(char*);
                     break;
@@ -418,8 +391,6 @@ char* DB2FileLoader::AutoProduceStrings(char const* format, char* dataTable, uin
             }
         }
     }
-
-    return stringPool;
 }
 
 char* DB2DatabaseLoader::Load(const char* format, int32 preparedStatement, uint32& records, char**& indexTable, char*& stringHolders, std::list<char*>& stringPool)
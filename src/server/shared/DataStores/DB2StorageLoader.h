@@ -22,8 +22,11 @@
 #include "Utilities/ByteConverter.h"
 #include <cassert>
 #include <list>
+#include <memory>
 #include <string>
 
+class DataFileMapping;
+
 class TC_SHARED_API DB2FileLoader
 {
     public:
@@ -80,9 +83,14 @@ class TC_SHARED_API DB2FileLoader
     uint32 GetOffset(size_t id) const { return (fieldsOffset != nullptr && id < fieldCount) ? fieldsOffset[id] : 0; }
     uint32 GetHash() const { return tableHash; }
     bool IsLoaded() const { return (data != nullptr); }
+    // records used in place and strings point into the mapped file, it has to be kept while they are used
+    std::shared_ptr<DataFileMapping> GetMapping() const { return mapping; }
+    // true when the file records have the layout of fmt in memory
+    bool CanUseRecordsInPlace(char const* fmt) const;
+    // returns the converted records, nullptr when the records are used in place
     char* AutoProduceData(char const* fmt, uint32& count, char**& indexTable);
     char* AutoProduceStringsArrayHolders(char const* fmt, char* dataTable);
-    char* AutoProduceStrings(char const* fmt, char* dataTable, uint32 locale);
+    void AutoProduceStrings(char const* fmt, char* dataTable, uint32 locale);
     static uint32 GetFormatRecordSize(char const* format, int32* index_pos = nullptr);
     static uint32 GetFormatStringFieldCount(const char* format);
 private:
@@ -92,6 +100,7 @@ private:
     uint32 fieldCount;
     uint32 stringSize;
     uint32 *fieldsOffset;
+    std::shared_ptr<DataFileMapping> mapping;
     unsigned char *data;
     unsigned char *stringTable;
 
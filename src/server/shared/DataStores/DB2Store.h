@@ -23,8 +23,11 @@
 #include "Common.h"
 #include "Errors.h"
 #include "ByteBuffer.h"
+#include <memory>
 #include <vector>
 
+class DataFileMapping;
+
 /// Interface class for common access
 class DB2StorageBase
 {
@@ -139,9 +142,11 @@ public:
             _stringPoolList.push_back(stringHolders);
 
             // load strings from db2 data
-            if (char* stringBlock = db2.AutoProduceStrings(_format, (char*)_dataTable, locale))
-                _stringPoolList.push_back(stringBlock);
+            db2.AutoProduceStrings(_format, (char*)_dataTable, locale);
+            _files.push_back(db2.GetMapping());
         }
+        else if (!_dataTable)
+            _files.push_back(db2.GetMapping());
 
         // error in db2 file at loading if nullptr
         return _indexTable.AsT != nullptr;
@@ -160,8 +165,10 @@ public:
 
         // load strings from another locale db2 data
         if (DB2FileLoader::GetFormatStringFieldCount(_format))
-            if (char* stringBlock = db2.AutoProduceStrings(_format, (char*)_dataTable, locale))
-                _stringPoolList.push_back(stringBlock);
+        {
+            db2.AutoProduceStrings(_format, (char*)_dataTable, locale);
+            _files.push_back(db2.GetMapping());
+        }
         return true;
     }
 
@@ -205,6 +212,7 @@ private:
     T* _dataTable;
     T* _dataTableEx;
     StringPoolList _stringPoolList;
+    std::vector<std::shared_ptr<DataFileMapping>> _files;  // records used in place and strings
     int32 _hotfixStatement;
 };
 
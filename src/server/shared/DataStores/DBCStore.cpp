@@ -17,6 +17,8 @@
 
 #include "DBCStore.h"
 #include "DBCDatabaseLoader.h"
+#include "DataFileMapping.h"
+#include <cstring>
 
 DBCStorageBase::DBCStorageBase(char const* fmt) : _fieldCount(0), _fileFormat(fmt), _dataTable(nullptr), _dataTableEx(nullptr), _indexTableSize(0)
 {
@@ -26,8 +28,6 @@ DBCStorageBase::~DBCStorageBase()
 {
     delete[] _dataTable;
     delete[] _dataTableEx;
-    for (char* strings : _stringPool)
-        delete[] strings;
 }
 
 bool DBCStorageBase::Load(std::string const& path, char**& indexTable)
@@ -45,8 +45,10 @@ bool DBCStorageBase::Load(std::string const& path, char**& indexTable)
     _dataTable = dbc.AutoProduceData(_fileFormat, _indexTableSize, indexTable);
 
     // load strings from dbc data
-    if (char* stringBlock = dbc.AutoProduceStrings(_fileFormat, _dataTable))
-        _stringPool.push_back(stringBlock);
+    dbc.AutoProduceStrings(_fileFormat, _dataTable);
+
+    if (!_dataTable || strchr(_fileFormat, FT_STRING))
+        _files.push_back(dbc.GetMapping());
 
     // error in dbc file at loading if NULL
     return indexTable != nullptr;
@@ -64,8 +66,10 @@ bool DBCStorageBase::LoadStringsFrom(std::string const& path, char**& indexTable
         return false;
 
     // load strings from another locale dbc data
-    if (char* stringBlock = dbc.AutoProduceStrings(_fileFormat, _dataTable))
-        _stringPool.push_back(stringBlock);
+    dbc.AutoProduceStrings(_fileFormat, _dataTable);
+
+    if (strchr(_fileFormat, FT_STRING))
+        _files.push_back(dbc.GetMapping());
 
     return true;
 }
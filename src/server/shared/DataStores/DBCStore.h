@@ -20,8 +20,11 @@
 
 #include "Common.h"
 #include "DBStorageIterator.h"
+#include <memory>
 #include <vector>
 
+class DataFileMapping;
+
  /// Interface class for common access
 class TC_SHARED_API DBCStorageBase
 {
@@ -45,7 +48,7 @@ class TC_SHARED_API DBCStorageBase
         char const* _fileFormat;
         char* _dataTable;
         char* _dataTableEx;
-        std::vector<char*> _stringPool;
+        std::vector<std::shared_ptr<DataFileMapping>> _files;  // records used in place and strings
         uint32 _indexTableSize;
 };
 
@@ -34,12 +34,15 @@
 #include "GitRevision.h"
 #include "InstanceSaveMgr.h"
 #include "IoContext.h"
+#include "MapCollisionCache.h"
 #include "MapManager.h"
 #include "Metric.h"
+#include "MovementRelay.h"
 #include "MySQLThreading.h"
 #include "ObjectAccessor.h"
 #include "OpenSSLCrypto.h"
 #include "OutdoorPvP/OutdoorPvPMgr.h"
+#include "PacketLog.h"
 #include "ProcessPriority.h"
 #include "RASession.h"
 #include "Resolver.h"
@@ -273,6 +276,36 @@ extern int main(int argc, char** argv)
     sMetric->Initialize(realm.Name, *ioContext, []()
     {
         TC_METRIC_VALUE("online_players", sWorld->GetPlayerCount());
+
+        MapCollisionCache::Stats collisionCacheStats = MapCollisionCache::ConsumeStats();
+        TC_METRIC_VALUE("los_cache_hits", collisionCacheStats.LineOfSightHits);
+        TC_METRIC_VALUE("los_cache_misses", collisionCacheStats.LineOfSightMisses);
+        TC_METRIC_VALUE("height_cache_hits", collisionCacheStats.HeightHits);
+        TC_METRIC_VALUE("height_cache_misses", collisionCacheStats.HeightMisses);
+
+        MovementRelay::Stats movementRelayStats = MovementRelay::ConsumeStats();
+        TC_METRIC_VALUE("movement_relay_heartbeats", movementRelayStats.RelayedHeartbeats);
+        TC_METRIC_VALUE("movement_relay_coalesced", movementRelayStats.CoalescedHeartbeats);
+        TC_METRIC_VALUE("movement_relay_throttled", movementRelayStats.ThrottledPackets);
+        TC_METRIC_VALUE("movement_relay_bytes_saved", movementRelayStats.BytesSaved);
+
+        PacketLog::Stats packetLogStats = PacketLog::ConsumeStats();
+        TC_METRIC_VALUE("packet_log_packets", packetLogStats.LoggedPackets);
+        TC_METRIC_VALUE("packet_log_dropped", packetLogStats.DroppedPackets);
+
+        Map::RelocationStats relocationStats = Map::ConsumeRelocationStats();
+        TC_METRIC_VALUE("relocation_cells_visited", relocationStats.VisitedCells);
+        TC_METRIC_VALUE("relocation_cells_per_update", relocationStats.Updates ? double(relocationStats.VisitedCells) / relocationStats.Updates : 0.0);
+
+        CreatureUpdateStates::Stats creatureUpdateStats = CreatureUpdateStates::ConsumeStats();
+        TC_METRIC_VALUE("creature_updates", creatureUpdateStats.Updated);
+        TC_METRIC_VALUE("creature_updates_skipped", creatureUpdateStats.Skipped);
+
+        Map::UpdateRateStats updateRateStats = Map::ConsumeUpdateRateStats();
+        TC_METRIC_VALUE("map_updates_full", updateRateStats.Updates[Map::UPDATE_RATE_FULL]);
+        TC_METRIC_VALUE("map_updates_idle", updateRateStats.Updates[Map::UPDATE_RATE_IDLE]);
+        TC_METRIC_VALUE("map_updates_empty", updateRateStats.Updates[Map::UPDATE_RATE_EMPTY]);
+        TC_METRIC_VALUE("map_updates_skipped", updateRateStats.Skipped);
     });
 
     TC_METRIC_EVENT("events", "Worldserver started", "");
@@ -0,0 +1,67 @@
+/*
+ * This file is part of the TrinityCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "catch2/catch.hpp"
+#include "CaseInsensitiveName.h"
+
+TEST_CASE("Names differing only in case are equal", "[CaseInsensitiveName]")
+{
+    Trinity::CaseInsensitiveNameHash hash;
+    Trinity::CaseInsensitiveNameEqualTo equal;
+
+    REQUIRE(equal("Stormwind Guard", "sTORMWIND gUARD"));
+    REQUIRE(hash("Stormwind Guard") == hash("sTORMWIND gUARD"));
+
+    // latin-1 and cyrillic letters are folded like wstrToLower does
+    REQUIRE(equal("\xC3\x84rger", "\xC3\xA4rger"));                         // Ärger / ärger
+    REQUIRE(hash("\xC3\x84rger") == hash("\xC3\xA4rger"));
+    REQUIRE(equal("\xD0\x91\xD0\xBE\xD0\xB3", "\xD0\xB1\xD0\xBE\xD0\xB3"));  // Бог / бог
+
+    REQUIRE_FALSE(equal("Guard", "Guards"));
+    REQUIRE_FALSE(equal("Guards", "Guard"));
+    REQUIRE_FALSE(equal("Guard", "Gaurd"));
+}
+
+TEST_CASE("Invalid utf8 is compared byte by byte", "[CaseInsensitiveName]")
+{
+    Trinity::CaseInsensitiveNameEqualTo equal;
+
+    REQUIRE(equal("A\xFF", "a\xFF"));
+    REQUIRE_FALSE(equal("A\xFF", "a\xFE"));
+}
+
+TEST_CASE("Prefix match ignores case", "[CaseInsensitiveName]")
+{
+    REQUIRE(Trinity::CaseInsensitiveNameStartsWith("General - Elwynn Forest", "gEN"));
+    REQUIRE(Trinity::CaseInsensitiveNameStartsWith("Trade", ""));
+    REQUIRE_FALSE(Trinity::CaseInsensitiveNameStartsWith("Trade", "Trades"));
+    REQUIRE_FALSE(Trinity::CaseInsensitiveNameStartsWith("Trade", "rade"));
+}
+
+TEST_CASE("Map lookups ignore case", "[CaseInsensitiveName]")
+{
+    Trinity::CaseInsensitiveNameMap<int> names;
+    names["Knights of Azeroth"] = 1;
+    names["Horde Raiders"] = 2;
+
+    REQUIRE(names.count("knights of azeroth") == 1);
+    REQUIRE(names.find("HORDE RAIDERS")->second == 2);
+    REQUIRE(names.find("Horde Raider") == names.end());
+
+    names.erase("KNIGHTS OF AZEROTH");
+    REQUIRE(names.size() == 1);
+}
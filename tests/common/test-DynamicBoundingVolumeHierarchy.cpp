@@ -0,0 +1,242 @@
+/*
+ * This file is part of the TrinityCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "catch2/catch.hpp"
+#include "DynamicBoundingVolumeHierarchy.h"
+#include <cmath>
+#include <set>
+#include <vector>
+
+struct TestBox
+{
+    G3D::AABox Bounds;
+};
+
+template<> struct BoundsTrait<TestBox>
+{
+    static void getBounds(TestBox const& box, G3D::AABox& out) { out = box.Bounds; }
+};
+
+namespace
+{
+    G3D::AABox MakeBox(float x, float y, float z, float size)
+    {
+        return G3D::AABox(G3D::Vector3(x, y, z), G3D::Vector3(x + size, y + size, z + size));
+    }
+
+    // collects every box the tree reports, never stops the traversal
+    struct CollectCallback
+    {
+        std::set<TestBox const*> Hits;
+
+        bool operator()(G3D::Ray const& /*ray*/, TestBox const& box, float& /*maxDist*/)
+        {
+            Hits.insert(&box);
+            return false;
+        }
+
+        void operator()(G3D::Vector3 const& /*point*/, TestBox const& box)
+        {
+            Hits.insert(&box);
+        }
+    };
+}
+
+TEST_CASE("Insert and remove", "[DynamicBVH]")
+{
+    DynamicBVH<TestBox> tree;
+    REQUIRE(tree.empty());
+
+    TestBox a{ MakeBox(0.0f, 0.0f, 0.0f, 1.0f) };
+    TestBox b{ MakeBox(10.0f, 0.0f, 0.0f, 1.0f) };
+    tree.insert(a);
+    tree.insert(b);
+
+    REQUIRE(tree.contains(a));
+    REQUIRE(tree.contains(b));
+    REQUIRE(tree.size() == 2);
+
+    tree.remove(a);
+    REQUIRE_FALSE(tree.contains(a));
+    REQUIRE(tree.contains(b));
+
+    tree.remove(b);
+    REQUIRE(tree.empty());
+}
+
+TEST_CASE("Empty tree", "[DynamicBVH]")
+{
+    DynamicBVH<TestBox> tree;
+    TestBox box{ MakeBox(0.0f, 0.0f, 0.0f, 1.0f) };
+
+    // objects never inserted are ignored
+    tree.remove(box);
+    REQUIRE_FALSE(tree.update(box));
+    REQUIRE(tree.empty());
+    REQUIRE(tree.height() == 0);
+
+    CollectCallback callback;
+    float maxDist = 100.0f;
+    tree.intersectRay(G3D::Ray(G3D::Vector3(-1.0f, 0.5f, 0.5f), G3D::Vector3(1.0f, 0.0f, 0.0f)), callback, maxDist);
+    tree.intersectPoint(G3D::Vector3(0.5f, 0.5f, 0.5f), callback);
+    REQUIRE(callback.Hits.empty());
+}
+
+TEST_CASE("Update margin", "[DynamicBVH]")
+{
+    DynamicBVH<TestBox> tree;
+    TestBox box{ MakeBox(0.0f, 0.0f, 0.0f, 1.0f) };
+    tree.insert(box);
+
+    // moving by exactly the margin still fits the stored bounds
+    box.Bounds = MakeBox(DynamicBVH<TestBox>::Margin, 0.0f, 0.0f, 1.0f);
+    REQUIRE_FALSE(tree.update(box));
+
+    box.Bounds = MakeBox(DynamicBVH<TestBox>::Margin + 0.25f, 0.0f, 0.0f, 1.0f);
+    REQUIRE(tree.update(box));
+
+    box.Bounds = MakeBox(5.0f, 0.0f, 0.0f, 1.0f);
+    REQUIRE(tree.update(box));
+
+    CollectCallback callback;
+    tree.intersectPoint(G3D::Vector3(5.5f, 0.5f, 0.5f), callback);
+    REQUIRE(callback.Hits.count(&box) == 1);
+}
+
+TEST_CASE("Ray distance", "[DynamicBVH]")
+{
+    DynamicBVH<TestBox> tree;
+    TestBox box{ MakeBox(10.0f, 0.0f, 0.0f, 1.0f) };
+    tree.insert(box);
+
+    G3D::Ray const ray(G3D::Vector3(0.0f, 0.5f, 0.5f), G3D::Vector3(1.0f, 0.0f, 0.0f));
+
+    // the stored bounds start at 10 - Margin
+    CollectCallback before;
+    float maxDist = 10.0f - DynamicBVH<TestBox>::Margin - 0.25f;
+    tree.intersectRay(ray, before, maxDist);
+    REQUIRE(before.Hits.empty());
+
+    CollectCallback within;
+    maxDist = 10.0f - DynamicBVH<TestBox>::Margin + 0.25f;
+    tree.intersectRay(ray, within, maxDist);
+    REQUIRE(within.Hits.count(&box) == 1);
+}
+
+TEST_CASE("Nearest box first", "[DynamicBVH]")
+{
+    // the box inserted last becomes the second child of the root
+    TestBox far{ MakeBox(4.0f, 0.0f, 0.0f, 10.0f) };
+    TestBox near{ MakeBox(2.0f, 0.0f, 0.0f, 1.0f) };
+    DynamicBVH<TestBox> tree;
+    tree.insert(far);
+    tree.insert(near);
+
+    // both boxes overlap the ray, a callback stopping at its first hit must get the near one
+    std::vector<TestBox const*> visited;
+    auto firstHit = [&](G3D::Ray const& /*ray*/, TestBox const& box, float& /*maxDist*/)
+    {
+        visited.push_back(&box);
+        return true;
+    };
+
+    float maxDist = 100.0f;
+    tree.intersectRay(G3D::Ray(G3D::Vector3(0.0f, 0.5f, 0.5f), G3D::Vector3(1.0f, 0.0f, 0.0f)), firstHit, maxDist);
+    REQUIRE(visited == std::vector<TestBox const*>{ &near });
+
+    // and from the other side the far box is the near one
+    visited.clear();
+    tree.intersectRay(G3D::Ray(G3D::Vector3(20.0f, 0.5f, 0.5f), G3D::Vector3(-1.0f, 0.0f, 0.0f)), firstHit, maxDist);
+    REQUIRE(visited == std::vector<TestBox const*>{ &far });
+}
+
+TEST_CASE("Boxes in a row", "[DynamicBVH]")
+{
+    // inserted in order, the worst case for a tree without rotations
+    std::vector<TestBox> boxes;
+    for (int i = 0; i < 256; ++i)
+        boxes.push_back(TestBox{ MakeBox(i * 4.0f, 0.0f, 0.0f, 1.0f) });
+
+    DynamicBVH<TestBox> tree;
+    for (TestBox const& box : boxes)
+        tree.insert(box);
+
+    REQUIRE(tree.size() == boxes.size());
+    REQUIRE(tree.height() <= 16);
+
+    for (std::size_t i = 0; i < boxes.size(); i += 2)
+        tree.remove(boxes[i]);
+
+    REQUIRE(tree.size() == boxes.size() / 2);
+    REQUIRE(tree.height() <= 14);
+
+    // a ray along the row finds every remaining box and none of the removed ones
+    CollectCallback callback;
+    float maxDist = 2000.0f;
+    tree.intersectRay(G3D::Ray(G3D::Vector3(-10.0f, 0.5f, 0.5f), G3D::Vector3(1.0f, 0.0f, 0.0f)), callback, maxDist);
+    REQUIRE(callback.Hits.size() == boxes.size() / 2);
+    for (std::size_t i = 0; i < boxes.size(); ++i)
+        REQUIRE(callback.Hits.count(&boxes[i]) == i % 2);
+}
+
+TEST_CASE("Moving battlefield models", "[DynamicBVH][.][benchmark]")
+{
+    // a battlefield worth of models: siege vehicles driving in circles, destructible buildings and walls standing still
+    std::vector<TestBox> vehicles;
+    std::vector<TestBox> buildings;
+    for (int i = 0; i < 100; ++i)
+        vehicles.push_back(TestBox{ MakeBox(float(i % 10) * 40.0f, float(i / 10) * 40.0f, 0.0f, 6.0f) });
+    for (int i = 0; i < 400; ++i)
+        buildings.push_back(TestBox{ MakeBox(float(i % 20) * 20.0f + 3.0f, float(i / 20) * 20.0f + 3.0f, 0.0f, 12.0f) });
+
+    DynamicBVH<TestBox> tree;
+    for (TestBox const& box : vehicles)
+        tree.insert(box);
+    for (TestBox const& box : buildings)
+        tree.insert(box);
+
+    int tick = 0;
+    BENCHMARK("move every vehicle")
+    {
+        ++tick;
+        for (std::size_t i = 0; i < vehicles.size(); ++i)
+        {
+            float const angle = float(tick + i) * 0.05f;
+            G3D::Vector3 const offset(std::cos(angle) * 0.4f, std::sin(angle) * 0.4f, 0.0f);
+            vehicles[i].Bounds = G3D::AABox(vehicles[i].Bounds.low() + offset, vehicles[i].Bounds.high() + offset);
+            tree.update(vehicles[i]);
+        }
+        return tree.height();
+    };
+
+    BENCHMARK("line of sight checks")
+    {
+        std::size_t hits = 0;
+        for (int i = 0; i < 100; ++i)
+        {
+            G3D::Vector3 const origin(float(i) * 4.0f, 0.0f, 5.0f);
+            G3D::Vector3 const target(400.0f - float(i) * 4.0f, 400.0f, 5.0f);
+            float maxDist = (target - origin).magnitude();
+            CollectCallback callback;
+            tree.intersectRay(G3D::Ray(origin, (target - origin) / maxDist), callback, maxDist);
+            hits += callback.Hits.size();
+        }
+        return hits;
+    };
+
+    REQUIRE(tree.size() == vehicles.size() + buildings.size());
+}
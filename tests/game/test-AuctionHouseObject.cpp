@@ -0,0 +1,93 @@
+/*
+ * This file is part of the TrinityCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "catch2/catch.hpp"
+#include "AuctionHouseMgr.h"
+
+namespace
+{
+    time_t const Now = 1000000;
+
+    AuctionEntry* MakeAuction(uint32 id, time_t expireTime)
+    {
+        AuctionEntry* auction = new AuctionEntry();
+        auction->Id = id;
+        auction->houseId = AUCTIONHOUSE_NEUTRAL;
+        auction->owner = 1;
+        auction->expire_time = expireTime;
+        return auction;
+    }
+}
+
+TEST_CASE("Expiration order", "[AuctionHouse]")
+{
+    AuctionHouseObject auctionHouse;
+    AuctionEntry* late = MakeAuction(1, Now + 2 * HOUR);
+    AuctionEntry* early = MakeAuction(2, Now + HOUR);
+    auctionHouse.AddAuction(late);
+    auctionHouse.AddAuction(early);
+
+    REQUIRE(auctionHouse.PopExpiredAuction(Now) == nullptr);
+    REQUIRE(auctionHouse.PopExpiredAuction(Now + 2 * HOUR) == early);
+    REQUIRE(auctionHouse.PopExpiredAuction(Now + 2 * HOUR) == late);
+    REQUIRE(auctionHouse.PopExpiredAuction(Now + 2 * HOUR) == nullptr);
+    REQUIRE(auctionHouse.Getcount() == 2);
+
+    // what AuctionHouseObject::Update does with expired auctions, this frees them
+    auctionHouse.RemoveAuction(early);
+    auctionHouse.RemoveAuction(late);
+    REQUIRE(auctionHouse.Getcount() == 0);
+}
+
+TEST_CASE("Expire time changes", "[AuctionHouse]")
+{
+    AuctionHouseObject auctionHouse;
+    // owned by the auction house, RemoveAuction or its destructor frees it
+    AuctionEntry* auction = MakeAuction(1, Now + 12 * HOUR);
+    auctionHouse.AddAuction(auction);
+
+    SECTION("failed deposit")
+    {
+        // what AuctionHouseMgr::UpdatePendingAuctions does when the seller went offline
+        auctionHouse.SetExpireTime(auction, Now);
+        REQUIRE(auctionHouse.PopExpiredAuction(Now + 60) == auction);
+
+        // the entry queued when the auction was added must not find it again
+        auctionHouse.RemoveAuction(auction);
+        REQUIRE(auctionHouse.PopExpiredAuction(Now + 12 * HOUR) == nullptr);
+    }
+
+    SECTION("pushed back")
+    {
+        auctionHouse.SetExpireTime(auction, Now + 18 * HOUR);
+        auctionHouse.SetExpireTime(auction, Now + 24 * HOUR);
+        REQUIRE(auctionHouse.PopExpiredAuction(Now + 12 * HOUR) == nullptr);
+        REQUIRE(auctionHouse.PopExpiredAuction(Now + 18 * HOUR) == nullptr);
+        REQUIRE(auctionHouse.PopExpiredAuction(Now + 24 * HOUR) == auction);
+
+        // the stale entries were dropped, not queued again
+        REQUIRE(auctionHouse.PopExpiredAuction(Now + 24 * HOUR) == nullptr);
+        auctionHouse.RemoveAuction(auction);
+    }
+
+    SECTION("removed")
+    {
+        auctionHouse.SetExpireTime(auction, Now);
+        auctionHouse.RemoveAuction(auction);
+        REQUIRE(auctionHouse.PopExpiredAuction(Now + 12 * HOUR) == nullptr);
+    }
+}
@@ -0,0 +1,231 @@
+/*
+ * This file is part of the TrinityCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "catch2/catch.hpp"
+#include "ClientGuidSet.h"
+#include <algorithm>
+#include <set>
+#include <vector>
+
+namespace
+{
+    ObjectGuid PlayerGuid(uint32 counter)
+    {
+        return ObjectGuid(HighGuid::Player, counter);
+    }
+
+    std::set<ObjectGuid> ToSet(ClientGuidSet const& guids)
+    {
+        return std::set<ObjectGuid>(guids.begin(), guids.end());
+    }
+}
+
+TEST_CASE("Insert and erase", "[ClientGuidSet]")
+{
+    ClientGuidSet guids;
+    REQUIRE(guids.empty());
+
+    REQUIRE(guids.insert(PlayerGuid(1)));
+    REQUIRE(!guids.insert(PlayerGuid(1)));
+    REQUIRE(guids.insert(PlayerGuid(2)));
+    REQUIRE(guids.size() == 2);
+    REQUIRE(guids.count(PlayerGuid(1)) == 1);
+    REQUIRE(guids.count(PlayerGuid(3)) == 0);
+
+    REQUIRE(guids.erase(PlayerGuid(1)) == 1);
+    REQUIRE(guids.erase(PlayerGuid(1)) == 0);
+    REQUIRE(guids.count(PlayerGuid(1)) == 0);
+    REQUIRE(ToSet(guids) == std::set<ObjectGuid>{ PlayerGuid(2) });
+
+    guids.clear();
+    REQUIRE(guids.empty());
+    REQUIRE(guids.begin() == guids.end());
+    REQUIRE(guids.count(PlayerGuid(2)) == 0);
+}
+
+TEST_CASE("Visibility update", "[ClientGuidSet]")
+{
+    ClientGuidSet guids;
+    for (uint32 counter = 1; counter <= 100; ++counter)
+        guids.insert(PlayerGuid(counter));
+
+    std::vector<ObjectGuid> unmarked;
+
+    SECTION("every object found")
+    {
+        uint32 generation = guids.StartVisibilityUpdate();
+        for (uint32 counter = 1; counter <= 100; ++counter)
+            REQUIRE(guids.MarkVisible(PlayerGuid(counter), generation));
+
+        guids.GetUnmarked(generation, unmarked);
+        REQUIRE(unmarked.empty());
+    }
+
+    SECTION("objects out of range")
+    {
+        uint32 generation = guids.StartVisibilityUpdate();
+        for (uint32 counter = 1; counter <= 100; counter += 2)
+            REQUIRE(guids.MarkVisible(PlayerGuid(counter), generation));
+
+        // marked once per update, unknown objects are never marked
+        REQUIRE(!guids.MarkVisible(PlayerGuid(1), generation));
+        REQUIRE(!guids.MarkVisible(PlayerGuid(1000), generation));
+
+        // found for the first time during the update
+        REQUIRE(guids.insert(PlayerGuid(1000)));
+
+        guids.GetUnmarked(generation, unmarked);
+        REQUIRE(unmarked.size() == 50);
+        REQUIRE(std::all_of(unmarked.begin(), unmarked.end(), [](ObjectGuid const& guid) { return guid.GetCounter() % 2 == 0; }));
+    }
+
+    SECTION("nested update")
+    {
+        uint32 outer = guids.StartVisibilityUpdate();
+        REQUIRE(guids.MarkVisible(PlayerGuid(1), outer));
+
+        uint32 inner = guids.StartVisibilityUpdate();
+        for (uint32 counter = 2; counter <= 100; ++counter)
+            REQUIRE(guids.MarkVisible(PlayerGuid(counter), inner));
+
+        guids.GetUnmarked(inner, unmarked);
+        REQUIRE(unmarked.size() == 1);
+
+        // objects found by the inner update count as found for the outer one
+        unmarked.clear();
+        guids.GetUnmarked(outer, unmarked);
+        REQUIRE(unmarked.empty());
+    }
+
+    SECTION("erased while marked")
+    {
+        uint32 generation = guids.StartVisibilityUpdate();
+        for (uint32 counter = 1; counter <= 100; ++counter)
+            guids.MarkVisible(PlayerGuid(counter), generation);
+
+        guids.erase(PlayerGuid(50));
+        guids.GetUnmarked(generation, unmarked);
+        REQUIRE(unmarked.empty());
+        REQUIRE(guids.size() == 99);
+    }
+}
+
+TEST_CASE("Erase at full load", "[ClientGuidSet]")
+{
+    // 47 objects is the most the initial 64 slots hold, with these guids probe sequences collide
+    // and a few of them wrap past the last slot
+    ClientGuidSet full;
+    std::vector<ObjectGuid> known;
+    for (uint32 counter = 1; known.size() < 47; ++counter)
+    {
+        known.push_back(ObjectGuid(HighGuid::Unit, 1234u, counter * 34));
+        REQUIRE(full.insert(known.back()));
+    }
+
+    for (ObjectGuid const& erased : known)
+    {
+        ClientGuidSet guids = full;
+        REQUIRE(guids.erase(erased) == 1);
+        REQUIRE(guids.erase(erased) == 0);
+        REQUIRE(guids.size() == known.size() - 1);
+        for (ObjectGuid const& guid : known)
+            REQUIRE(guids.count(guid) == (guid == erased ? 0u : 1u));
+    }
+
+    // emptied front to back and back to front
+    ClientGuidSet forward = full;
+    ClientGuidSet backward = full;
+    for (std::size_t i = 0; i < known.size(); ++i)
+    {
+        REQUIRE(forward.erase(known[i]) == 1);
+        REQUIRE(backward.erase(known[known.size() - 1 - i]) == 1);
+        for (std::size_t j = i + 1; j < known.size(); ++j)
+        {
+            REQUIRE(forward.count(known[j]) == 1);
+            REQUIRE(backward.count(known[known.size() - 1 - j]) == 1);
+        }
+    }
+
+    REQUIRE(forward.empty());
+    REQUIRE(backward.empty());
+    REQUIRE(forward.begin() == forward.end());
+}
+
+TEST_CASE("Grow during an update", "[ClientGuidSet]")
+{
+    ClientGuidSet guids;
+    for (uint32 counter = 1; counter <= 40; ++counter)
+        guids.insert(PlayerGuid(counter));
+
+    uint32 generation = guids.StartVisibilityUpdate();
+    for (uint32 counter = 1; counter <= 40; counter += 2)
+        REQUIRE(guids.MarkVisible(PlayerGuid(counter), generation));
+
+    // found for the first time, enough of them to outgrow the table in the middle of the update
+    for (uint32 counter = 1001; counter <= 1100; ++counter)
+        REQUIRE(guids.insert(PlayerGuid(counter)));
+
+    for (uint32 counter = 1; counter <= 40; counter += 2)
+        REQUIRE(!guids.MarkVisible(PlayerGuid(counter), generation));
+
+    std::vector<ObjectGuid> unmarked;
+    guids.GetUnmarked(generation, unmarked);
+    std::sort(unmarked.begin(), unmarked.end());
+
+    std::vector<ObjectGuid> expected;
+    for (uint32 counter = 2; counter <= 40; counter += 2)
+        expected.push_back(PlayerGuid(counter));
+    REQUIRE(unmarked == expected);
+    REQUIRE(guids.size() == 140);
+    REQUIRE(guids.count(PlayerGuid(1100)) == 1);
+}
+
+TEST_CASE("Empty guid", "[ClientGuidSet]")
+{
+    ClientGuidSet guids;
+    REQUIRE(!guids.insert(ObjectGuid::Empty));
+    REQUIRE(guids.count(ObjectGuid::Empty) == 0);
+    REQUIRE(guids.erase(ObjectGuid::Empty) == 0);
+    REQUIRE(!guids.MarkVisible(ObjectGuid::Empty, guids.StartVisibilityUpdate()));
+
+    // empty slots hold the empty guid, it must not be found among them either
+    guids.insert(PlayerGuid(1));
+    REQUIRE(guids.find(ObjectGuid::Empty) == guids.end());
+    REQUIRE(guids.erase(ObjectGuid::Empty) == 0);
+    REQUIRE(guids.size() == 1);
+}
+
+TEST_CASE("Clear during an update", "[ClientGuidSet]")
+{
+    ClientGuidSet guids;
+    for (uint32 counter = 1; counter <= 10; ++counter)
+        guids.insert(PlayerGuid(counter));
+
+    uint32 generation = guids.StartVisibilityUpdate();
+    guids.MarkVisible(PlayerGuid(1), generation);
+    guids.clear();
+
+    std::vector<ObjectGuid> unmarked;
+    guids.GetUnmarked(generation, unmarked);
+    REQUIRE(unmarked.empty());
+
+    // known again afterwards, as found by the running update
+    REQUIRE(guids.insert(PlayerGuid(2)));
+    REQUIRE(!guids.MarkVisible(PlayerGuid(2), generation));
+    guids.GetUnmarked(generation, unmarked);
+    REQUIRE(unmarked.empty());
+}
@@ -0,0 +1,123 @@
+/*
+ * This file is part of the TrinityCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "catch2/catch.hpp"
+#include "MapCollisionCache.h"
+
+namespace
+{
+    // a door between the two query endpoints, blocking only while spawned
+    struct Door
+    {
+        float MinX = 10.0f, MinY = -2.0f, MaxX = 12.0f, MaxY = 2.0f;
+        bool Spawned = true;
+    };
+
+    // what Map::isInLineOfSight does around the dynamic tree query
+    bool IsInLineOfSight(MapCollisionCache const& cache, Door const& door, uint32 terrainGeneration = 0)
+    {
+        uint32 generation;
+        REQUIRE(cache.GetLineOfSightGeneration(terrainGeneration, 0.0f, 0.0f, 20.0f, 0.0f, generation));
+
+        bool result;
+        if (cache.FindLineOfSight(generation, 0, 0.0f, 0.0f, 0.0f, 20.0f, 0.0f, 0.0f, 0, 0, result))
+            return result;
+
+        result = !door.Spawned;
+        cache.StoreLineOfSight(generation, 0, 0.0f, 0.0f, 0.0f, 20.0f, 0.0f, 0.0f, 0, 0, result);
+        return result;
+    }
+}
+
+TEST_CASE("Spawn state changes line of sight", "[MapCollisionCache]")
+{
+    MapCollisionCache cache;
+    Door door;
+
+    REQUIRE_FALSE(IsInLineOfSight(cache, door));
+
+    // GameObject::InvalidateModelCollision on despawn
+    door.Spawned = false;
+    cache.Invalidate(door.MinX, door.MinY, door.MaxX, door.MaxY);
+    REQUIRE(IsInLineOfSight(cache, door));
+
+    // and on respawn
+    door.Spawned = true;
+    cache.Invalidate(door.MinX, door.MinY, door.MaxX, door.MaxY);
+    REQUIRE_FALSE(IsInLineOfSight(cache, door));
+}
+
+TEST_CASE("Changes in other grids keep results", "[MapCollisionCache]")
+{
+    MapCollisionCache cache;
+    Door door;
+
+    REQUIRE_FALSE(IsInLineOfSight(cache, door));
+
+    door.Spawned = false;
+    cache.Invalidate(1000.0f, 1000.0f, 1010.0f, 1010.0f);
+    REQUIRE_FALSE(IsInLineOfSight(cache, door));
+
+    cache.Invalidate();
+    REQUIRE(IsInLineOfSight(cache, door));
+}
+
+TEST_CASE("Changes while querying drop the result", "[MapCollisionCache]")
+{
+    MapCollisionCache cache;
+
+    // the door despawns on another thread while the query still sees it
+    uint32 generation;
+    REQUIRE(cache.GetLineOfSightGeneration(0, 0.0f, 0.0f, 20.0f, 0.0f, generation));
+    cache.Invalidate(10.0f, -2.0f, 12.0f, 2.0f);
+    cache.StoreLineOfSight(generation, 0, 0.0f, 0.0f, 0.0f, 20.0f, 0.0f, 0.0f, 0, 0, false);
+
+    REQUIRE(cache.GetLineOfSightGeneration(0, 0.0f, 0.0f, 20.0f, 0.0f, generation));
+    bool result;
+    REQUIRE_FALSE(cache.FindLineOfSight(generation, 0, 0.0f, 0.0f, 0.0f, 20.0f, 0.0f, 0.0f, 0, 0, result));
+
+    // same for terrain loaded while a height query runs
+    generation = cache.GetHeightGeneration(0);
+    cache.StoreHeight(generation, 0, 5.0f, 5.0f, 10.0f, true, 50.0f, -200000.0f);
+    float height;
+    REQUIRE_FALSE(cache.FindHeight(cache.GetHeightGeneration(1), 0, 5.0f, 5.0f, 10.0f, true, 50.0f, height));
+}
+
+TEST_CASE("Lines spanning many grids are not cached", "[MapCollisionCache]")
+{
+    MapCollisionCache cache;
+    uint32 generation;
+    REQUIRE_FALSE(cache.GetLineOfSightGeneration(0, 0.0f, 0.0f, 3 * SIZE_OF_GRIDS, 0.0f, generation));
+}
+
+TEST_CASE("Shared terrain changes drop results", "[MapCollisionCache]")
+{
+    // an instance and its parent map, both using the terrain owned by the parent
+    MapCollisionCache parent;
+    MapCollisionCache instance;
+    uint32 terrainGeneration = 0;
+    Door door;
+
+    REQUIRE_FALSE(IsInLineOfSight(parent, door, terrainGeneration));
+    REQUIRE_FALSE(IsInLineOfSight(instance, door, terrainGeneration));
+
+    // Map::LoadMapAndVMap on the parent changes what the query sees
+    door.Spawned = false;
+    ++terrainGeneration;
+    REQUIRE(IsInLineOfSight(parent, door, terrainGeneration));
+    REQUIRE(IsInLineOfSight(instance, door, terrainGeneration));
+}
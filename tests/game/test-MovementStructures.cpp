@@ -0,0 +1,649 @@
+/*
+ * This file is part of the TrinityCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "catch2/catch.hpp"
+#include "ByteBuffer.h"
+#include "MovementStructures.h"
+#include "UnitDefines.h"
+#include <G3D/g3dmath.h>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <random>
+#include <vector>
+
+namespace
+{
+    // Unit::WriteMovementInfo as it was before the sequences were compiled, kept unchanged as the reference output
+    void LegacyWriteMovementInfo(ByteBuffer& data, MovementStatusElements const* sequence, Movement::MovementStatusWriteData const& status)
+    {
+        MovementInfo const& mi = *status.Info;
+
+        bool hasMovementFlags = mi.flags != 0;
+        bool hasMovementFlags2 = mi.flags2 != 0;
+        bool hasTimestamp = true;
+        bool hasOrientation = !G3D::fuzzyEq(status.Pos.GetOrientation(), 0.0f);
+        bool hasTransportData = !status.TransportGuid.IsEmpty();
+        bool hasSpline = status.HasSpline;
+
+        bool hasTransportTime2 = hasTransportData && mi.transport.time2 != 0;
+        bool hasTransportVehicleId = hasTransportData && mi.transport.vehicleId != 0;
+        bool hasPitch = mi.HasMovementFlag(MovementFlags(MOVEMENTFLAG_SWIMMING | MOVEMENTFLAG_FLYING)) || mi.HasExtraMovementFlag(MOVEMENTFLAG2_ALWAYS_ALLOW_PITCHING);
+        bool hasFallDirection = mi.HasMovementFlag(MOVEMENTFLAG_FALLING);
+        bool hasFallData = hasFallDirection || mi.jump.fallTime != 0;
+        bool hasSplineElevation = mi.HasMovementFlag(MOVEMENTFLAG_SPLINE_ELEVATION);
+
+        ObjectGuid guid = status.Guid;
+        ObjectGuid tguid = hasTransportData ? status.TransportGuid : ObjectGuid::Empty;
+
+        for (; *sequence != MSEEnd; ++sequence)
+        {
+            MovementStatusElements const& element = *sequence;
+
+            switch (element)
+            {
+                case MSEHasGuidByte0:
+                case MSEHasGuidByte1:
+                case MSEHasGuidByte2:
+                case MSEHasGuidByte3:
+                case MSEHasGuidByte4:
+                case MSEHasGuidByte5:
+                case MSEHasGuidByte6:
+                case MSEHasGuidByte7:
+                    data.WriteBit(guid[element - MSEHasGuidByte0]);
+                    break;
+                case MSEHasTransportGuidByte0:
+                case MSEHasTransportGuidByte1:
+                case MSEHasTransportGuidByte2:
+                case MSEHasTransportGuidByte3:
+                case MSEHasTransportGuidByte4:
+                case MSEHasTransportGuidByte5:
+                case MSEHasTransportGuidByte6:
+                case MSEHasTransportGuidByte7:
+                    if (hasTransportData)
+                        data.WriteBit(tguid[element - MSEHasTransportGuidByte0]);
+                    break;
+                case MSEGuidByte0:
+                case MSEGuidByte1:
+                case MSEGuidByte2:
+                case MSEGuidByte3:
+                case MSEGuidByte4:
+                case MSEGuidByte5:
+                case MSEGuidByte6:
+                case MSEGuidByte7:
+                    data.WriteByteSeq(guid[element - MSEGuidByte0]);
+                    break;
+                case MSETransportGuidByte0:
+                case MSETransportGuidByte1:
+                case MSETransportGuidByte2:
+                case MSETransportGuidByte3:
+                case MSETransportGuidByte4:
+                case MSETransportGuidByte5:
+                case MSETransportGuidByte6:
+                case MSETransportGuidByte7:
+                    if (hasTransportData)
+                        data.WriteByteSeq(tguid[element - MSETransportGuidByte0]);
+                    break;
+                case MSEHasMovementFlags:
+                    data.WriteBit(!hasMovementFlags);
+                    break;
+                case MSEHasMovementFlags2:
+                    data.WriteBit(!hasMovementFlags2);
+                    break;
+                case MSEHasTimestamp:
+                    data.WriteBit(!hasTimestamp);
+                    break;
+                case MSEHasOrientation:
+                    data.WriteBit(!hasOrientation);
+                    break;
+                case MSEHasTransportData:
+                    data.WriteBit(hasTransportData);
+                    break;
+                case MSEHasTransportTime2:
+                    if (hasTransportData)
+                        data.WriteBit(hasTransportTime2);
+                    break;
+                case MSEHasVehicleId:
+                    if (hasTransportData)
+                        data.WriteBit(hasTransportVehicleId);
+                    break;
+                case MSEHasPitch:
+                    data.WriteBit(!hasPitch);
+                    break;
+                case MSEHasFallData:
+                    data.WriteBit(hasFallData);
+                    break;
+                case MSEHasFallDirection:
+                    if (hasFallData)
+                        data.WriteBit(hasFallDirection);
+                    break;
+                case MSEHasSplineElevation:
+                    data.WriteBit(!hasSplineElevation);
+                    break;
+                case MSEHasSpline:
+                    data.WriteBit(hasSpline);
+                    break;
+                case MSEHasHeightChangeFailed:
+                    data.WriteBit(mi.HasHeightChangeFailed());
+                    break;
+                case MSEMovementFlags:
+                    if (hasMovementFlags)
+                        data.WriteBits(mi.flags, 30);
+                    break;
+                case MSEMovementFlags2:
+                    if (hasMovementFlags2)
+                        data.WriteBits(mi.flags2, 12);
+                    break;
+                case MSETimestamp:
+                    if (hasTimestamp)
+                        data << mi.time;
+                    break;
+                case MSEPositionX:
+                    data << status.Pos.GetPositionX();
+                    break;
+                case MSEPositionY:
+                    data << status.Pos.GetPositionY();
+                    break;
+                case MSEPositionZ:
+                    data << status.Pos.GetPositionZ();
+                    break;
+                case MSEOrientation:
+                    if (hasOrientation)
+                        data << status.Pos.GetOrientation();
+                    break;
+                case MSETransportPositionX:
+                    if (hasTransportData)
+                        data << mi.transport.pos.GetPositionX();
+                    break;
+                case MSETransportPositionY:
+                    if (hasTransportData)
+                        data << mi.transport.pos.GetPositionY();
+                    break;
+                case MSETransportPositionZ:
+                    if (hasTransportData)
+                        data << mi.transport.pos.GetPositionZ();
+                    break;
+                case MSETransportOrientation:
+                    if (hasTransportData)
+                        data << mi.transport.pos.GetOrientation();
+                    break;
+                case MSETransportSeat:
+                    if (hasTransportData)
+                        data << mi.transport.seat;
+                    break;
+                case MSETransportTime:
+                    if (hasTransportData)
+                        data << mi.transport.time;
+                    break;
+                case MSETransportTime2:
+                    if (hasTransportData && hasTransportTime2)
+                        data << mi.transport.time2;
+                    break;
+                case MSETransportVehicleId:
+                    if (hasTransportData && hasTransportVehicleId)
+                        data << mi.transport.vehicleId;
+                    break;
+                case MSEPitch:
+                    if (hasPitch)
+                        data << mi.pitch;
+                    break;
+                case MSEFallTime:
+                    if (hasFallData)
+                        data << mi.jump.fallTime;
+                    break;
+                case MSEFallVerticalSpeed:
+                    if (hasFallData)
+                        data << mi.jump.zspeed;
+                    break;
+                case MSEFallCosAngle:
+                    if (hasFallData && hasFallDirection)
+                        data << mi.jump.cosAngle;
+                    break;
+                case MSEFallSinAngle:
+                    if (hasFallData && hasFallDirection)
+                        data << mi.jump.sinAngle;
+                    break;
+                case MSEFallHorizontalSpeed:
+                    if (hasFallData && hasFallDirection)
+                        data << mi.jump.xyspeed;
+                    break;
+                case MSESplineElevation:
+                    if (hasSplineElevation)
+                        data << mi.splineElevation;
+                    break;
+                case MSECounter:
+                    data << uint32(status.Counter);
+                    break;
+                case MSEZeroBit:
+                    data.WriteBit(0);
+                    break;
+                case MSEOneBit:
+                    data.WriteBit(1);
+                    break;
+                case MSEFlushBits:
+                    data.FlushBits();
+                    break;
+                case MSEExtraElement:
+                    status.Extras->WriteNextElement(data);
+                    break;
+                default:
+                    FAIL("invalid element " << element);
+                    break;
+            }
+        }
+    }
+
+    // Player::ReadMovementInfo as it was before the sequences were compiled, without the validation of the result
+    void LegacyReadMovementInfo(ByteBuffer& data, MovementStatusElements const* sequence, MovementInfo* mi, Movement::ExtraMovementStatusElement* extras)
+    {
+        bool hasMovementFlags = false;
+        bool hasMovementFlags2 = false;
+        bool hasTimestamp = false;
+        bool hasOrientation = false;
+        bool hasTransportData = false;
+        bool hasTransportTime2 = false;
+        bool hasTransportVehicleId = false;
+        bool hasPitch = false;
+        bool hasFallData = false;
+        bool hasFallDirection = false;
+        bool hasSplineElevation = false;
+
+        ObjectGuid guid;
+        ObjectGuid tguid;
+
+        for (; *sequence != MSEEnd; ++sequence)
+        {
+            MovementStatusElements const& element = *sequence;
+
+            switch (element)
+            {
+                case MSEHasGuidByte0:
+                case MSEHasGuidByte1:
+                case MSEHasGuidByte2:
+                case MSEHasGuidByte3:
+                case MSEHasGuidByte4:
+                case MSEHasGuidByte5:
+                case MSEHasGuidByte6:
+                case MSEHasGuidByte7:
+                    guid[element - MSEHasGuidByte0] = data.ReadBit();
+                    break;
+                case MSEHasTransportGuidByte0:
+                case MSEHasTransportGuidByte1:
+                case MSEHasTransportGuidByte2:
+                case MSEHasTransportGuidByte3:
+                case MSEHasTransportGuidByte4:
+                case MSEHasTransportGuidByte5:
+                case MSEHasTransportGuidByte6:
+                case MSEHasTransportGuidByte7:
+                    if (hasTransportData)
+                        tguid[element - MSEHasTransportGuidByte0] = data.ReadBit();
+                    break;
+                case MSEGuidByte0:
+                case MSEGuidByte1:
+                case MSEGuidByte2:
+                case MSEGuidByte3:
+                case MSEGuidByte4:
+                case MSEGuidByte5:
+                case MSEGuidByte6:
+                case MSEGuidByte7:
+                    data.ReadByteSeq(guid[element - MSEGuidByte0]);
+                    break;
+                case MSETransportGuidByte0:
+                case MSETransportGuidByte1:
+                case MSETransportGuidByte2:
+                case MSETransportGuidByte3:
+                case MSETransportGuidByte4:
+                case MSETransportGuidByte5:
+                case MSETransportGuidByte6:
+                case MSETransportGuidByte7:
+                    if (hasTransportData)
+                        data.ReadByteSeq(tguid[element - MSETransportGuidByte0]);
+                    break;
+                case MSEHasMovementFlags:
+                    hasMovementFlags = !data.ReadBit();
+                    break;
+                case MSEHasMovementFlags2:
+                    hasMovementFlags2 = !data.ReadBit();
+                    break;
+                case MSEHasTimestamp:
+                    hasTimestamp = !data.ReadBit();
+                    break;
+                case MSEHasOrientation:
+                    hasOrientation = !data.ReadBit();
+                    break;
+                case MSEHasTransportData:
+                    hasTransportData = data.ReadBit();
+                    break;
+                case MSEHasTransportTime2:
+                    if (hasTransportData)
+                        hasTransportTime2 = data.ReadBit();
+                    break;
+                case MSEHasVehicleId:
+                    if (hasTransportData)
+                        hasTransportVehicleId = data.ReadBit();
+                    break;
+                case MSEHasPitch:
+                    hasPitch = !data.ReadBit();
+                    break;
+                case MSEHasFallData:
+                    hasFallData = data.ReadBit();
+                    break;
+                case MSEHasFallDirection:
+                    if (hasFallData)
+                        hasFallDirection = data.ReadBit();
+                    break;
+                case MSEHasSplineElevation:
+                    hasSplineElevation = !data.ReadBit();
+                    break;
+                case MSEHasSpline:
+                    data.ReadBit();
+                    break;
+                case MSEHasHeightChangeFailed:
+                    data.ReadBit();
+                    break;
+                case MSEMovementFlags:
+                    if (hasMovementFlags)
+                        mi->flags = data.ReadBits(30);
+                    break;
+                case MSEMovementFlags2:
+                    if (hasMovementFlags2)
+                        mi->flags2 = data.ReadBits(12);
+                    break;
+                case MSETimestamp:
+                    if (hasTimestamp)
+                        data >> mi->time;
+                    break;
+                case MSEPositionX:
+                    data >> mi->pos.m_positionX;
+                    break;
+                case MSEPositionY:
+                    data >> mi->pos.m_positionY;
+                    break;
+                case MSEPositionZ:
+                    data >> mi->pos.m_positionZ;
+                    break;
+                case MSEOrientation:
+                    if (hasOrientation)
+                        mi->pos.SetOrientation(data.read<float>());
+                    break;
+                case MSETransportPositionX:
+                    if (hasTransportData)
+                        data >> mi->transport.pos.m_positionX;
+                    break;
+                case MSETransportPositionY:
+                    if (hasTransportData)
+                        data >> mi->transport.pos.m_positionY;
+                    break;
+                case MSETransportPositionZ:
+                    if (hasTransportData)
+                        data >> mi->transport.pos.m_positionZ;
+                    break;
+                case MSETransportOrientation:
+                    if (hasTransportData)
+                        mi->transport.pos.SetOrientation(data.read<float>());
+                    break;
+                case MSETransportSeat:
+                    if (hasTransportData)
+                        data >> mi->transport.seat;
+                    break;
+                case MSETransportTime:
+                    if (hasTransportData)
+                        data >> mi->transport.time;
+                    break;
+                case MSETransportTime2:
+                    if (hasTransportData && hasTransportTime2)
+                        data >> mi->transport.time2;
+                    break;
+                case MSETransportVehicleId:
+                    if (hasTransportData && hasTransportVehicleId)
+                        data >> mi->transport.vehicleId;
+                    break;
+                case MSEPitch:
+                    if (hasPitch)
+                        mi->pitch = G3D::wrap(data.read<float>(), float(-M_PI), float(M_PI));
+                    break;
+                case MSEFallTime:
+                    if (hasFallData)
+                        data >> mi->jump.fallTime;
+                    break;
+                case MSEFallVerticalSpeed:
+                    if (hasFallData)
+                        data >> mi->jump.zspeed;
+                    break;
+                case MSEFallCosAngle:
+                    if (hasFallData && hasFallDirection)
+                        data >> mi->jump.cosAngle;
+                    break;
+                case MSEFallSinAngle:
+                    if (hasFallData && hasFallDirection)
+                        data >> mi->jump.sinAngle;
+                    break;
+                case MSEFallHorizontalSpeed:
+                    if (hasFallData && hasFallDirection)
+                        data >> mi->jump.xyspeed;
+                    break;
+                case MSESplineElevation:
+                    if (hasSplineElevation)
+                        data >> mi->splineElevation;
+                    break;
+                case MSECounter:
+                    data >> mi->movementCounter;
+                    break;
+                case MSEZeroBit:
+                case MSEOneBit:
+                    data.ReadBit();
+                    break;
+                case MSEExtraElement:
+                    extras->ReadNextElement(data);
+                    break;
+                default:
+                    FAIL("invalid element " << element);
+                    break;
+            }
+        }
+
+        mi->guid = guid;
+        mi->transport.guid = tguid;
+    }
+
+    bool IsBitElement(MovementStatusElements element)
+    {
+        return element <= MSEHasHeightChangeFailed || element == MSEMovementFlags || element == MSEMovementFlags2
+            || element == MSEZeroBit || element == MSEOneBit;
+    }
+
+    // extra values for each MSEExtraElement of sequence, bits where the sequence is writing bits and floats elsewhere
+    std::vector<MovementStatusElements> GetExtraElements(MovementStatusElements const* sequence)
+    {
+        std::vector<MovementStatusElements> extras;
+        for (; *sequence != MSEEnd; ++sequence)
+        {
+            if (*sequence != MSEExtraElement)
+                continue;
+
+            MovementStatusElements const* next = sequence + 1;
+            while (*next == MSEExtraElement)
+                ++next;
+
+            extras.push_back(IsBitElement(*next) ? MSEExtraTwoBits : MSEExtraFloat);
+        }
+
+        return extras;
+    }
+
+    bool HasElement(MovementStatusElements const* sequence, MovementStatusElements element)
+    {
+        for (; *sequence != MSEEnd; ++sequence)
+            if (*sequence == element)
+                return true;
+
+        return false;
+    }
+
+    bool SameBits(float left, float right)
+    {
+        return std::memcmp(&left, &right, sizeof(float)) == 0;
+    }
+
+    bool SameMovementInfo(MovementInfo const& left, MovementInfo const& right)
+    {
+        return left.guid == right.guid && left.flags == right.flags && left.flags2 == right.flags2
+            && SameBits(left.pos.GetPositionX(), right.pos.GetPositionX()) && SameBits(left.pos.GetPositionY(), right.pos.GetPositionY())
+            && SameBits(left.pos.GetPositionZ(), right.pos.GetPositionZ()) && SameBits(left.pos.GetOrientation(), right.pos.GetOrientation())
+            && left.time == right.time && left.movementCounter == right.movementCounter
+            && left.transport.guid == right.transport.guid && left.transport.seat == right.transport.seat
+            && SameBits(left.transport.pos.GetPositionX(), right.transport.pos.GetPositionX()) && SameBits(left.transport.pos.GetPositionY(), right.transport.pos.GetPositionY())
+            && SameBits(left.transport.pos.GetPositionZ(), right.transport.pos.GetPositionZ()) && SameBits(left.transport.pos.GetOrientation(), right.transport.pos.GetOrientation())
+            && left.transport.time == right.transport.time && left.transport.time2 == right.transport.time2 && left.transport.vehicleId == right.transport.vehicleId
+            && SameBits(left.pitch, right.pitch) && left.jump.fallTime == right.jump.fallTime && SameBits(left.jump.zspeed, right.jump.zspeed)
+            && SameBits(left.jump.sinAngle, right.jump.sinAngle) && SameBits(left.jump.cosAngle, right.jump.cosAngle) && SameBits(left.jump.xyspeed, right.jump.xyspeed)
+            && SameBits(left.splineElevation, right.splineElevation);
+    }
+
+    bool SameContents(ByteBuffer const& left, ByteBuffer const& right)
+    {
+        return left.size() == right.size() && (left.empty() || std::memcmp(left.contents(), right.contents(), left.size()) == 0);
+    }
+
+    class RandomStatus
+    {
+    public:
+        explicit RandomStatus(uint32 seed) : _rng(seed) { }
+
+        void Fill(MovementInfo& mi, Movement::MovementStatusWriteData& status)
+        {
+            mi.flags = Chance() ? 0 : Uniform<uint32>(0, 0x3FFFFFFF);
+            mi.flags2 = Chance() ? 0 : Uniform<uint16>(0, 0xFFF);
+            mi.time = _rng();
+            mi.transport.pos.Relocate(Coord(), Coord(), Coord(), Chance() ? 0.0f : Angle());
+            mi.transport.seat = int8(Uniform<int32>(-1, 7));
+            mi.transport.time = _rng();
+            mi.transport.time2 = Chance() ? 0 : _rng();
+            mi.transport.vehicleId = Chance() ? 0 : _rng();
+            mi.pitch = Angle() - float(M_PI);
+            mi.jump.fallTime = Chance() ? 0 : _rng();
+            mi.jump.zspeed = Coord();
+            mi.jump.sinAngle = Coord();
+            mi.jump.cosAngle = Coord();
+            mi.jump.xyspeed = Coord();
+            mi.splineElevation = Coord();
+
+            status.Info = &mi;
+            status.Pos.Relocate(Coord(), Coord(), Coord(), Chance() ? 0.0f : Angle());
+            status.Guid = ObjectGuid(Uniform<uint64>(1, std::numeric_limits<uint64>::max()));
+            status.TransportGuid = Chance() ? ObjectGuid::Empty : ObjectGuid(Uniform<uint64>(1, std::numeric_limits<uint64>::max()));
+            status.HasSpline = Chance();
+            status.Counter = _rng();
+        }
+
+        float Coord() { return std::uniform_real_distribution<float>(-10000.0f, 10000.0f)(_rng); }
+
+    private:
+        template<typename T>
+        T Uniform(T min, T max) { return std::uniform_int_distribution<T>(min, max)(_rng); }
+
+        bool Chance() { return (_rng() & 1) != 0; }
+        float Angle() { return std::uniform_real_distribution<float>(0.0f, float(2 * M_PI))(_rng); }
+
+        std::mt19937 _rng;
+    };
+}
+
+TEST_CASE("Compiled movement status serializers match the legacy interpreter", "[MovementStructures]")
+{
+    RandomStatus random(39);
+    uint32 sequences = 0;
+
+    for (uint32 opcode = 0; opcode <= MAX_OPCODE; ++opcode)
+    {
+        MovementStatusElements const* sequence = GetMovementStatusElementsSequence(opcode);
+        if (!sequence)
+            continue;
+
+        ++sequences;
+
+        // bits following a flush are not read back the way they are written, server only sequences use it
+        bool readable = !HasElement(sequence, MSEFlushBits);
+
+        std::vector<MovementStatusElements> extraElements = GetExtraElements(sequence);
+
+        INFO("opcode " << opcode);
+
+        for (uint32 i = 0; i < 200; ++i)
+        {
+            MovementInfo mi;
+            Movement::MovementStatusWriteData status;
+            random.Fill(mi, status);
+
+            Movement::ExtraMovementStatusElement compiledExtras(extraElements.data());
+            Movement::ExtraMovementStatusElement legacyExtras(extraElements.data());
+            compiledExtras.Data.floatData = legacyExtras.Data.floatData = random.Coord();
+            compiledExtras.Data.byteData = legacyExtras.Data.byteData = int8(i % 4);
+
+            ByteBuffer compiled;
+            status.Extras = &compiledExtras;
+            REQUIRE(Movement::WriteMovementStatus(compiled, opcode, status));
+            compiled.FlushBits();
+
+            ByteBuffer legacy;
+            status.Extras = &legacyExtras;
+            LegacyWriteMovementInfo(legacy, sequence, status);
+            legacy.FlushBits();
+
+            REQUIRE(SameContents(compiled, legacy));
+
+            if (!readable)
+                continue;
+
+            MovementInfo compiledRead;
+            Movement::ExtraMovementStatusElement compiledReadExtras(extraElements.data());
+            ByteBuffer compiledData(compiled);
+            REQUIRE(Movement::ReadMovementStatus(compiledData, opcode, compiledRead, &compiledReadExtras));
+
+            MovementInfo legacyRead;
+            Movement::ExtraMovementStatusElement legacyReadExtras(extraElements.data());
+            ByteBuffer legacyData(compiled);
+            LegacyReadMovementInfo(legacyData, sequence, &legacyRead, &legacyReadExtras);
+
+            REQUIRE(compiledData.rpos() == compiled.size());
+            REQUIRE(legacyData.rpos() == compiled.size());
+            REQUIRE(SameMovementInfo(compiledRead, legacyRead));
+            REQUIRE(SameBits(compiledReadExtras.Data.floatData, legacyReadExtras.Data.floatData));
+            REQUIRE(compiledReadExtras.Data.byteData == legacyReadExtras.Data.byteData);
+
+            // everything that was read is written back the same way
+            Movement::MovementStatusWriteData readStatus;
+            readStatus.Info = &compiledRead;
+            readStatus.Pos = compiledRead.pos;
+            readStatus.Guid = compiledRead.guid;
+            readStatus.TransportGuid = compiledRead.transport.guid;
+            readStatus.HasSpline = status.HasSpline;
+            readStatus.Counter = compiledRead.movementCounter;
+            Movement::ExtraMovementStatusElement rewriteExtras(extraElements.data());
+            rewriteExtras.Data = compiledReadExtras.Data;
+            readStatus.Extras = &rewriteExtras;
+
+            ByteBuffer rewritten;
+            REQUIRE(Movement::WriteMovementStatus(rewritten, opcode, readStatus));
+            rewritten.FlushBits();
+
+            REQUIRE(SameContents(compiled, rewritten));
+        }
+    }
+
+    REQUIRE(sequences > 100);
+}
@@ -0,0 +1,209 @@
+/*
+ * This file is part of the TrinityCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "catch2/catch.hpp"
+#include "PathRequestQueue.h"
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+namespace
+{
+    // holds back builds on the path finding threads until opened
+    struct Gate
+    {
+        std::mutex Lock;
+        std::condition_variable Condition;
+        bool Open = false;
+        uint32 Waiting = 0;
+
+        void Pass()
+        {
+            std::unique_lock<std::mutex> lock(Lock);
+            ++Waiting;
+            Condition.notify_all();
+            Condition.wait(lock, [this] { return Open; });
+        }
+
+        void WaitForBuild()
+        {
+            std::unique_lock<std::mutex> lock(Lock);
+            Condition.wait(lock, [this] { return Waiting > 0; });
+        }
+
+        void Release()
+        {
+            std::lock_guard<std::mutex> lock(Lock);
+            Open = true;
+            Condition.notify_all();
+        }
+    };
+
+    // no navmesh is loaded for terrain map 0, only the queue itself runs
+    class TestPathRequest : public PathRequest
+    {
+        public:
+            TestPathRequest(G3D::Vector3 const& start, G3D::Vector3 const& end, float collisionHeight = 2.0f, Gate* gate = nullptr)
+                : PathRequest(0, start, end, collisionHeight, 0), Builds(0), _gate(gate) { }
+
+            std::atomic<uint32> Builds;
+            std::thread::id BuildThread;
+
+        protected:
+            void Build(dtNavMeshQuery const* /*navMeshQuery*/) override
+            {
+                if (_gate)
+                    _gate->Pass();
+
+                BuildThread = std::this_thread::get_id();
+                ++Builds;
+            }
+
+        private:
+            Gate* _gate;
+    };
+
+    G3D::Vector3 const Start(100.0f, 100.0f, 10.0f);
+    G3D::Vector3 const End(130.0f, 100.0f, 10.0f);
+}
+
+TEST_CASE("Requests are shared by quantized start and end", "[PathRequestQueue]")
+{
+    PathRequestProcessor processor;
+    PathRequestQueue queue(processor, 0);
+
+    std::shared_ptr<TestPathRequest> first = std::make_shared<TestPathRequest>(Start, End);
+    REQUIRE(queue.Submit(first) == first);
+
+    SECTION("same quantum")
+    {
+        std::shared_ptr<TestPathRequest> near = std::make_shared<TestPathRequest>(Start + G3D::Vector3(0.2f, 0.0f, 0.0f), End + G3D::Vector3(0.0f, 0.3f, 0.0f));
+        REQUIRE(queue.Submit(near) == first);
+        REQUIRE(near->Builds == 0);
+        REQUIRE(first->Builds == 1);
+    }
+
+    SECTION("different start")
+    {
+        std::shared_ptr<TestPathRequest> other = std::make_shared<TestPathRequest>(Start + G3D::Vector3(0.5f, 0.0f, 0.0f), End);
+        REQUIRE(queue.Submit(other) == other);
+        REQUIRE(other->Builds == 1);
+    }
+
+    SECTION("different end")
+    {
+        std::shared_ptr<TestPathRequest> other = std::make_shared<TestPathRequest>(Start, End + G3D::Vector3(0.0f, 0.0f, 0.5f));
+        REQUIRE(queue.Submit(other) == other);
+        REQUIRE(other->Builds == 1);
+    }
+
+    SECTION("nobody waits for it anymore")
+    {
+        first.reset();
+        queue.Update();
+
+        std::shared_ptr<TestPathRequest> again = std::make_shared<TestPathRequest>(Start, End);
+        REQUIRE(queue.Submit(again) == again);
+        REQUIRE(again->Builds == 1);
+    }
+}
+
+TEST_CASE("Collision heights get separate requests", "[PathRequestQueue]")
+{
+    PathRequestProcessor processor;
+    PathRequestQueue queue(processor, 0);
+
+    std::shared_ptr<TestPathRequest> small = std::make_shared<TestPathRequest>(Start, End, 2.0f);
+    std::shared_ptr<TestPathRequest> large = std::make_shared<TestPathRequest>(Start, End, 9.0f);
+    REQUIRE(queue.Submit(small) == small);
+    REQUIRE(queue.Submit(large) == large);
+    REQUIRE(small->Builds == 1);
+    REQUIRE(large->Builds == 1);
+
+    std::shared_ptr<TestPathRequest> sameAsLarge = std::make_shared<TestPathRequest>(Start, End, 9.0f);
+    REQUIRE(queue.Submit(sameAsLarge) == large);
+}
+
+TEST_CASE("Requests are built right away without path finding threads", "[PathRequestQueue]")
+{
+    // MapUpdate.PathfindingThreads = 0
+    PathRequestProcessor processor;
+    PathRequestQueue queue(processor, 0);
+
+    std::shared_ptr<TestPathRequest> request = std::make_shared<TestPathRequest>(Start, End);
+    std::shared_ptr<PathRequest const> submitted = queue.Submit(request);
+    REQUIRE(submitted->IsReady());
+    REQUIRE(request->Builds == 1);
+    REQUIRE(request->BuildThread == std::this_thread::get_id());
+
+    uint32 gridX = Trinity::ComputeGridCoordSimple(Start.x, Start.y).x_coord;
+    uint32 gridY = Trinity::ComputeGridCoordSimple(Start.x, Start.y).y_coord;
+    REQUIRE_FALSE(queue.IsGridInUse(gridX, gridY));
+}
+
+TEST_CASE("Cancel and drain before the navmesh is unloaded", "[PathRequestQueue]")
+{
+    PathRequestProcessor processor;
+    processor.activate(1);
+
+    {
+        Gate gate;
+        PathRequestQueue queue(processor, 0);
+
+        // the only thread is stuck building the first request, the others wait behind it
+        std::shared_ptr<TestPathRequest> running = std::make_shared<TestPathRequest>(Start, End, 2.0f, &gate);
+        std::shared_ptr<TestPathRequest> pending = std::make_shared<TestPathRequest>(End, Start);
+        std::shared_ptr<TestPathRequest> pendingFar = std::make_shared<TestPathRequest>(Start, G3D::Vector3(900.0f, 900.0f, 10.0f));
+        REQUIRE(queue.Submit(running) == running);
+        REQUIRE(queue.Submit(pending) == pending);
+        REQUIRE(queue.Submit(pendingFar) == pendingFar);
+        gate.WaitForBuild();
+
+        GridCoord farGrid = Trinity::ComputeGridCoordSimple(900.0f, 900.0f);
+        REQUIRE(queue.IsGridInUse(farGrid.x_coord, farGrid.y_coord));
+        REQUIRE_FALSE(running->IsReady());
+
+        std::thread releaser([&gate]
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(50));
+            gate.Release();
+        });
+
+        // what Map::UnloadAll and ~Map do before the navmesh goes away
+        queue.CancelAll();
+        releaser.join();
+
+        // the running request finished, the pending ones were never built
+        REQUIRE(running->IsReady());
+        REQUIRE(running->Builds == 1);
+        REQUIRE_FALSE(pending->IsReady());
+        REQUIRE(pending->Builds == 0);
+        REQUIRE(pendingFar->Builds == 0);
+
+        GridCoord startGrid = Trinity::ComputeGridCoordSimple(Start.x, Start.y);
+        REQUIRE_FALSE(queue.IsGridInUse(startGrid.x_coord, startGrid.y_coord));
+        REQUIRE_FALSE(queue.IsGridInUse(farGrid.x_coord, farGrid.y_coord));
+
+        // cancelled requests are not shared anymore
+        std::shared_ptr<TestPathRequest> again = std::make_shared<TestPathRequest>(End, Start);
+        REQUIRE(queue.Submit(again) == again);
+        queue.CancelAll();
+    }
+
+    processor.deactivate();
+}
@@ -0,0 +1,365 @@
+/*
+ * This file is part of the TrinityCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "catch2/catch.hpp"
+#include "DBCStructure.h"
+#include "ProcAuraIndex.h"
+#include "SpellInfo.h"
+#include "SpellMgr.h"
+#include "Unit.h"
+#include <algorithm>
+#include <iterator>
+#include <map>
+#include <memory>
+#include <vector>
+
+namespace
+{
+    uint32 const ProcTypes[] =
+    {
+        PROC_FLAG_KILL, PROC_FLAG_DEAL_MELEE_SWING, PROC_FLAG_TAKE_MELEE_SWING,
+        PROC_FLAG_DEAL_MELEE_ABILITY, PROC_FLAG_TAKE_MELEE_ABILITY,
+        PROC_FLAG_DEAL_HARMFUL_SPELL, PROC_FLAG_TAKE_HARMFUL_SPELL,
+        PROC_FLAG_DEAL_HELPFUL_SPELL, PROC_FLAG_TAKE_HELPFUL_SPELL,
+        PROC_FLAG_DEAL_PERIODIC, PROC_FLAG_TAKE_PERIODIC, PROC_FLAG_TAKE_ANY_DAMAGE,
+        PROC_FLAG_MAIN_HAND_WEAPON_SWING, PROC_FLAG_DEATH
+    };
+
+    std::unique_ptr<SpellInfo> MakeSpellInfo(uint32 id, uint32 familyName, flag96 const& familyFlags)
+    {
+        SpellEntry entry = { };
+        entry.ID = id;
+        SpellEffectEntry const* effects[MAX_SPELL_EFFECTS] = { };
+
+        std::unique_ptr<SpellInfo> spellInfo = std::make_unique<SpellInfo>(&entry, effects);
+        spellInfo->SpellFamilyName = familyName;
+        spellInfo->SpellFamilyFlags = familyFlags;
+        return spellInfo;
+    }
+
+    SpellProcEntry MakeProcEntry(uint32 procFlags)
+    {
+        SpellProcEntry procEntry = { };
+        procEntry.ProcFlags = procFlags;
+        procEntry.SpellPhaseMask = PROC_SPELL_PHASE_HIT;    // what LoadSpellProcs fills in when the row has none
+        return procEntry;
+    }
+
+    AuraApplication* FakeAurApp(std::uintptr_t id)
+    {
+        return reinterpret_cast<AuraApplication*>(id << 4);
+    }
+
+    flag96 FamilyFlag(uint32 bit)
+    {
+        flag96 flags;
+        flags[bit / 32] |= 1u << (bit % 32);
+        return flags;
+    }
+
+    // proc auras of a raider and the spells cast during a raid fight, everything derived from its index
+    struct RaidFight
+    {
+        static uint32 const EventCount = 5000;
+
+        RaidFight()
+        {
+            // some spells without a family
+            for (uint32 i = 0; i < 200; ++i)
+                Spells.push_back(MakeSpellInfo(i + 1, i % 4, FamilyFlag(i * 37 % 96)));
+
+            // a few of them applied twice
+            for (uint32 i = 0; i < 40; ++i)
+            {
+                SpellProcEntry procEntry = MakeProcEntry(ProcTypes[i * 7 % std::size(ProcTypes)]);
+                if (i % 3 == 0)
+                    procEntry.ProcFlags |= ProcTypes[i * 11 % std::size(ProcTypes)];
+                if (i % 3 != 1)
+                {
+                    procEntry.SpellFamilyName = i % 4;
+                    procEntry.SpellFamilyMask = FamilyFlag(i * 53 % 96);
+                }
+                ProcEntries.push_back(procEntry);
+            }
+
+            for (uint32 i = 0; i < ProcEntries.size(); ++i)
+            {
+                AuraApplication* aurApp = FakeAurApp(i + 1);
+                AppliedAuras.emplace(1000 + i / 2, aurApp);
+                ProcEntryOf[aurApp] = &ProcEntries[i];
+                Index.Insert(aurApp, 1000 + i / 2, ProcEntries[i]);
+            }
+        }
+
+        uint32 GetTypeMask(uint32 event) const { return ProcTypes[event * 13 % std::size(ProcTypes)]; }
+        SpellInfo const* GetSpellInfo(uint32 event) const { return event % 3 ? Spells[event * 31 % Spells.size()].get() : nullptr; }
+
+        // the loop over Unit::m_appliedAuras the index replaced
+        std::vector<AuraApplication*> FullScan(ProcEventInfo& eventInfo) const
+        {
+            std::vector<AuraApplication*> accepted;
+            for (auto const& pair : AppliedAuras)
+                if (SpellMgr::CanSpellTriggerProcOnEvent(*ProcEntryOf.at(pair.second), eventInfo))
+                    accepted.push_back(pair.second);
+            return accepted;
+        }
+
+        std::vector<AuraApplication*> IndexScan(ProcEventInfo& eventInfo)
+        {
+            std::vector<AuraApplication*> candidates;
+            Index.Visit(ProcAuraIndex::MakeFilter(eventInfo.GetTypeMask(), eventInfo.GetSpellInfo()), [&](AuraApplication* aurApp)
+            {
+                if (SpellMgr::CanSpellTriggerProcOnEvent(*ProcEntryOf.at(aurApp), eventInfo))
+                    candidates.push_back(aurApp);
+            });
+            return candidates;
+        }
+
+        std::vector<std::unique_ptr<SpellInfo>> Spells;
+        std::vector<SpellProcEntry> ProcEntries;
+        std::multimap<uint32, AuraApplication*> AppliedAuras;
+        std::map<AuraApplication*, SpellProcEntry const*> ProcEntryOf;
+        ProcAuraIndex Index;
+    };
+
+    std::vector<AuraApplication*> VisitAll(ProcAuraIndex& index, uint32 typeMask)
+    {
+        std::vector<AuraApplication*> visited;
+        index.Visit(ProcAuraIndex::MakeFilter(typeMask, nullptr), [&](AuraApplication* aurApp) { visited.push_back(aurApp); });
+        return visited;
+    }
+}
+
+TEST_CASE("Applied aura order", "[ProcAuraIndex]")
+{
+    SpellProcEntry procEntry = MakeProcEntry(PROC_FLAG_DEAL_MELEE_SWING);
+    SpellProcEntry takenEntry = MakeProcEntry(PROC_FLAG_TAKE_MELEE_SWING);
+
+    AuraApplication* first = FakeAurApp(1);
+    AuraApplication* second = FakeAurApp(2);
+    AuraApplication* third = FakeAurApp(3);
+    AuraApplication* taken = FakeAurApp(4);
+
+    ProcAuraIndex index;
+    index.Insert(second, 20, procEntry);
+    index.Insert(third, 20, procEntry);
+    index.Insert(first, 10, procEntry);
+    index.Insert(taken, 5, takenEntry);
+    REQUIRE(index.GetProcFlags() == (PROC_FLAG_DEAL_MELEE_SWING | PROC_FLAG_TAKE_MELEE_SWING));
+    REQUIRE(VisitAll(index, PROC_FLAG_DEAL_MELEE_SWING) == std::vector<AuraApplication*>{ first, second, third });
+
+    index.Remove(taken);
+    REQUIRE(index.GetProcFlags() == PROC_FLAG_DEAL_MELEE_SWING);
+    REQUIRE(VisitAll(index, PROC_FLAG_TAKE_MELEE_SWING).empty());
+
+    index.Clear();
+    REQUIRE(index.empty());
+    REQUIRE(index.GetProcFlags() == 0);
+}
+
+TEST_CASE("Changes during a visit", "[ProcAuraIndex]")
+{
+    SpellProcEntry procEntry = MakeProcEntry(PROC_FLAG_DEAL_MELEE_SWING);
+    AuraApplication* a = FakeAurApp(1);
+    AuraApplication* b = FakeAurApp(2);
+    AuraApplication* c = FakeAurApp(3);
+    AuraApplication* d = FakeAurApp(4);
+
+    ProcAuraIndex index;
+    index.Insert(a, 10, procEntry);
+    index.Insert(b, 20, procEntry);
+    index.Insert(c, 30, procEntry);
+    index.Insert(d, 40, procEntry);
+
+    std::vector<AuraApplication*> visited;
+    auto visit = [&](auto&& onVisit)
+    {
+        visited.clear();
+        index.Visit(ProcAuraIndex::MakeFilter(PROC_FLAG_DEAL_MELEE_SWING, nullptr), [&](AuraApplication* aurApp)
+        {
+            visited.push_back(aurApp);
+            onVisit(aurApp);
+        });
+    };
+
+    SECTION("remove a visited aura")
+    {
+        visit([&](AuraApplication* aurApp) { if (aurApp == b) index.Remove(a); });
+        REQUIRE(visited == std::vector<AuraApplication*>{ a, b, c, d });
+    }
+
+    SECTION("remove the current aura")
+    {
+        visit([&](AuraApplication* aurApp) { if (aurApp == b) index.Remove(b); });
+        REQUIRE(visited == std::vector<AuraApplication*>{ a, b, c, d });
+        REQUIRE(index.size() == 3);
+    }
+
+    SECTION("remove an aura ahead")
+    {
+        visit([&](AuraApplication* aurApp) { if (aurApp == a) index.Remove(c); });
+        REQUIRE(visited == std::vector<AuraApplication*>{ a, b, d });
+    }
+
+    SECTION("apply during a visit")
+    {
+        // like the applied aura map, an aura applied in front of the visit is not visited, one applied behind it is
+        AuraApplication* front = FakeAurApp(5);
+        AuraApplication* behind = FakeAurApp(6);
+        visit([&](AuraApplication* aurApp)
+        {
+            if (aurApp == b)
+            {
+                index.Insert(front, 5, procEntry);
+                index.Insert(behind, 20, procEntry);    // same spell id, after b like multimap::insert
+            }
+        });
+        REQUIRE(visited == std::vector<AuraApplication*>{ a, b, behind, c, d });
+    }
+
+    SECTION("nested visit")
+    {
+        std::vector<AuraApplication*> inner;
+        visit([&](AuraApplication* aurApp)
+        {
+            if (aurApp != b)
+                return;
+
+            index.Visit(ProcAuraIndex::MakeFilter(PROC_FLAG_DEAL_MELEE_SWING, nullptr), [&](AuraApplication* innerAurApp)
+            {
+                inner.push_back(innerAurApp);
+                if (innerAurApp == c)
+                    index.Remove(a);
+            });
+        });
+        REQUIRE(inner == std::vector<AuraApplication*>{ a, b, c, d });
+        REQUIRE(visited == std::vector<AuraApplication*>{ a, b, c, d });
+    }
+}
+
+TEST_CASE("Proc data reload", "[ProcAuraIndex]")
+{
+    // what Unit::_RebuildProcAuraIndex does when SpellMgr::GetSpellProcVersion changed
+    AuraApplication* meleeAura = FakeAurApp(1);
+    AuraApplication* lostProcData = FakeAurApp(2);
+
+    ProcAuraIndex index;
+    index.SetVersion(1);
+    index.Insert(meleeAura, 10, MakeProcEntry(PROC_FLAG_DEAL_MELEE_SWING));
+    index.Insert(lostProcData, 20, MakeProcEntry(PROC_FLAG_DEAL_MELEE_SWING));
+    REQUIRE(VisitAll(index, PROC_FLAG_DEAL_MELEE_SWING) == std::vector<AuraApplication*>{ meleeAura, lostProcData });
+
+    // the reloaded table moved the first aura to spell hits and dropped the second one
+    uint32 const reloadedVersion = 2;
+    REQUIRE(index.GetVersion() != reloadedVersion);
+    index.Clear();
+    index.Insert(meleeAura, 10, MakeProcEntry(PROC_FLAG_DEAL_HARMFUL_SPELL));
+    index.SetVersion(reloadedVersion);
+
+    REQUIRE(index.GetVersion() == reloadedVersion);
+    REQUIRE(index.GetProcFlags() == PROC_FLAG_DEAL_HARMFUL_SPELL);
+    REQUIRE(VisitAll(index, PROC_FLAG_DEAL_MELEE_SWING).empty());
+    REQUIRE(VisitAll(index, PROC_FLAG_DEAL_HARMFUL_SPELL) == std::vector<AuraApplication*>{ meleeAura });
+}
+
+TEST_CASE("Spell family filter", "[ProcAuraIndex]")
+{
+    std::unique_ptr<SpellInfo> strike = MakeSpellInfo(1, SPELLFAMILY_WARRIOR, flag96(0x2, 0, 0));
+    std::unique_ptr<SpellInfo> fireball = MakeSpellInfo(2, SPELLFAMILY_MAGE, flag96(0x1, 0, 0));
+
+    SpellProcEntry anySpell = MakeProcEntry(PROC_FLAG_DEAL_HARMFUL_SPELL);
+    SpellProcEntry warriorSpells = anySpell;
+    warriorSpells.SpellFamilyName = SPELLFAMILY_WARRIOR;
+    SpellProcEntry strikeOnly = warriorSpells;
+    strikeOnly.SpellFamilyMask = flag96(0x2, 0, 0);
+    SpellProcEntry otherWarriorSpell = warriorSpells;
+    otherWarriorSpell.SpellFamilyMask = flag96(0x4, 0, 0);
+    SpellProcEntry strikeOrKill = strikeOnly;
+    strikeOrKill.ProcFlags |= PROC_FLAG_KILL;
+
+    AuraApplication* anySpellAura = FakeAurApp(1);
+    AuraApplication* warriorSpellsAura = FakeAurApp(2);
+    AuraApplication* strikeOnlyAura = FakeAurApp(3);
+    AuraApplication* otherWarriorSpellAura = FakeAurApp(4);
+    AuraApplication* strikeOrKillAura = FakeAurApp(5);
+
+    ProcAuraIndex index;
+    index.Insert(anySpellAura, 10, anySpell);
+    index.Insert(warriorSpellsAura, 20, warriorSpells);
+    index.Insert(strikeOnlyAura, 30, strikeOnly);
+    index.Insert(otherWarriorSpellAura, 40, otherWarriorSpell);
+    index.Insert(strikeOrKillAura, 50, strikeOrKill);
+
+    auto visit = [&](uint32 typeMask, SpellInfo const* spellInfo)
+    {
+        std::vector<AuraApplication*> visited;
+        index.Visit(ProcAuraIndex::MakeFilter(typeMask, spellInfo), [&](AuraApplication* aurApp) { visited.push_back(aurApp); });
+        return visited;
+    };
+
+    // same as SpellInfo::IsAffected, auras without a family take every spell
+    REQUIRE(visit(PROC_FLAG_DEAL_HARMFUL_SPELL, strike.get()) == std::vector<AuraApplication*>{ anySpellAura, warriorSpellsAura, strikeOnlyAura, strikeOrKillAura });
+    REQUIRE(visit(PROC_FLAG_DEAL_HARMFUL_SPELL, fireball.get()) == std::vector<AuraApplication*>{ anySpellAura });
+
+    // kills trigger before the spell family is checked, events without a spell are not filtered by family
+    REQUIRE(visit(PROC_FLAG_KILL, fireball.get()) == std::vector<AuraApplication*>{ strikeOrKillAura });
+    REQUIRE(visit(PROC_FLAG_DEAL_HARMFUL_SPELL, nullptr).size() == 5);
+}
+
+TEST_CASE("Raid fight", "[ProcAuraIndex]")
+{
+    RaidFight fight;
+    for (uint32 event = 0; event < RaidFight::EventCount; ++event)
+    {
+        DamageInfo damageInfo(nullptr, nullptr, 100, fight.GetSpellInfo(event), SPELL_SCHOOL_MASK_NORMAL, SPELL_DIRECT_DAMAGE, BASE_ATTACK);
+        ProcEventInfo eventInfo(nullptr, nullptr, nullptr, fight.GetTypeMask(event), PROC_SPELL_TYPE_DAMAGE, PROC_SPELL_PHASE_HIT, PROC_HIT_NORMAL, nullptr, &damageInfo, nullptr);
+
+        // every aura that can proc is still asked, in the applied aura order
+        CAPTURE(event);
+        REQUIRE(fight.IndexScan(eventInfo) == fight.FullScan(eventInfo));
+    }
+}
+
+TEST_CASE("Raid fight replay", "[ProcAuraIndex][.][benchmark]")
+{
+    RaidFight fight;
+    std::vector<DamageInfo> damageInfos;
+    std::vector<ProcEventInfo> eventInfos;
+    damageInfos.reserve(RaidFight::EventCount);
+    eventInfos.reserve(RaidFight::EventCount);
+    for (uint32 event = 0; event < RaidFight::EventCount; ++event)
+    {
+        damageInfos.emplace_back(nullptr, nullptr, 100, fight.GetSpellInfo(event), SPELL_SCHOOL_MASK_NORMAL, SPELL_DIRECT_DAMAGE, BASE_ATTACK);
+        eventInfos.emplace_back(nullptr, nullptr, nullptr, fight.GetTypeMask(event), PROC_SPELL_TYPE_DAMAGE, PROC_SPELL_PHASE_HIT, PROC_HIT_NORMAL, nullptr, &damageInfos.back(), nullptr);
+    }
+
+    BENCHMARK("applied auras")
+    {
+        std::size_t procs = 0;
+        for (ProcEventInfo& eventInfo : eventInfos)
+            procs += fight.FullScan(eventInfo).size();
+        return procs;
+    };
+
+    BENCHMARK("proc aura index")
+    {
+        std::size_t procs = 0;
+        for (ProcEventInfo& eventInfo : eventInfos)
+            procs += fight.IndexScan(eventInfo).size();
+        return procs;
+    };
+}
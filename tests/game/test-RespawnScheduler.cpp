@@ -0,0 +1,417 @@
+/*
+ * This file is part of the TrinityCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "catch2/catch.hpp"
+#include "RespawnScheduler.h"
+#include <algorithm>
+#include <vector>
+
+namespace
+{
+    time_t const TurnSeconds = RespawnScheduler::WheelSlots * RespawnScheduler::SlotSeconds;
+
+    RespawnInfo MakeRespawn(ObjectGuid::LowType spawnId, time_t respawnTime, uint32 gridId = 1, SpawnObjectType type = SPAWN_TYPE_CREATURE)
+    {
+        return RespawnInfo{ type, spawnId, 1, respawnTime, gridId, {} };
+    }
+
+    uint32 const GridCount = 64 * 64;
+
+    // a continent worth of spawns spread over every grid, positions and respawn delays derived from the spawn id.
+    // Keeps track of what has to be scheduled to check the scheduler against
+    struct Continent
+    {
+        explicit Continent(std::size_t spawnCount, time_t now) : Scheduled(spawnCount, false), Loaded(GridCount, false)
+        {
+            Spawns.reserve(spawnCount);
+            for (std::size_t i = 0; i < spawnCount; ++i)
+            {
+                // one in ten respawns a week later, sharing its slot with short ones of later turns of the wheel
+                time_t const delay = (i % 10) ? time_t(i * 7919 % 3600) : 7 * 24 * 3600;
+                Spawns.push_back(MakeRespawn(i + 1, now + delay, uint32(i * 2654435761u % GridCount), (i % 5) ? SPAWN_TYPE_CREATURE : SPAWN_TYPE_GAMEOBJECT));
+            }
+        }
+
+        uint32 GetScheduleGrid(RespawnInfo const& info) const
+        {
+            // every 20th spawn stands for a pooled one
+            return (info.spawnId % 20) ? info.gridId : RespawnScheduler::AnyGrid;
+        }
+
+        bool IsChecked(RespawnInfo const& info) const
+        {
+            uint32 gridId = GetScheduleGrid(info);
+            return gridId == RespawnScheduler::AnyGrid || Loaded[gridId];
+        }
+
+        void Schedule(RespawnInfo& info, time_t respawnTime)
+        {
+            info.respawnTime = respawnTime;
+            Scheduler.Insert(&info, GetScheduleGrid(info));
+            Scheduled[info.spawnId - 1] = true;
+            ++ScheduledCount;
+        }
+
+        void Unscheduled(RespawnInfo const* info)
+        {
+            REQUIRE(Scheduled[info->spawnId - 1]);
+            Scheduled[info->spawnId - 1] = false;
+            --ScheduledCount;
+        }
+
+        void SetLoaded(uint32 gridId, bool loaded)
+        {
+            Loaded[gridId] = loaded;
+            Scheduler.SetGridLoaded(gridId, loaded);
+        }
+
+        std::size_t CountDue(time_t now, bool checked) const
+        {
+            std::size_t count = 0;
+            for (RespawnInfo const& info : Spawns)
+                if (Scheduled[info.spawnId - 1] && info.respawnTime <= now && IsChecked(info) == checked)
+                    ++count;
+            return count;
+        }
+
+        std::vector<RespawnInfo> Spawns;
+        std::vector<bool> Scheduled;
+        std::vector<bool> Loaded;
+        std::size_t ScheduledCount = 0;
+        RespawnScheduler Scheduler;
+    };
+
+    // takes the due list out of the scheduler, earliest first
+    std::vector<RespawnInfo*> TakeDue(RespawnScheduler& scheduler)
+    {
+        std::vector<RespawnInfo*> due;
+        while (RespawnInfo* next = scheduler.GetNextDue())
+        {
+            due.push_back(next);
+            scheduler.Erase(next);
+        }
+        return due;
+    }
+}
+
+TEST_CASE("Unloaded grids", "[RespawnScheduler]")
+{
+    RespawnScheduler scheduler;
+
+    RespawnInfo near = MakeRespawn(1, 100, 10);
+    RespawnInfo far = MakeRespawn(2, 100, 20);
+    RespawnInfo later = MakeRespawn(3, 100 + TurnSeconds * 3, 10, SPAWN_TYPE_GAMEOBJECT);
+    RespawnInfo pooled = MakeRespawn(4, 90, 20);
+
+    scheduler.SetGridLoaded(10, true);
+    scheduler.Insert(&near, 10);
+    scheduler.Insert(&far, 20);
+    scheduler.Insert(&later, 10);
+    scheduler.Insert(&pooled, RespawnScheduler::AnyGrid);
+
+    scheduler.Update(99);
+    REQUIRE(scheduler.GetNextDue() == &pooled);
+    scheduler.Erase(&pooled);
+    REQUIRE(scheduler.GetNextDue() == nullptr);
+
+    scheduler.Update(100 + TurnSeconds);
+    REQUIRE(scheduler.GetNextDue() == &near);
+    scheduler.Erase(&near);
+    REQUIRE(scheduler.GetNextDue() == nullptr);
+    REQUIRE(scheduler.size() == 2);
+
+    std::vector<RespawnInfo*> due;
+    scheduler.CollectDue(20, 100 + TurnSeconds * 2, due);
+    REQUIRE(due.size() == 1);
+    REQUIRE(due.front() == &far);
+    REQUIRE(scheduler.size() == 1);
+
+    scheduler.SetGridLoaded(10, false);
+    scheduler.Update(later.respawnTime);
+    REQUIRE(scheduler.GetNextDue() == nullptr);
+
+    // rescheduled before it is due, it comes up at its new time
+    later.respawnTime = 5000;
+    scheduler.Erase(&later);
+    scheduler.Insert(&later, 10);
+    scheduler.SetGridLoaded(10, true);
+    scheduler.Update(4999);
+    REQUIRE(scheduler.GetNextDue() == nullptr);
+    scheduler.Update(5000);
+    REQUIRE(scheduler.GetNextDue() == &later);
+}
+
+TEST_CASE("Slot boundaries", "[RespawnScheduler]")
+{
+    RespawnScheduler scheduler;
+    scheduler.SetGridLoaded(1, true);
+
+    // the first and last second of a slot and the first second of the next one
+    time_t const slotStart = 1000 * RespawnScheduler::SlotSeconds;
+    RespawnInfo first = MakeRespawn(1, slotStart);
+    RespawnInfo last = MakeRespawn(2, slotStart + RespawnScheduler::SlotSeconds - 1);
+    RespawnInfo next = MakeRespawn(3, slotStart + RespawnScheduler::SlotSeconds);
+    scheduler.Insert(&first, 1);
+    scheduler.Insert(&last, 1);
+    scheduler.Insert(&next, 1);
+
+    scheduler.Update(slotStart - 1);
+    REQUIRE(scheduler.GetNextDue() == nullptr);
+
+    scheduler.Update(slotStart);
+    REQUIRE(TakeDue(scheduler) == std::vector<RespawnInfo*>{ &first });
+
+    scheduler.Update(last.respawnTime - 1);
+    REQUIRE(scheduler.GetNextDue() == nullptr);
+
+    scheduler.Update(last.respawnTime);
+    REQUIRE(TakeDue(scheduler) == std::vector<RespawnInfo*>{ &last });
+
+    scheduler.Update(next.respawnTime);
+    REQUIRE(TakeDue(scheduler) == std::vector<RespawnInfo*>{ &next });
+    REQUIRE(scheduler.empty());
+}
+
+TEST_CASE("Later turns", "[RespawnScheduler]")
+{
+    RespawnScheduler scheduler;
+    scheduler.SetGridLoaded(1, true);
+
+    time_t const now = 5000 * RespawnScheduler::SlotSeconds;
+    scheduler.Update(now);
+
+    // same slot as now, one and two turns of the wheel later
+    RespawnInfo nextTurn = MakeRespawn(1, now + TurnSeconds);
+    RespawnInfo turnAfter = MakeRespawn(2, now + 2 * TurnSeconds);
+    scheduler.Insert(&nextTurn, 1);
+    scheduler.Insert(&turnAfter, 1);
+
+    for (time_t t = now; t < nextTurn.respawnTime; t += RespawnScheduler::SlotSeconds)
+    {
+        scheduler.Update(t);
+        REQUIRE(scheduler.GetNextDue() == nullptr);
+    }
+
+    scheduler.Update(nextTurn.respawnTime);
+    REQUIRE(TakeDue(scheduler) == std::vector<RespawnInfo*>{ &nextTurn });
+    scheduler.Update(turnAfter.respawnTime - 1);
+    REQUIRE(scheduler.GetNextDue() == nullptr);
+    scheduler.Update(turnAfter.respawnTime);
+    REQUIRE(TakeDue(scheduler) == std::vector<RespawnInfo*>{ &turnAfter });
+}
+
+TEST_CASE("Past respawn times", "[RespawnScheduler]")
+{
+    RespawnScheduler scheduler;
+    scheduler.SetGridLoaded(1, true);
+
+    time_t const now = 7000 * RespawnScheduler::SlotSeconds + 2;
+    scheduler.Update(now);
+
+    // behind the slots the grid already checked, and long overdue from before the server started
+    RespawnInfo overdue = MakeRespawn(1, now - 3 * RespawnScheduler::SlotSeconds);
+    RespawnInfo ancient = MakeRespawn(2, 0);
+    RespawnInfo current = MakeRespawn(3, now);
+    scheduler.Insert(&overdue, 1);
+    scheduler.Insert(&ancient, 1);
+    scheduler.Insert(&current, 1);
+
+    scheduler.Update(now);
+    REQUIRE(TakeDue(scheduler) == std::vector<RespawnInfo*>{ &ancient, &overdue, &current });
+}
+
+TEST_CASE("Unloaded for several turns", "[RespawnScheduler]")
+{
+    RespawnScheduler scheduler;
+    scheduler.SetGridLoaded(1, true);
+    scheduler.Update(0);
+
+    // one respawn in every slot of the wheel, and one just after the grid comes back
+    std::vector<RespawnInfo> respawns;
+    for (uint32 i = 0; i < RespawnScheduler::WheelSlots; ++i)
+        respawns.push_back(MakeRespawn(i + 1, time_t(i) * RespawnScheduler::SlotSeconds + 1));
+    time_t const loadTime = 3 * TurnSeconds + 1;
+    respawns.push_back(MakeRespawn(RespawnScheduler::WheelSlots + 1, loadTime + 1));
+    for (RespawnInfo& info : respawns)
+        scheduler.Insert(&info, 1);
+
+    scheduler.SetGridLoaded(1, false);
+    scheduler.Update(loadTime);
+    REQUIRE(scheduler.GetNextDue() == nullptr);
+
+    SECTION("loading the grid again")
+    {
+        scheduler.SetGridLoaded(1, true);
+        scheduler.Update(loadTime);
+        std::vector<RespawnInfo*> due = TakeDue(scheduler);
+        REQUIRE(due.size() == respawns.size() - 1);
+        for (std::size_t i = 0; i < due.size(); ++i)
+            REQUIRE(due[i] == &respawns[i]);
+    }
+
+    SECTION("collecting the grid's respawns while it is unloaded")
+    {
+        std::vector<RespawnInfo*> due;
+        scheduler.CollectDue(1, loadTime, due);
+        REQUIRE(due.size() == respawns.size() - 1);
+        REQUIRE(scheduler.size() == 1);
+        for (RespawnInfo* info : due)
+            REQUIRE(info->respawnTime <= loadTime);
+    }
+
+    REQUIRE(scheduler.size() == 1);
+}
+
+TEST_CASE("Same respawn time", "[RespawnScheduler]")
+{
+    RespawnScheduler scheduler;
+    scheduler.SetGridLoaded(1, true);
+
+    RespawnInfo gameObject = MakeRespawn(7, 400, 1, SPAWN_TYPE_GAMEOBJECT);
+    RespawnInfo creature = MakeRespawn(7, 400, 1, SPAWN_TYPE_CREATURE);
+    RespawnInfo lowerId = MakeRespawn(3, 400);
+    RespawnInfo earlier = MakeRespawn(9, 399);
+    scheduler.Insert(&gameObject, 1);
+    scheduler.Insert(&creature, 1);
+    scheduler.Insert(&lowerId, 1);
+    scheduler.Insert(&earlier, 1);
+
+    scheduler.Update(400);
+    REQUIRE(scheduler.GetDueCount() == 4);
+
+    // erasing from the middle of the due list keeps the rest in order
+    scheduler.Erase(&lowerId);
+    REQUIRE(TakeDue(scheduler) == std::vector<RespawnInfo*>{ &earlier, &creature, &gameObject });
+}
+
+TEST_CASE("Clear", "[RespawnScheduler]")
+{
+    RespawnScheduler scheduler;
+    scheduler.SetGridLoaded(1, true);
+
+    // due, waiting in a loaded and an unloaded grid, and pooled
+    RespawnInfo due = MakeRespawn(1, 100);
+    RespawnInfo waiting = MakeRespawn(2, 100 + TurnSeconds);
+    RespawnInfo unloaded = MakeRespawn(3, 100, 2);
+    RespawnInfo pooled = MakeRespawn(4, 200);
+    scheduler.Insert(&due, 1);
+    scheduler.Insert(&waiting, 1);
+    scheduler.Insert(&unloaded, 2);
+    scheduler.Insert(&pooled, RespawnScheduler::AnyGrid);
+
+    scheduler.Update(100);
+    REQUIRE(scheduler.GetNextDue() == &due);
+
+    std::vector<RespawnInfo*> infos;
+    scheduler.Clear(infos);
+    std::sort(infos.begin(), infos.end(), [](RespawnInfo const* left, RespawnInfo const* right) { return left->spawnId < right->spawnId; });
+    REQUIRE(infos == std::vector<RespawnInfo*>{ &due, &waiting, &unloaded, &pooled });
+    REQUIRE(scheduler.empty());
+    REQUIRE(scheduler.GetNextDue() == nullptr);
+
+    // usable again afterwards
+    scheduler.Insert(&due, 1);
+    scheduler.Update(100);
+    REQUIRE(TakeDue(scheduler) == std::vector<RespawnInfo*>{ &due });
+}
+
+TEST_CASE("Continent", "[RespawnScheduler]")
+{
+    time_t now = 1000000;
+    Continent continent(120000, now);
+    for (RespawnInfo& info : continent.Spawns)
+        continent.Schedule(info, info.respawnTime);
+
+    // the grids a few hundred players keep loaded
+    for (uint32 gridId = 0; gridId < GridCount; gridId += 10)
+        continent.SetLoaded(gridId, true);
+
+    REQUIRE(continent.Scheduler.size() == continent.Spawns.size());
+
+    // an hour in respawn checks of 5 seconds
+    for (uint32 step = 0; step < 720; ++step)
+    {
+        now += 5;
+
+        // players moving around, loaded grids first hand out what came due while they were unloaded
+        for (uint32 i = 0; i < 4; ++i)
+        {
+            uint32 const gridId = (step * 37 + i * 1031) % GridCount;
+            if (continent.Loaded[gridId])
+            {
+                continent.SetLoaded(gridId, false);
+                continue;
+            }
+
+            continent.SetLoaded(gridId, true);
+
+            std::vector<RespawnInfo*> due;
+            continent.Scheduler.CollectDue(gridId, now, due);
+            for (RespawnInfo* info : due)
+            {
+                REQUIRE(info->gridId == gridId);
+                REQUIRE(info->respawnTime <= now);
+                continent.Unscheduled(info);
+            }
+        }
+
+        continent.Scheduler.Update(now);
+        REQUIRE(continent.Scheduler.GetDueCount() == continent.CountDue(now, true));
+
+        time_t last = 0;
+        while (RespawnInfo* next = continent.Scheduler.GetNextDue())
+        {
+            REQUIRE(next->respawnTime <= now);
+            REQUIRE(next->respawnTime >= last);
+            REQUIRE(continent.IsChecked(*next));
+            last = next->respawnTime;
+
+            continent.Scheduler.Erase(next);
+            continent.Unscheduled(next);
+
+            // some can't respawn yet and are checked again later
+            if ((next->spawnId + step) % 5 == 0)
+                continent.Schedule(*next, now + 1 + time_t(next->spawnId % 600));
+        }
+
+        REQUIRE(continent.Scheduler.size() == continent.ScheduledCount);
+    }
+
+    // respawns of unloaded grids were never looked at and are still there
+    std::size_t const unloadedDue = continent.CountDue(now, false);
+    REQUIRE(unloadedDue > 0);
+
+    std::size_t collected = 0;
+    for (uint32 gridId = 0; gridId < GridCount; ++gridId)
+    {
+        if (continent.Loaded[gridId])
+            continue;
+
+        std::vector<RespawnInfo*> due;
+        continent.Scheduler.CollectDue(gridId, now, due);
+        for (RespawnInfo* info : due)
+            continent.Unscheduled(info);
+        collected += due.size();
+    }
+
+    REQUIRE(collected == unloadedDue);
+
+    std::vector<RespawnInfo*> remaining;
+    continent.Scheduler.Clear(remaining);
+    REQUIRE(remaining.size() == continent.ScheduledCount);
+    REQUIRE(continent.Scheduler.empty());
+}